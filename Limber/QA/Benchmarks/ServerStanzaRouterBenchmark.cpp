@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Swiften/Elements/Message.h>
+#include <Swiften/JID/JID.h>
+
+#include <Limber/Server/ServerSession.h>
+#include <Limber/Server/ServerStanzaRouter.h>
+
+using namespace Swift;
+
+namespace {
+    class CountingServerSession : public ServerSession {
+        public:
+            CountingServerSession(const JID& jid, int priority) : jid_(jid), priority_(priority), sentStanzas_(0) {
+            }
+
+            virtual const JID& getJID() const { return jid_; }
+            virtual int getPriority() const { return priority_; }
+
+            virtual void sendStanza(std::shared_ptr<Stanza>) {
+                ++sentStanzas_;
+            }
+
+        private:
+            JID jid_;
+            int priority_;
+            size_t sentStanzas_;
+    };
+
+    JID getUserJID(int user) {
+        return JID("user" + std::to_string(user), "example.com");
+    }
+
+    void report(const std::string& name, std::chrono::steady_clock::time_point start, size_t count) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        std::cout << std::left << std::setw(24) << name << std::right
+            << std::setw(10) << count
+            << std::setw(12) << elapsed.count() / 1000 << " ms"
+            << std::setw(12) << std::fixed << std::setprecision(3) << static_cast<double>(elapsed.count()) / static_cast<double>(count) << " us/op" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int users = argc > 1 ? std::stoi(argv[1]) : 5000;
+    int resources = 3;
+    int stanzas = 100000;
+
+    std::vector<std::unique_ptr<CountingServerSession> > sessions;
+    for (int user = 0; user < users; ++user) {
+        for (int resource = 0; resource < resources; ++resource) {
+            sessions.push_back(std::unique_ptr<CountingServerSession>(new CountingServerSession(JID(getUserJID(user).getNode(), "example.com", "resource" + std::to_string(resource)), resource)));
+        }
+    }
+
+    // Created up front, so that only the routing is measured
+    std::vector<std::shared_ptr<Message> > fullJIDMessages;
+    std::vector<std::shared_ptr<Message> > bareJIDMessages;
+    for (int i = 0; i < stanzas; ++i) {
+        int user = (i * 7919) % users;
+        std::shared_ptr<Message> message = std::make_shared<Message>();
+        message->setTo(JID(getUserJID(user).getNode(), "example.com", "resource" + std::to_string(i % resources)));
+        fullJIDMessages.push_back(message);
+        message = std::make_shared<Message>();
+        message->setTo(getUserJID(user));
+        bareJIDMessages.push_back(message);
+    }
+
+    std::cout << sessions.size() << " sessions of " << users << " users" << std::endl;
+    ServerStanzaRouter router;
+
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& session : sessions) {
+        router.addClientSession(session.get());
+    }
+    report("addClientSession", start, sessions.size());
+
+    start = std::chrono::steady_clock::now();
+    for (const auto& message : fullJIDMessages) {
+        router.routeStanza(message);
+    }
+    report("routeStanza (full JID)", start, fullJIDMessages.size());
+
+    start = std::chrono::steady_clock::now();
+    for (const auto& message : bareJIDMessages) {
+        router.routeStanza(message);
+    }
+    report("routeStanza (bare JID)", start, bareJIDMessages.size());
+
+    start = std::chrono::steady_clock::now();
+    for (const auto& session : sessions) {
+        router.removeClientSession(session.get());
+    }
+    report("removeClientSession", start, sessions.size());
+
+    return 0;
+}
@@ -1,13 +1,14 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #pragma once
 
-#include <map>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 #include <Swiften/Elements/Stanza.h>
 #include <Swiften/JID/JID.h>
@@ -15,6 +16,13 @@
 namespace Swift {
     class ServerSession;
 
+    /**
+     * Routes stanzas to the client sessions of the addressed user.
+     *
+     * Sessions are indexed by their bare JID, so routing only looks at the
+     * sessions of one user. Priorities are read when a stanza is routed, so
+     * sessions can change their priority without telling the router.
+     */
     class ServerStanzaRouter {
         public:
             ServerStanzaRouter();
@@ -25,6 +33,6 @@ namespace Swift {
             void removeClientSession(ServerSession*);
 
         private:
-            std::vector<ServerSession*> clientSessions_;
+            std::unordered_map<JID, std::vector<ServerSession*> > clientSessions_;
     };
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -23,6 +23,8 @@ class ServerStanzaRouterTest : public CppUnit::TestFixture {
         CPPUNIT_TEST(testRouteStanza_BareJIDWithMultipleSessions);
         CPPUNIT_TEST(testRouteStanza_BareJIDWithOnlyNegativePriorities);
         CPPUNIT_TEST(testRouteStanza_BareJIDWithChangingPresence);
+        CPPUNIT_TEST(testRouteStanza_BareJIDWithSessionsOfOtherUsers);
+        CPPUNIT_TEST(testRemoveClientSession);
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -124,6 +126,36 @@ class ServerStanzaRouterTest : public CppUnit::TestFixture {
             CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(session2.sentStanzas.size()));
         }
 
+        void testRouteStanza_BareJIDWithSessionsOfOtherUsers() {
+            ServerStanzaRouter testling;
+            MockServerSession session1(JID("foo@bar.com/Bla"), 1);
+            testling.addClientSession(&session1);
+            MockServerSession session2(JID("baz@bar.com/Bla"), 8);
+            testling.addClientSession(&session2);
+
+            bool result = testling.routeStanza(createMessageTo("foo@bar.com"));
+
+            CPPUNIT_ASSERT(result);
+            CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(session1.sentStanzas.size()));
+            CPPUNIT_ASSERT_EQUAL(0, static_cast<int>(session2.sentStanzas.size()));
+        }
+
+        void testRemoveClientSession() {
+            ServerStanzaRouter testling;
+            MockServerSession session1(JID("foo@bar.com/Bla"), 1);
+            testling.addClientSession(&session1);
+            MockServerSession session2(JID("foo@bar.com/Baz"), 8);
+            testling.addClientSession(&session2);
+
+            testling.removeClientSession(&session2);
+            CPPUNIT_ASSERT(testling.routeStanza(createMessageTo("foo@bar.com/Baz")));
+            testling.removeClientSession(&session1);
+            CPPUNIT_ASSERT(!testling.routeStanza(createMessageTo("foo@bar.com/Baz")));
+
+            CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(session1.sentStanzas.size()));
+            CPPUNIT_ASSERT_EQUAL(0, static_cast<int>(session2.sentStanzas.size()));
+        }
+
     private:
         std::shared_ptr<Message> createMessageTo(const std::string& recipient) {
             std::shared_ptr<Message> message(new Message());
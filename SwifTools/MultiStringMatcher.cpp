@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <SwifTools/MultiStringMatcher.h>
+
+#include <algorithm>
+#include <deque>
+
+namespace Swift {
+
+namespace {
+    unsigned char toLowerASCII(char c) {
+        return static_cast<unsigned char>(c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+    }
+
+    bool compareChildren(const std::pair<unsigned char, size_t>& child, unsigned char c) {
+        return child.first < c;
+    }
+}
+
+MultiStringMatcher::MultiStringMatcher(const std::vector<Pattern>& patterns) : patterns_(patterns), nodes_(1) {
+    // Build a trie of the (lowercased) patterns. Node 0 is the root, so
+    // getChild() can use 0 for a missing child.
+    for (size_t i = 0; i < patterns_.size(); ++i) {
+        size_t node = 0;
+        for (char c : patterns_[i].text) {
+            unsigned char key = toLowerASCII(c);
+            size_t child = getChild(node, key);
+            if (!child) {
+                child = nodes_.size();
+                auto& children = nodes_[node].children;
+                children.insert(std::lower_bound(children.begin(), children.end(), key, &compareChildren), std::make_pair(key, child));
+                nodes_.push_back(Node());
+            }
+            node = child;
+        }
+        if (node != 0) {
+            nodes_[node].patterns.push_back(i);
+        }
+    }
+
+    // Add the failure links breadth-first, so the failure node of a node is
+    // always complete before the node itself.
+    std::deque<size_t> queue;
+    for (const auto& child : nodes_[0].children) {
+        queue.push_back(child.second);
+    }
+    while (!queue.empty()) {
+        size_t node = queue.front();
+        queue.pop_front();
+        for (const auto& child : nodes_[node].children) {
+            size_t failure = nodes_[node].failure;
+            while (failure != 0 && !getChild(failure, child.first)) {
+                failure = nodes_[failure].failure;
+            }
+            failure = getChild(failure, child.first);
+            nodes_[child.second].failure = failure;
+            nodes_[child.second].patterns.insert(nodes_[child.second].patterns.end(), nodes_[failure].patterns.begin(), nodes_[failure].patterns.end());
+            queue.push_back(child.second);
+        }
+    }
+}
+
+size_t MultiStringMatcher::getChild(size_t node, unsigned char c) const {
+    const auto& children = nodes_[node].children;
+    auto i = std::lower_bound(children.begin(), children.end(), c, &compareChildren);
+    return (i != children.end() && i->first == c) ? i->second : 0;
+}
+
+std::vector<MultiStringMatcher::Match> MultiStringMatcher::findAll(const std::string& text) const {
+    std::vector<Match> matches;
+    size_t node = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        unsigned char c = toLowerASCII(text[i]);
+        while (node != 0 && !getChild(node, c)) {
+            node = nodes_[node].failure;
+        }
+        node = getChild(node, c);
+        for (size_t pattern : nodes_[node].patterns) {
+            const Pattern& p = patterns_[pattern];
+            size_t position = i + 1 - p.text.size();
+            if (p.caseSensitive && text.compare(position, p.text.size(), p.text) != 0) {
+                continue;
+            }
+            matches.push_back(Match(pattern, position, p.text.size()));
+        }
+    }
+    std::sort(matches.begin(), matches.end(), [](const Match& a, const Match& b) {
+        return a.position < b.position || (a.position == b.position && a.pattern < b.pattern);
+    });
+    return matches;
+}
+
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Swift {
+    /**
+     * Finds all occurrences of a fixed set of strings in a text in a single
+     * pass over the text (using the Aho-Corasick algorithm).
+     *
+     * Case-insensitive patterns only ignore the case of ASCII letters.
+     */
+    class MultiStringMatcher {
+        public:
+            struct Pattern {
+                Pattern(const std::string& text, bool caseSensitive = true) : text(text), caseSensitive(caseSensitive) {}
+
+                std::string text;
+                bool caseSensitive;
+            };
+
+            struct Match {
+                Match(size_t pattern, size_t position, size_t length) : pattern(pattern), position(position), length(length) {}
+
+                /** The index of the matching pattern. */
+                size_t pattern;
+                size_t position;
+                size_t length;
+            };
+
+        public:
+            MultiStringMatcher(const std::vector<Pattern>& patterns = std::vector<Pattern>());
+
+            /**
+             * Returns all (possibly overlapping) matches in the text, ordered by
+             * position and then by pattern index.
+             */
+            std::vector<Match> findAll(const std::string& text) const;
+
+        private:
+            struct Node {
+                std::vector<std::pair<unsigned char, size_t> > children;
+                size_t failure = 0;
+                std::vector<size_t> patterns;
+            };
+
+            size_t getChild(size_t node, unsigned char c) const;
+
+        private:
+            std::vector<Pattern> patterns_;
+            std::vector<Node> nodes_;
+    };
+}
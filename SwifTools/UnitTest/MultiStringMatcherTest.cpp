@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+
+#include <SwifTools/MultiStringMatcher.h>
+
+using namespace Swift;
+
+class MultiStringMatcherTest : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE(MultiStringMatcherTest);
+    CPPUNIT_TEST(testFindAll_NoPatterns);
+    CPPUNIT_TEST(testFindAll_NoMatch);
+    CPPUNIT_TEST(testFindAll_MultipleOccurrences);
+    CPPUNIT_TEST(testFindAll_OverlappingPatterns);
+    CPPUNIT_TEST(testFindAll_SuffixPatterns);
+    CPPUNIT_TEST(testFindAll_CaseInsensitive);
+    CPPUNIT_TEST(testFindAll_CaseSensitive);
+    CPPUNIT_TEST(testFindAll_NonASCII);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void testFindAll_NoPatterns() {
+        MultiStringMatcher testling;
+
+        CPPUNIT_ASSERT(testling.findAll("some text").empty());
+    }
+
+    void testFindAll_NoMatch() {
+        MultiStringMatcher testling({MultiStringMatcher::Pattern("foo"), MultiStringMatcher::Pattern("bar")});
+
+        CPPUNIT_ASSERT(testling.findAll("fo ba fobar").size() == 1);
+        CPPUNIT_ASSERT(testling.findAll("fo ba").empty());
+    }
+
+    void testFindAll_MultipleOccurrences() {
+        MultiStringMatcher testling({MultiStringMatcher::Pattern(":)"), MultiStringMatcher::Pattern(":(")});
+
+        std::vector<MultiStringMatcher::Match> matches = testling.findAll(":( a :) b :(");
+
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), matches.size());
+        assertMatch(matches[0], 1, 0, 2);
+        assertMatch(matches[1], 0, 5, 2);
+        assertMatch(matches[2], 1, 10, 2);
+    }
+
+    void testFindAll_OverlappingPatterns() {
+        MultiStringMatcher testling({MultiStringMatcher::Pattern("she"), MultiStringMatcher::Pattern("he"), MultiStringMatcher::Pattern("hers"), MultiStringMatcher::Pattern("his")});
+
+        std::vector<MultiStringMatcher::Match> matches = testling.findAll("ushers");
+
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), matches.size());
+        assertMatch(matches[0], 0, 1, 3);
+        assertMatch(matches[1], 1, 2, 2);
+        assertMatch(matches[2], 2, 2, 4);
+    }
+
+    void testFindAll_SuffixPatterns() {
+        MultiStringMatcher testling({MultiStringMatcher::Pattern("abcd"), MultiStringMatcher::Pattern("bc"), MultiStringMatcher::Pattern("c")});
+
+        std::vector<MultiStringMatcher::Match> matches = testling.findAll("abcx");
+
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), matches.size());
+        assertMatch(matches[0], 1, 1, 2);
+        assertMatch(matches[1], 2, 2, 1);
+    }
+
+    void testFindAll_CaseInsensitive() {
+        MultiStringMatcher testling({MultiStringMatcher::Pattern("Juliet", false)});
+
+        std::vector<MultiStringMatcher::Match> matches = testling.findAll("JULIET juliet jUlIeT");
+
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), matches.size());
+        assertMatch(matches[2], 0, 14, 6);
+    }
+
+    void testFindAll_CaseSensitive() {
+        MultiStringMatcher testling({MultiStringMatcher::Pattern(":D"), MultiStringMatcher::Pattern(":d", false)});
+
+        std::vector<MultiStringMatcher::Match> matches = testling.findAll(":d :D");
+
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), matches.size());
+        assertMatch(matches[0], 1, 0, 2);
+        assertMatch(matches[1], 0, 3, 2);
+        assertMatch(matches[2], 1, 3, 2);
+    }
+
+    void testFindAll_NonASCII() {
+        MultiStringMatcher testling({MultiStringMatcher::Pattern("\xc3\xa9t\xc3\xa9", false)});
+
+        std::vector<MultiStringMatcher::Match> matches = testling.findAll("l'\xc3\xa9t\xc3\xa9");
+
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), matches.size());
+        assertMatch(matches[0], 0, 2, 5);
+    }
+
+private:
+    void assertMatch(const MultiStringMatcher::Match& match, size_t pattern, size_t position, size_t length) {
+        CPPUNIT_ASSERT_EQUAL(pattern, match.pattern);
+        CPPUNIT_ASSERT_EQUAL(position, match.position);
+        CPPUNIT_ASSERT_EQUAL(length, match.length);
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MultiStringMatcherTest);
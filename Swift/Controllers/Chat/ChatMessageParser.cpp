@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2017 Isode Limited.
+ * Copyright (c) 2013-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -7,14 +7,13 @@
 #include <Swift/Controllers/Chat/ChatMessageParser.h>
 
 #include <algorithm>
+#include <cctype>
 #include <memory>
 #include <utility>
 #include <vector>
 
 #include <boost/algorithm/string.hpp>
-#include <boost/regex.hpp>
 
-#include <Swiften/Base/Regex.h>
 #include <Swiften/Base/String.h>
 
 #include <SwifTools/Linkify.h>
@@ -24,7 +23,25 @@ namespace Swift {
     ChatMessageParser::ChatMessageParser(const std::map<std::string, std::string>& emoticons, std::shared_ptr<HighlightConfiguration> highlightConfiguration, Mode mode) : emoticons_(emoticons), highlightConfiguration_(highlightConfiguration), mode_(mode) {
     }
 
-    typedef std::pair<std::string, std::string> StringPair;
+    namespace {
+        bool isWhitespace(char c) {
+            return std::isspace(static_cast<unsigned char>(c)) != 0;
+        }
+
+        bool isWordCharacter(char c) {
+            return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+        }
+
+        bool isWordBoundary(const std::string& text, size_t begin, size_t end, size_t position) {
+            bool wordBefore = position > begin && isWordCharacter(text[position - 1]);
+            bool wordAfter = position < end && isWordCharacter(text[position]);
+            return wordBefore != wordAfter;
+        }
+
+        bool isSameKeywordHighlight(const HighlightConfiguration::KeywordHightlight& a, const HighlightConfiguration::KeywordHightlight& b) {
+            return a.keyword == b.keyword && a.matchCaseSensitive == b.matchCaseSensitive && a.action == b.action;
+        }
+    }
 
     ChatWindow::ChatMessage ChatMessageParser::parseMessageBody(const std::string& body, const std::string& senderNickname, bool senderIsSelf) {
         ChatWindow::ChatMessage parsedMessage;
@@ -58,13 +75,22 @@ namespace Swift {
             }
         }
 
-        /* do emoticon substitution */
-        parsedMessage = emoticonHighlight(parsedMessage);
-
-        if (!senderIsSelf) { /* do not highlight our own messsages */
-            // Highlight keywords and own mentions.
-            parsedMessage = splitHighlight(parsedMessage);
+        /* Parse two, emoticons, keywords and own mentions (do not highlight our own messsages) */
+        updateMatcher();
+        ChatWindow::ChatMessage newMessage = parsedMessage;
+        newMessage.setParts(std::vector<std::shared_ptr<ChatWindow::ChatMessagePart> >());
+        for (const auto& part : parsedMessage.getParts()) {
+            std::shared_ptr<ChatWindow::ChatTextMessagePart> textPart;
+            if ((textPart = std::dynamic_pointer_cast<ChatWindow::ChatTextMessagePart>(part))) {
+                parseTextPart(textPart->text, !senderIsSelf, newMessage);
+            }
+            else {
+                newMessage.append(part);
+            }
+        }
+        parsedMessage = newMessage;
 
+        if (!senderIsSelf) {
             // Highlight full message events like, specific sender, general
             // incoming group message, or general incoming direct message.
             parsedMessage = fullMessageHighlight(parsedMessage, senderNickname);
@@ -73,161 +99,110 @@ namespace Swift {
         return parsedMessage;
     }
 
-    ChatWindow::ChatMessage ChatMessageParser::emoticonHighlight(const ChatWindow::ChatMessage& message) {
-        ChatWindow::ChatMessage parsedMessage = message;
-
-        std::string regexString;
-        /* Parse two, emoticons */
-        for (StringPair emoticon : emoticons_) {
-            /* Construct a regexp that finds an instance of any of the emoticons inside a group
-             * at the start or end of the line, or beside whitespace.
-             */
-            regexString += regexString.empty() ? "" : "|";
-            std::string escaped = "(" + Regex::escape(emoticon.first) + ")";
-            regexString += "^" + escaped + "|";
-            regexString += escaped + "$|";
-            regexString += "\\s" + escaped + "|";
-            regexString += escaped + "\\s";
-
+    void ChatMessageParser::updateMatcher() {
+        // The highlight configuration is changed in place, so compare it with the one the matcher was built for.
+        HighlightAction ownMentionAction = highlightConfiguration_->ownMentionAction;
+        const auto& keywordHighlights = highlightConfiguration_->keywordHighlights;
+        if (matcherValid_ && matcherNick_ == nick_ && matcherOwnMentionAction_ == ownMentionAction && matcherKeywordHighlights_.size() == keywordHighlights.size() && std::equal(keywordHighlights.begin(), keywordHighlights.end(), matcherKeywordHighlights_.begin(), &isSameKeywordHighlight)) {
+            return;
         }
-        if (!regexString.empty()) {
-            regexString += "";
-            boost::regex emoticonRegex(regexString);
-
-            ChatWindow::ChatMessage newMessage;
-            for (const auto& part : parsedMessage.getParts()) {
-                std::shared_ptr<ChatWindow::ChatTextMessagePart> textPart;
-                if ((textPart = std::dynamic_pointer_cast<ChatWindow::ChatTextMessagePart>(part))) {
-                    try {
-                        boost::match_results<std::string::const_iterator> match;
-                        const std::string& text = textPart->text;
-                        std::string::const_iterator start = text.begin();
-                        while (regex_search(start, text.end(), match, emoticonRegex)) {
-                            int matchIndex = 0;
-                            for (matchIndex = 1; matchIndex < static_cast<int>(match.size()); matchIndex++) {
-                                if (match[matchIndex].length() > 0) {
-                                    //This is the matching subgroup
-                                    break;
-                                }
-                            }
-                            std::string::const_iterator matchStart = match[matchIndex].first;
-                            std::string::const_iterator matchEnd = match[matchIndex].second;
-                            if (start != matchStart) {
-                                /* If we're skipping over plain text since the previous emoticon, record it as plain text */
-                                newMessage.append(std::make_shared<ChatWindow::ChatTextMessagePart>(std::string(start, matchStart)));
-                            }
-                            std::shared_ptr<ChatWindow::ChatEmoticonMessagePart> emoticonPart = std::make_shared<ChatWindow::ChatEmoticonMessagePart>();
-                            std::string matchString = match[matchIndex].str();
-                            std::map<std::string, std::string>::const_iterator emoticonIterator = emoticons_.find(matchString);
-                            assert (emoticonIterator != emoticons_.end());
-                            const StringPair& emoticon = *emoticonIterator;
-                            emoticonPart->imagePath = emoticon.second;
-                            emoticonPart->alternativeText = emoticon.first;
-                            newMessage.append(emoticonPart);
-                            start = matchEnd;
-                        }
-                        if (start != text.end()) {
-                            /* If there's plain text after the last emoticon, record it */
-                            newMessage.append(std::make_shared<ChatWindow::ChatTextMessagePart>(std::string(start, text.end())));
-                        }
-
-                    }
-                    catch (const std::runtime_error&) {
-                        /* Basically too expensive to compute the regex results and it gave up, so pass through as text */
-                        newMessage.append(part);
-                    }
-                }
-                else {
-                    newMessage.append(part);
-                }
+        matcherValid_ = true;
+        matcherNick_ = nick_;
+        matcherOwnMentionAction_ = ownMentionAction;
+        matcherKeywordHighlights_ = keywordHighlights;
+
+        // Patterns that match at the same position are preferred in this order.
+        std::vector<MultiStringMatcher::Pattern> matcherPatterns;
+        patterns_.clear();
+        for (const auto& emoticon : emoticons_) {
+            if (!emoticon.first.empty()) {
+                matcherPatterns.push_back(MultiStringMatcher::Pattern(emoticon.first));
+                patterns_.push_back(Pattern{Pattern::Type::Emoticon, emoticon.second, HighlightAction()});
             }
-            parsedMessage.setParts(newMessage.getParts());
         }
-
-        return parsedMessage;
-    }
-
-    ChatWindow::ChatMessage ChatMessageParser::splitHighlight(const ChatWindow::ChatMessage& message) {
-        auto keywordToRegEx = [](const std::string& keyword, bool matchCaseSensitive) {
-            std::string escaped = Regex::escape(keyword);
-            boost::regex::flag_type flags = boost::regex::normal;
-            if (!matchCaseSensitive) {
-                flags |= boost::regex::icase;
+        if (!nick_.empty() && !ownMentionAction.isEmpty()) {
+            ownMentionAction.setSoundFilePath(boost::optional<std::string>());
+            ownMentionAction.setSystemNotificationEnabled(false);
+            matcherPatterns.push_back(MultiStringMatcher::Pattern(nick_, false));
+            patterns_.push_back(Pattern{Pattern::Type::OwnMention, "", ownMentionAction});
+        }
+        for (const auto& keywordHighlight : keywordHighlights) {
+            if (!keywordHighlight.keyword.empty() && !keywordHighlight.action.isEmpty()) {
+                matcherPatterns.push_back(MultiStringMatcher::Pattern(keywordHighlight.keyword, keywordHighlight.matchCaseSensitive));
+                patterns_.push_back(Pattern{Pattern::Type::Keyword, "", keywordHighlight.action});
             }
-            return boost::regex("\\b" + escaped + "\\b", flags);
-        };
+        }
+        matcher_ = MultiStringMatcher(matcherPatterns);
+    }
 
-        auto highlightKeywordInChatMessage = [&](const ChatWindow::ChatMessage& message, const std::string& keyword, bool matchCaseSensitive, const HighlightAction& action) {
-            ChatWindow::ChatMessage resultMessage;
+    void ChatMessageParser::parseTextPart(const std::string& text, bool highlight, ChatWindow::ChatMessage& parsedMessage) {
+        std::vector<MultiStringMatcher::Match> matches = matcher_.findAll(text);
 
-            for (const auto& part : message.getParts()) {
-                std::shared_ptr<ChatWindow::ChatTextMessagePart> textPart;
-                if ((textPart = std::dynamic_pointer_cast<ChatWindow::ChatTextMessagePart>(part))) {
-                    try {
-                        boost::match_results<std::string::const_iterator> match;
-                        const std::string& text = textPart->text;
-                        std::string::const_iterator start = text.begin();
-                        while (regex_search(start, text.end(), match, keywordToRegEx(keyword, matchCaseSensitive))) {
-                            std::string::const_iterator matchStart = match[0].first;
-                            std::string::const_iterator matchEnd = match[0].second;
-                            if (start != matchStart) {
-                                /* If we're skipping over plain text since the previous emoticon, record it as plain text */
-                                resultMessage.append(std::make_shared<ChatWindow::ChatTextMessagePart>(std::string(start, matchStart)));
-                            }
-                            std::shared_ptr<ChatWindow::ChatHighlightingMessagePart> highlightPart = std::make_shared<ChatWindow::ChatHighlightingMessagePart>();
-                            highlightPart->text = match.str();
-                            highlightPart->action = action;
-                            resultMessage.append(highlightPart);
-                            start = matchEnd;
-                        }
-                        if (start != text.end()) {
-                            /* If there's plain text after the last emoticon, record it */
-                            resultMessage.append(std::make_shared<ChatWindow::ChatTextMessagePart>(std::string(start, text.end())));
-                        }
-                    }
-                    catch (const std::runtime_error&) {
-                        /* Basically too expensive to compute the regex results and it gave up, so pass through as text */
-                        resultMessage.append(part);
-                    }
-                } else {
-                    resultMessage.append(part);
-                }
+        /* Emoticons are found at the start or end of the text, beside whitespace, or right after another emoticon. */
+        std::vector<MultiStringMatcher::Match> emoticonMatches;
+        size_t start = 0;
+        for (const auto& match : matches) {
+            if (patterns_[match.pattern].type != Pattern::Type::Emoticon || match.position < start) {
+                continue;
             }
-            return resultMessage;
-        };
-
-        ChatWindow::ChatMessage parsedMessage = message;
-
-        // detect mentions of own nickname
-        HighlightAction ownMentionKeywordAction = highlightConfiguration_->ownMentionAction;
-        ownMentionKeywordAction.setSoundFilePath(boost::optional<std::string>());
-        ownMentionKeywordAction.setSystemNotificationEnabled(false);
-        if (!getNick().empty() && !highlightConfiguration_->ownMentionAction.isEmpty()) {
-            auto nicknameHighlightedMessage = highlightKeywordInChatMessage(parsedMessage, nick_, false, ownMentionKeywordAction);
-            auto highlightedParts = nicknameHighlightedMessage.getParts();
-            auto ownNicknamePart = std::find_if(highlightedParts.begin(), highlightedParts.end(), [&](std::shared_ptr<ChatWindow::ChatMessagePart>& part){
-                auto highlightPart = std::dynamic_pointer_cast<ChatWindow::ChatHighlightingMessagePart>(part);
-                if (highlightPart && highlightPart->text == nick_) {
-                    return true;
-                }
-                return false;
-            });
-            if (ownNicknamePart != highlightedParts.end()) {
-                parsedMessage.setHighlightActionOwnMention(highlightConfiguration_->ownMentionAction);
+            size_t end = match.position + match.length;
+            if (match.position == start || isWhitespace(text[match.position - 1]) || end == text.size() || isWhitespace(text[end])) {
+                emoticonMatches.push_back(match);
+                start = end;
             }
-            parsedMessage.setParts(nicknameHighlightedMessage.getParts());
         }
 
-        // detect keywords
-        for (const auto& keywordHighlight : highlightConfiguration_->keywordHighlights) {
-            if (keywordHighlight.keyword.empty() || keywordHighlight.action.isEmpty()) {
+        /* Keywords and own mentions are whole words in the text between the emoticons and earlier matches. The leftmost match wins. */
+        std::vector<MultiStringMatcher::Match> selectedMatches;
+        size_t nextEmoticon = 0;
+        start = 0;
+        for (const auto& match : matches) {
+            while (nextEmoticon < emoticonMatches.size() && emoticonMatches[nextEmoticon].position <= match.position) {
+                selectedMatches.push_back(emoticonMatches[nextEmoticon]);
+                start = emoticonMatches[nextEmoticon].position + emoticonMatches[nextEmoticon].length;
+                nextEmoticon++;
+            }
+            if (!highlight || patterns_[match.pattern].type == Pattern::Type::Emoticon || match.position < start) {
                 continue;
             }
-            auto newMessage = highlightKeywordInChatMessage(parsedMessage, keywordHighlight.keyword, keywordHighlight.matchCaseSensitive, keywordHighlight.action);
-            parsedMessage.setParts(newMessage.getParts());
+            size_t end = match.position + match.length;
+            size_t segmentEnd = nextEmoticon < emoticonMatches.size() ? emoticonMatches[nextEmoticon].position : text.size();
+            if (end <= segmentEnd && isWordBoundary(text, start, segmentEnd, match.position) && isWordBoundary(text, start, segmentEnd, end)) {
+                selectedMatches.push_back(match);
+                start = end;
+            }
         }
+        selectedMatches.insert(selectedMatches.end(), emoticonMatches.begin() + static_cast<std::ptrdiff_t>(nextEmoticon), emoticonMatches.end());
 
-        return parsedMessage;
+        start = 0;
+        for (const auto& match : selectedMatches) {
+            if (start != match.position) {
+                /* If we're skipping over plain text since the previous match, record it as plain text */
+                parsedMessage.append(std::make_shared<ChatWindow::ChatTextMessagePart>(text.substr(start, match.position - start)));
+            }
+            const Pattern& pattern = patterns_[match.pattern];
+            std::string matchText = text.substr(match.position, match.length);
+            if (pattern.type == Pattern::Type::Emoticon) {
+                std::shared_ptr<ChatWindow::ChatEmoticonMessagePart> emoticonPart = std::make_shared<ChatWindow::ChatEmoticonMessagePart>();
+                emoticonPart->imagePath = pattern.imagePath;
+                emoticonPart->alternativeText = matchText;
+                parsedMessage.append(emoticonPart);
+            }
+            else {
+                std::shared_ptr<ChatWindow::ChatHighlightingMessagePart> highlightPart = std::make_shared<ChatWindow::ChatHighlightingMessagePart>();
+                highlightPart->text = matchText;
+                highlightPart->action = pattern.action;
+                parsedMessage.append(highlightPart);
+                if (pattern.type == Pattern::Type::OwnMention && matchText == nick_) {
+                    parsedMessage.setHighlightActionOwnMention(highlightConfiguration_->ownMentionAction);
+                }
+            }
+            start = match.position + match.length;
+        }
+        if (start != text.size()) {
+            /* If there's plain text after the last match, record it */
+            parsedMessage.append(std::make_shared<ChatWindow::ChatTextMessagePart>(text.substr(start)));
+        }
     }
 
     ChatWindow::ChatMessage ChatMessageParser::fullMessageHighlight(const ChatWindow::ChatMessage& parsedMessage, const std::string& sender) {
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2017 Isode Limited.
+ * Copyright (c) 2013-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -8,6 +8,9 @@
 
 #include <memory>
 #include <string>
+#include <vector>
+
+#include <SwifTools/MultiStringMatcher.h>
 
 #include <Swift/Controllers/Highlighting/HighlightConfiguration.h>
 #include <Swift/Controllers/UIInterfaces/ChatWindow.h>
@@ -17,6 +20,9 @@ namespace Swift {
     /**
      * @brief The ChatMessageParser class takes an emoticon map, a \ref HighlightConfiguration, and a boolean that indicates if the message context is in a MUC or not.
      * The class handles parsing a message string and identifies emoticons, URLs, and various highlights.
+     *
+     * The emoticons, highlight keywords and own nick are searched for with a single matcher, which is only rebuilt when
+     * the nick or the highlight configuration changes.
      */
     class ChatMessageParser {
         public:
@@ -31,8 +37,16 @@ namespace Swift {
             ChatWindow::ChatMessage parseMessageBody(const std::string& body, const std::string& sender = "", bool senderIsSelf = false);
 
         private:
-            ChatWindow::ChatMessage emoticonHighlight(const ChatWindow::ChatMessage& parsedMessage);
-            ChatWindow::ChatMessage splitHighlight(const ChatWindow::ChatMessage& parsedMessage);
+            struct Pattern {
+                enum class Type { Emoticon, OwnMention, Keyword };
+
+                Type type;
+                std::string imagePath;
+                HighlightAction action;
+            };
+
+            void updateMatcher();
+            void parseTextPart(const std::string& text, bool highlight, ChatWindow::ChatMessage& parsedMessage);
             ChatWindow::ChatMessage fullMessageHighlight(const ChatWindow::ChatMessage& parsedMessage, const std::string& sender);
 
         private:
@@ -40,5 +54,12 @@ namespace Swift {
             std::shared_ptr<HighlightConfiguration> highlightConfiguration_;
             Mode mode_;
             std::string nick_;
+
+            std::vector<Pattern> patterns_;
+            MultiStringMatcher matcher_;
+            bool matcherValid_ = false;
+            std::string matcherNick_;
+            HighlightAction matcherOwnMentionAction_;
+            std::vector<HighlightConfiguration::KeywordHightlight> matcherKeywordHighlights_;
     };
 }
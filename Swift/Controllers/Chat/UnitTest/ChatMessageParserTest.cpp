@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2017 Isode Limited.
+ * Copyright (c) 2013-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -290,3 +290,70 @@ TEST_F(ChatMessageParserTest, testWithDefaultConfiguration) {
     ASSERT_EQ(HighlightAction(), result.getHighlightActionGroupMessage());
     ASSERT_EQ(HighlightAction(), result.getHighlightActionSender());
 }
+
+TEST_F(ChatMessageParserTest, testKeywordAndEmoticonInSameWord) {
+    auto config = highlightConfigFromKeyword("Lazy", false);
+    auto testling = ChatMessageParser(emoticons_, config);
+    auto result = testling.parseMessageBody(":)Lazy:( lazy");
+    assertEmoticon(result, 0, smile1_, smile1Path_);
+    assertHighlight(result, 1, "Lazy", config->keywordHighlights[0].action);
+    assertEmoticon(result, 2, smile2_, smile2Path_);
+    assertText(result, 3, " ");
+    assertHighlight(result, 4, "lazy", config->keywordHighlights[0].action);
+}
+
+TEST_F(ChatMessageParserTest, testOwnMentionTakesPrecedenceOverKeyword) {
+    auto config = highlightConfigFromKeyword("Juliet", false);
+    config->ownMentionAction.setFrontColor(std::string("#f0f0f0"));
+    auto ownMentionActionForPart = config->ownMentionAction;
+    auto testling = ChatMessageParser(emoticons_, config);
+    testling.setNick("Juliet");
+    auto result = testling.parseMessageBody("Juliet and juliet");
+    assertHighlight(result, 0, "Juliet", ownMentionActionForPart);
+    assertText(result, 1, " and ");
+    assertHighlight(result, 2, "juliet", ownMentionActionForPart);
+    ASSERT_EQ(config->ownMentionAction, result.getHighlightActionOwnMention());
+}
+
+TEST_F(ChatMessageParserTest, testNoHighlightInOwnMessages) {
+    auto config = highlightConfigFromKeyword("trigger", false);
+    auto testling = ChatMessageParser(emoticons_, config);
+    auto result = testling.parseMessageBody("trigger :)", "Juliet", true);
+    assertText(result, 0, "trigger ");
+    assertEmoticon(result, 1, smile1_, smile1Path_);
+}
+
+TEST_F(ChatMessageParserTest, testHighlightConfigurationChanges) {
+    DummySettingsProvider settings;
+    HighlightManager manager(&settings);
+    auto testling = ChatMessageParser(emoticons_, manager.getConfiguration());
+    auto result = testling.parseMessageBody("one two");
+    assertText(result, 0, "one two");
+
+    manager.setConfiguration(*highlightConfigFromKeyword("two", false));
+    result = testling.parseMessageBody("one two");
+    assertText(result, 0, "one ");
+    assertHighlight(result, 1, "two", manager.getConfiguration()->keywordHighlights[0].action);
+
+    auto config = *manager.getConfiguration();
+    config.keywordHighlights[0].keyword = "one";
+    manager.setConfiguration(config);
+    result = testling.parseMessageBody("one two");
+    assertHighlight(result, 0, "one", manager.getConfiguration()->keywordHighlights[0].action);
+    assertText(result, 1, " two");
+}
+
+TEST_F(ChatMessageParserTest, testNickChanges) {
+    auto config = std::make_shared<HighlightConfiguration>();
+    config->ownMentionAction.setFrontColor(std::string("#f0f0f0"));
+    auto testling = ChatMessageParser(emoticons_, config);
+    testling.setNick("Juliet");
+    auto result = testling.parseMessageBody("Romeo, Juliet");
+    assertText(result, 0, "Romeo, ");
+    assertHighlight(result, 1, "Juliet", config->ownMentionAction);
+
+    testling.setNick("Romeo");
+    result = testling.parseMessageBody("Romeo, Juliet");
+    assertHighlight(result, 0, "Romeo", config->ownMentionAction);
+    assertText(result, 1, ", Juliet");
+}
@@ -5,7 +5,7 @@
  */
 
 /*
- * Copyright (c) 2013-2016 Isode Limited.
+ * Copyright (c) 2013-2018 Isode Limited.
  * Licensed under the GNU General Public License.
  * See the COPYING file for more information.
  */
@@ -131,15 +131,7 @@ void HistoryViewController::handleSelectedContactChanged(RosterItem* newContact)
 }
 
 void HistoryViewController::handleNewMessage(const HistoryMessage& message) {
-    JID contactJID = message.getFromJID().toBare() == selfJID_ ? message.getToJID() : message.getFromJID();
-
-    JID displayJID;
-    if (message.getType() == HistoryMessage::PrivateMessage) {
-        displayJID = contactJID;
-    }
-    else {
-        displayJID = contactJID.toBare();
-    }
+    JID displayJID = getDisplayJID(message);
 
     // check current conversation
     if (selectedItem_ && selectedItem_->getJID() == displayJID) {
@@ -169,31 +161,43 @@ void HistoryViewController::addNewMessage(const HistoryMessage& message, bool ad
     historyWindow_->addMessage(message.getMessage(), nick, senderIsSelf, avatarPath, message.getTime(), addAtTheTop);
 }
 
+JID HistoryViewController::getDisplayJID(const HistoryMessage& message) const {
+    JID contactJID = message.getFromJID().toBare() == selfJID_ ? message.getToJID() : message.getFromJID();
+    if (message.getType() == HistoryMessage::PrivateMessage) {
+        return contactJID;
+    }
+    return contactJID.toBare();
+}
+
 void HistoryViewController::handleReturnPressed(const std::string& keyword) {
     reset();
 
+    // getContacts() returns each matching contact with the dates of all its
+    // matches, so the list is complete without loading the messages
     for (int it = HistoryMessage::Chat; it <= HistoryMessage::PrivateMessage; it++) {
         HistoryMessage::Type type = static_cast<HistoryMessage::Type>(it);
-
         contacts_[type] = historyController_->getContacts(selfJID_, type, keyword);
 
         for (ContactsMap::const_iterator contact = contacts_[type].begin(); contact != contacts_[type].end(); contact++) {
-            const JID& jid = contact->first;
-            std::string nick;
-            if (type == HistoryMessage::PrivateMessage) {
-                nick = jid.toString();
-            }
-            else {
-                nick = nickResolver_->jidToNick(jid);
-            }
-            roster_->addContact(jid, jid, nick, category[type], avatarManager_->getAvatarPath(jid));
+            addContact(contact->first, type);
+        }
+    }
+}
 
-            Presence::ref presence = getPresence(jid, type == HistoryMessage::Groupchat);
+void HistoryViewController::addContact(const JID& jid, HistoryMessage::Type type) {
+    std::string nick;
+    if (type == HistoryMessage::PrivateMessage) {
+        nick = jid.toString();
+    }
+    else {
+        nick = nickResolver_->jidToNick(jid);
+    }
+    roster_->addContact(jid, jid, nick, category[type], avatarManager_->getAvatarPath(jid));
 
-            if (presence.get()) {
-                roster_->applyOnItem(SetPresence(presence, JID::WithoutResource), jid);
-            }
-        }
+    Presence::ref presence = getPresence(jid, type == HistoryMessage::Groupchat);
+
+    if (presence.get()) {
+        roster_->applyOnItem(SetPresence(presence, JID::WithoutResource), jid);
     }
 }
 
@@ -5,7 +5,7 @@
  */
 
 /*
- * Copyright (c) 2016 Isode Limited.
+ * Copyright (c) 2016-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -53,6 +53,8 @@ namespace Swift {
             void handleAvatarChanged(const JID& jid);
 
             void addNewMessage(const HistoryMessage& message, bool addAtTheTop);
+            void addContact(const JID& jid, HistoryMessage::Type type);
+            JID getDisplayJID(const HistoryMessage& message) const;
             void reset();
             Presence::ref getPresence(const JID& jid, bool isMUC);
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2017 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -72,6 +72,29 @@ void GroupRosterItem::addChild(RosterItem* item) {
     onDataChanged();
 }
 
+/**
+ * Adds all the items at once, showing the given subset of them, and emits
+ * the changed signals only once.
+ */
+void GroupRosterItem::addChildren(const std::vector<RosterItem*>& items, const std::vector<RosterItem*>& displayedItems) {
+    children_.reserve(children_.size() + items.size());
+    for (auto* item : items) {
+        children_.push_back(item);
+        GroupRosterItem* group = dynamic_cast<GroupRosterItem*>(item);
+        if (group) {
+            group->onChildrenChanged.connect(boost::bind(&GroupRosterItem::handleChildrenChanged, this, group));
+        } else {
+            item->onDataChanged.connect(boost::bind(&GroupRosterItem::handleDataChanged, this, item));
+        }
+    }
+    if (!displayedItems.empty()) {
+        displayedChildren_.insert(displayedChildren_.end(), displayedItems.begin(), displayedItems.end());
+        sortDisplayed();
+    }
+    onChildrenChanged();
+    onDataChanged();
+}
+
 /**
  * Does not emit a changed signal.
  */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -23,6 +23,7 @@ class GroupRosterItem : public RosterItem {
         const std::vector<RosterItem*>& getDisplayedChildren() const;
 
         void addChild(RosterItem* item);
+        void addChildren(const std::vector<RosterItem*>& items, const std::vector<RosterItem*>& displayedItems);
         std::unique_ptr<ContactRosterItem> removeChild(const JID& jid);
         std::unique_ptr<GroupRosterItem> removeGroupChild(const std::string& group);
         void removeAll();
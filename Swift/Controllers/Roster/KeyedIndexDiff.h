@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace Swift {
+    /**
+     * Computes the difference between two sequences in the same form as
+     * computeIndexDiff(), but matches elements by a key instead of comparing
+     * every element of one sequence with every element of the other.
+     *
+     * KeyFunction returns the key of an element, which needs to be hashable
+     * with std::hash. Of the elements that occur in both sequences, the
+     * longest run that kept its relative order is reported as unchanged (or
+     * updated, if UpdatePredicate holds), and the others as removed and
+     * inserted. This takes linear time if no elements moved, and O(n log n)
+     * time in the worst case. If a key occurs more than once, the occurrences
+     * are matched in order.
+     */
+    template<typename X, typename KeyFunction, typename UpdatePredicate>
+    void computeKeyedIndexDiff(const std::vector<X>& x, const std::vector<X>& y, std::vector<size_t>& updates, std::vector<size_t>& postUpdates, std::vector<size_t>& removes, std::vector<size_t>& inserts) {
+        typedef typename std::decay<decltype(KeyFunction()(x.front()))>::type Key;
+        const size_t none = static_cast<size_t>(-1);
+        KeyFunction key;
+        UpdatePredicate updatePredicate;
+
+        // Skip the common prefix & suffix, which is all there is if only the
+        // data of elements changed
+        size_t prefixLength = 0;
+        while (prefixLength < x.size() && prefixLength < y.size() && key(x[prefixLength]) == key(y[prefixLength])) {
+            ++prefixLength;
+        }
+        size_t suffixLength = 0;
+        while (prefixLength + suffixLength < x.size() && prefixLength + suffixLength < y.size() && key(x[x.size() - suffixLength - 1]) == key(y[y.size() - suffixLength - 1])) {
+            ++suffixLength;
+        }
+        size_t xLength = x.size() - prefixLength - suffixLength;
+        size_t yLength = y.size() - prefixLength - suffixLength;
+
+        // Match the remaining elements by key. For each key, the map holds the
+        // first unmatched position in x, and nextWithSameKey chains the other
+        // positions with that key.
+        std::vector<size_t> matches(yLength, none);
+        if (xLength > 0 && yLength > 0) {
+            std::unordered_map<Key, size_t> unmatched(xLength);
+            std::vector<size_t> nextWithSameKey(xLength, none);
+            for (size_t i = xLength; i-- > 0;) {
+                auto result = unmatched.insert(std::make_pair(key(x[prefixLength + i]), i));
+                if (!result.second) {
+                    nextWithSameKey[i] = result.first->second;
+                    result.first->second = i;
+                }
+            }
+            for (size_t j = 0; j < yLength; ++j) {
+                auto match = unmatched.find(key(y[prefixLength + j]));
+                if (match != unmatched.end() && match->second != none) {
+                    matches[j] = match->second;
+                    match->second = nextWithSameKey[match->second];
+                }
+            }
+        }
+
+        // Find the longest increasing subsequence of matched x positions.
+        // tails[k] is the element of y ending the best subsequence of length
+        // k + 1 found so far.
+        std::vector<size_t> tails;
+        std::vector<size_t> predecessors(yLength, none);
+        for (size_t j = 0; j < yLength; ++j) {
+            if (matches[j] == none) {
+                continue;
+            }
+            if (tails.empty() || matches[tails.back()] < matches[j]) {
+                predecessors[j] = tails.empty() ? none : tails.back();
+                tails.push_back(j);
+            }
+            else {
+                auto tail = std::lower_bound(tails.begin(), tails.end(), matches[j], [&matches](size_t t, size_t position) {
+                    return matches[t] < position;
+                });
+                predecessors[j] = tail == tails.begin() ? none : *(tail - 1);
+                *tail = j;
+            }
+        }
+        std::vector<bool> yKept(yLength, false);
+        std::vector<bool> xKept(xLength, false);
+        for (size_t j = tails.empty() ? none : tails.back(); j != none; j = predecessors[j]) {
+            yKept[j] = true;
+            xKept[matches[j]] = true;
+        }
+
+        // Report the changes
+        for (size_t i = 0; i < prefixLength; ++i) {
+            if (updatePredicate(x[i], y[i])) {
+                updates.push_back(i);
+                postUpdates.push_back(i);
+            }
+        }
+        for (size_t j = 0; j < yLength; ++j) {
+            if (!yKept[j]) {
+                inserts.push_back(prefixLength + j);
+            }
+            else if (updatePredicate(x[prefixLength + matches[j]], y[prefixLength + j])) {
+                updates.push_back(prefixLength + matches[j]);
+                postUpdates.push_back(prefixLength + j);
+            }
+        }
+        for (size_t i = 0; i < xLength; ++i) {
+            if (!xKept[i]) {
+                removes.push_back(prefixLength + i);
+            }
+        }
+        for (size_t k = suffixLength; k > 0; --k) {
+            if (updatePredicate(x[x.size() - k], y[y.size() - k])) {
+                updates.push_back(x.size() - k);
+                postUpdates.push_back(y.size() - k);
+            }
+        }
+    }
+}
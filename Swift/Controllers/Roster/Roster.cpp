@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -8,6 +8,7 @@
 
 #include <algorithm>
 #include <deque>
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
@@ -108,26 +109,56 @@ void Roster::handleChildrenChanged(GroupRosterItem* item) {
 }
 
 void Roster::addContact(const JID& jid, const JID& displayJID, const std::string& name, const std::string& groupName, const boost::filesystem::path& avatarPath) {
-    GroupRosterItem* group(getGroup(groupName));
-    ContactRosterItem *item = new ContactRosterItem(jid, displayJID, name, group);
-    item->onVCardRequested.connect(boost::bind(boost::ref(onVCardUpdateRequested), jid));
-    item->setAvatarPath(avatarPath);
-    if (blockingSupported_) {
-        item->setBlockState(ContactRosterItem::IsUnblocked);
-    }
-    group->addChild(item);
-    ItemMap::iterator i = itemMap_.insert(std::make_pair(fullJIDMapping_ ? jid : jid.toBare(), std::vector<ContactRosterItem*>())).first;
-    if (!i->second.empty()) {
-        for (const auto& existingGroup : i->second[0]->getGroups()) {
-            item->addGroup(existingGroup);
+    addContacts(std::vector<ContactEntry>(1, ContactEntry{jid, displayJID, name, groupName, avatarPath}));
+}
+
+struct GroupAdditions {
+    GroupAdditions() : group(nullptr) {}
+    GroupRosterItem* group;
+    std::vector<RosterItem*> items;
+    std::vector<RosterItem*> displayedItems;
+};
+
+void Roster::addContacts(const std::vector<ContactEntry>& contacts) {
+    // Collect the new items per group first, so each group only sorts and signals once
+    std::map<std::string, GroupAdditions> additions;
+    for (const auto& contact : contacts) {
+        GroupAdditions& groupAdditions = additions[contact.group];
+        if (!groupAdditions.group) {
+            groupAdditions.group = getGroup(contact.group);
+        }
+        ContactRosterItem *item = new ContactRosterItem(contact.jid, contact.displayJID, contact.name, groupAdditions.group);
+        item->onVCardRequested.connect(boost::bind(boost::ref(onVCardUpdateRequested), contact.jid));
+        item->setAvatarPath(contact.avatarPath);
+        if (blockingSupported_) {
+            item->setBlockState(ContactRosterItem::IsUnblocked);
+        }
+        groupAdditions.items.push_back(item);
+        if (isDisplayed(item)) {
+            groupAdditions.displayedItems.push_back(item);
+        }
+        ItemMap::iterator i = itemMap_.insert(std::make_pair(fullJIDMapping_ ? contact.jid : contact.jid.toBare(), std::vector<ContactRosterItem*>())).first;
+        if (!i->second.empty()) {
+            for (const auto& existingGroup : i->second[0]->getGroups()) {
+                item->addGroup(existingGroup);
+            }
+        }
+        i->second.push_back(item);
+        for (auto* sameJIDItem : i->second) {
+            sameJIDItem->addGroup(contact.group);
         }
     }
-    i->second.push_back(item);
-    item->onDataChanged.connect(boost::bind(&Roster::handleDataChanged, this, item));
-    filterContact(item, group);
 
-    for (auto* item : i->second) {
-        item->addGroup(groupName);
+    for (const auto& groupAdditions : additions) {
+        GroupRosterItem* group = groupAdditions.second.group;
+        size_t oldDisplayedSize = group->getDisplayedChildren().size();
+        group->addChildren(groupAdditions.second.items, groupAdditions.second.displayedItems);
+        for (auto* item : groupAdditions.second.items) {
+            item->onDataChanged.connect(boost::bind(&Roster::handleDataChanged, this, item));
+        }
+        if (oldDisplayedSize == 0 && group->getDisplayedChildren().size() > 0) {
+            onGroupAdded(group);
+        }
     }
 }
 
@@ -228,13 +259,17 @@ void Roster::removeFilter(RosterFilter* filter) {
     onFilterRemoved(filter);
 }
 
-void Roster::filterContact(ContactRosterItem* contact, GroupRosterItem* group) {
-    size_t oldDisplayedSize = group->getDisplayedChildren().size();
+bool Roster::isDisplayed(ContactRosterItem* contact) const {
     bool hide = true;
     for (auto* filter : filters_) {
         hide &= (*filter)(contact);
     }
-    group->setDisplayed(contact, filters_.empty() || !hide);
+    return filters_.empty() || !hide;
+}
+
+void Roster::filterContact(ContactRosterItem* contact, GroupRosterItem* group) {
+    size_t oldDisplayedSize = group->getDisplayedChildren().size();
+    group->setDisplayed(contact, isDisplayed(contact));
     size_t newDisplayedSize = group->getDisplayedChildren().size();
     if (oldDisplayedSize == 0 && newDisplayedSize > 0) {
         onGroupAdded(group);
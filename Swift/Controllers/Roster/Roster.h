@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -27,11 +27,21 @@ class GroupRosterItem;
 class ContactRosterItem;
 
 class Roster {
+    public:
+        struct ContactEntry {
+            JID jid;
+            JID displayJID;
+            std::string name;
+            std::string group;
+            boost::filesystem::path avatarPath;
+        };
+
     public:
         Roster(bool sortByStatus = true, bool fullJIDMapping = false);
         ~Roster();
 
         void addContact(const JID& jid, const JID& displayJID, const std::string& name, const std::string& group, const boost::filesystem::path& avatarPath);
+        void addContacts(const std::vector<ContactEntry>& contacts);
         void removeContact(const JID& jid);
         void removeContactFromGroup(const JID& jid, const std::string& group);
         void removeGroup(const std::string& group);
@@ -58,6 +68,7 @@ class Roster {
         void handleDataChanged(RosterItem* item);
         void handleChildrenChanged(GroupRosterItem* item);
         void filterGroup(GroupRosterItem* item);
+        bool isDisplayed(ContactRosterItem* contact) const;
         void filterContact(ContactRosterItem* contact, GroupRosterItem* group);
         void filterAll();
 
@@ -76,7 +76,7 @@ RosterController::RosterController(const JID& jid, XMPPRoster* xmppRoster, Avata
 
     changeStatusConnection_ = mainWindow_->onChangeStatusRequest.connect(boost::bind(&RosterController::handleChangeStatusRequest, this, _1, _2));
     signOutConnection_ = mainWindow_->onSignOutRequest.connect(boost::bind(boost::ref(onSignOutRequest)));
-    xmppRoster_->onJIDAdded.connect(boost::bind(&RosterController::handleOnJIDAdded, this, _1));
+    xmppRoster_->onJIDsAdded.connect(boost::bind(&RosterController::handleOnJIDsAdded, this, _1));
     xmppRoster_->onJIDUpdated.connect(boost::bind(&RosterController::handleOnJIDUpdated, this, _1, _2, _3));
     xmppRoster_->onJIDRemoved.connect(boost::bind(&RosterController::handleOnJIDRemoved, this, _1));
     xmppRoster_->onRosterCleared.connect(boost::bind(&RosterController::handleRosterCleared, this));
@@ -140,23 +140,36 @@ void RosterController::handleChangeStatusRequest(StatusShow::Type show, const st
     onChangeStatusRequest(show, statusText);
 }
 
-void RosterController::handleOnJIDAdded(const JID& jid) {
-    std::vector<std::string> groups = xmppRoster_->getGroupsForJID(jid);
-    std::string name = nickResolver_->jidToNick(jid);
-    if (!groups.empty()) {
-        for (const auto& group : groups) {
-            roster_->addContact(jid, jid, name, group, avatarManager_->getAvatarPath(jid));
+void RosterController::handleOnJIDsAdded(const std::vector<JID>& jids) {
+    std::vector<Roster::ContactEntry> contacts;
+    contacts.reserve(jids.size());
+    std::vector<std::string> names;
+    names.reserve(jids.size());
+    for (const auto& jid : jids) {
+        std::vector<std::string> groups = xmppRoster_->getGroupsForJID(jid);
+        std::string name = nickResolver_->jidToNick(jid);
+        boost::filesystem::path avatarPath = avatarManager_->getAvatarPath(jid);
+        if (!groups.empty()) {
+            for (const auto& group : groups) {
+                contacts.push_back(Roster::ContactEntry{jid, jid, name, group, avatarPath});
+            }
         }
+        else {
+            contacts.push_back(Roster::ContactEntry{jid, jid, name, QT_TRANSLATE_NOOP("", "Contacts"), avatarPath});
+        }
+        names.push_back(name);
     }
-    else {
-        roster_->addContact(jid, jid, name, QT_TRANSLATE_NOOP("", "Contacts"), avatarManager_->getAvatarPath(jid));
-    }
-    applyAllPresenceTo(jid);
+    roster_->addContacts(contacts);
 
-    chattables_.addJID(jid, Chattables::State::Type::Person);
-    auto state = chattables_.getState(jid);
-    state.name = name;
-    chattables_.setState(jid, state);
+    for (size_t i = 0; i < jids.size(); ++i) {
+        const JID& jid = jids[i];
+        applyAllPresenceTo(jid);
+
+        chattables_.addJID(jid, Chattables::State::Type::Person);
+        auto state = chattables_.getState(jid);
+        state.name = names[i];
+        chattables_.setState(jid, state);
+    }
 }
 
 void RosterController::applyAllPresenceTo(const JID& jid) {
@@ -71,7 +71,7 @@ namespace Swift {
             void initBlockingCommand();
 
         private:
-            void handleOnJIDAdded(const JID &jid);
+            void handleOnJIDsAdded(const std::vector<JID>& jids);
             void handleRosterCleared();
             void handleOnJIDRemoved(const JID &jid);
             void handleOnJIDUpdated(const JID &jid, const std::string& oldName, const std::vector<std::string>& oldGroups);
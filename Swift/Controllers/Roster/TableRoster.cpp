@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2011-2016 Isode Limited.
+ * Copyright (c) 2011-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -16,13 +16,13 @@
 #include <Swiften/Network/TimerFactory.h>
 
 #include <Swift/Controllers/Roster/GroupRosterItem.h>
-#include <Swift/Controllers/Roster/LeastCommonSubsequence.h>
+#include <Swift/Controllers/Roster/KeyedIndexDiff.h>
 #include <Swift/Controllers/Roster/Roster.h>
 
 namespace Swift {
-    struct SectionNameEquals {
-        bool operator()(const TableRoster::Section& s1, const TableRoster::Section& s2) const {
-            return s1.name == s2.name;
+    struct SectionName {
+        const std::string& operator()(const TableRoster::Section& s) const {
+            return s.name;
         }
     };
 
@@ -33,9 +33,9 @@ namespace Swift {
         }
     };
 
-    struct ItemEquals {
-            bool operator()(const TableRoster::Item& i1, const TableRoster::Item& i2) const {
-                return i1.jid == i2.jid;
+    struct ItemJID {
+            const JID& operator()(const TableRoster::Item& i) const {
+                return i.jid;
             }
     };
 
@@ -122,7 +122,7 @@ void TableRoster::handleUpdateTimerTick() {
     Update update;
     std::vector<size_t> sectionUpdates;
     std::vector<size_t> sectionPostUpdates;
-    computeIndexDiff<Section,SectionNameEquals,True<Section> >(sections, newSections, sectionUpdates, sectionPostUpdates, update.deletedSections, update.insertedSections);
+    computeKeyedIndexDiff<Section, SectionName, True<Section> >(sections, newSections, sectionUpdates, sectionPostUpdates, update.deletedSections, update.insertedSections);
     assert(sectionUpdates.size() == sectionPostUpdates.size());
     for (size_t i = 0; i < sectionUpdates.size(); ++i) {
         assert(sectionUpdates[i] < sections.size());
@@ -131,7 +131,7 @@ void TableRoster::handleUpdateTimerTick() {
         std::vector<size_t> itemPostUpdates;
         std::vector<size_t> itemRemoves;
         std::vector<size_t> itemInserts;
-        computeIndexDiff<Item, ItemEquals, ItemNeedsUpdate >(sections[sectionUpdates[i]].items, newSections[sectionPostUpdates[i]].items, itemUpdates, itemPostUpdates, itemRemoves, itemInserts);
+        computeKeyedIndexDiff<Item, ItemJID, ItemNeedsUpdate >(sections[sectionUpdates[i]].items, newSections[sectionPostUpdates[i]].items, itemUpdates, itemPostUpdates, itemRemoves, itemInserts);
         size_t end = update.insertedRows.size();
         update.insertedRows.resize(update.insertedRows.size() + itemInserts.size());
         std::transform(itemInserts.begin(), itemInserts.end(), update.insertedRows.begin() + boost::numeric_cast<long long>(end), CreateIndexForSection(sectionPostUpdates[i]));
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2011-2016 Isode Limited.
+ * Copyright (c) 2011-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -68,7 +68,7 @@ namespace Swift {
             void scheduleUpdate();
 
         private:
-            friend struct SectionNameEquals;
+            friend struct SectionName;
             struct Section {
                 Section(const std::string& name) : name(name) {
                 }
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <QA/Checker/IO.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+
+#include <Swift/Controllers/Roster/KeyedIndexDiff.h>
+#include <Swift/Controllers/Roster/LeastCommonSubsequence.h>
+
+using namespace Swift;
+
+namespace {
+    struct Identity {
+        template<typename T>
+        const T& operator()(const T& t) const {
+            return t;
+        }
+    };
+
+    struct Never {
+        template<typename T>
+        bool operator()(const T&, const T&) const {
+            return false;
+        }
+    };
+
+    struct IsBOrC {
+        bool operator()(char c, char c2) const {
+            CPPUNIT_ASSERT_EQUAL(c, c2);
+            return c == 'b' || c == 'c';
+        }
+    };
+
+    struct IsArizonaOrNewJersey {
+        bool operator()(const std::string& s, const std::string& s2) const {
+            CPPUNIT_ASSERT_EQUAL(s, s2);
+            return s == "Arizona" || s == "New Jersey";
+        }
+    };
+}
+
+class KeyedIndexDiffTest : public CppUnit::TestFixture {
+        CPPUNIT_TEST_SUITE(KeyedIndexDiffTest);
+        CPPUNIT_TEST(testComputeKeyedIndexDiff_1);
+        CPPUNIT_TEST(testComputeKeyedIndexDiff_Sequence1Empty);
+        CPPUNIT_TEST(testComputeKeyedIndexDiff_Sequence2Empty);
+        CPPUNIT_TEST(testComputeKeyedIndexDiff_BothSequencesEmpty);
+        CPPUNIT_TEST(testComputeKeyedIndexDiff_NoCommonSequence);
+        CPPUNIT_TEST(testComputeKeyedIndexDiff_SameSequences);
+        CPPUNIT_TEST(testComputeKeyedIndexDiff_MovedElement);
+        CPPUNIT_TEST(testComputeKeyedIndexDiff_DuplicateKeys);
+        CPPUNIT_TEST(testComputeKeyedIndexDiff_SameSizeAsLeastCommonSubsequenceDiff);
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+        void testComputeKeyedIndexDiff_1() {
+            std::vector<std::string> x = {"Arizona", "California", "Delaware", "New Jersey", "Washington"};
+            std::vector<std::string> y = {"Alaska", "Arizona", "California", "Georgia", "New Jersey", "Virginia"};
+
+            computeKeyedIndexDiff<std::string, Identity, IsArizonaOrNewJersey>(x, y, updates, postUpdates, removes, inserts);
+
+            CPPUNIT_ASSERT_EQUAL(std::vector<size_t>({0, 3}), updates);
+            CPPUNIT_ASSERT_EQUAL(std::vector<size_t>({1, 4}), postUpdates);
+            CPPUNIT_ASSERT_EQUAL(std::vector<size_t>({2, 4}), removes);
+            CPPUNIT_ASSERT_EQUAL(std::vector<size_t>({0, 3, 5}), inserts);
+        }
+
+        void testComputeKeyedIndexDiff_Sequence1Empty() {
+            std::vector<char> x;
+            std::vector<char> y = {'a', 'b', 'c'};
+
+            computeKeyedIndexDiff<char, Identity, IsBOrC>(x, y, updates, postUpdates, removes, inserts);
+
+            CPPUNIT_ASSERT(updates.empty());
+            CPPUNIT_ASSERT(postUpdates.empty());
+            CPPUNIT_ASSERT(removes.empty());
+            CPPUNIT_ASSERT_EQUAL(std::vector<size_t>({0, 1, 2}), inserts);
+        }
+
+        void testComputeKeyedIndexDiff_Sequence2Empty() {
+            std::vector<char> x = {'a', 'b', 'c'};
+            std::vector<char> y;
+
+            computeKeyedIndexDiff<char, Identity, IsBOrC>(x, y, updates, postUpdates, removes, inserts);
+
+            CPPUNIT_ASSERT(updates.empty());
+            CPPUNIT_ASSERT(postUpdates.empty());
+            CPPUNIT_ASSERT_EQUAL(std::vector<size_t>({0, 1, 2}), removes);
+            CPPUNIT_ASSERT(inserts.empty());
+        }
+
+        void testComputeKeyedIndexDiff_BothSequencesEmpty() {
+            std::vector<char> x;
+            std::vector<char> y;
+
+            computeKeyedIndexDiff<char, Identity, IsBOrC>(x, y, updates, postUpdates, removes, inserts);
+
+            CPPUNIT_ASSERT(updates.empty());
+            CPPUNIT_ASSERT(postUpdates.empty());
+            CPPUNIT_ASSERT(removes.empty());
+            CPPUNIT_ASSERT(inserts.empty());
+        }
+
+        void testComputeKeyedIndexDiff_NoCommonSequence() {
+            std::vector<char> x = {'a', 'b', 'c'};
+            std::vector<char> y = {'d', 'e', 'f', 'g'};
+
+            computeKeyedIndexDiff<char, Identity, IsBOrC>(x, y, updates, postUpdates, removes, inserts);
+
+            CPPUNIT_ASSERT(updates.empty());
+            CPPUNIT_ASSERT(postUpdates.empty());
+            CPPUNIT_ASSERT_EQUAL(std::vector<size_t>({0, 1, 2}), removes);
+            CPPUNIT_ASSERT_EQUAL(std::vector<size_t>({0, 1, 2, 3}), inserts);
+        }
+
+        void testComputeKeyedIndexDiff_SameSequences() {
+            std::vector<char> x = {'a', 'b', 'c', 'd'};
+            std::vector<char> y = {'a', 'b', 'c', 'd'};
+
+            computeKeyedIndexDiff<char, Identity, IsBOrC>(x, y, updates, postUpdates, removes, inserts);
+
+            CPPUNIT_ASSERT_EQUAL(std::vector<size_t>({1, 2}), updates);
+            CPPUNIT_ASSERT_EQUAL(std::vector<size_t>({1, 2}), postUpdates);
+            CPPUNIT_ASSERT(removes.empty());
+            CPPUNIT_ASSERT(inserts.empty());
+        }
+
+        void testComputeKeyedIndexDiff_MovedElement() {
+            std::vector<char> x = {'a', 'b', 'c', 'd', 'e'};
+            std::vector<char> y = {'a', 'd', 'b', 'c', 'e'};
+
+            computeKeyedIndexDiff<char, Identity, IsBOrC>(x, y, updates, postUpdates, removes, inserts);
+
+            CPPUNIT_ASSERT_EQUAL(std::vector<size_t>({1, 2}), updates);
+            CPPUNIT_ASSERT_EQUAL(std::vector<size_t>({2, 3}), postUpdates);
+            CPPUNIT_ASSERT_EQUAL(std::vector<size_t>({3}), removes);
+            CPPUNIT_ASSERT_EQUAL(std::vector<size_t>({1}), inserts);
+        }
+
+        void testComputeKeyedIndexDiff_DuplicateKeys() {
+            std::vector<char> x = {'x', 'a', 'b', 'a', 'x'};
+            std::vector<char> y = {'y', 'a', 'a', 'b', 'y'};
+
+            computeKeyedIndexDiff<char, Identity, Never>(x, y, updates, postUpdates, removes, inserts);
+
+            CPPUNIT_ASSERT(updates.empty());
+            CPPUNIT_ASSERT_EQUAL(std::vector<size_t>({0, 3, 4}), removes);
+            CPPUNIT_ASSERT_EQUAL(std::vector<size_t>({0, 2, 4}), inserts);
+        }
+
+        void testComputeKeyedIndexDiff_SameSizeAsLeastCommonSubsequenceDiff() {
+            // Shuffle, drop and add elements pseudo-randomly, and check that
+            // the diff is as small as the one based on the full LCS matrix.
+            unsigned int seed = 42;
+            for (int round = 0; round < 20; ++round) {
+                std::vector<int> x;
+                std::vector<int> y;
+                for (int i = 0; i < 100; ++i) {
+                    seed = seed * 1103515245 + 12345;
+                    switch ((seed >> 16) % 4) {
+                        case 0: x.push_back(i); break;
+                        case 1: y.push_back(i); break;
+                        default: x.push_back(i); y.push_back(i); break;
+                    }
+                }
+                for (size_t i = 0; i < y.size(); ++i) {
+                    seed = seed * 1103515245 + 12345;
+                    if ((seed >> 16) % 8 == 0) {
+                        std::swap(y[i], y[(seed >> 8) % y.size()]);
+                    }
+                }
+
+                std::vector<size_t> lcsUpdates;
+                std::vector<size_t> lcsPostUpdates;
+                std::vector<size_t> lcsRemoves;
+                std::vector<size_t> lcsInserts;
+                computeIndexDiff<int, std::equal_to<int>, Never>(x, y, lcsUpdates, lcsPostUpdates, lcsRemoves, lcsInserts);
+                removes.clear();
+                inserts.clear();
+                computeKeyedIndexDiff<int, Identity, Never>(x, y, updates, postUpdates, removes, inserts);
+
+                CPPUNIT_ASSERT_EQUAL(lcsRemoves.size(), removes.size());
+                CPPUNIT_ASSERT_EQUAL(lcsInserts.size(), inserts.size());
+            }
+        }
+
+    private:
+        std::vector<size_t> updates;
+        std::vector<size_t> postUpdates;
+        std::vector<size_t> removes;
+        std::vector<size_t> inserts;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(KeyedIndexDiffTest);
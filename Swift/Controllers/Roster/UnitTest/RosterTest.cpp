@@ -1,10 +1,11 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <memory>
+#include <vector>
 
 #include <cppunit/extensions/HelperMacros.h>
 #include <cppunit/extensions/TestFactoryRegistry.h>
@@ -18,6 +19,7 @@ using namespace Swift;
 class RosterTest : public CppUnit::TestFixture {
         CPPUNIT_TEST_SUITE(RosterTest);
         CPPUNIT_TEST(testGetGroup);
+        CPPUNIT_TEST(testAddContacts);
         CPPUNIT_TEST(testRemoveContact);
         CPPUNIT_TEST(testRemoveSecondContact);
         CPPUNIT_TEST(testRemoveSecondContactSameBare);
@@ -47,6 +49,35 @@ class RosterTest : public CppUnit::TestFixture {
 
         }
 
+        void testAddContacts() {
+            std::vector<GroupRosterItem*> addedGroups;
+            roster_->onGroupAdded.connect([&](GroupRosterItem* group) { addedGroups.push_back(group); });
+            std::vector<Roster::ContactEntry> contacts;
+            contacts.push_back(Roster::ContactEntry{jid3_, jid3_, "Cookie", "group1", ""});
+            contacts.push_back(Roster::ContactEntry{jid2_, jid2_, "Ernie", "group2", ""});
+            contacts.push_back(Roster::ContactEntry{jid1_, jid1_, "Bert", "group1", ""});
+            contacts.push_back(Roster::ContactEntry{jid1_, jid1_, "Bert", "group2", ""});
+
+            roster_->addContacts(contacts);
+
+            CPPUNIT_ASSERT_EQUAL(2, static_cast<int>(roster_->getRoot()->getChildren().size()));
+            GroupRosterItem* group1 = static_cast<GroupRosterItem*>(roster_->getRoot()->getChildren()[0]);
+            GroupRosterItem* group2 = static_cast<GroupRosterItem*>(roster_->getRoot()->getChildren()[1]);
+            CPPUNIT_ASSERT_EQUAL(std::string("group1"), group1->getDisplayName());
+            CPPUNIT_ASSERT_EQUAL(std::string("group2"), group2->getDisplayName());
+            CPPUNIT_ASSERT_EQUAL(2, static_cast<int>(group1->getDisplayedChildren().size()));
+            CPPUNIT_ASSERT_EQUAL(std::string("Bert"), group1->getDisplayedChildren()[0]->getDisplayName());
+            CPPUNIT_ASSERT_EQUAL(std::string("Cookie"), group1->getDisplayedChildren()[1]->getDisplayName());
+            CPPUNIT_ASSERT_EQUAL(std::string("Bert"), group2->getDisplayedChildren()[0]->getDisplayName());
+            CPPUNIT_ASSERT_EQUAL(std::string("Ernie"), group2->getDisplayedChildren()[1]->getDisplayName());
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), addedGroups.size());
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), static_cast<ContactRosterItem*>(group1->getChildren()[1])->getGroups().size());
+
+            roster_->removeContact(jid1_);
+            CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(group1->getChildren().size()));
+            CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(group2->getChildren().size()));
+        }
+
         void testRemoveContact() {
             roster_->addContact(jid1_, jid1_, "Bert", "group1", "");
             CPPUNIT_ASSERT_EQUAL(std::string("Bert"), static_cast<GroupRosterItem*>(roster_->getRoot()->getChildren()[0])->getChildren()[0]->getDisplayName());
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <Swift/Controllers/Roster/KeyedIndexDiff.h>
+#include <Swift/Controllers/Roster/LeastCommonSubsequence.h>
+#include <Swift/Controllers/Roster/TableRoster.h>
+
+using namespace Swift;
+
+namespace {
+    // The same comparisons as TableRoster uses for the rows of a section
+    struct ItemJID {
+        const JID& operator()(const TableRoster::Item& i) const {
+            return i.jid;
+        }
+    };
+
+    struct ItemEquals {
+        bool operator()(const TableRoster::Item& i1, const TableRoster::Item& i2) const {
+            return i1.jid == i2.jid;
+        }
+    };
+
+    struct ItemNeedsUpdate {
+        bool operator()(const TableRoster::Item& i1, const TableRoster::Item& i2) const {
+            return i1.status != i2.status || i1.description != i2.description || i1.name != i2.name || i1.avatarPath.empty() != i2.avatarPath.empty();
+        }
+    };
+
+    typedef std::vector<TableRoster::Item> Items;
+
+    TableRoster::Item createItem(size_t i) {
+        return TableRoster::Item("Contact " + std::to_string(i), "", JID("contact" + std::to_string(i), "example.com"), StatusShow::None, "");
+    }
+
+    Items createItems(size_t count) {
+        Items items;
+        for (size_t i = 0; i < count; ++i) {
+            items.push_back(createItem(i));
+        }
+        return items;
+    }
+
+    // Every 10th contact comes online, in place
+    Items changePresence(const Items& items) {
+        Items result(items);
+        for (size_t i = 0; i < result.size(); i += 10) {
+            result[i].status = StatusShow::Online;
+        }
+        return result;
+    }
+
+    // Every 10th contact comes online, and is sorted to the top
+    Items changePresenceAndSort(const Items& items) {
+        Items result = changePresence(items);
+        std::stable_partition(result.begin(), result.end(), [](const TableRoster::Item& item) {
+            return item.status == StatusShow::Online;
+        });
+        return result;
+    }
+
+    // Every 100th contact is removed, and as many new ones are added
+    Items addAndRemove(const Items& items) {
+        Items result;
+        for (size_t i = 0; i < items.size(); ++i) {
+            if (i % 100 == 50) {
+                result.push_back(createItem(items.size() + i));
+            }
+            if (i % 100 != 0) {
+                result.push_back(items[i]);
+            }
+        }
+        return result;
+    }
+
+    template<typename Diff>
+    void run(const std::string& name, const Items& before, const Items& after, Diff diff) {
+        int rounds = 10;
+        size_t changes = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < rounds; ++round) {
+            std::vector<size_t> updates;
+            std::vector<size_t> postUpdates;
+            std::vector<size_t> removes;
+            std::vector<size_t> inserts;
+            diff(before, after, updates, postUpdates, removes, inserts);
+            changes = updates.size() + removes.size() + inserts.size();
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        std::cout << std::left << std::setw(40) << name << std::right
+            << std::setw(8) << before.size() << " items"
+            << std::setw(8) << changes << " changes"
+            << std::setw(12) << std::fixed << std::setprecision(3) << static_cast<double>(elapsed.count()) / rounds / 1000.0 << " ms/diff" << std::endl;
+    }
+
+    void runAll(const std::string& name, size_t count, bool leastCommonSubsequence) {
+        Items items = createItems(count);
+        Items presence = changePresence(items);
+        Items sorted = changePresenceAndSort(items);
+        Items added = addAndRemove(items);
+        auto diff = leastCommonSubsequence ? &computeIndexDiff<TableRoster::Item, ItemEquals, ItemNeedsUpdate> : &computeKeyedIndexDiff<TableRoster::Item, ItemJID, ItemNeedsUpdate>;
+        run(name + " (presence)", items, presence, diff);
+        run(name + " (presence, sorted)", items, sorted, diff);
+        run(name + " (add & remove)", items, added, diff);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t items = argc > 1 ? std::stoul(argv[1]) : 10000;
+
+    runAll("computeKeyedIndexDiff", items, false);
+
+    // The LCS diff needs items^2 integers of memory, so only compare with it
+    // on a smaller section by default.
+    size_t leastCommonSubsequenceItems = argc > 2 ? std::stoul(argv[2]) : std::min(items, static_cast<size_t>(2000));
+    runAll("computeKeyedIndexDiff", leastCommonSubsequenceItems, false);
+    runAll("computeIndexDiff", leastCommonSubsequenceItems, true);
+
+    return 0;
+}
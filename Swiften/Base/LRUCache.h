@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017 Isode Limited.
+ * Copyright (c) 2017-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -68,6 +68,13 @@ public:
         return cachedValue;
     }
 
+    /**
+     * Removes the cache entry for the provided \p key, if there is one.
+     */
+    void erase(const KEY_TYPE& key) {
+        boost::multi_index::get<1>(cache).erase(key);
+    }
+
 private:
     using entry_t =  std::pair<KEY_TYPE, VALUE_TYPE>;
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -158,11 +158,16 @@ bool String::isValidXMPPCharacter(std::uint32_t codepoint) {
 }
 
 std::string String::sanitizeXMPPString(const std::string& input) {
-    std::string result;
-    result.reserve(input.length());
+    std::string result(input);
+    sanitizeXMPPStringInPlace(result);
+    return result;
+}
 
-    auto it = input.data();
-    const auto end = it + input.length();
+void String::sanitizeXMPPStringInPlace(std::string& s, std::size_t offset) {
+    auto begin = &s[0];
+    auto it = begin + offset;
+    auto out = it;
+    const auto end = begin + s.length();
 
     std::size_t consumed;
     bool status = UTF8_ACCEPT;
@@ -171,7 +176,10 @@ std::string String::sanitizeXMPPString(const std::string& input) {
         const auto codepoint = getNextCodepoint(it, end, consumed, status);
         if (status) {
             if (isValidXMPPCharacter(codepoint)) {
-                std::copy(it, it + consumed, std::back_inserter(result));
+                if (out != it) {
+                    std::copy(it, it + consumed, out);
+                }
+                out += consumed;
             }
             it += consumed;
         }
@@ -179,8 +187,7 @@ std::string String::sanitizeXMPPString(const std::string& input) {
             ++it;
         }
     }
-    result.shrink_to_fit();
-    return result;
+    s.resize(static_cast<std::size_t>(out - begin));
 }
 
 std::vector<std::string> String::split(const std::string& s, char c) {
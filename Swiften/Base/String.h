@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -25,6 +25,12 @@ namespace Swift {
             SWIFTEN_API bool isValidXMPPCharacter(std::uint32_t codepoint);
             SWIFTEN_API std::string sanitizeXMPPString(const std::string& input);
 
+            /**
+             * Like sanitizeXMPPString(), but removes the invalid characters from the
+             * given string starting at the given offset, without allocating.
+             */
+            SWIFTEN_API void sanitizeXMPPStringInPlace(std::string& s, std::size_t offset = 0);
+
             inline bool beginsWith(const std::string& s, char c) {
                 return s.size() > 0 && s[0] == c;
             }
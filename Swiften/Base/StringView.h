@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <string>
+
+#include <Swiften/Base/API.h>
+
+namespace Swift {
+    /**
+     * A non-owning, read-only reference to a sequence of characters.
+     *
+     * A StringView does not copy the data it refers to, so the data has to
+     * outlive the view. Views handed out by the XML parsers are only valid
+     * for the duration of the callback they are passed to.
+     */
+    class SWIFTEN_API StringView {
+        public:
+            StringView() : data_(nullptr), size_(0) {
+            }
+
+            StringView(const char* data, size_t size) : data_(data), size_(size) {
+            }
+
+            StringView(const char* s) : data_(s), size_(s ? std::strlen(s) : 0) {
+            }
+
+            StringView(const std::string& s) : data_(s.data()), size_(s.size()) {
+            }
+
+            const char* data() const {
+                return data_;
+            }
+
+            size_t size() const {
+                return size_;
+            }
+
+            bool empty() const {
+                return size_ == 0;
+            }
+
+            const char* begin() const {
+                return data_;
+            }
+
+            const char* end() const {
+                return data_ + size_;
+            }
+
+            char operator[](size_t i) const {
+                return data_[i];
+            }
+
+            std::string toString() const {
+                return size_ ? std::string(data_, size_) : std::string();
+            }
+
+        private:
+            const char* data_;
+            size_t size_;
+    };
+
+    inline bool operator==(const StringView& a, const StringView& b) {
+        return a.size() == b.size() && (a.size() == 0 || std::memcmp(a.data(), b.data(), a.size()) == 0);
+    }
+
+    inline bool operator!=(const StringView& a, const StringView& b) {
+        return !(a == b);
+    }
+
+    inline std::ostream& operator<<(std::ostream& os, const StringView& s) {
+        return os.write(s.data(), static_cast<std::streamsize>(s.size()));
+    }
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017 Isode Limited.
+ * Copyright (c) 2017-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -115,3 +115,18 @@ TEST(LRUCacheTest, testCacheMissFunctionIsUsedOnCacheMiss) {
     }));
     ASSERT_EQ(b::optional<std::string>(), testling.get("D"));
 }
+
+TEST(LRUCacheTest, testErase) {
+    LRUCache<std::string, std::string, 3> testling;
+
+    testling.insert("A", "AA");
+    testling.insert("B", "BB");
+    testling.erase("A");
+    testling.erase("C");
+
+    ASSERT_EQ(b::optional<std::string>(), testling.get("A"));
+    ASSERT_EQ(b::optional<std::string>("BB"), testling.get("B"));
+
+    testling.insert("A", "AAA");
+    ASSERT_EQ(b::optional<std::string>("AAA"), testling.get("A"));
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2011-2016 Isode Limited.
+ * Copyright (c) 2011-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -11,6 +11,7 @@
 #include <Swiften/Base/API.h>
 #include <Swiften/Base/SafeString.h>
 #include <Swiften/Base/URL.h>
+#include <Swiften/Compress/ZLibCompressionOptions.h>
 #include <Swiften/TLS/TLSOptions.h>
 
 namespace Swift {
@@ -40,6 +41,13 @@ namespace Swift {
          */
         bool useStreamCompression = true;
 
+        /**
+         * Tuning of ZLib stream compression, e.g. to use less memory
+         * per stream. If these are not valid, connecting fails with a
+         * CompressionFailedError before the session is started.
+         */
+        ZLibCompressionOptions streamCompressionOptions;
+
         /**
          * Sets whether TLS encryption should be used.
          *
@@ -72,6 +80,15 @@ namespace Swift {
          */
         bool forgetPassword = false;
 
+        /**
+         * Keep the keys derived from the password during SCRAM authentication,
+         * so reconnecting doesn't have to repeat the expensive key derivation.
+         * The keys are only kept in memory, for the lifetime of the client.
+         *
+         * Default: true
+         */
+        bool cacheSCRAMKeys = true;
+
         /**
          * Use XEP-0198 acks in the stream when available.
          * Default: true
@@ -134,6 +151,15 @@ namespace Swift {
         SafeString boshHTTPConnectProxyAuthID = SafeString("");
         SafeString boshHTTPConnectProxyAuthPassword = SafeString("");
 
+        /**
+         * Pipeline BOSH requests on the open HTTP connections, instead of
+         * opening a new connection when all connections are waiting for a
+         * response. Only enable this if the BOSH server and any HTTP proxies
+         * in between support HTTP/1.1 pipelining.
+         * Default: false
+         */
+        bool boshPipelining = false;
+
         /**
          * This can be initialized with a custom HTTPTrafficFilter, which allows HTTP CONNECT
          * proxy initialization to be customized.
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -9,12 +9,14 @@
 #include <memory>
 
 #include <boost/bind.hpp>
+#include <boost/optional.hpp>
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_io.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 
 #include <Swiften/Base/Log.h>
 #include <Swiften/Base/Platform.h>
+#include <Swiften/Compress/ZLibException.h>
 #include <Swiften/Crypto/CryptoProvider.h>
 #include <Swiften/Elements/AuthChallenge.h>
 #include <Swiften/Elements/AuthFailure.h>
@@ -43,7 +45,7 @@
 #include <Swiften/SASL/DIGESTMD5ClientAuthenticator.h>
 #include <Swiften/SASL/EXTERNALClientAuthenticator.h>
 #include <Swiften/SASL/PLAINClientAuthenticator.h>
-#include <Swiften/SASL/SCRAMSHA1ClientAuthenticator.h>
+#include <Swiften/SASL/SCRAMClientAuthenticator.h>
 #include <Swiften/Session/SessionStream.h>
 #include <Swiften/Session/BasicSessionStream.h>
 #include <Swiften/Session/BOSHSessionStream.h>
@@ -62,6 +64,41 @@
 
 namespace Swift {
 
+namespace {
+    struct SCRAMMechanism {
+        CryptoProvider::HashAlgorithm algorithm;
+        bool plus;
+        // The TLS finish message, if the stream is encrypted
+        ByteArray channelBindingData;
+    };
+
+    /**
+     * Returns the strongest SCRAM variant offered by the server that the
+     * crypto provider supports.
+     *
+     * If channel binding is possible, any -PLUS variant wins over the
+     * variants without it: a server that supports channel binding has to
+     * reject a client that could have used it, but didn't.
+     */
+    boost::optional<SCRAMMechanism> getSCRAMMechanism(const StreamFeatures* streamFeatures, CryptoProvider* crypto, SessionStream* stream) {
+        ByteArray finishMessage;
+        if (stream->isTLSEncrypted()) {
+            finishMessage = stream->getTLSFinishMessage();
+        }
+        for (bool plus : {true, false}) {
+            if (plus && finishMessage.empty()) {
+                continue;
+            }
+            for (auto algorithm : {CryptoProvider::HashAlgorithm::SHA512, CryptoProvider::HashAlgorithm::SHA256, CryptoProvider::HashAlgorithm::SHA1}) {
+                if (streamFeatures->hasAuthenticationMechanism(SCRAMClientAuthenticator::getMechanismName(algorithm, plus)) && crypto->isHashAlgorithmSupported(algorithm)) {
+                    return SCRAMMechanism{algorithm, plus, finishMessage};
+                }
+            }
+        }
+        return boost::optional<SCRAMMechanism>();
+    }
+}
+
 ClientSession::ClientSession(
         const JID& jid,
         std::shared_ptr<SessionStream> stream,
@@ -269,19 +306,14 @@ void ClientSession::handleElement(std::shared_ptr<ToplevelElement> element) {
                 state = State::Authenticating;
                 stream->writeElement(std::make_shared<AuthRequest>("EXTERNAL", createSafeByteArray("")));
             }
-            else if (streamFeatures->hasAuthenticationMechanism("SCRAM-SHA-1") || streamFeatures->hasAuthenticationMechanism("SCRAM-SHA-1-PLUS")) {
+            else if (boost::optional<SCRAMMechanism> scramMechanism = getSCRAMMechanism(streamFeatures, crypto, stream.get())) {
                 std::ostringstream s;
-                ByteArray finishMessage;
-                bool plus = streamFeatures->hasAuthenticationMechanism("SCRAM-SHA-1-PLUS");
-                if (stream->isTLSEncrypted()) {
-                    finishMessage = stream->getTLSFinishMessage();
-                    plus &= !finishMessage.empty();
-                }
                 s << boost::uuids::random_generator()();
-                SCRAMSHA1ClientAuthenticator* scramAuthenticator = new SCRAMSHA1ClientAuthenticator(s.str(), plus, idnConverter, crypto);
-                if (!finishMessage.empty()) {
-                    scramAuthenticator->setTLSChannelBindingData(finishMessage);
+                SCRAMClientAuthenticator* scramAuthenticator = new SCRAMClientAuthenticator(scramMechanism->algorithm, s.str(), scramMechanism->plus, idnConverter, crypto);
+                if (!scramMechanism->channelBindingData.empty()) {
+                    scramAuthenticator->setTLSChannelBindingData(scramMechanism->channelBindingData);
                 }
+                scramAuthenticator->setKeyCache(scramKeyCache);
                 authenticator = scramAuthenticator;
                 state = State::WaitingForCredentials;
                 onNeedCredentials();
@@ -322,7 +354,14 @@ void ClientSession::handleElement(std::shared_ptr<ToplevelElement> element) {
     else if (std::dynamic_pointer_cast<Compressed>(element)) {
         CHECK_STATE_OR_RETURN(State::Compressing);
         state = State::WaitingForStreamStart;
-        stream->addZLibCompression();
+        try {
+            stream->addZLibCompression();
+        }
+        catch (const ZLibException&) {
+            // e.g. invalid compression options
+            finishSession(Error::CompressionFailedError);
+            return;
+        }
         stream->resetXMPPParser();
         sendStreamHeader();
     }
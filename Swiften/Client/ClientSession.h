@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -22,6 +22,7 @@ namespace Swift {
     class ClientAuthenticator;
     class CryptoProvider;
     class IDNConverter;
+    class SCRAMKeyCache;
     class Stanza;
     class StanzaAckRequester;
     class StanzaAckResponder;
@@ -145,6 +146,14 @@ namespace Swift {
                 sessionShutdownTimeoutInMilliseconds = timeoutInMilliseconds;
             }
 
+            /**
+             * Sets the cache in which SCRAM authentication keeps the keys
+             * derived from the password, for use by later sessions.
+             */
+            void setSCRAMKeyCache(std::shared_ptr<SCRAMKeyCache> cache) {
+                scramKeyCache = cache;
+            }
+
         public:
             boost::signals2::signal<void ()> onNeedCredentials;
             boost::signals2::signal<void ()> onInitialized;
@@ -211,5 +220,6 @@ namespace Swift {
             CertificateTrustChecker* certificateTrustChecker;
             bool singleSignOn;
             int authenticationPort;
+            std::shared_ptr<SCRAMKeyCache> scramKeyCache;
     };
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -16,6 +16,7 @@
 #include <Swiften/Base/Log.h>
 #include <Swiften/Client/ClientSession.h>
 #include <Swiften/Client/ClientSessionStanzaChannel.h>
+#include <Swiften/Network/CachingDomainNameResolver.h>
 #include <Swiften/Network/ChainedConnector.h>
 #include <Swiften/Network/DomainNameResolveError.h>
 #include <Swiften/Network/HTTPConnectProxiedConnectionFactory.h>
@@ -23,6 +24,7 @@
 #include <Swiften/Network/ProxyProvider.h>
 #include <Swiften/Network/SOCKS5ProxiedConnectionFactory.h>
 #include <Swiften/Queries/IQRouter.h>
+#include <Swiften/SASL/SCRAMKeyCache.h>
 #include <Swiften/Session/BOSHSessionStream.h>
 #include <Swiften/Session/BasicSessionStream.h>
 #include <Swiften/TLS/CertificateVerificationError.h>
@@ -31,6 +33,23 @@
 
 namespace Swift {
 
+namespace {
+    // The cached addresses may not be valid anymore after a connection
+    // failed, e.g. because the network changed, so a reconnect resolves the
+    // names again. The resolver is shared with other clients, so only the
+    // names of this client's server (or BOSH host) are dropped.
+    void invalidateDomainNameCache(NetworkFactories* networkFactories, const ClientOptions& options, const JID& jid) {
+        if (CachingDomainNameResolver* resolver = dynamic_cast<CachingDomainNameResolver*>(networkFactories->getDomainNameResolver())) {
+            if (!options.boshURL.isEmpty()) {
+                resolver->invalidate(options.boshURL.getHost());
+            }
+            else {
+                resolver->invalidate(options.manualHostname.empty() ? jid.getDomain() : options.manualHostname);
+            }
+        }
+    }
+}
+
 CoreClient::CoreClient(const JID& jid, const SafeByteArray& password, NetworkFactories* networkFactories) : jid_(jid), password_(password), networkFactories(networkFactories), disconnectRequested_(false), certificateTrustChecker(nullptr) {
     stanzaChannel_ = new ClientSessionStanzaChannel();
     stanzaChannel_->onMessageReceived.connect(boost::bind(&CoreClient::handleMessageReceived, this, _1));
@@ -40,6 +59,7 @@ CoreClient::CoreClient(const JID& jid, const SafeByteArray& password, NetworkFac
 
     iqRouter_ = new IQRouter(stanzaChannel_);
     iqRouter_->setJID(jid);
+    iqRouter_->setTimerFactory(networkFactories->getTimerFactory());
 }
 
 CoreClient::~CoreClient() {
@@ -140,6 +160,7 @@ void CoreClient::connect(const ClientOptions& o) {
             options.boshHTTPConnectProxyAuthPassword,
             options.tlsOptions,
             options.httpTrafficFilter));
+        boshSessionStream_->setPipeliningEnabled(options.boshPipelining);
         sessionStream_ = boshSessionStream_;
         sessionStream_->onDataRead.connect(boost::bind(&CoreClient::handleDataRead, this, _1));
         sessionStream_->onDataWritten.connect(boost::bind(&CoreClient::handleDataWritten, this, _1));
@@ -173,6 +194,12 @@ void CoreClient::bindSessionToStream() {
             break;
     }
     session_->setUseAcks(options.useAcks);
+    if (options.cacheSCRAMKeys) {
+        if (!scramKeyCache_) {
+            scramKeyCache_ = std::make_shared<SCRAMKeyCache>();
+        }
+        session_->setSCRAMKeyCache(scramKeyCache_);
+    }
     stanzaChannel_->setSession(session_);
     session_->onFinished.connect(boost::bind(&CoreClient::handleSessionFinished, this, _1));
     session_->onNeedCredentials.connect(boost::bind(&CoreClient::handleNeedCredentials, this));
@@ -191,6 +218,7 @@ void CoreClient::handleConnectorFinished(std::shared_ptr<Connection> connection,
         boost::optional<ClientError> clientError;
         if (!disconnectRequested_) {
             clientError = std::dynamic_pointer_cast<DomainNameResolveError>(error) ? boost::optional<ClientError>(ClientError::DomainNameResolveError) : boost::optional<ClientError>(ClientError::ConnectionError);
+            invalidateDomainNameCache(networkFactories, options, jid_);
         }
         onDisconnected(clientError);
     }
@@ -204,9 +232,23 @@ void CoreClient::handleConnectorFinished(std::shared_ptr<Connection> connection,
             return;
         }
 
+        if (options.useStreamCompression && !options.streamCompressionOptions.isValid()) {
+            // Don't wait until compression has been negotiated to find out the options can't be used
+            SWIFT_LOG(warning) << "Invalid stream compression options" << std::endl;
+            onDisconnected(boost::optional<ClientError>(ClientError::CompressionFailedError));
+            return;
+        }
+
         connection_ = connection;
 
-        sessionStream_ = std::make_shared<BasicSessionStream>(ClientStreamType, connection_, getPayloadParserFactories(), getPayloadSerializers(), networkFactories->getTLSContextFactory(), networkFactories->getTimerFactory(), networkFactories->getXMLParserFactory(), options.tlsOptions);
+        // Resume TLS sessions per account. The domain is what the server
+        // certificate is checked against, and the account keeps clients with
+        // different credentials from picking up each other's sessions.
+        TLSOptions tlsOptions = options.tlsOptions;
+        if (tlsOptions.sessionCacheKey.empty()) {
+            tlsOptions.sessionCacheKey = jid_.toBare().toString();
+        }
+        sessionStream_ = std::make_shared<BasicSessionStream>(ClientStreamType, connection_, getPayloadParserFactories(), getPayloadSerializers(), networkFactories->getTLSContextFactory(), networkFactories->getTimerFactory(), networkFactories->getXMLParserFactory(), tlsOptions, options.streamCompressionOptions);
         if (certificate_) {
             sessionStream_->setTLSCertificate(certificate_);
         }
@@ -303,9 +345,11 @@ void CoreClient::handleSessionFinished(std::shared_ptr<Error> error) {
                     break;
                 case SessionStream::SessionStreamError::ConnectionReadError:
                     clientError = ClientError(ClientError::ConnectionReadError);
+                    invalidateDomainNameCache(networkFactories, options, jid_);
                     break;
                 case SessionStream::SessionStreamError::ConnectionWriteError:
                     clientError = ClientError(ClientError::ConnectionWriteError);
+                    invalidateDomainNameCache(networkFactories, options, jid_);
                     break;
             }
         }
@@ -445,6 +489,9 @@ const JID& CoreClient::getJID() const {
 
 void CoreClient::purgePassword() {
     safeClear(password_);
+    if (scramKeyCache_) {
+        scramKeyCache_->clear();
+    }
 }
 
 void CoreClient::resetConnector() {
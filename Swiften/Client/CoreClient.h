@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2017 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -31,6 +31,7 @@ namespace Swift {
     class Message;
     class NetworkFactories;
     class Presence;
+    class SCRAMKeyCache;
     class SessionStream;
     class Stanza;
     class StanzaChannel;
@@ -236,5 +237,6 @@ namespace Swift {
             CertificateWithKey::ref certificate_;
             bool disconnectRequested_;
             CertificateTrustChecker* certificateTrustChecker;
+            std::shared_ptr<SCRAMKeyCache> scramKeyCache_;
     };
 }
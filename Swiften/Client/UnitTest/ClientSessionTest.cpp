@@ -1,11 +1,13 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <deque>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include <boost/bind.hpp>
 #include <boost/optional.hpp>
@@ -58,6 +60,8 @@ class ClientSessionTest : public CppUnit::TestFixture {
         CPPUNIT_TEST(testAuthenticate_PLAINOverNonTLS);
         CPPUNIT_TEST(testAuthenticate_RequireTLS);
         CPPUNIT_TEST(testAuthenticate_EXTERNAL);
+        CPPUNIT_TEST(testAuthenticate_SCRAM_StrongestHash);
+        CPPUNIT_TEST(testAuthenticate_SCRAM_PrefersChannelBinding);
         CPPUNIT_TEST(testStreamManagement);
         CPPUNIT_TEST(testStreamManagement_Failed);
         CPPUNIT_TEST(testUnexpectedChallenge);
@@ -225,6 +229,34 @@ class ClientSessionTest : public CppUnit::TestFixture {
             session->finish();
         }
 
+        void testAuthenticate_SCRAM_StrongestHash() {
+            std::shared_ptr<ClientSession> session(createSession());
+            session->start();
+            server->receiveStreamStart();
+            server->sendStreamStart();
+            server->sendStreamFeaturesWithAuthentication({"SCRAM-SHA-1", "SCRAM-SHA-1-PLUS", "SCRAM-SHA-512"});
+            CPPUNIT_ASSERT(needCredentials);
+            session->sendCredentials(createSafeByteArray("mypass"));
+            server->receiveAuthRequest("SCRAM-SHA-512");
+
+            session->finish();
+        }
+
+        void testAuthenticate_SCRAM_PrefersChannelBinding() {
+            std::shared_ptr<ClientSession> session(createSession());
+            session->start();
+            server->receiveStreamStart();
+            server->sendStreamStart();
+            server->tlsEncrypted = true;
+            server->tlsFinishMessage = createByteArray("finished");
+            server->sendStreamFeaturesWithAuthentication({"SCRAM-SHA-1", "SCRAM-SHA-1-PLUS", "SCRAM-SHA-512"});
+            CPPUNIT_ASSERT(needCredentials);
+            session->sendCredentials(createSafeByteArray("mypass"));
+            server->receiveAuthRequest("SCRAM-SHA-1-PLUS");
+
+            session->finish();
+        }
+
         void testAuthenticate_Unauthorized() {
             std::shared_ptr<ClientSession> session(createSession());
             session->start();
@@ -509,7 +541,7 @@ class ClientSessionTest : public CppUnit::TestFixture {
                 }
 
                 virtual ByteArray getTLSFinishMessage() const {
-                    return ByteArray();
+                    return tlsFinishMessage;
                 }
 
                 virtual Certificate::ref getPeerCertificate() const {
@@ -591,6 +623,14 @@ class ClientSessionTest : public CppUnit::TestFixture {
                     onElementReceived(streamFeatures);
                 }
 
+                void sendStreamFeaturesWithAuthentication(const std::vector<std::string>& mechanisms) {
+                    std::shared_ptr<StreamFeatures> streamFeatures(new StreamFeatures());
+                    for (const auto& mechanism : mechanisms) {
+                        streamFeatures->addAuthenticationMechanism(mechanism);
+                    }
+                    onElementReceived(streamFeatures);
+                }
+
                 void sendStreamFeaturesWithEXTERNALAuthentication() {
                     std::shared_ptr<StreamFeatures> streamFeatures(new StreamFeatures());
                     streamFeatures->addAuthenticationMechanism("EXTERNAL");
@@ -695,6 +735,7 @@ class ClientSessionTest : public CppUnit::TestFixture {
                 bool available;
                 bool canTLSEncrypt;
                 bool tlsEncrypted;
+                ByteArray tlsFinishMessage;
                 bool compressed;
                 bool whitespacePingEnabled;
                 std::string bindID;
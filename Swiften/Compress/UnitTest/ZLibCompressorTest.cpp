@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -11,6 +11,7 @@
 
 #include <Swiften/Base/SafeByteArray.h>
 #include <Swiften/Compress/ZLibCompressor.h>
+#include <Swiften/Compress/ZLibException.h>
 
 using namespace Swift;
 
@@ -20,6 +21,8 @@ class ZLibCompressorTest : public CppUnit::TestFixture
         CPPUNIT_TEST_SUITE(ZLibCompressorTest);
         CPPUNIT_TEST(testProcess);
         CPPUNIT_TEST(testProcess_Twice);
+        CPPUNIT_TEST(testConstructor_InvalidOptions);
+        CPPUNIT_TEST(testOptionsIsValid);
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -39,6 +42,44 @@ class ZLibCompressorTest : public CppUnit::TestFixture
 
             CPPUNIT_ASSERT_EQUAL(createSafeByteArray("\x4a\x4a\x2c\x02\x00\x00\x00\xff\xff",9), result);
         }
+
+        void testOptionsIsValid() {
+            ZLibCompressionOptions options;
+            CPPUNIT_ASSERT(options.isValid());
+            options.level = -1;
+            CPPUNIT_ASSERT(options.isValid());
+            options.level = -2;
+            CPPUNIT_ASSERT(!options.isValid());
+
+            options = ZLibCompressionOptions();
+            options.memLevel = 10;
+            CPPUNIT_ASSERT(!options.isValid());
+        }
+
+        void testConstructor_InvalidOptions() {
+            ZLibCompressionOptions options;
+            options.level = 10;
+            CPPUNIT_ASSERT_THROW(ZLibCompressor testling(options), ZLibException);
+
+            options = ZLibCompressionOptions();
+            options.windowBits = 8;
+            CPPUNIT_ASSERT_THROW(ZLibCompressor testling(options), ZLibException);
+
+            options = ZLibCompressionOptions();
+            options.windowBits = 16;
+            CPPUNIT_ASSERT_THROW(ZLibCompressor testling(options), ZLibException);
+
+            options = ZLibCompressionOptions();
+            options.memLevel = 0;
+            CPPUNIT_ASSERT_THROW(ZLibCompressor testling(options), ZLibException);
+
+            options = ZLibCompressionOptions();
+            options.windowBits = 9;
+            options.memLevel = 1;
+            options.level = 0;
+            ZLibCompressor testling(options);
+            CPPUNIT_ASSERT(!testling.process(createSafeByteArray("foo")).empty());
+        }
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(ZLibCompressorTest);
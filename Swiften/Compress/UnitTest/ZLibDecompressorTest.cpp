@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -10,6 +10,7 @@
 #include <cppunit/extensions/TestFactoryRegistry.h>
 
 #include <Swiften/Base/ByteArray.h>
+#include <Swiften/Compress/ZLibCompressionOptions.h>
 #include <Swiften/Compress/ZLibCompressor.h>
 #include <Swiften/Compress/ZLibDecompressor.h>
 #include <Swiften/Compress/ZLibException.h>
@@ -25,6 +26,10 @@ class ZLibDecompressorTest : public CppUnit::TestFixture
         CPPUNIT_TEST(testProcess_Invalid);
         CPPUNIT_TEST(testProcess_Huge);
         CPPUNIT_TEST(testProcess_ChunkSize);
+        CPPUNIT_TEST(testProcess_SmallWindow);
+        CPPUNIT_TEST(testProcess_Dictionary);
+        CPPUNIT_TEST(testProcess_DictionaryMissing);
+        CPPUNIT_TEST(testProcess_LargeInput);
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -75,6 +80,52 @@ class ZLibDecompressorTest : public CppUnit::TestFixture
 
             CPPUNIT_ASSERT_EQUAL(original, decompressed);
         }
+
+        void testProcess_SmallWindow() {
+            ZLibCompressionOptions options;
+            options.windowBits = 9;
+            options.memLevel = 1;
+            SafeByteArray original(createSafeByteArray("<message to='foo@bar.com'><body>Hello</body></message>"));
+            SafeByteArray compressed = ZLibCompressor(options).process(original);
+            SafeByteArray decompressed = ZLibDecompressor().process(compressed);
+
+            CPPUNIT_ASSERT_EQUAL(original, decompressed);
+        }
+
+        void testProcess_Dictionary() {
+            ZLibCompressionOptions options;
+            options.dictionary = ZLibCompressionOptions::getXMPPDictionary();
+            ZLibCompressor compressor(options);
+            ZLibDecompressor decompressor(options);
+
+            SafeByteArray first(createSafeByteArray("<message to='foo@bar.com' type='chat'><body>Hello</body></message>"));
+            CPPUNIT_ASSERT_EQUAL(first, decompressor.process(compressor.process(first)));
+            SafeByteArray second(createSafeByteArray("<presence><show>away</show></presence>"));
+            CPPUNIT_ASSERT_EQUAL(second, decompressor.process(compressor.process(second)));
+        }
+
+        void testProcess_DictionaryMissing() {
+            ZLibCompressionOptions options;
+            options.dictionary = ZLibCompressionOptions::getXMPPDictionary();
+            SafeByteArray compressed = ZLibCompressor(options).process(createSafeByteArray("<presence/>"));
+
+            CPPUNIT_ASSERT_THROW(ZLibDecompressor().process(compressed), ZLibException);
+        }
+
+        void testProcess_LargeInput() {
+            std::vector<char> data;
+            data.reserve(1024 * 1024);
+            unsigned int seed = 1;
+            for (unsigned int i = 0; i < 1024 * 1024; ++i) {
+                seed = seed * 1103515245 + 12345;
+                data.push_back(static_cast<char>(seed >> 16));
+            }
+            SafeByteArray original(createSafeByteArray(&data[0], data.size()));
+            SafeByteArray compressed = ZLibCompressor().process(original);
+            SafeByteArray decompressed = ZLibDecompressor().process(compressed);
+
+            CPPUNIT_ASSERT_EQUAL(original, decompressed);
+        }
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(ZLibDecompressorTest);
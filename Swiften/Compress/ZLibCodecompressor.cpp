@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -8,6 +8,7 @@
 
 #include <string.h>
 
+#include <algorithm>
 #include <cassert>
 
 #include <boost/numeric/conversion/cast.hpp>
@@ -19,7 +20,7 @@
 
 namespace Swift {
 
-static const size_t CHUNK_SIZE = 1024; // If you change this, also change the unittest
+static const size_t MINIMUM_OUTPUT_SIZE = 1024; // If you change this, also change the unittest
 
 
 ZLibCodecompressor::ZLibCodecompressor() : p(new Private()) {
@@ -32,26 +33,34 @@ ZLibCodecompressor::ZLibCodecompressor() : p(new Private()) {
 ZLibCodecompressor::~ZLibCodecompressor() {
 }
 
+size_t ZLibCodecompressor::getOutputSizeEstimate(size_t inputSize) {
+    return 4 * inputSize;
+}
+
 SafeByteArray ZLibCodecompressor::process(const SafeByteArray& input) {
-    SafeByteArray output;
+    SafeByteArray output(std::max(MINIMUM_OUTPUT_SIZE, getOutputSizeEstimate(input.size())));
     p->stream.avail_in = static_cast<unsigned int>(input.size());
     p->stream.next_in = reinterpret_cast<Bytef*>(const_cast<unsigned char*>(vecptr(input)));
     size_t outputPosition = 0;
-    do {
-        output.resize(outputPosition + CHUNK_SIZE);
-        p->stream.avail_out = CHUNK_SIZE;
+    while (true) {
+        p->stream.avail_out = static_cast<unsigned int>(output.size() - outputPosition);
         p->stream.next_out = reinterpret_cast<Bytef*>(vecptr(output) + outputPosition);
         int result = processZStream();
         if (result != Z_OK && result != Z_BUF_ERROR) {
             throw ZLibException(/* p->stream.msg */);
         }
-        outputPosition += CHUNK_SIZE;
+        outputPosition = output.size() - p->stream.avail_out;
+        if (p->stream.avail_out != 0) {
+            break;
+        }
+        // There may be more output; grow geometrically so that large
+        // stanzas only take a few rounds.
+        output.resize(2 * output.size());
     }
-    while (p->stream.avail_out == 0);
     if (p->stream.avail_in != 0) {
         throw ZLibException();
     }
-    output.resize(outputPosition - p->stream.avail_out);
+    output.resize(outputPosition);
     return output;
 }
 
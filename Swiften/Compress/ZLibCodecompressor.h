@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -20,6 +20,13 @@ namespace Swift {
             SafeByteArray process(const SafeByteArray& data);
             virtual int processZStream() = 0;
 
+        protected:
+            /**
+             * Returns the size of the output buffer to start processing
+             * \p inputSize bytes with. The buffer is grown if it is too small.
+             */
+            virtual size_t getOutputSizeEstimate(size_t inputSize);
+
         protected:
             struct Private;
             const std::unique_ptr<Private> p;
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <Swiften/Compress/ZLibCompressionOptions.h>
+
+#include <zlib.h>
+
+namespace Swift {
+
+bool ZLibCompressionOptions::isValid() const {
+    // zlib silently adjusts some out of range values, so check the documented ranges here
+    return level >= Z_DEFAULT_COMPRESSION && level <= 9 && windowBits >= 9 && windowBits <= 15 && memLevel >= 1 && memLevel <= 9;
+}
+
+const std::string& ZLibCompressionOptions::getXMPPDictionary() {
+    // zlib looks for matches from the end of the dictionary backwards, so
+    // the most common strings come last.
+    static const std::string dictionary =
+        "<error type=\"cancel\"><item-not-found xmlns=\"urn:ietf:params:xml:ns:xmpp-stanzas\"/></error>"
+        "<c xmlns=\"http://jabber.org/protocol/caps\" hash=\"sha-1\" node=\"\" ver=\"\"/>"
+        "<x xmlns=\"http://jabber.org/protocol/muc#user\"><item affiliation=\"\" role=\"\"/></x>"
+        "<query xmlns=\"jabber:iq:roster\"><item jid=\"\" name=\"\" subscription=\"both\"><group></group></item></query>"
+        "<query xmlns=\"http://jabber.org/protocol/disco#info\"/>"
+        "<delay xmlns=\"urn:xmpp:delay\" from=\"\" stamp=\"\"/>"
+        "<r xmlns=\"urn:xmpp:sm:3\"/><a xmlns=\"urn:xmpp:sm:3\" h=\"\"/>"
+        "<active xmlns=\"http://jabber.org/protocol/chatstates\"/>"
+        "<composing xmlns=\"http://jabber.org/protocol/chatstates\"/>"
+        "<request xmlns=\"urn:xmpp:receipts\"/><received xmlns=\"urn:xmpp:receipts\" id=\"\"/>"
+        "<iq type=\"get\" id=\"\" to=\"\"><ping xmlns=\"urn:xmpp:ping\"/></iq>"
+        "<iq type=\"result\" from=\"\" id=\"\" to=\"\"/>"
+        "<presence from=\"\" to=\"\" type=\"unavailable\"><show>away</show><status></status><priority></priority></presence>"
+        "<message from=\"\" id=\"\" to=\"\" type=\"chat\"><body></body></message>";
+    return dictionary;
+}
+
+}
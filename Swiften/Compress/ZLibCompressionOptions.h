@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#pragma once
+
+#include <string>
+
+#include <Swiften/Base/API.h>
+
+namespace Swift {
+    /**
+     * Tuning of ZLib stream compression.
+     *
+     * A compressor uses about 2^(windowBits + 2) + 2^(memLevel + 9) bytes of
+     * state, which is 256 KB with the defaults. Smaller windows and memory
+     * levels trade some compression ratio for a lot less memory per stream.
+     */
+    struct SWIFTEN_API ZLibCompressionOptions {
+        ZLibCompressionOptions() {
+        }
+
+        /**
+         * Compression level, from 0 (no compression) to 9 (best compression),
+         * or -1 for zlib's default level.
+         *
+         * Default: 9
+         */
+        int level = 9;
+
+        /**
+         * Base two logarithm of the compression window size, from 9 to 15.
+         *
+         * This only applies to compression: the decompressor always uses the
+         * largest window, as it has to handle whatever window the peer uses.
+         *
+         * Default: 15
+         */
+        int windowBits = 15;
+
+        /**
+         * Amount of memory used for the compression state, from 1 to 9.
+         *
+         * Default: 8
+         */
+        int memLevel = 8;
+
+        /**
+         * Preset dictionary to prime both compression and decompression with.
+         *
+         * A preset dictionary is not part of XEP-0138, so this only works if
+         * the peer uses the same dictionary (e.g. getXMPPDictionary()).
+         *
+         * Default: empty (no dictionary)
+         */
+        std::string dictionary;
+
+        /**
+         * Returns whether the level, window size and memory level are within
+         * the ranges documented above.
+         */
+        bool isValid() const;
+
+        /**
+         * A dictionary of strings that are common in XMPP streams.
+         */
+        static const std::string& getXMPPDictionary();
+    };
+}
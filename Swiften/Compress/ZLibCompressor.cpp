@@ -1,24 +1,33 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <Swiften/Compress/ZLibCompressor.h>
 
-#include <cassert>
 #include <zlib.h>
 
 #include <Swiften/Compress/ZLibCodecompressor_Private.h>
+#include <Swiften/Compress/ZLibException.h>
 
 #pragma GCC diagnostic ignored "-Wold-style-cast"
 
 namespace Swift {
 
-ZLibCompressor::ZLibCompressor() {
-    int result = deflateInit(&p->stream, COMPRESSION_LEVEL);
-    assert(result == Z_OK);
-    (void) result;
+ZLibCompressor::ZLibCompressor(const ZLibCompressionOptions& options) {
+    if (!options.isValid()) {
+        throw ZLibException();
+    }
+    if (deflateInit2(&p->stream, options.level, Z_DEFLATED, options.windowBits, options.memLevel, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw ZLibException();
+    }
+    if (!options.dictionary.empty()) {
+        if (deflateSetDictionary(&p->stream, reinterpret_cast<const Bytef*>(options.dictionary.data()), static_cast<uInt>(options.dictionary.size())) != Z_OK) {
+            deflateEnd(&p->stream);
+            throw ZLibException();
+        }
+    }
 }
 
 ZLibCompressor::~ZLibCompressor() {
@@ -29,4 +38,10 @@ int ZLibCompressor::processZStream() {
     return deflate(&p->stream, Z_SYNC_FLUSH);
 }
 
+size_t ZLibCompressor::getOutputSizeEstimate(size_t inputSize) {
+    // deflateBound() covers compressing the input in one go, but not the
+    // few bytes of the sync flush marker.
+    return deflateBound(&p->stream, static_cast<uLong>(inputSize)) + 16;
+}
+
 }
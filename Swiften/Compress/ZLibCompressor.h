@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -8,16 +8,21 @@
 
 #include <Swiften/Base/API.h>
 #include <Swiften/Compress/ZLibCodecompressor.h>
+#include <Swiften/Compress/ZLibCompressionOptions.h>
 
 namespace Swift {
     class SWIFTEN_API ZLibCompressor : public ZLibCodecompressor {
         public:
-            ZLibCompressor();
+            /**
+             * Throws a ZLibException if the options are out of range, or
+             * the compressor can't be set up with them.
+             */
+            ZLibCompressor(const ZLibCompressionOptions& options = ZLibCompressionOptions());
             virtual ~ZLibCompressor();
 
             virtual int processZStream();
 
-        private:
-            static const int COMPRESSION_LEVEL = 9;
+        protected:
+            virtual size_t getOutputSizeEstimate(size_t inputSize);
     };
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -15,7 +15,7 @@
 
 namespace Swift {
 
-ZLibDecompressor::ZLibDecompressor() {
+ZLibDecompressor::ZLibDecompressor(const ZLibCompressionOptions& options) : dictionary_(options.dictionary) {
     int result = inflateInit(&p->stream);
     assert(result == Z_OK);
     (void) result;
@@ -26,7 +26,14 @@ ZLibDecompressor::~ZLibDecompressor() {
 }
 
 int ZLibDecompressor::processZStream() {
-    return inflate(&p->stream, Z_SYNC_FLUSH);
+    int result = inflate(&p->stream, Z_SYNC_FLUSH);
+    if (result == Z_NEED_DICT && !dictionary_.empty()) {
+        result = inflateSetDictionary(&p->stream, reinterpret_cast<const Bytef*>(dictionary_.data()), static_cast<uInt>(dictionary_.size()));
+        if (result == Z_OK) {
+            result = inflate(&p->stream, Z_SYNC_FLUSH);
+        }
+    }
+    return result;
 }
 
 }
@@ -1,20 +1,26 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #pragma once
 
+#include <string>
+
 #include <Swiften/Base/API.h>
 #include <Swiften/Compress/ZLibCodecompressor.h>
+#include <Swiften/Compress/ZLibCompressionOptions.h>
 
 namespace Swift {
     class SWIFTEN_API ZLibDecompressor : public ZLibCodecompressor {
         public:
-            ZLibDecompressor();
+            ZLibDecompressor(const ZLibCompressionOptions& options = ZLibCompressionOptions());
             virtual ~ZLibDecompressor();
 
             virtual int processZStream();
+
+        private:
+            std::string dictionary_;
     };
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2017 Isode Limited.
+ * Copyright (c) 2013-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -12,6 +12,7 @@
 
 #include <CommonCrypto/CommonDigest.h>
 #include <CommonCrypto/CommonHMAC.h>
+#include <CommonCrypto/CommonKeyDerivation.h>
 
 #include <Swiften/Base/ByteArray.h>
 #include <Swiften/Crypto/Hash.h>
@@ -101,6 +102,125 @@ namespace {
             bool finalized;
     };
 
+    class SHA256Hash : public Hash {
+        public:
+            SHA256Hash() : finalized(false) {
+                if (!CC_SHA256_Init(&context)) {
+                    assert(false);
+                }
+            }
+
+            virtual ~SHA256Hash() override {
+            }
+
+            virtual Hash& update(const ByteArray& data) override {
+                return updateInternal(data);
+            }
+
+            virtual Hash& update(const SafeByteArray& data) override {
+                return updateInternal(data);
+            }
+
+            virtual std::vector<unsigned char> getHash() override {
+                assert(!finalized);
+                std::vector<unsigned char> result(CC_SHA256_DIGEST_LENGTH);
+                CC_SHA256_Final(vecptr(result), &context);
+                return result;
+            }
+
+        private:
+            template<typename ContainerType>
+            Hash& updateInternal(const ContainerType& data) {
+                assert(!finalized);
+                if (!CC_SHA256_Update(&context, vecptr(data), boost::numeric_cast<CC_LONG>(data.size()))) {
+                    assert(false);
+                }
+                return *this;
+            }
+
+        private:
+            CC_SHA256_CTX context;
+            bool finalized;
+    };
+
+    class SHA512Hash : public Hash {
+        public:
+            SHA512Hash() : finalized(false) {
+                if (!CC_SHA512_Init(&context)) {
+                    assert(false);
+                }
+            }
+
+            virtual ~SHA512Hash() override {
+            }
+
+            virtual Hash& update(const ByteArray& data) override {
+                return updateInternal(data);
+            }
+
+            virtual Hash& update(const SafeByteArray& data) override {
+                return updateInternal(data);
+            }
+
+            virtual std::vector<unsigned char> getHash() override {
+                assert(!finalized);
+                std::vector<unsigned char> result(CC_SHA512_DIGEST_LENGTH);
+                CC_SHA512_Final(vecptr(result), &context);
+                return result;
+            }
+
+        private:
+            template<typename ContainerType>
+            Hash& updateInternal(const ContainerType& data) {
+                assert(!finalized);
+                if (!CC_SHA512_Update(&context, vecptr(data), boost::numeric_cast<CC_LONG>(data.size()))) {
+                    assert(false);
+                }
+                return *this;
+            }
+
+        private:
+            CC_SHA512_CTX context;
+            bool finalized;
+    };
+
+    CCHmacAlgorithm getHMACAlgorithm(CryptoProvider::HashAlgorithm algorithm) {
+        switch (algorithm) {
+            case CryptoProvider::HashAlgorithm::SHA1: return kCCHmacAlgSHA1;
+            case CryptoProvider::HashAlgorithm::SHA256: return kCCHmacAlgSHA256;
+            case CryptoProvider::HashAlgorithm::SHA512: return kCCHmacAlgSHA512;
+        }
+        assert(false);
+        return kCCHmacAlgSHA1;
+    }
+
+    CCPseudoRandomAlgorithm getPseudoRandomAlgorithm(CryptoProvider::HashAlgorithm algorithm) {
+        switch (algorithm) {
+            case CryptoProvider::HashAlgorithm::SHA1: return kCCPRFHmacAlgSHA1;
+            case CryptoProvider::HashAlgorithm::SHA256: return kCCPRFHmacAlgSHA256;
+            case CryptoProvider::HashAlgorithm::SHA512: return kCCPRFHmacAlgSHA512;
+        }
+        assert(false);
+        return kCCPRFHmacAlgSHA1;
+    }
+
+    size_t getDigestLength(CryptoProvider::HashAlgorithm algorithm) {
+        switch (algorithm) {
+            case CryptoProvider::HashAlgorithm::SHA1: return CC_SHA1_DIGEST_LENGTH;
+            case CryptoProvider::HashAlgorithm::SHA256: return CC_SHA256_DIGEST_LENGTH;
+            case CryptoProvider::HashAlgorithm::SHA512: return CC_SHA512_DIGEST_LENGTH;
+        }
+        assert(false);
+        return 0;
+    }
+
+    template<typename T>
+    ByteArray getHMACInternal(CryptoProvider::HashAlgorithm algorithm, const T& key, const ByteArray& data) {
+        std::vector<unsigned char> result(getDigestLength(algorithm));
+        CCHmac(getHMACAlgorithm(algorithm), vecptr(key), key.size(), vecptr(data), data.size(), vecptr(result));
+        return result;
+    }
+
     template<typename T>
     ByteArray getHMACSHA1Internal(const T& key, const ByteArray& data) {
         std::vector<unsigned char> result(CC_SHA1_DIGEST_LENGTH);
@@ -135,3 +255,26 @@ bool CommonCryptoCryptoProvider::isMD5AllowedForCrypto() const {
     return true;
 }
 
+Hash* CommonCryptoCryptoProvider::createSHA256() {
+    return new SHA256Hash();
+}
+
+Hash* CommonCryptoCryptoProvider::createSHA512() {
+    return new SHA512Hash();
+}
+
+ByteArray CommonCryptoCryptoProvider::getHMAC(HashAlgorithm algorithm, const SafeByteArray& key, const ByteArray& data) {
+    return getHMACInternal(algorithm, key, data);
+}
+
+ByteArray CommonCryptoCryptoProvider::getHMAC(HashAlgorithm algorithm, const ByteArray& key, const ByteArray& data) {
+    return getHMACInternal(algorithm, key, data);
+}
+
+ByteArray CommonCryptoCryptoProvider::getPBKDF2(HashAlgorithm algorithm, const SafeByteArray& password, const ByteArray& salt, int iterations) {
+    std::vector<unsigned char> result(getDigestLength(algorithm));
+    if (CCKeyDerivationPBKDF(kCCPBKDF2, reinterpret_cast<const char*>(vecptr(password)), password.size(), vecptr(salt), salt.size(), getPseudoRandomAlgorithm(algorithm), boost::numeric_cast<unsigned int>(iterations), vecptr(result), result.size()) != kCCSuccess) {
+        assert(false);
+    }
+    return result;
+}
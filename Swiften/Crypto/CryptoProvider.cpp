@@ -1,14 +1,98 @@
 /*
- * Copyright (c) 2013-2016 Isode Limited.
+ * Copyright (c) 2013-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <Swiften/Crypto/CryptoProvider.h>
 
+#include <cassert>
 #include <memory>
 
+#include <Swiften/Base/Concat.h>
+
 using namespace Swift;
 
+namespace {
+    size_t getBlockSize(CryptoProvider::HashAlgorithm algorithm) {
+        return algorithm == CryptoProvider::HashAlgorithm::SHA512 ? 128 : 64;
+    }
+
+    template<typename T>
+    ByteArray getHMACInternal(CryptoProvider* crypto, CryptoProvider::HashAlgorithm algorithm, const T& key, const ByteArray& data) {
+        size_t blockSize = getBlockSize(algorithm);
+
+        SafeByteArray paddedKey;
+        if (key.size() > blockSize) {
+            paddedKey = createSafeByteArray(crypto->getHash(algorithm, key));
+        }
+        else {
+            paddedKey = SafeByteArray(key.begin(), key.end());
+        }
+        paddedKey.resize(blockSize, 0x0);
+
+        SafeByteArray innerKey(paddedKey);
+        SafeByteArray outerKey(paddedKey);
+        for (size_t i = 0; i < blockSize; ++i) {
+            innerKey[i] ^= 0x36;
+            outerKey[i] ^= 0x5c;
+        }
+
+        std::unique_ptr<Hash> innerHash(crypto->createHash(algorithm));
+        assert(innerHash);
+        ByteArray innerResult = innerHash->update(innerKey).update(data).getHash();
+        std::unique_ptr<Hash> outerHash(crypto->createHash(algorithm));
+        return outerHash->update(outerKey).update(innerResult).getHash();
+    }
+}
+
 CryptoProvider::~CryptoProvider() {
 }
+
+Hash* CryptoProvider::createSHA256() {
+    return nullptr;
+}
+
+Hash* CryptoProvider::createSHA512() {
+    return nullptr;
+}
+
+Hash* CryptoProvider::createHash(HashAlgorithm algorithm) {
+    switch (algorithm) {
+        case HashAlgorithm::SHA1: return createSHA1();
+        case HashAlgorithm::SHA256: return createSHA256();
+        case HashAlgorithm::SHA512: return createSHA512();
+    }
+    assert(false);
+    return nullptr;
+}
+
+bool CryptoProvider::isHashAlgorithmSupported(HashAlgorithm algorithm) {
+    return std::unique_ptr<Hash>(createHash(algorithm)) != nullptr;
+}
+
+ByteArray CryptoProvider::getHMAC(HashAlgorithm algorithm, const SafeByteArray& key, const ByteArray& data) {
+    if (algorithm == HashAlgorithm::SHA1) {
+        return getHMACSHA1(key, data);
+    }
+    return getHMACInternal(this, algorithm, key, data);
+}
+
+ByteArray CryptoProvider::getHMAC(HashAlgorithm algorithm, const ByteArray& key, const ByteArray& data) {
+    if (algorithm == HashAlgorithm::SHA1) {
+        return getHMACSHA1(key, data);
+    }
+    return getHMACInternal(this, algorithm, key, data);
+}
+
+ByteArray CryptoProvider::getPBKDF2(HashAlgorithm algorithm, const SafeByteArray& password, const ByteArray& salt, int iterations) {
+    ByteArray u = getHMAC(algorithm, password, concat(salt, createByteArray("\0\0\0\1", 4)));
+    ByteArray result(u);
+    for (int i = 1; i < iterations; ++i) {
+        u = getHMAC(algorithm, password, u);
+        for (size_t j = 0; j < u.size(); ++j) {
+            result[j] ^= u[j];
+        }
+    }
+    return result;
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2016 Isode Limited.
+ * Copyright (c) 2013-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -15,6 +15,13 @@ namespace Swift {
     class Hash;
 
     class SWIFTEN_API CryptoProvider {
+        public:
+            enum class HashAlgorithm {
+                SHA1,
+                SHA256,
+                SHA512
+            };
+
         public:
             virtual ~CryptoProvider();
 
@@ -24,6 +31,37 @@ namespace Swift {
             virtual ByteArray getHMACSHA1(const ByteArray& key, const ByteArray& data) = 0;
             virtual bool isMD5AllowedForCrypto() const = 0;
 
+            /**
+             * Returns a nullptr if the provider doesn't support SHA-256.
+             */
+            virtual Hash* createSHA256();
+
+            /**
+             * Returns a nullptr if the provider doesn't support SHA-512.
+             */
+            virtual Hash* createSHA512();
+
+            /**
+             * HMAC (RFC 2104) with the given hash algorithm.
+             *
+             * The default implementation builds on the hashes of the provider.
+             * The algorithm has to be supported by the provider.
+             */
+            virtual ByteArray getHMAC(HashAlgorithm algorithm, const SafeByteArray& key, const ByteArray& data);
+            virtual ByteArray getHMAC(HashAlgorithm algorithm, const ByteArray& key, const ByteArray& data);
+
+            /**
+             * PBKDF2 (RFC 2898) with HMAC using the given hash algorithm, producing
+             * a key with the size of the hash.
+             *
+             * The default implementation iterates getHMAC(), providers should
+             * override it with their native implementation where available.
+             */
+            virtual ByteArray getPBKDF2(HashAlgorithm algorithm, const SafeByteArray& password, const ByteArray& salt, int iterations);
+
+            Hash* createHash(HashAlgorithm algorithm);
+            bool isHashAlgorithmSupported(HashAlgorithm algorithm);
+
             // Convenience
             template<typename T> ByteArray getSHA1Hash(const T& data) {
                 return std::shared_ptr<Hash>(createSHA1())->update(data).getHash();
@@ -32,5 +70,9 @@ namespace Swift {
             template<typename T> ByteArray getMD5Hash(const T& data) {
                 return std::shared_ptr<Hash>(createMD5())->update(data).getHash();
             }
+
+            template<typename T> ByteArray getHash(HashAlgorithm algorithm, const T& data) {
+                return std::shared_ptr<Hash>(createHash(algorithm))->update(data).getHash();
+            }
     };
 }
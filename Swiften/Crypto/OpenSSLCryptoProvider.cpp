@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2017 Isode Limited.
+ * Copyright (c) 2013-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -9,6 +9,7 @@
 #include <openssl/sha.h>
 #include <openssl/md5.h>
 #include <openssl/hmac.h>
+#include <openssl/evp.h>
 #include <cassert>
 #include <boost/numeric/conversion/cast.hpp>
 
@@ -102,6 +103,68 @@ namespace {
             bool finalized;
     };
 
+    class EVPHash : public Hash {
+        public:
+            EVPHash(const EVP_MD* digest) : context(EVP_MD_CTX_create()), finalized(false) {
+                if (!EVP_DigestInit_ex(context, digest, nullptr)) {
+                    assert(false);
+                }
+            }
+
+            ~EVPHash() {
+                EVP_MD_CTX_destroy(context);
+            }
+
+            virtual Hash& update(const ByteArray& data) override {
+                return updateInternal(data);
+            }
+
+            virtual Hash& update(const SafeByteArray& data) override {
+                return updateInternal(data);
+            }
+
+            virtual std::vector<unsigned char> getHash() override {
+                assert(!finalized);
+                unsigned int len = EVP_MAX_MD_SIZE;
+                std::vector<unsigned char> result(len);
+                EVP_DigestFinal_ex(context, vecptr(result), &len);
+                result.resize(len);
+                return result;
+            }
+
+        private:
+            template<typename ContainerType>
+            Hash& updateInternal(const ContainerType& data) {
+                assert(!finalized);
+                if (!EVP_DigestUpdate(context, vecptr(data), data.size())) {
+                    assert(false);
+                }
+                return *this;
+            }
+
+        private:
+            EVP_MD_CTX* context;
+            bool finalized;
+    };
+
+    const EVP_MD* getDigest(CryptoProvider::HashAlgorithm algorithm) {
+        switch (algorithm) {
+            case CryptoProvider::HashAlgorithm::SHA1: return EVP_sha1();
+            case CryptoProvider::HashAlgorithm::SHA256: return EVP_sha256();
+            case CryptoProvider::HashAlgorithm::SHA512: return EVP_sha512();
+        }
+        assert(false);
+        return nullptr;
+    }
+
+    template<typename T>
+    ByteArray getHMACInternal(CryptoProvider::HashAlgorithm algorithm, const T& key, const ByteArray& data) {
+        unsigned int len = EVP_MAX_MD_SIZE;
+        std::vector<unsigned char> result(len);
+        HMAC(getDigest(algorithm), vecptr(key), boost::numeric_cast<int>(key.size()), vecptr(data), data.size(), vecptr(result), &len);
+        result.resize(len);
+        return result;
+    }
 
     template<typename T>
     ByteArray getHMACSHA1Internal(const T& key, const ByteArray& data) {
@@ -138,3 +201,28 @@ bool OpenSSLCryptoProvider::isMD5AllowedForCrypto() const {
     return true;
 }
 
+
+Hash* OpenSSLCryptoProvider::createSHA256() {
+    return new EVPHash(EVP_sha256());
+}
+
+Hash* OpenSSLCryptoProvider::createSHA512() {
+    return new EVPHash(EVP_sha512());
+}
+
+ByteArray OpenSSLCryptoProvider::getHMAC(HashAlgorithm algorithm, const SafeByteArray& key, const ByteArray& data) {
+    return getHMACInternal(algorithm, key, data);
+}
+
+ByteArray OpenSSLCryptoProvider::getHMAC(HashAlgorithm algorithm, const ByteArray& key, const ByteArray& data) {
+    return getHMACInternal(algorithm, key, data);
+}
+
+ByteArray OpenSSLCryptoProvider::getPBKDF2(HashAlgorithm algorithm, const SafeByteArray& password, const ByteArray& salt, int iterations) {
+    const EVP_MD* digest = getDigest(algorithm);
+    std::vector<unsigned char> result(boost::numeric_cast<size_t>(EVP_MD_size(digest)));
+    if (!PKCS5_PBKDF2_HMAC(reinterpret_cast<const char*>(vecptr(password)), boost::numeric_cast<int>(password.size()), vecptr(salt), boost::numeric_cast<int>(salt.size()), iterations, digest, boost::numeric_cast<int>(result.size()), vecptr(result))) {
+        assert(false);
+    }
+    return result;
+}
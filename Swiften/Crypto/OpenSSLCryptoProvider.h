@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2017 Isode Limited.
+ * Copyright (c) 2013-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -19,5 +19,10 @@ namespace Swift {
             virtual ByteArray getHMACSHA1(const SafeByteArray& key, const ByteArray& data) override;
             virtual ByteArray getHMACSHA1(const ByteArray& key, const ByteArray& data) override;
             virtual bool isMD5AllowedForCrypto() const override;
+            virtual Hash* createSHA256() override;
+            virtual Hash* createSHA512() override;
+            virtual ByteArray getHMAC(HashAlgorithm algorithm, const SafeByteArray& key, const ByteArray& data) override;
+            virtual ByteArray getHMAC(HashAlgorithm algorithm, const ByteArray& key, const ByteArray& data) override;
+            virtual ByteArray getPBKDF2(HashAlgorithm algorithm, const SafeByteArray& password, const ByteArray& salt, int iterations) override;
     };
 }
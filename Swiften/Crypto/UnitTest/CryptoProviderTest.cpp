@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -21,6 +21,7 @@
 #include <Swiften/Crypto/CommonCryptoCryptoProvider.h>
 #endif
 #include <Swiften/Crypto/Hash.h>
+#include <Swiften/StringCodecs/Hexify.h>
 
 using namespace Swift;
 
@@ -42,6 +43,17 @@ class CryptoProviderTest : public CppUnit::TestFixture {
         CPPUNIT_TEST(testGetHMACSHA1);
         CPPUNIT_TEST(testGetHMACSHA1_KeyLongerThanBlockSize);
 
+        CPPUNIT_TEST(testGetSHA256Hash);
+        CPPUNIT_TEST(testGetSHA512Hash);
+        CPPUNIT_TEST(testGetHMACSHA256);
+        CPPUNIT_TEST(testGetHMACSHA256_KeyLongerThanBlockSize);
+        CPPUNIT_TEST(testGetHMACSHA512);
+        CPPUNIT_TEST(testGetHMACSHA512_KeyLongerThanBlockSize);
+
+        CPPUNIT_TEST(testGetPBKDF2SHA1);
+        CPPUNIT_TEST(testGetPBKDF2SHA256);
+        CPPUNIT_TEST(testGetPBKDF2SHA512);
+
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -141,6 +153,89 @@ class CryptoProviderTest : public CppUnit::TestFixture {
             CPPUNIT_ASSERT_EQUAL(createByteArray("\xd6""n""\x8f""P|1""\xd3"",""\x6"" ""\xb9\xe3""gg""\x8e\xcf"" ]+""\xa"), result);
         }
 
+
+        ////////////////////////////////////////////////////////////
+        // SHA-256/SHA-512
+        ////////////////////////////////////////////////////////////
+
+        void testGetSHA256Hash() {
+            if (!provider->isHashAlgorithmSupported(CryptoProvider::HashAlgorithm::SHA256)) {
+                return;
+            }
+            ByteArray result(provider->getHash(CryptoProvider::HashAlgorithm::SHA256, createByteArray("abc")));
+
+            CPPUNIT_ASSERT_EQUAL(std::string("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"), Hexify::hexify(result));
+        }
+
+        void testGetSHA512Hash() {
+            if (!provider->isHashAlgorithmSupported(CryptoProvider::HashAlgorithm::SHA512)) {
+                return;
+            }
+            ByteArray result(provider->getHash(CryptoProvider::HashAlgorithm::SHA512, createByteArray("abc")));
+
+            CPPUNIT_ASSERT_EQUAL(std::string("ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f"), Hexify::hexify(result));
+        }
+
+
+        ////////////////////////////////////////////////////////////
+        // HMAC-SHA-256/HMAC-SHA-512
+        //
+        // Both the provider's implementation and the generic one of
+        // CryptoProvider are checked.
+        ////////////////////////////////////////////////////////////
+
+        void testGetHMACSHA256() {
+            checkHMAC(CryptoProvider::HashAlgorithm::SHA256, createSafeByteArray("Jefe"), "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+        }
+
+        void testGetHMACSHA256_KeyLongerThanBlockSize() {
+            checkHMAC(CryptoProvider::HashAlgorithm::SHA256, SafeByteArray(131, 0xaa), "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54");
+        }
+
+        void testGetHMACSHA512() {
+            checkHMAC(CryptoProvider::HashAlgorithm::SHA512, createSafeByteArray("Jefe"), "164b7a7bfcf819e2e395fbe73b56e0a387bd64222e831fd610270cd7ea2505549758bf75c05a994a6d034f65f8f0e6fdcaeab1a34d4a6b4b636e070a38bce737");
+        }
+
+        void testGetHMACSHA512_KeyLongerThanBlockSize() {
+            checkHMAC(CryptoProvider::HashAlgorithm::SHA512, SafeByteArray(131, 0xaa), "80b24263c7c1a3ebb71493c1dd7be8b49b46d1f41b4aeec1121b013783f8f3526b56d037e05f2598bd0fd2215d6a1e5295e64f73f63f0aec8b915a985d786598");
+        }
+
+
+        ////////////////////////////////////////////////////////////
+        // PBKDF2
+        ////////////////////////////////////////////////////////////
+
+        void testGetPBKDF2SHA1() {
+            checkPBKDF2(CryptoProvider::HashAlgorithm::SHA1, 4096, "4b007901b765489abead49d926f721d065a429c1");
+        }
+
+        void testGetPBKDF2SHA256() {
+            checkPBKDF2(CryptoProvider::HashAlgorithm::SHA256, 4096, "c5e478d59288c841aa530db6845c4c8d962893a001ce4e11a4963873aa98134a");
+        }
+
+        void testGetPBKDF2SHA512() {
+            checkPBKDF2(CryptoProvider::HashAlgorithm::SHA512, 2, "e1d9c16aa681708a45f5c7c4e215ceb66e011a2e9f0040713f18aefdb866d53cf76cab2868a39b9f7840edce4fef5a82be67335c77a6068e04112754f27ccf4e");
+        }
+
+    private:
+        void checkHMAC(CryptoProvider::HashAlgorithm algorithm, const SafeByteArray& key, const std::string& expected) {
+            if (!provider->isHashAlgorithmSupported(algorithm)) {
+                return;
+            }
+            ByteArray data = createByteArray(key.size() > 100 ? "Test Using Larger Than Block-Size Key - Hash Key First" : "what do ya want for nothing?");
+            CPPUNIT_ASSERT_EQUAL(expected, Hexify::hexify(provider->getHMAC(algorithm, key, data)));
+            CPPUNIT_ASSERT_EQUAL(expected, Hexify::hexify(provider->getHMAC(algorithm, ByteArray(key.begin(), key.end()), data)));
+            CPPUNIT_ASSERT_EQUAL(expected, Hexify::hexify(provider->CryptoProvider::getHMAC(algorithm, key, data)));
+        }
+
+        void checkPBKDF2(CryptoProvider::HashAlgorithm algorithm, int iterations, const std::string& expected) {
+            if (!provider->isHashAlgorithmSupported(algorithm)) {
+                return;
+            }
+            CPPUNIT_ASSERT_EQUAL(expected, Hexify::hexify(provider->getPBKDF2(algorithm, createSafeByteArray("password"), createByteArray("salt"), iterations)));
+            CPPUNIT_ASSERT_EQUAL(expected, Hexify::hexify(provider->CryptoProvider::getPBKDF2(algorithm, createSafeByteArray("password"), createByteArray("salt"), iterations)));
+        }
+
     private:
         CryptoProviderType* provider;
 };
@@ -14,6 +14,8 @@
 
 namespace Swift {
     class SWIFTEN_API BlockListPayload : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(BlockListPayload)
+
         public:
             BlockListPayload(const std::vector<JID>& items = std::vector<JID>()) : items(items) {
             }
@@ -14,6 +14,8 @@
 
 namespace Swift {
     class SWIFTEN_API BlockPayload : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(BlockPayload)
+
         public:
             BlockPayload(const std::vector<JID>& jids = std::vector<JID>()) : items(jids) {
             }
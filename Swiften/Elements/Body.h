@@ -13,6 +13,8 @@
 
 namespace Swift {
     class SWIFTEN_API Body : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(Body)
+
         public:
             Body(const std::string& text = "") : text_(text) {
             }
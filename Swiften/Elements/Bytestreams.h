@@ -18,6 +18,8 @@
 
 namespace Swift {
     class SWIFTEN_API Bytestreams : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(Bytestreams)
+
         public:
             typedef std::shared_ptr<Bytestreams> ref;
 
@@ -14,6 +14,8 @@
 
 namespace Swift {
     class SWIFTEN_API CapsInfo : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(CapsInfo)
+
         public:
             typedef std::shared_ptr<CapsInfo> ref;
 
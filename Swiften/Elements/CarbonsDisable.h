@@ -13,6 +13,8 @@
 
 namespace Swift {
     class SWIFTEN_API CarbonsDisable : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(CarbonsDisable)
+
         public:
             typedef std::shared_ptr<CarbonsDisable> ref;
 
@@ -13,6 +13,8 @@
 
 namespace Swift {
     class SWIFTEN_API CarbonsEnable : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(CarbonsEnable)
+
         public:
             typedef std::shared_ptr<CarbonsEnable> ref;
 
@@ -13,6 +13,8 @@
 
 namespace Swift {
     class SWIFTEN_API CarbonsPrivate : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(CarbonsPrivate)
+
         public:
             typedef std::shared_ptr<CarbonsPrivate> ref;
 
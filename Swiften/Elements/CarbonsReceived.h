@@ -14,6 +14,8 @@
 
 namespace Swift {
     class SWIFTEN_API CarbonsReceived : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(CarbonsReceived)
+
         public:
             typedef std::shared_ptr<CarbonsReceived> ref;
 
@@ -14,6 +14,8 @@
 
 namespace Swift {
     class SWIFTEN_API CarbonsSent : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(CarbonsSent)
+
         public:
             typedef std::shared_ptr<CarbonsSent> ref;
 
@@ -13,6 +13,8 @@
 
 namespace Swift {
     class SWIFTEN_API ChatState : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(ChatState)
+
         public:
             typedef std::shared_ptr<ChatState> ref;
 
@@ -13,6 +13,8 @@
 
 namespace Swift {
     class SWIFTEN_API ClientState : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(ClientState)
+
         public:
             typedef std::shared_ptr<ClientState> ref;
 
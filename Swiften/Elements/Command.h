@@ -18,6 +18,8 @@ namespace Swift {
      * Ad-Hoc Command (XEP-0050).
      */
     class SWIFTEN_API Command : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(Command)
+
         public:
             typedef std::shared_ptr<Command> ref;
 
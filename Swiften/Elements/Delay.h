@@ -15,6 +15,8 @@
 
 namespace Swift {
     class SWIFTEN_API Delay : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(Delay)
+
         public:
             Delay() {}
             Delay(const boost::posix_time::ptime& time, const JID& from = JID()) : time_(time), from_(from) {}
@@ -20,6 +20,8 @@
 namespace Swift {
 
 class SWIFTEN_API DeliveryReceipt : public Payload {
+        SWIFTEN_PAYLOAD_TYPE_TAG(DeliveryReceipt)
+
     public:
         typedef std::shared_ptr<DeliveryReceipt> ref;
 
@@ -18,6 +18,8 @@
 namespace Swift {
 
 class SWIFTEN_API DeliveryReceiptRequest : public Payload {
+        SWIFTEN_PAYLOAD_TYPE_TAG(DeliveryReceiptRequest)
+
     public:
         typedef std::shared_ptr<DeliveryReceiptRequest> ref;
 
@@ -18,6 +18,8 @@ namespace Swift {
      * disco#info from XEP-0030
      */
     class SWIFTEN_API DiscoInfo : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(DiscoInfo)
+
         public:
             typedef std::shared_ptr<DiscoInfo> ref;
 
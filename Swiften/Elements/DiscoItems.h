@@ -18,6 +18,8 @@ namespace Swift {
      * Service discovery disco#items from XEP-0030.
      */
     class SWIFTEN_API DiscoItems : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(DiscoItems)
+
         public:
             /**
              * A single result item.
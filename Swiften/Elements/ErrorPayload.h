@@ -14,6 +14,8 @@
 
 namespace Swift {
     class SWIFTEN_API ErrorPayload : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(ErrorPayload)
+
         public:
             typedef std::shared_ptr<ErrorPayload> ref;
 
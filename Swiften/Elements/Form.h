@@ -24,6 +24,8 @@ namespace Swift {
      * the strange multi-value instead of newline thing by transforming them.
      */
     class SWIFTEN_API Form : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(Form)
+
         public:
             typedef std::shared_ptr<Form> ref;
             typedef std::vector<FormField::ref> FormItem;
@@ -16,6 +16,8 @@ namespace Swift {
     class Stanza;
 
     class SWIFTEN_API Forwarded : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(Forwarded)
+
         public:
             typedef std::shared_ptr<Forwarded> ref;
 
@@ -15,6 +15,8 @@
 
 namespace Swift {
     class SWIFTEN_API IBB : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(IBB)
+
         public:
             typedef std::shared_ptr<IBB> ref;
 
@@ -22,6 +22,8 @@
 namespace Swift {
 
     class SWIFTEN_API Idle : public Payload {
+    SWIFTEN_PAYLOAD_TYPE_TAG(Idle)
+
     public:
         typedef std::shared_ptr<Idle> ref;
 
@@ -17,6 +17,8 @@
 
 namespace Swift {
     class SWIFTEN_API InBandRegistrationPayload : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(InBandRegistrationPayload)
+
         public:
             typedef std::shared_ptr<InBandRegistrationPayload> ref;
 
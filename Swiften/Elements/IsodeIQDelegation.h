@@ -14,6 +14,8 @@
 
 namespace Swift {
     class SWIFTEN_API IsodeIQDelegation : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(IsodeIQDelegation)
+
         public:
 
             IsodeIQDelegation();
@@ -19,6 +19,8 @@
 
 namespace Swift {
     class SWIFTEN_API JingleContentPayload : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(JingleContentPayload)
+
         public:
             typedef std::shared_ptr<JingleContentPayload> ref;
 
@@ -15,6 +15,8 @@
 
 namespace Swift {
     class SWIFTEN_API JingleFileTransferDescription : public JingleDescription {
+            SWIFTEN_PAYLOAD_TYPE_TAG(JingleFileTransferDescription)
+
         public:
             typedef std::shared_ptr<JingleFileTransferDescription> ref;
 
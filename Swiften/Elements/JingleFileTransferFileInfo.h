@@ -26,6 +26,8 @@ namespace Swift {
     class SWIFTEN_API JingleFileTransferFileInfo : public Payload {
         typedef std::shared_ptr<JingleFileTransferFileInfo> ref;
 
+            SWIFTEN_PAYLOAD_TYPE_TAG(JingleFileTransferFileInfo)
+
         public:
             JingleFileTransferFileInfo(const std::string& name = "", const std::string& description = "", unsigned long long size = 0, const boost::posix_time::ptime &date = boost::posix_time::ptime()) :
                 name_(name), description_(description), size_(size), date_(date), supportsRangeRequests_(false), rangeOffset_(0) {
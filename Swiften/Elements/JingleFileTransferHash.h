@@ -23,6 +23,8 @@
 namespace Swift {
 
 class SWIFTEN_API JingleFileTransferHash : public Payload {
+SWIFTEN_PAYLOAD_TYPE_TAG(JingleFileTransferHash)
+
 public:
     typedef std::shared_ptr<JingleFileTransferHash> ref;
 
@@ -16,6 +16,8 @@
 
 namespace Swift {
     class SWIFTEN_API JingleIBBTransportPayload : public JingleTransportPayload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(JingleIBBTransportPayload)
+
         public:
             typedef std::shared_ptr<JingleIBBTransportPayload> ref;
 
@@ -19,6 +19,8 @@
 
 namespace Swift {
     class SWIFTEN_API JinglePayload : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(JinglePayload)
+
         public:
             typedef std::shared_ptr<JinglePayload> ref;
             struct Reason : public Payload {
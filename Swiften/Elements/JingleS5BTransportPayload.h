@@ -16,6 +16,8 @@
 
 namespace Swift {
     class SWIFTEN_API JingleS5BTransportPayload : public JingleTransportPayload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(JingleS5BTransportPayload)
+
         public:
             enum Mode {
                 TCPMode, // default case
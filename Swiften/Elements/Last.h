@@ -11,6 +11,8 @@
 
 namespace Swift {
     class SWIFTEN_API Last : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(Last)
+
         public:
             Last(int seconds = 0) : seconds_(seconds) {}
 
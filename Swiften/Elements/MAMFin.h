@@ -17,6 +17,8 @@
 
 namespace Swift {
     class SWIFTEN_API MAMFin : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(MAMFin)
+
         public:
             MAMFin() : isComplete_(false), isStable_(true) {}
             virtual ~MAMFin();
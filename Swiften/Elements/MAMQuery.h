@@ -18,6 +18,8 @@
 
 namespace Swift {
     class SWIFTEN_API MAMQuery : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(MAMQuery)
+
         public:
             virtual ~MAMQuery();
 
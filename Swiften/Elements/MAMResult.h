@@ -16,6 +16,8 @@
 
 namespace Swift {
     class SWIFTEN_API MAMResult : public ContainerPayload<Forwarded> {
+            SWIFTEN_PAYLOAD_TYPE_TAG(MAMResult)
+
         public:
             virtual ~MAMResult();
 
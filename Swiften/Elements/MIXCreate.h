@@ -16,6 +16,8 @@
 
 namespace Swift {
     class SWIFTEN_API MIXCreate : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(MIXCreate)
+
         public:
             using ref = std::shared_ptr<MIXCreate>;
 
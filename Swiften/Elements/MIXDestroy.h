@@ -14,6 +14,8 @@
 
 namespace Swift {
     class SWIFTEN_API MIXDestroy : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(MIXDestroy)
+
         public:
             using ref = std::shared_ptr<MIXDestroy>;
 
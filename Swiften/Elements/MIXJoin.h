@@ -20,6 +20,8 @@
 namespace Swift {
     class SWIFTEN_API MIXJoin : public Payload {
 
+            SWIFTEN_PAYLOAD_TYPE_TAG(MIXJoin)
+
         public:
             using ref = std::shared_ptr<MIXJoin>;
 
@@ -16,6 +16,8 @@
 
 namespace Swift {
     class SWIFTEN_API MIXLeave : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(MIXLeave)
+
         public:
             using ref = std::shared_ptr<MIXLeave>;
 
@@ -17,6 +17,8 @@
 
 namespace Swift {
     class SWIFTEN_API MIXParticipant : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(MIXParticipant)
+
         public:
             using ref = std::shared_ptr<MIXParticipant>;
 
@@ -17,6 +17,8 @@
 
 namespace Swift {
     class SWIFTEN_API MIXPayload : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(MIXPayload)
+
         public:
             using ref = std::shared_ptr<MIXPayload>;
 
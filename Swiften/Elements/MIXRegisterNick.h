@@ -14,6 +14,8 @@
 
 namespace Swift {
     class SWIFTEN_API MIXRegisterNick : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(MIXRegisterNick)
+
         public:
             using ref = std::shared_ptr<MIXRegisterNick>;
 
@@ -14,6 +14,8 @@
 
 namespace Swift {
     class SWIFTEN_API MIXSetNick : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(MIXSetNick)
+
         public:
             using ref = std::shared_ptr<MIXSetNick>;
 
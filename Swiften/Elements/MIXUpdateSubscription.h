@@ -18,6 +18,8 @@
 namespace Swift {
     class SWIFTEN_API MIXUpdateSubscription : public Payload {
 
+            SWIFTEN_PAYLOAD_TYPE_TAG(MIXUpdateSubscription)
+
         public:
             using ref = std::shared_ptr<MIXUpdateSubscription>;
 
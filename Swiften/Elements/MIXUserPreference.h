@@ -14,6 +14,8 @@
 
 namespace Swift {
     class SWIFTEN_API MIXUserPreference : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(MIXUserPreference)
+
         public:
             using ref = std::shared_ptr<MIXUserPreference>;
 
@@ -20,6 +20,8 @@
 
 namespace Swift {
     class SWIFTEN_API MUCAdminPayload : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(MUCAdminPayload)
+
         public:
             typedef std::shared_ptr<MUCAdminPayload> ref;
 
@@ -14,6 +14,8 @@
 
 namespace Swift {
     class SWIFTEN_API MUCDestroyPayload : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(MUCDestroyPayload)
+
         public:
             typedef std::shared_ptr<MUCDestroyPayload> ref;
 
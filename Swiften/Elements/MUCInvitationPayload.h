@@ -14,6 +14,8 @@
 
 namespace Swift {
     class SWIFTEN_API MUCInvitationPayload : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(MUCInvitationPayload)
+
         public:
             typedef std::shared_ptr<MUCInvitationPayload> ref;
             MUCInvitationPayload() : continuation_(false), impromptu_(false) {
@@ -14,6 +14,8 @@
 
 namespace Swift {
     class SWIFTEN_API MUCOwnerPayload : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(MUCOwnerPayload)
+
         public:
             typedef std::shared_ptr<MUCOwnerPayload> ref;
 
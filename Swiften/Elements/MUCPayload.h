@@ -17,6 +17,8 @@
 
 namespace Swift {
     class SWIFTEN_API MUCPayload : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(MUCPayload)
+
         public:
             typedef std::shared_ptr<MUCPayload> ref;
 
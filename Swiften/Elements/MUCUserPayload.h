@@ -20,6 +20,8 @@
 
 namespace Swift {
     class SWIFTEN_API MUCUserPayload : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(MUCUserPayload)
+
         public:
             typedef std::shared_ptr<MUCUserPayload> ref;
 
@@ -13,6 +13,8 @@
 
 namespace Swift {
     class SWIFTEN_API Nickname : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(Nickname)
+
         public:
             Nickname(const std::string& nickname = "") : nickname(nickname) {
             }
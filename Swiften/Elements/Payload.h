@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -7,19 +7,69 @@
 #pragma once
 
 #include <memory>
+#include <type_traits>
 
 #include <Swiften/Base/API.h>
 #include <Swiften/Elements/Element.h>
 
+/**
+ * Declares a type tag for a payload class, so that Stanza can look up
+ * payloads of that class by comparing tags instead of using RTTI.
+ *
+ * Payloads of a class deriving from the declaring class get its tag too, so
+ * only declare a tag in classes that no other tagged class derives from.
+ */
+#define SWIFTEN_PAYLOAD_TYPE_TAG(cls) \
+    public: \
+        typedef cls TypeTagOwner; \
+        static Swift::Payload::TypeTag getStaticTypeTag() { \
+            static const char tag = 0; \
+            return &tag; \
+        } \
+        virtual Swift::Payload::TypeTag getTypeTag() const { \
+            return getStaticTypeTag(); \
+        }
+
 namespace Swift {
     class SWIFTEN_API Payload : public Element {
         public:
             typedef std::shared_ptr<Payload> ref;
+            typedef const void* TypeTag;
         public:
             Payload() {}
             SWIFTEN_DEFAULT_COPY_CONSTRUCTOR(Payload)
             virtual ~Payload();
 
             SWIFTEN_DEFAULT_COPY_ASSIGMNENT_OPERATOR(Payload)
+
+            /**
+             * Returns the tag of the class of this payload, or nullptr if
+             * none of its classes declares one.
+             */
+            virtual TypeTag getTypeTag() const;
+
+            /**
+             * Returns the tag declared by T itself, or nullptr if T doesn't
+             * declare one.
+             */
+            template<typename T>
+            static TypeTag getTypeTagOf() {
+                return TypeTagOf<T>::get();
+            }
+
+        private:
+            template<typename T, typename Enable = void>
+            struct TypeTagOf {
+                static TypeTag get() {
+                    return nullptr;
+                }
+            };
+
+            template<typename T>
+            struct TypeTagOf<T, typename std::enable_if<std::is_same<typename T::TypeTagOwner, T>::value>::type> {
+                static TypeTag get() {
+                    return T::getStaticTypeTag();
+                }
+            };
     };
 }
@@ -11,6 +11,8 @@
 
 namespace Swift {
     class SWIFTEN_API Priority : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(Priority)
+
         public:
             Priority(int priority = 0) : priority_(priority) {
             }
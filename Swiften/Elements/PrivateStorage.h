@@ -13,6 +13,8 @@
 
 namespace Swift {
     class SWIFTEN_API PrivateStorage : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PrivateStorage)
+
         public:
             PrivateStorage(std::shared_ptr<Payload> payload = std::shared_ptr<Payload>()) : payload(payload) {
             }
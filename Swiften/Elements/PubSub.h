@@ -12,6 +12,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSub : public ContainerPayload<PubSubPayload> {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSub)
+
         public:
             PubSub();
             virtual ~PubSub();
@@ -13,6 +13,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubAffiliation : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubAffiliation)
+
         public:
             enum Type {
                 None,
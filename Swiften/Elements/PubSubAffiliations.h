@@ -19,6 +19,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubAffiliations : public PubSubPayload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubAffiliations)
+
         public:
 
             PubSubAffiliations();
@@ -14,6 +14,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubConfigure : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubConfigure)
+
         public:
 
             PubSubConfigure();
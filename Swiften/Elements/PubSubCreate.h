@@ -16,6 +16,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubCreate : public PubSubPayload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubCreate)
+
         public:
 
             PubSubCreate();
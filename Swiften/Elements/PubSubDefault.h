@@ -16,6 +16,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubDefault : public PubSubPayload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubDefault)
+
         public:
             enum Type {
                 None,
@@ -10,6 +10,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubError : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubError)
+
         public:
             enum Type {
                 UnknownType = 0,
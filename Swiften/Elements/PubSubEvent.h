@@ -15,6 +15,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubEvent : public ContainerPayload<PubSubEventPayload> {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubEvent)
+
         public:
             PubSubEvent();
             virtual ~PubSubEvent();
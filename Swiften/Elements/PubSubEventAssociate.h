@@ -13,6 +13,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubEventAssociate : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubEventAssociate)
+
         public:
 
             PubSubEventAssociate();
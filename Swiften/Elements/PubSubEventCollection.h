@@ -19,6 +19,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubEventCollection : public PubSubEventPayload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubEventCollection)
+
         public:
 
             PubSubEventCollection();
@@ -16,6 +16,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubEventConfiguration : public PubSubEventPayload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubEventConfiguration)
+
         public:
 
             PubSubEventConfiguration();
@@ -16,6 +16,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubEventDelete : public PubSubEventPayload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubEventDelete)
+
         public:
 
             PubSubEventDelete();
@@ -13,6 +13,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubEventDisassociate : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubEventDisassociate)
+
         public:
 
             PubSubEventDisassociate();
@@ -17,6 +17,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubEventItem : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubEventItem)
+
         public:
 
             PubSubEventItem();
@@ -18,6 +18,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubEventItems : public PubSubEventPayload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubEventItems)
+
         public:
 
             PubSubEventItems();
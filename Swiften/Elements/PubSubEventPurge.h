@@ -14,6 +14,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubEventPurge : public PubSubEventPayload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubEventPurge)
+
         public:
 
             PubSubEventPurge();
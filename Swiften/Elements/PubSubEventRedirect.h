@@ -13,6 +13,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubEventRedirect : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubEventRedirect)
+
         public:
 
             PubSubEventRedirect();
@@ -13,6 +13,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubEventRetract : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubEventRetract)
+
         public:
 
             PubSubEventRetract();
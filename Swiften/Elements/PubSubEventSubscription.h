@@ -18,6 +18,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubEventSubscription : public PubSubEventPayload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubEventSubscription)
+
         public:
             enum SubscriptionType {
                 None,
@@ -15,6 +15,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubItem : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubItem)
+
         public:
 
             PubSubItem();
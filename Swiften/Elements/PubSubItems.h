@@ -19,6 +19,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubItems : public PubSubPayload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubItems)
+
         public:
 
             PubSubItems();
@@ -19,6 +19,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubOptions : public PubSubPayload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubOptions)
+
         public:
 
             PubSubOptions();
@@ -12,6 +12,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubOwnerAffiliation : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubOwnerAffiliation)
+
         public:
             enum Type {
                 None,
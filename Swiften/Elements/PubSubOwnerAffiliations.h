@@ -17,6 +17,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubOwnerAffiliations : public PubSubOwnerPayload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubOwnerAffiliations)
+
         public:
 
             PubSubOwnerAffiliations();
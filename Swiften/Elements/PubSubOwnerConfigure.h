@@ -18,6 +18,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubOwnerConfigure : public PubSubOwnerPayload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubOwnerConfigure)
+
         public:
 
             PubSubOwnerConfigure();
@@ -15,6 +15,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubOwnerDefault : public PubSubOwnerPayload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubOwnerDefault)
+
         public:
 
             PubSubOwnerDefault();
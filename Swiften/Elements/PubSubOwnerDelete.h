@@ -16,6 +16,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubOwnerDelete : public PubSubOwnerPayload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubOwnerDelete)
+
         public:
 
             PubSubOwnerDelete();
@@ -12,6 +12,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubOwnerPubSub : public ContainerPayload<PubSubOwnerPayload> {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubOwnerPubSub)
+
         public:
             PubSubOwnerPubSub();
             virtual ~PubSubOwnerPubSub();
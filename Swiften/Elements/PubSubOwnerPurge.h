@@ -14,6 +14,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubOwnerPurge : public PubSubOwnerPayload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubOwnerPurge)
+
         public:
 
             PubSubOwnerPurge();
@@ -13,6 +13,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubOwnerRedirect : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubOwnerRedirect)
+
         public:
 
             PubSubOwnerRedirect();
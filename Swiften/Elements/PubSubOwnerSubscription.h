@@ -12,6 +12,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubOwnerSubscription : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubOwnerSubscription)
+
         public:
             enum SubscriptionType {
                 None,
@@ -17,6 +17,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubOwnerSubscriptions : public PubSubOwnerPayload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubOwnerSubscriptions)
+
         public:
 
             PubSubOwnerSubscriptions();
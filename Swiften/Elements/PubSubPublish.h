@@ -17,6 +17,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubPublish : public PubSubPayload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubPublish)
+
         public:
 
             PubSubPublish();
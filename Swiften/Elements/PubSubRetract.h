@@ -19,6 +19,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubRetract : public PubSubPayload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubRetract)
+
         public:
 
             PubSubRetract();
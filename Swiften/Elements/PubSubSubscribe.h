@@ -19,6 +19,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubSubscribe : public PubSubPayload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubSubscribe)
+
         public:
 
             PubSubSubscribe();
@@ -11,6 +11,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubSubscribeOptions : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubSubscribeOptions)
+
         public:
 
             PubSubSubscribeOptions();
@@ -19,6 +19,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubSubscription : public PubSubPayload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubSubscription)
+
         public:
             enum SubscriptionType {
                 None,
@@ -19,6 +19,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubSubscriptions : public PubSubPayload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubSubscriptions)
+
         public:
 
             PubSubSubscriptions();
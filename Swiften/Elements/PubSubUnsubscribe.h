@@ -17,6 +17,8 @@
 
 namespace Swift {
     class SWIFTEN_API PubSubUnsubscribe : public PubSubPayload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(PubSubUnsubscribe)
+
         public:
 
             PubSubUnsubscribe();
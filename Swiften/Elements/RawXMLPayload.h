@@ -13,6 +13,8 @@
 
 namespace Swift {
     class SWIFTEN_API RawXMLPayload : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(RawXMLPayload)
+
         public:
             RawXMLPayload(const std::string& data = "") : rawXML_(data) {}
 
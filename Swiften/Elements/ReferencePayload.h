@@ -20,6 +20,8 @@ namespace Swift {
      */
     class SWIFTEN_API ReferencePayload : public Payload {
 
+    SWIFTEN_PAYLOAD_TYPE_TAG(ReferencePayload)
+
     public:
 
         typedef std::shared_ptr<ReferencePayload> ref;
@@ -20,6 +20,8 @@
 
 namespace Swift {
     class SWIFTEN_API Replace : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(Replace)
+
         public:
             typedef std::shared_ptr<Replace> ref;
             Replace(const std::string& id = std::string()) : replaceID_(id) {}
@@ -14,6 +14,8 @@
 
 namespace Swift {
     class SWIFTEN_API ResourceBind : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(ResourceBind)
+
         public:
             ResourceBind() {}
 
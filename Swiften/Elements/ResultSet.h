@@ -15,6 +15,8 @@
 
 namespace Swift {
     class SWIFTEN_API ResultSet : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(ResultSet)
+
         public:
             virtual ~ResultSet();
 
@@ -22,6 +22,8 @@
 
 namespace Swift {
     class SWIFTEN_API RosterItemExchangePayload : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(RosterItemExchangePayload)
+
         public:
             typedef std::shared_ptr<RosterItemExchangePayload> ref;
 
@@ -17,6 +17,8 @@
 
 namespace Swift {
     class SWIFTEN_API RosterPayload : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(RosterPayload)
+
         public:
             typedef std::shared_ptr<RosterPayload> ref;
             typedef std::vector<RosterItemPayload> RosterItemPayloads;
@@ -24,6 +24,8 @@
 namespace Swift {
 
 class SWIFTEN_API S5BProxyRequest : public Payload {
+SWIFTEN_PAYLOAD_TYPE_TAG(S5BProxyRequest)
+
 public:
     typedef std::shared_ptr<S5BProxyRequest> ref;
 
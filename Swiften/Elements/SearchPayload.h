@@ -20,6 +20,8 @@ namespace Swift {
      * XEP-0055 search payload.
      */
     class SWIFTEN_API SearchPayload : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(SearchPayload)
+
         public:
             typedef std::shared_ptr<SearchPayload> ref;
 
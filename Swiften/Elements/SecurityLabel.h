@@ -14,6 +14,8 @@
 
 namespace Swift {
     class SWIFTEN_API SecurityLabel : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(SecurityLabel)
+
         public:
             using ref = std::shared_ptr<SecurityLabel>;
 
@@ -17,6 +17,8 @@
 
 namespace Swift {
     class SWIFTEN_API SecurityLabelsCatalog : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(SecurityLabelsCatalog)
+
         public:
             typedef std::shared_ptr<SecurityLabelsCatalog> ref;
             class Item {
@@ -14,6 +14,8 @@
 
 namespace Swift {
     class SWIFTEN_API SoftwareVersion : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(SoftwareVersion)
+
         public:
             typedef std::shared_ptr<SoftwareVersion> ref;
 
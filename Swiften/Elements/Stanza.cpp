@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -24,11 +24,11 @@ Stanza::~Stanza() {
 void Stanza::updatePayload(std::shared_ptr<Payload> payload) {
     for (auto&& i : payloads_) {
         if (typeid(*i.get()) == typeid(*payload.get())) {
-            i = payload;
+            i = std::move(payload);
             return;
         }
     }
-    addPayload(payload);
+    addPayload(std::move(payload));
 }
 
 static bool sameType(std::shared_ptr<Payload> a, std::shared_ptr<Payload> b) {
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -8,18 +8,18 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <boost/date_time/posix_time/ptime.hpp>
 #include <boost/optional/optional.hpp>
 
 #include <Swiften/Base/API.h>
+#include <Swiften/Elements/Payload.h>
 #include <Swiften/Elements/ToplevelElement.h>
 #include <Swiften/JID/JID.h>
 
 namespace Swift {
-    class Payload;
-
     class SWIFTEN_API Stanza : public ToplevelElement {
         public:
             typedef std::shared_ptr<Stanza> ref;
@@ -33,8 +33,9 @@ namespace Swift {
 
             template<typename T>
             std::shared_ptr<T> getPayload() const {
+                const Payload::TypeTag tag = Payload::getTypeTagOf<T>();
                 for (const auto& payload : payloads_) {
-                    std::shared_ptr<T> result(std::dynamic_pointer_cast<T>(payload));
+                    std::shared_ptr<T> result(payloadCast<T>(payload, tag));
                     if (result) {
                         return result;
                     }
@@ -44,9 +45,10 @@ namespace Swift {
 
             template<typename T>
             std::vector< std::shared_ptr<T> > getPayloads() const {
+                const Payload::TypeTag tag = Payload::getTypeTagOf<T>();
                 std::vector< std::shared_ptr<T> > results;
                 for (const auto& payload : payloads_) {
-                    std::shared_ptr<T> result(std::dynamic_pointer_cast<T>(payload));
+                    std::shared_ptr<T> result(payloadCast<T>(payload, tag));
                     if (result) {
                         results.push_back(result);
                     }
@@ -60,7 +62,7 @@ namespace Swift {
             }
 
             void addPayload(std::shared_ptr<Payload> payload) {
-                payloads_.push_back(payload);
+                payloads_.push_back(std::move(payload));
             }
 
             template<typename InputIterator>
@@ -92,6 +94,19 @@ namespace Swift {
             // Falls back to any timestamp if no specific timestamp for the given JID is found.
             boost::optional<boost::posix_time::ptime> getTimestampFrom(const JID& jid) const;
 
+        private:
+            /**
+             * Payloads of a class with a type tag are matched by comparing
+             * tags. Only types without one need RTTI.
+             */
+            template<typename T>
+            static std::shared_ptr<T> payloadCast(const std::shared_ptr<Payload>& payload, Payload::TypeTag tag) {
+                if (tag) {
+                    return payload && payload->getTypeTag() == tag ? std::static_pointer_cast<T>(payload) : std::shared_ptr<T>();
+                }
+                return std::dynamic_pointer_cast<T>(payload);
+            }
+
         private:
             std::string id_;
             JID from_;
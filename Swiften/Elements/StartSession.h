@@ -13,6 +13,8 @@
 
 namespace Swift {
     class SWIFTEN_API StartSession : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(StartSession)
+
         public:
             StartSession() {}
     };
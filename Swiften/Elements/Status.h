@@ -13,6 +13,8 @@
 
 namespace Swift {
     class SWIFTEN_API Status : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(Status)
+
         public:
             Status(const std::string& text = "") : text_(text) {
             }
@@ -13,6 +13,8 @@
 
 namespace Swift {
     class SWIFTEN_API StatusShow : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(StatusShow)
+
         public:
             enum Type { Online, Away, FFC, XA, DND, None };
 
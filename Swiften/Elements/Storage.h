@@ -18,6 +18,8 @@
 
 namespace Swift {
     class SWIFTEN_API Storage : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(Storage)
+
         public:
             struct Room {
                 Room() : autoJoin(false) {}
@@ -18,6 +18,8 @@
 
 namespace Swift {
     class SWIFTEN_API StreamInitiation : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(StreamInitiation)
+
         public:
             typedef std::shared_ptr<StreamInitiation> ref;
 
@@ -17,6 +17,8 @@
 namespace Swift {
 
 class SWIFTEN_API StreamInitiationFileInfo : public Payload {
+SWIFTEN_PAYLOAD_TYPE_TAG(StreamInitiationFileInfo)
+
 public:
     typedef std::shared_ptr<StreamInitiationFileInfo> ref;
 
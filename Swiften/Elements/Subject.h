@@ -13,6 +13,8 @@
 
 namespace Swift {
     class SWIFTEN_API Subject : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(Subject)
+
         public:
             Subject(const std::string& text = "") : text_(text) {
             }
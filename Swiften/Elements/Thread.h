@@ -13,6 +13,8 @@
 
 namespace Swift {
     class SWIFTEN_API Thread : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(Thread)
+
         public:
             Thread(const std::string& text = "", const std::string& parent = "");
             virtual ~Thread();
@@ -14,6 +14,8 @@
 
 namespace Swift {
     class SWIFTEN_API UnblockPayload : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(UnblockPayload)
+
         public:
             UnblockPayload(const std::vector<JID>& jids = std::vector<JID>()) : items(jids) {
             }
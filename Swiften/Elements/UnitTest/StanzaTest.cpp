@@ -1,16 +1,19 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include <boost/date_time/posix_time/posix_time.hpp>
 
 #include <cppunit/extensions/HelperMacros.h>
 #include <cppunit/extensions/TestFactoryRegistry.h>
 
+#include <Swiften/Elements/Body.h>
 #include <Swiften/Elements/Delay.h>
 #include <Swiften/Elements/Message.h>
 #include <Swiften/Elements/Payload.h>
@@ -25,6 +28,12 @@ class StanzaTest : public CppUnit::TestFixture
         CPPUNIT_TEST(testGetPayload);
         CPPUNIT_TEST(testGetPayloads);
         CPPUNIT_TEST(testGetPayload_NoSuchPayload);
+        CPPUNIT_TEST(testGetPayload_Subclass);
+        CPPUNIT_TEST(testGetPayloads_Subclass);
+        CPPUNIT_TEST(testGetPayload_TypeTag);
+        CPPUNIT_TEST(testGetPayload_TypeTagSubclass);
+        CPPUNIT_TEST(testAddPayloads);
+        CPPUNIT_TEST(testRemovePayloadOfSameType);
         CPPUNIT_TEST(testDestructor);
         CPPUNIT_TEST(testDestructor_Copy);
         CPPUNIT_TEST(testUpdatePayload_ExistingPayload);
@@ -56,6 +65,25 @@ class StanzaTest : public CppUnit::TestFixture
                 MyPayload3() {}
         };
 
+        class MyPayload1Subclass : public MyPayload1 {
+            public:
+                MyPayload1Subclass() {}
+        };
+
+        class MyTaggedPayload : public Payload {
+                SWIFTEN_PAYLOAD_TYPE_TAG(MyTaggedPayload)
+
+            public:
+                MyTaggedPayload(const std::string& s = "") : text_(s) {}
+
+                std::string text_;
+        };
+
+        class MyTaggedPayloadSubclass : public MyTaggedPayload {
+            public:
+                MyTaggedPayloadSubclass() {}
+        };
+
         class DestroyingPayload : public Payload {
             public:
                 DestroyingPayload(bool* alive) : alive_(alive) {
@@ -121,6 +149,82 @@ class StanzaTest : public CppUnit::TestFixture
             CPPUNIT_ASSERT(!p);
         }
 
+        void testGetPayload_Subclass() {
+            Message m;
+            m.addPayload(std::make_shared<MyPayload2>());
+            m.addPayload(std::make_shared<MyPayload1Subclass>());
+
+            CPPUNIT_ASSERT(m.getPayload<MyPayload1>());
+            CPPUNIT_ASSERT(m.getPayload<MyPayload1Subclass>());
+            CPPUNIT_ASSERT(!m.getPayload<MyPayload3>());
+        }
+
+        void testGetPayloads_Subclass() {
+            Message m;
+            m.addPayload(std::make_shared<MyPayload1>());
+            m.addPayload(std::make_shared<MyPayload2>());
+            m.addPayload(std::make_shared<MyPayload1Subclass>());
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), m.getPayloads<MyPayload1>().size());
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), m.getPayloads<MyPayload1Subclass>().size());
+        }
+
+        void testGetPayload_TypeTag() {
+            Message m;
+            m.addPayload(std::make_shared<MyPayload1>());
+            m.addPayload(std::make_shared<MyTaggedPayload>("foo"));
+            m.addPayload(std::make_shared<Body>("bar"));
+            m.addPayload(std::make_shared<MyTaggedPayload>("baz"));
+
+            CPPUNIT_ASSERT(!Payload::getTypeTagOf<MyPayload1>());
+            CPPUNIT_ASSERT(Payload::getTypeTagOf<MyTaggedPayload>());
+            CPPUNIT_ASSERT(Payload::getTypeTagOf<MyTaggedPayload>() != Payload::getTypeTagOf<Body>());
+            CPPUNIT_ASSERT_EQUAL(std::string("foo"), m.getPayload<MyTaggedPayload>()->text_);
+            CPPUNIT_ASSERT_EQUAL(std::string("bar"), m.getPayload<Body>()->getText());
+            std::vector<std::shared_ptr<MyTaggedPayload>> payloads = m.getPayloads<MyTaggedPayload>();
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), payloads.size());
+            CPPUNIT_ASSERT_EQUAL(std::string("baz"), payloads[1]->text_);
+            CPPUNIT_ASSERT(m.getPayload<MyPayload1>());
+            CPPUNIT_ASSERT(!m.getPayload<MyTaggedPayloadSubclass>());
+        }
+
+        void testGetPayload_TypeTagSubclass() {
+            Message m;
+            m.addPayload(std::make_shared<MyTaggedPayloadSubclass>());
+
+            CPPUNIT_ASSERT(!Payload::getTypeTagOf<MyTaggedPayloadSubclass>());
+            CPPUNIT_ASSERT(m.getPayload<MyTaggedPayload>());
+            CPPUNIT_ASSERT(m.getPayload<MyTaggedPayloadSubclass>());
+            CPPUNIT_ASSERT(!m.getPayload<Body>());
+        }
+
+        void testAddPayloads() {
+            Message m;
+            std::vector<std::shared_ptr<MyPayload2> > payloads;
+            payloads.push_back(std::make_shared<MyPayload2>("foo"));
+            payloads.push_back(std::make_shared<MyPayload2>("bar"));
+            m.addPayloads(payloads);
+
+            std::vector<std::shared_ptr<MyPayload2> > result = m.getPayloads<MyPayload2>();
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), result.size());
+            CPPUNIT_ASSERT_EQUAL(std::string("bar"), result[1]->text_);
+        }
+
+        void testRemovePayloadOfSameType() {
+            Message m;
+            m.addPayload(std::make_shared<MyPayload1>());
+            m.addPayload(std::make_shared<MyPayload2>("foo"));
+            m.addPayload(std::make_shared<MyPayload3>());
+            m.addPayload(std::make_shared<MyPayload2>("bar"));
+
+            m.removePayloadOfSameType(std::make_shared<MyPayload2>());
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), m.getPayloads().size());
+            CPPUNIT_ASSERT(!m.getPayload<MyPayload2>());
+            CPPUNIT_ASSERT(m.getPayload<MyPayload1>());
+            CPPUNIT_ASSERT(m.getPayload<MyPayload3>());
+        }
+
         void testGetPayloads() {
             Message m;
             std::shared_ptr<MyPayload2> payload1(new MyPayload2());
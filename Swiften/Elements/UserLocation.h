@@ -16,6 +16,8 @@
 
 namespace Swift {
     class SWIFTEN_API UserLocation : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(UserLocation)
+
         public:
 
             UserLocation();
@@ -15,6 +15,8 @@
 
 namespace Swift {
     class SWIFTEN_API UserTune : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(UserTune)
+
         public:
 
             UserTune();
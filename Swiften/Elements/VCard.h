@@ -18,6 +18,8 @@
 
 namespace Swift {
     class SWIFTEN_API VCard : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(VCard)
+
         public:
             typedef std::shared_ptr<VCard> ref;
 
@@ -13,6 +13,8 @@
 
 namespace Swift {
     class SWIFTEN_API VCardUpdate : public Payload {
+            SWIFTEN_PAYLOAD_TYPE_TAG(VCardUpdate)
+
         public:
             VCardUpdate(const std::string& photoHash = "") : photoHash_(photoHash) {}
 
@@ -21,6 +21,8 @@
 
 namespace Swift {
     class SWIFTEN_API WhiteboardPayload : public Payload {
+    SWIFTEN_PAYLOAD_TYPE_TAG(WhiteboardPayload)
+
     public:
         typedef std::shared_ptr<WhiteboardPayload> ref;
 
@@ -1,30 +1,44 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #pragma once
 
+#include <cstdint>
+#include <iosfwd>
 #include <memory>
 
-#include <boost/function.hpp>
-
+#include <Swiften/EventLoop/EventCallback.h>
 #include <Swiften/EventLoop/EventOwner.h>
 
 namespace Swift {
     class Event {
         public:
-            Event(std::shared_ptr<EventOwner> owner, const boost::function<void()>& callback) : id(~0U), owner(owner), callback(callback) {
+            Event() : id(~0ULL) {
+            }
+
+            Event(std::shared_ptr<EventOwner> owner, EventCallback callback) : id(~0ULL), owner(std::move(owner)), callback(std::move(callback)) {
+            }
+
+            Event(Event&& other) : id(other.id), owner(std::move(other.owner)), callback(std::move(other.callback)) {
+            }
+
+            Event& operator=(Event&& other) {
+                id = other.id;
+                owner = std::move(other.owner);
+                callback = std::move(other.callback);
+                return *this;
             }
 
             bool operator==(const Event& o) const {
                 return o.id == id;
             }
 
-            unsigned int id;
+            std::uint64_t id;
             std::shared_ptr<EventOwner> owner;
-            boost::function<void()> callback;
+            EventCallback callback;
     };
 }
 
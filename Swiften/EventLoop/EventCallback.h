@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <boost/ref.hpp>
+
+namespace Swift {
+    /**
+     * A move-only holder for a callable taking no arguments.
+     *
+     * Callables up to BufferSize bytes (e.g. a boost::bind of a member
+     * function with a few arguments) are stored inline, so posting them
+     * to an event loop does not allocate. Larger callables are stored on
+     * the heap. Like boost::function, a callable wrapped in boost::ref is
+     * called through the reference.
+     */
+    class EventCallback {
+        public:
+            static const size_t BufferSize = 8 * sizeof(void*);
+
+            EventCallback() : operations_(nullptr) {
+            }
+
+            template<typename F, typename = typename std::enable_if<!std::is_same<typename std::decay<F>::type, EventCallback>::value>::type>
+            EventCallback(F&& f) : operations_(nullptr) {
+                typedef typename std::decay<F>::type Callable;
+                store<Callable>(std::forward<F>(f), std::integral_constant<bool, fitsInline<Callable>()>());
+            }
+
+            EventCallback(EventCallback&& other) : operations_(nullptr) {
+                take(other);
+            }
+
+            EventCallback& operator=(EventCallback&& other) {
+                if (this != &other) {
+                    reset();
+                    take(other);
+                }
+                return *this;
+            }
+
+            EventCallback(const EventCallback&) = delete;
+            EventCallback& operator=(const EventCallback&) = delete;
+
+            ~EventCallback() {
+                reset();
+            }
+
+            bool empty() const {
+                return operations_ == nullptr;
+            }
+
+            void operator()() {
+                operations_->invoke(&buffer_);
+            }
+
+            void reset() {
+                if (operations_) {
+                    operations_->destroy(&buffer_);
+                    operations_ = nullptr;
+                }
+            }
+
+        private:
+            typedef std::aligned_storage<BufferSize>::type Buffer;
+
+            struct Operations {
+                void (*invoke)(void*);
+                void (*move)(void* from, void* to);
+                void (*destroy)(void*);
+            };
+
+            template<typename Callable>
+            static constexpr bool fitsInline() {
+                return sizeof(Callable) <= sizeof(Buffer) && alignof(Callable) <= alignof(Buffer) && std::is_nothrow_move_constructible<Callable>::value;
+            }
+
+            template<typename Callable>
+            struct InlineOperations {
+                static void invoke(void* buffer) {
+                    boost::unwrap_ref(*static_cast<Callable*>(buffer))();
+                }
+
+                static void move(void* from, void* to) {
+                    Callable* callable = static_cast<Callable*>(from);
+                    new (to) Callable(std::move(*callable));
+                    callable->~Callable();
+                }
+
+                static void destroy(void* buffer) {
+                    static_cast<Callable*>(buffer)->~Callable();
+                }
+
+                static const Operations* get() {
+                    static const Operations operations = { &invoke, &move, &destroy };
+                    return &operations;
+                }
+            };
+
+            template<typename Callable>
+            struct HeapOperations {
+                static Callable* callable(void* buffer) {
+                    return *static_cast<Callable**>(buffer);
+                }
+
+                static void invoke(void* buffer) {
+                    boost::unwrap_ref(*callable(buffer))();
+                }
+
+                static void move(void* from, void* to) {
+                    new (to) Callable*(callable(from));
+                }
+
+                static void destroy(void* buffer) {
+                    delete callable(buffer);
+                }
+
+                static const Operations* get() {
+                    static const Operations operations = { &invoke, &move, &destroy };
+                    return &operations;
+                }
+            };
+
+            template<typename Callable, typename F>
+            void store(F&& f, std::true_type /* inline */) {
+                new (&buffer_) Callable(std::forward<F>(f));
+                operations_ = InlineOperations<Callable>::get();
+            }
+
+            template<typename Callable, typename F>
+            void store(F&& f, std::false_type /* inline */) {
+                new (&buffer_) Callable*(new Callable(std::forward<F>(f)));
+                operations_ = HeapOperations<Callable>::get();
+            }
+
+            void take(EventCallback& other) {
+                if (other.operations_) {
+                    other.operations_->move(&other.buffer_, &buffer_);
+                    operations_ = other.operations_;
+                    other.operations_ = nullptr;
+                }
+            }
+
+        private:
+            Buffer buffer_;
+            const Operations* operations_;
+    };
+}
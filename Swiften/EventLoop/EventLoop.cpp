@@ -8,15 +8,14 @@
 
 #include <algorithm>
 #include <cassert>
-#include <vector>
-
-#include <boost/optional.hpp>
 
 #include <Swiften/Base/Log.h>
 
 namespace Swift {
 
-inline void invokeCallback(const Event& event) {
+static const size_t minimumRemovedOwnersPruneSize = 64;
+
+inline void invokeCallback(Event& event) {
     try {
         assert(!event.callback.empty());
         event.callback();
@@ -29,7 +28,7 @@ inline void invokeCallback(const Event& event) {
     }
 }
 
-EventLoop::EventLoop() : nextEventID_(0), handlingEvents_(false) {
+EventLoop::EventLoop() : nextEventID_(0), events_(1024), pendingEvents_(0), overflowing_(false), handlingEvents_(false), removedOwnersPruneSize_(minimumRemovedOwnersPruneSize) {
 }
 
 EventLoop::~EventLoop() {
@@ -44,22 +43,22 @@ void EventLoop::handleNextEvents() {
     if (!handlingEvents_) {
         handlingEvents_ = true;
         std::unique_lock<std::recursive_mutex> lock(removeEventsMutex_);
-        {
-            std::vector<Event> nextEvents;
-            {
-                std::unique_lock<std::recursive_mutex> lock(eventsMutex_);
-                for (int n = 0; ((n < eventsBatched) && !events_.empty()); n++) {
-                    nextEvents.push_back(events_.front());
-                    events_.pop_front();
-                }
-                callEventPosted = !events_.empty();
-            }
-            if (!nextEvents.empty()) {
-                for (const auto& event : nextEvents) {
-                    invokeCallback(event);
-                }
+        int handledEvents = 0;
+        Event event;
+        while (handledEvents < eventsBatched && takeNextEvent(event)) {
+            handledEvents++;
+            if (!isRemoved(event)) {
+                invokeCallback(event);
             }
+            // Release the callback and owner before waiting for the next event
+            event = Event();
         }
+        if (!removedOwners_.empty() && events_.isEmpty() && !overflowing_) {
+            // All events posted before any of the removals have been seen
+            removedOwners_.clear();
+            removedOwnersPruneSize_ = minimumRemovedOwnersPruneSize;
+        }
+        callEventPosted = pendingEvents_.fetch_sub(handledEvents) - handledEvents > 0;
         handlingEvents_ = false;
     }
 
@@ -68,32 +67,75 @@ void EventLoop::handleNextEvents() {
     }
 }
 
-void EventLoop::postEvent(boost::function<void ()> callback, std::shared_ptr<EventOwner> owner) {
-    Event event(owner, callback);
-    bool callEventPosted = false;
-    {
-        std::unique_lock<std::recursive_mutex> lock(eventsMutex_);
-
-        callEventPosted = events_.empty();
-
-        event.id = nextEventID_;
-        nextEventID_++;
-        events_.push_back(event);
+void EventLoop::queueEvent(Event event) {
+    event.id = nextEventID_++;
+    if (overflowing_ || !events_.tryPush(event)) {
+        std::lock_guard<std::mutex> lock(overflowMutex_);
+        overflowEvents_.push_back(std::move(event));
+        overflowing_ = true;
     }
-    if (callEventPosted) {
+    // Counting the event only after it is queued means the count can drop below
+    // zero when the event gets handled first. The event is then not counted
+    // as pending here either, so eventPosted() is only called when the queue
+    // goes from empty to non-empty.
+    if (pendingEvents_++ == 0) {
         eventPosted();
     }
 }
 
-void EventLoop::removeEventsFromOwner(std::shared_ptr<EventOwner> owner) {
-    std::unique_lock<std::recursive_mutex> removeLock(removeEventsMutex_, std::defer_lock);
-    std::unique_lock<std::recursive_mutex> eventsLock(eventsMutex_, std::defer_lock);
+bool EventLoop::takeNextEvent(Event& event) {
+    if (events_.tryPop(event)) {
+        return true;
+    }
+    // A producer whose push into events_ is still in progress may have posted
+    // later events to overflowEvents_ already, so only take from there once
+    // every event pushed into events_ has been handled.
+    if (overflowing_ && events_.isEmpty()) {
+        std::lock_guard<std::mutex> lock(overflowMutex_);
+        bool result = false;
+        if (!overflowEvents_.empty()) {
+            event = std::move(overflowEvents_.front());
+            overflowEvents_.pop_front();
+            result = true;
+        }
+        if (overflowEvents_.empty()) {
+            overflowing_ = false;
+        }
+        return result;
+    }
+    return false;
+}
 
-    std::lock(removeLock, eventsLock);
+bool EventLoop::isRemoved(const Event& event) const {
+    if (!event.owner || removedOwners_.empty()) {
+        return false;
+    }
+    auto i = removedOwners_.find(event.owner.get());
+    return i != removedOwners_.end() && event.id < i->second.firstKeptEventID;
+}
 
-    events_.remove_if([&](const Event& event) {
-        return event.owner == owner;
-    });
+void EventLoop::pruneRemovedOwners() {
+    for (auto i = removedOwners_.begin(); i != removedOwners_.end(); ) {
+        if (i->second.owner.expired()) {
+            i = removedOwners_.erase(i);
+        }
+        else {
+            ++i;
+        }
+    }
+}
+
+void EventLoop::removeEventsFromOwner(std::shared_ptr<EventOwner> owner) {
+    std::unique_lock<std::recursive_mutex> removeLock(removeEventsMutex_);
+    RemovedOwner& removedOwner = removedOwners_[owner.get()];
+    removedOwner.owner = owner;
+    removedOwner.firstKeptEventID = nextEventID_;
+    // If the queue never runs empty, the entries are only cleaned up here. Pruning
+    // whenever their number doubles keeps the cost per removal constant.
+    if (removedOwners_.size() >= removedOwnersPruneSize_) {
+        pruneRemovedOwners();
+        removedOwnersPruneSize_ = std::max(minimumRemovedOwnersPruneSize, 2 * removedOwners_.size());
+    }
 }
 
 }
@@ -1,18 +1,22 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #pragma once
 
-#include <list>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
 #include <mutex>
-
-#include <boost/function.hpp>
+#include <unordered_map>
+#include <utility>
 
 #include <Swiften/Base/API.h>
 #include <Swiften/EventLoop/Event.h>
+#include <Swiften/EventLoop/EventQueue.h>
 
 namespace Swift {
     class EventOwner;
@@ -32,8 +36,14 @@ namespace Swift {
              * The \ref postEvent method allows events to be added to the event queue of the \ref EventLoop.
              * An optional \ref EventOwner can be passed as \p owner, allowing later removal of events that have not yet been
              * executed using the \ref removeEventsFromOwner method.
+             *
+             * Posting does not take a lock, and does not allocate for small callbacks, so it
+             * is cheap to call from other threads.
              */
-            void postEvent(boost::function<void ()> event, std::shared_ptr<EventOwner> owner = std::shared_ptr<EventOwner>());
+            template<typename Callback>
+            void postEvent(Callback&& callback, std::shared_ptr<EventOwner> owner = std::shared_ptr<EventOwner>()) {
+                queueEvent(Event(std::move(owner), EventCallback(std::forward<Callback>(callback))));
+            }
 
             /**
              * The \ref removeEventsFromOwner method removes all events from the specified \p owner from the
@@ -62,10 +72,35 @@ namespace Swift {
             virtual void eventPosted() = 0;
 
         private:
-            unsigned int nextEventID_;
-            std::list<Event> events_;
+            void queueEvent(Event event);
+            bool takeNextEvent(Event& event);
+            bool isRemoved(const Event& event) const;
+            void pruneRemovedOwners();
+
+        private:
+            std::atomic<std::uint64_t> nextEventID_;
+            EventQueue events_;
+            // Number of events in the queue, as seen by the producers and the consumer.
+            std::atomic<int> pendingEvents_;
+            // Events that did not fit in events_. Once there are any, new events are
+            // added here as well until they are all handled, and they are only handled
+            // once events_ has run empty, to keep the events of each thread in order.
+            std::deque<Event> overflowEvents_;
+            std::atomic<bool> overflowing_;
+            std::mutex overflowMutex_;
             bool handlingEvents_;
-            std::recursive_mutex eventsMutex_;
+            // Held while handling events, so that removing events of an owner waits for
+            // any event of that owner that is being handled.
             std::recursive_mutex removeEventsMutex_;
+            // For each owner whose events were removed, the ID of the first event posted
+            // after the removal. Older events of the owner are dropped instead of handled.
+            // Queued events keep their owner alive, so the entry of an owner that is gone
+            // is not needed anymore.
+            struct RemovedOwner {
+                std::weak_ptr<EventOwner> owner;
+                std::uint64_t firstKeptEventID;
+            };
+            std::unordered_map<EventOwner*, RemovedOwner> removedOwners_;
+            size_t removedOwnersPruneSize_;
     };
 }
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <Swiften/EventLoop/EventQueue.h>
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+
+namespace Swift {
+
+// Every slot carries a sequence number telling whose turn it is: a slot
+// with sequence p is free for the producer claiming position p, and one
+// with sequence p + 1 holds the event pushed at position p, ready for the
+// consumer. Popping hands the slot on to the producer one lap later.
+
+EventQueue::EventQueue(size_t capacity) : mask_(capacity - 1), slots_(new Slot[capacity]), enqueuePosition_(0), dequeuePosition_(0) {
+    assert(capacity >= 2 && (capacity & mask_) == 0);
+    for (size_t i = 0; i < capacity; ++i) {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+EventQueue::~EventQueue() {
+    Event event;
+    while (tryPop(event)) {
+    }
+}
+
+bool EventQueue::tryPush(Event& event) {
+    Slot* slot;
+    size_t position = enqueuePosition_.load(std::memory_order_relaxed);
+    while (true) {
+        slot = &slots_[position & mask_];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+        if (difference == 0) {
+            if (enqueuePosition_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (difference < 0) {
+            // The consumer has not freed this slot yet
+            return false;
+        }
+        else {
+            position = enqueuePosition_.load(std::memory_order_relaxed);
+        }
+    }
+    new (&slot->storage) Event(std::move(event));
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+bool EventQueue::tryPop(Event& event) {
+    size_t position = dequeuePosition_.load(std::memory_order_relaxed);
+    Slot& slot = slots_[position & mask_];
+    if (slot.sequence.load(std::memory_order_acquire) != position + 1) {
+        return false;
+    }
+    Event* storedEvent = static_cast<Event*>(static_cast<void*>(&slot.storage));
+    event = std::move(*storedEvent);
+    storedEvent->~Event();
+    slot.sequence.store(position + mask_ + 1, std::memory_order_release);
+    dequeuePosition_.store(position + 1, std::memory_order_relaxed);
+    return true;
+}
+
+bool EventQueue::isEmpty() const {
+    return enqueuePosition_.load(std::memory_order_acquire) == dequeuePosition_.load(std::memory_order_relaxed);
+}
+
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+#include <boost/noncopyable.hpp>
+
+#include <Swiften/Base/API.h>
+#include <Swiften/EventLoop/Event.h>
+
+namespace Swift {
+    /**
+     * A bounded lock-free queue of events, for any number of producers and a
+     * single consumer.
+     *
+     * Pushing an event takes one compare-and-swap and does not allocate; the
+     * events are moved into slots of a ring that is allocated up front.
+     * Popping is only safe from one thread at a time.
+     */
+    class SWIFTEN_API EventQueue : public boost::noncopyable {
+        public:
+            /**
+             * \p capacity has to be a power of two.
+             */
+            EventQueue(size_t capacity);
+            ~EventQueue();
+
+            /**
+             * Moves \p event into the queue, unless the queue is full.
+             */
+            bool tryPush(Event& event);
+
+            /**
+             * Moves the oldest event out of the queue into \p event.
+             *
+             * This can fail while the queue is not empty, if the producer
+             * of the oldest event is still busy pushing it.
+             */
+            bool tryPop(Event& event);
+
+            /**
+             * Returns whether every event pushed so far has been popped,
+             * including the events that are still being pushed.
+             */
+            bool isEmpty() const;
+
+        private:
+            struct Slot {
+                std::atomic<size_t> sequence;
+                std::aligned_storage<sizeof(Event), alignof(Event)>::type storage;
+            };
+
+            size_t mask_;
+            std::unique_ptr<Slot[]> slots_;
+            std::atomic<size_t> enqueuePosition_;
+            std::atomic<size_t> dequeuePosition_;
+    };
+}
@@ -1,10 +1,13 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
+#include <chrono>
+#include <string>
 #include <thread>
+#include <vector>
 
 #include <boost/bind.hpp>
 
@@ -23,6 +26,13 @@ class EventLoopTest : public CppUnit::TestFixture {
         CPPUNIT_TEST(testPost);
         CPPUNIT_TEST(testRemove);
         CPPUNIT_TEST(testHandleEvent_Recursive);
+        CPPUNIT_TEST(testPost_MoreEventsThanQueueCapacity);
+        CPPUNIT_TEST(testPost_FromMultipleThreads);
+        CPPUNIT_TEST(testPost_FromMultipleThreadsWhileHandling);
+        CPPUNIT_TEST(testPost_LargeCallback);
+        CPPUNIT_TEST(testRemove_FromEvent);
+        CPPUNIT_TEST(testRemove_PostAfterRemove);
+        CPPUNIT_TEST(testRemove_ManyOwners);
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -74,6 +84,135 @@ class EventLoopTest : public CppUnit::TestFixture {
             CPPUNIT_ASSERT_EQUAL(1, events_[1]);
         }
 
+        void testPost_MoreEventsThanQueueCapacity() {
+            DummyEventLoop testling;
+
+            for (int i = 0; i < 5000; ++i) {
+                testling.postEvent(boost::bind(&EventLoopTest::logEvent, this, i));
+            }
+            testling.processEvents();
+
+            CPPUNIT_ASSERT_EQUAL(5000, static_cast<int>(events_.size()));
+            for (int i = 0; i < 5000; ++i) {
+                CPPUNIT_ASSERT_EQUAL(i, events_[static_cast<size_t>(i)]);
+            }
+        }
+
+        void testPost_FromMultipleThreads() {
+            DummyEventLoop testling;
+            const int threadCount = 4;
+            const int eventsPerThread = 2000;
+
+            std::vector<std::thread> threads;
+            for (int t = 0; t < threadCount; ++t) {
+                threads.push_back(std::thread([&testling, this, t, eventsPerThread]() {
+                    for (int i = 0; i < eventsPerThread; ++i) {
+                        testling.postEvent(boost::bind(&EventLoopTest::logEvent, this, t * eventsPerThread + i));
+                    }
+                }));
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            testling.processEvents();
+
+            CPPUNIT_ASSERT_EQUAL(threadCount * eventsPerThread, static_cast<int>(events_.size()));
+            std::vector<int> lastEvents(threadCount, -1);
+            for (int event : events_) {
+                int thread = event / eventsPerThread;
+                CPPUNIT_ASSERT(event > lastEvents[static_cast<size_t>(thread)]);
+                lastEvents[static_cast<size_t>(thread)] = event;
+            }
+        }
+
+        void testPost_FromMultipleThreadsWhileHandling() {
+            DummyEventLoop testling;
+            const int threadCount = 4;
+            const int eventsPerThread = 20000;
+
+            std::vector<std::thread> threads;
+            for (int t = 0; t < threadCount; ++t) {
+                threads.push_back(std::thread([&testling, this, t, eventsPerThread]() {
+                    for (int i = 0; i < eventsPerThread; ++i) {
+                        testling.postEvent(boost::bind(&EventLoopTest::logEvent, this, t * eventsPerThread + i));
+                    }
+                }));
+            }
+            std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+            while (static_cast<int>(events_.size()) < threadCount * eventsPerThread && std::chrono::steady_clock::now() < deadline) {
+                testling.processEvents();
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            testling.processEvents();
+
+            CPPUNIT_ASSERT_EQUAL(threadCount * eventsPerThread, static_cast<int>(events_.size()));
+            std::vector<int> lastEvents(threadCount, -1);
+            for (int event : events_) {
+                int thread = event / eventsPerThread;
+                CPPUNIT_ASSERT(event > lastEvents[static_cast<size_t>(thread)]);
+                lastEvents[static_cast<size_t>(thread)] = event;
+            }
+        }
+
+        void testPost_LargeCallback() {
+            DummyEventLoop testling;
+            std::vector<int> values(100, 7);
+            std::string padding(1000, 'x');
+
+            testling.postEvent([this, values, padding]() { logEvent(values[99] + static_cast<int>(padding.size())); });
+            testling.processEvents();
+
+            CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(events_.size()));
+            CPPUNIT_ASSERT_EQUAL(1007, events_[0]);
+        }
+
+        void testRemove_FromEvent() {
+            DummyEventLoop testling;
+            std::shared_ptr<MyEventOwner> eventOwner1(new MyEventOwner());
+            std::shared_ptr<MyEventOwner> eventOwner2(new MyEventOwner());
+
+            testling.postEvent(boost::bind(&EventLoop::removeEventsFromOwner, &testling, eventOwner2), eventOwner1);
+            testling.postEvent(boost::bind(&EventLoopTest::logEvent, this, 1), eventOwner2);
+            testling.postEvent(boost::bind(&EventLoopTest::logEvent, this, 2), eventOwner1);
+            testling.processEvents();
+
+            CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(events_.size()));
+            CPPUNIT_ASSERT_EQUAL(2, events_[0]);
+        }
+
+        void testRemove_PostAfterRemove() {
+            DummyEventLoop testling;
+            std::shared_ptr<MyEventOwner> eventOwner(new MyEventOwner());
+
+            testling.postEvent(boost::bind(&EventLoopTest::logEvent, this, 1), eventOwner);
+            testling.removeEventsFromOwner(eventOwner);
+            testling.postEvent(boost::bind(&EventLoopTest::logEvent, this, 2), eventOwner);
+            testling.processEvents();
+
+            CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(events_.size()));
+            CPPUNIT_ASSERT_EQUAL(2, events_[0]);
+        }
+
+        void testRemove_ManyOwners() {
+            DummyEventLoop testling;
+            std::shared_ptr<MyEventOwner> eventOwner(new MyEventOwner());
+
+            testling.postEvent(boost::bind(&EventLoopTest::logEvent, this, 1), eventOwner);
+            testling.removeEventsFromOwner(eventOwner);
+            // Owners that are gone get cleaned up, but the removal of the events above must last.
+            for (int i = 0; i < 1000; ++i) {
+                std::shared_ptr<MyEventOwner> otherEventOwner(new MyEventOwner());
+                testling.removeEventsFromOwner(otherEventOwner);
+            }
+            testling.postEvent(boost::bind(&EventLoopTest::logEvent, this, 2), eventOwner);
+            testling.processEvents();
+
+            CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(events_.size()));
+            CPPUNIT_ASSERT_EQUAL(2, events_[0]);
+        }
+
     private:
         struct MyEventOwner : public EventOwner {};
         void logEvent(int i) {
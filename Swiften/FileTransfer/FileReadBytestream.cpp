@@ -1,15 +1,17 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <Swiften/FileTransfer/FileReadBytestream.h>
 
+#include <algorithm>
 #include <cassert>
 #include <memory>
 
 #include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
 #include <boost/numeric/conversion/cast.hpp>
 
 #include <Swiften/Base/ByteArray.h>
@@ -31,13 +33,41 @@ std::shared_ptr<ByteArray> FileReadBytestream::read(size_t size)  {
     if (!stream) {
         stream = new boost::filesystem::ifstream(file, std::ios_base::in|std::ios_base::binary);
     }
-    std::shared_ptr<ByteArray> result = std::make_shared<ByteArray>();
-    result->resize(size);
+    // Only reuse the previous chunk if nobody else holds on to it anymore.
+    if (!buffer || buffer.use_count() != 1) {
+        buffer = std::make_shared<ByteArray>();
+    }
+    buffer->resize(size);
     assert(stream->good());
-    stream->read(reinterpret_cast<char*>(vecptr(*result)), boost::numeric_cast<std::streamsize>(size));
-    result->resize(boost::numeric_cast<size_t>(stream->gcount()));
-    onRead(*result);
-    return result;
+    stream->read(reinterpret_cast<char*>(vecptr(*buffer)), boost::numeric_cast<std::streamsize>(size));
+    buffer->resize(boost::numeric_cast<size_t>(stream->gcount()));
+    onRead(*buffer);
+    return buffer;
+}
+
+std::pair<unsigned long long, size_t> FileReadBytestream::skip(size_t size) {
+    if (!stream) {
+        stream = new boost::filesystem::ifstream(file, std::ios_base::in|std::ios_base::binary);
+    }
+    assert(stream->good());
+    unsigned long long offset = boost::numeric_cast<unsigned long long>(static_cast<std::streamoff>(stream->tellg()));
+    if (!onRead.empty()) {
+        // The listeners need the data anyway
+        return std::make_pair(offset, FileReadBytestream::read(size)->size());
+    }
+
+    boost::system::error_code error;
+    unsigned long long fileSize = boost::filesystem::file_size(file, error);
+    size_t skipped = 0;
+    if (!error && offset < fileSize) {
+        skipped = boost::numeric_cast<size_t>(std::min<unsigned long long>(size, fileSize - offset));
+    }
+    stream->seekg(boost::numeric_cast<std::streamoff>(skipped), std::ios_base::cur);
+    if (skipped < size) {
+        // Leave the stream in the same state as read() at the end of the file
+        stream->setstate(std::ios_base::eofbit | std::ios_base::failbit);
+    }
+    return std::make_pair(offset, skipped);
 }
 
 bool FileReadBytestream::isFinished() const {
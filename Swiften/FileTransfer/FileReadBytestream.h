@@ -1,18 +1,29 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #pragma once
 
+#include <memory>
+#include <utility>
+
 #include <boost/filesystem/fstream.hpp>
 #include <boost/filesystem/path.hpp>
 
 #include <Swiften/Base/API.h>
+#include <Swiften/Base/ByteArray.h>
 #include <Swiften/FileTransfer/ReadBytestream.h>
 
 namespace Swift {
+    /**
+     * Reads a file in chunks.
+     *
+     * The buffer returned by read() is reused for the next chunk once it is
+     * no longer referenced, so callers that are done with a chunk before
+     * reading the next one don't cause an allocation per chunk.
+     */
     class SWIFTEN_API FileReadBytestream : public ReadBytestream {
         public:
             FileReadBytestream(const boost::filesystem::path& file);
@@ -21,8 +32,29 @@ namespace Swift {
             virtual std::shared_ptr< std::vector<unsigned char> > read(size_t size);
             virtual bool isFinished() const;
 
+            /**
+             * Advances the stream by up to \p size bytes without returning them,
+             * so that the caller can send them from the file directly (see
+             * Connection::writeFile()).
+             *
+             * If onRead has listeners, the data is read for them, so there is
+             * nothing to gain over read(). The SOCKS5 bytestream sessions
+             * only skip streams without listeners; Jingle transfers hash the
+             * file without listening (see
+             * IncrementalBytestreamHashCalculator::feedFile()).
+             *
+             * @return the offset in the file and the number of bytes skipped,
+             *  which is 0 at the end of the file.
+             */
+            std::pair<unsigned long long, size_t> skip(size_t size);
+
+            const boost::filesystem::path& getFile() const {
+                return file;
+            }
+
         private:
             boost::filesystem::path file;
             boost::filesystem::ifstream* stream;
+            std::shared_ptr<ByteArray> buffer;
     };
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2011-2016 Isode Limited.
+ * Copyright (c) 2011-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -29,6 +29,9 @@
 
 using namespace Swift;
 
+// Strongest first
+static const std::vector<std::string> preferredHashAlgorithms = {"sha-512", "sha-256", "sha-1", "md5"};
+
 // TODO: ALlow terminate when already terminated.
 
 IncomingJingleFileTransfer::IncomingJingleFileTransfer(
@@ -76,8 +79,15 @@ void IncomingJingleFileTransfer::accept(
 
     assert(!hashCalculator);
 
-    hashCalculator = new IncrementalBytestreamHashCalculator(
-            hashes.find("md5") != hashes.end(), hashes.find("sha-1") != hashes.end(), crypto);
+    // Only calculate the strongest hash offered, that's the one we verify
+    std::vector<std::string> hashAlgorithms;
+    for (const auto& algorithm : preferredHashAlgorithms) {
+        if (hashes.find(algorithm) != hashes.end() && IncrementalBytestreamHashCalculator::isAlgorithmSupported(algorithm, crypto)) {
+            hashAlgorithms.push_back(algorithm);
+            break;
+        }
+    }
+    hashCalculator = new IncrementalBytestreamHashCalculator(hashAlgorithms, crypto);
 
     writeStreamDataReceivedConnection = stream->onWrite.connect(
             boost::bind(&IncomingJingleFileTransfer::handleWriteStreamDataReceived, this, _1));
@@ -146,11 +156,8 @@ void IncomingJingleFileTransfer::handleSessionInfoReceived(JinglePayload::ref ji
     if (transferHash) {
         SWIFT_LOG(debug) << "Received hash information." << std::endl;
         waitOnHashTimer->stop();
-        if (transferHash->getFileInfo().getHashes().find("sha-1") != transferHash->getFileInfo().getHashes().end()) {
-            hashes["sha-1"] = transferHash->getFileInfo().getHash("sha-1").get();
-        }
-        if (transferHash->getFileInfo().getHashes().find("md5") != transferHash->getFileInfo().getHashes().end()) {
-            hashes["md5"] = transferHash->getFileInfo().getHash("md5").get();
+        for (const auto& hash : transferHash->getFileInfo().getHashes()) {
+            hashes[hash.first] = hash.second;
         }
         if (state == WaitingForHash) {
             checkHashAndTerminate();
@@ -253,25 +260,22 @@ JingleContentID IncomingJingleFileTransfer::getContentID() const {
 
 bool IncomingJingleFileTransfer::verifyData() {
     if (hashes.empty()) {
-        SWIFT_LOG(debug) << "no verification possible, skipping" << std::endl;
+        SWIFT_LOG(warning) << "No hash received, the transfer is not verified" << std::endl;
         return true;
     }
-    if (hashes.find("sha-1") != hashes.end()) {
-        SWIFT_LOG(debug) << "Verify SHA-1 hash: " << (hashes["sha-1"] == hashCalculator->getSHA1Hash()) << std::endl;
-        return hashes["sha-1"] == hashCalculator->getSHA1Hash();
-    }
-    else if (hashes.find("md5") != hashes.end()) {
-        SWIFT_LOG(debug) << "Verify MD5 hash: " << (hashes["md5"] == hashCalculator->getMD5Hash()) << std::endl;
-        return hashes["md5"] == hashCalculator->getMD5Hash();
-    }
-    else {
-        SWIFT_LOG(debug) << "Unknown hash, skipping" << std::endl;
-        return true;
+    for (const auto& algorithm : preferredHashAlgorithms) {
+        if (hashes.find(algorithm) != hashes.end() && hashCalculator->hasHash(algorithm)) {
+            bool verified = hashes[algorithm] == hashCalculator->getHash(algorithm);
+            SWIFT_LOG(debug) << "Verify " << algorithm << " hash: " << verified << std::endl;
+            return verified;
+        }
     }
+    SWIFT_LOG(warning) << "No supported hash received, the transfer is not verified" << std::endl;
+    return true;
 }
 
 void IncomingJingleFileTransfer::handleWaitOnHashTimerTicked() {
-    SWIFT_LOG(debug) << std::endl;
+    SWIFT_LOG(warning) << "No hash received in time, the transfer is not verified" << std::endl;
     waitOnHashTimer->stop();
     terminate(JinglePayload::Reason::Success);
 }
@@ -5,7 +5,7 @@
  */
 
 /*
- * Copyright (c) 2013-2016 Isode Limited.
+ * Copyright (c) 2013-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -13,63 +13,219 @@
 
 #include <Swiften/FileTransfer/IncrementalBytestreamHashCalculator.h>
 
+#include <cassert>
+#include <memory>
+
+#include <boost/bind.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/numeric/conversion/cast.hpp>
+
+#include <Swiften/Base/Algorithm.h>
 #include <Swiften/Crypto/CryptoProvider.h>
+#include <Swiften/Crypto/Hash.h>
 #include <Swiften/StringCodecs/Hexify.h>
 
 namespace Swift {
 
-IncrementalBytestreamHashCalculator::IncrementalBytestreamHashCalculator(bool doMD5, bool doSHA1, CryptoProvider* crypto) {
-    md5Hasher = doMD5 ? crypto->createMD5() : nullptr;
-    sha1Hasher = doSHA1 ? crypto->createSHA1() : nullptr;
+namespace {
+    // Data that arrives faster than it can be hashed is held back from the
+    // caller once this much is waiting.
+    const size_t maxPendingDataSize = 8 * 1024 * 1024;
+
+    const size_t fileChunkSize = 1024 * 1024;
+
+    Hash* createHasher(const std::string& algorithm, CryptoProvider* crypto) {
+        if (algorithm == "md5") {
+            return crypto->createMD5();
+        }
+        else if (algorithm == "sha-1") {
+            return crypto->createSHA1();
+        }
+        else if (algorithm == "sha-256") {
+            return crypto->createSHA256();
+        }
+        else if (algorithm == "sha-512") {
+            return crypto->createSHA512();
+        }
+        return nullptr;
+    }
+
+    std::vector<std::string> getAlgorithms(bool doMD5, bool doSHA1) {
+        std::vector<std::string> algorithms;
+        if (doMD5) {
+            algorithms.push_back("md5");
+        }
+        if (doSHA1) {
+            algorithms.push_back("sha-1");
+        }
+        return algorithms;
+    }
+}
+
+IncrementalBytestreamHashCalculator::IncrementalBytestreamHashCalculator(bool doMD5, bool doSHA1, CryptoProvider* crypto) : IncrementalBytestreamHashCalculator(getAlgorithms(doMD5, doSHA1), crypto) {
+}
+
+IncrementalBytestreamHashCalculator::IncrementalBytestreamHashCalculator(const std::vector<std::string>& algorithms, CryptoProvider* crypto) : finished(false), stopRequested(false), abortRequested(false) {
+    for (const auto& algorithm : algorithms) {
+        if (hashers.find(algorithm) == hashers.end()) {
+            if (Hash* hasher = createHasher(algorithm, crypto)) {
+                hashers[algorithm] = hasher;
+            }
+        }
+    }
+    // Nothing is hashed without hashers, so there's no need for a thread
+    thread = hashers.empty() ? nullptr : new std::thread(boost::bind(&IncrementalBytestreamHashCalculator::run, this));
 }
 
 IncrementalBytestreamHashCalculator::~IncrementalBytestreamHashCalculator() {
-    delete md5Hasher;
-    delete sha1Hasher;
+    if (thread) {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            pendingData.clear();
+            stopRequested = true;
+            abortRequested = true;
+        }
+        queueChanged.notify_all();
+        thread->join();
+        delete thread;
+    }
+    for (auto& hasher : hashers) {
+        delete hasher.second;
+    }
 }
 
 void IncrementalBytestreamHashCalculator::feedData(const ByteArray& data) {
-    if (md5Hasher) {
-        md5Hasher->update(data);
+    if (finished || data.empty() || hashers.empty()) {
+        return;
     }
-    if (sha1Hasher) {
-        sha1Hasher->update(data);
+    {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        while (pendingData.size() >= maxPendingDataSize) {
+            queueChanged.wait(lock);
+        }
+        append(pendingData, data);
     }
+    queueChanged.notify_all();
 }
-/*
-void IncrementalBytestreamHashCalculator::feedData(const SafeByteArray& data) {
-    if (md5Hasher) {
-        md5Hasher->update(createByteArray(data.data(), data.size()));
+
+void IncrementalBytestreamHashCalculator::feedFile(const boost::filesystem::path& file) {
+    if (finished || hashers.empty()) {
+        return;
     }
-    if (sha1Hasher) {
-        sha1Hasher->update(createByteArray(data.data(), data.size()));
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        pendingFile = file;
     }
-}*/
+    queueChanged.notify_all();
+}
 
-ByteArray IncrementalBytestreamHashCalculator::getSHA1Hash() {
-    assert(sha1Hasher);
-    if (!sha1Hash) {
-        sha1Hash = sha1Hasher->getHash();
+void IncrementalBytestreamHashCalculator::run() {
+    // The queue and this buffer are swapped on every round, so both keep
+    // their capacity and no memory is allocated per chunk.
+    ByteArray data;
+    while (true) {
+        boost::optional<boost::filesystem::path> file;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            while (pendingData.empty() && !pendingFile && !stopRequested) {
+                queueChanged.wait(lock);
+            }
+            if (pendingFile) {
+                file.swap(pendingFile);
+            }
+            else if (pendingData.empty()) {
+                break;
+            }
+            else {
+                data.swap(pendingData);
+            }
+        }
+        queueChanged.notify_all();
+
+        if (file) {
+            hashFile(*file);
+            continue;
+        }
+
+        for (auto& hasher : hashers) {
+            hasher.second->update(data);
+        }
+        data.clear();
     }
-    return *sha1Hash;
 }
 
-ByteArray IncrementalBytestreamHashCalculator::getMD5Hash() {
-    assert(md5Hasher);
-    if (!md5Hash) {
-        md5Hash = md5Hasher->getHash();
+void IncrementalBytestreamHashCalculator::hashFile(const boost::filesystem::path& file) {
+    boost::filesystem::ifstream stream(file, std::ios_base::in|std::ios_base::binary);
+    ByteArray data;
+    while (stream.good()) {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            if (abortRequested) {
+                return;
+            }
+        }
+        data.resize(fileChunkSize);
+        stream.read(reinterpret_cast<char*>(vecptr(data)), boost::numeric_cast<std::streamsize>(data.size()));
+        data.resize(boost::numeric_cast<size_t>(stream.gcount()));
+        if (data.empty()) {
+            break;
+        }
+        for (auto& hasher : hashers) {
+            hasher.second->update(data);
+        }
+    }
+}
+
+void IncrementalBytestreamHashCalculator::finish() {
+    if (finished) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopRequested = true;
     }
-    return *md5Hash;
+    queueChanged.notify_all();
+    // The thread hashes all queued data and the whole file before it stops.
+    if (thread) {
+        thread->join();
+        delete thread;
+        thread = nullptr;
+    }
+
+    for (auto& hasher : hashers) {
+        hashes[hasher.first] = hasher.second->getHash();
+    }
+    finished = true;
+}
+
+bool IncrementalBytestreamHashCalculator::hasHash(const std::string& algorithm) const {
+    return hashers.find(algorithm) != hashers.end();
+}
+
+ByteArray IncrementalBytestreamHashCalculator::getHash(const std::string& algorithm) {
+    assert(hasHash(algorithm));
+    finish();
+    return hashes[algorithm];
+}
+
+ByteArray IncrementalBytestreamHashCalculator::getSHA1Hash() {
+    return getHash("sha-1");
+}
+
+ByteArray IncrementalBytestreamHashCalculator::getMD5Hash() {
+    return getHash("md5");
 }
 
 std::string IncrementalBytestreamHashCalculator::getSHA1String() {
-    assert(sha1Hasher);
-    return Hexify::hexify(getSHA1Hash());;
+    return Hexify::hexify(getSHA1Hash());
 }
 
 std::string IncrementalBytestreamHashCalculator::getMD5String() {
-    assert(md5Hasher);
-    return Hexify::hexify(getMD5Hash());;
+    return Hexify::hexify(getMD5Hash());
+}
+
+bool IncrementalBytestreamHashCalculator::isAlgorithmSupported(const std::string& algorithm, CryptoProvider* crypto) {
+    return std::unique_ptr<Hash>(createHasher(algorithm, crypto)) != nullptr;
 }
 
 }
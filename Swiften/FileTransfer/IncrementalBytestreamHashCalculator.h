@@ -5,15 +5,21 @@
  */
 
 /*
- * Copyright (c) 2013-2016 Isode Limited.
+ * Copyright (c) 2013-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #pragma once
 
+#include <condition_variable>
+#include <map>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
+#include <boost/filesystem/path.hpp>
 #include <boost/optional.hpp>
 
 #include <Swiften/Base/ByteArray.h>
@@ -23,13 +29,42 @@ namespace Swift {
     class Hash;
     class CryptoProvider;
 
+    /**
+     * Calculates hashes over a bytestream as it is transferred.
+     *
+     * Algorithms are identified by their XEP-0300 names ("sha-1", "sha-256",
+     * ...). The data passed to feedData() is hashed on a background thread,
+     * so the caller isn't blocked by the hashing. Asking for a hash waits
+     * until all data fed so far has been hashed, and finalizes the hashes.
+     *
+     * Instead of being fed the data, the calculator can also read a file
+     * itself on the background thread (see feedFile()).
+     */
     class IncrementalBytestreamHashCalculator {
     public:
         IncrementalBytestreamHashCalculator(bool doMD5, bool doSHA1, CryptoProvider* crypto);
+
+        /**
+         * Algorithms that aren't supported by the crypto provider are ignored.
+         */
+        IncrementalBytestreamHashCalculator(const std::vector<std::string>& algorithms, CryptoProvider* crypto);
         ~IncrementalBytestreamHashCalculator();
 
         void feedData(const ByteArray& data);
-        //void feedData(const SafeByteArray& data);
+
+        /**
+         * Hashes the contents of the given file, which is read on the
+         * background thread. This replaces feeding the data of the file
+         * with feedData(), so the file can be sent without passing every
+         * chunk through the calculator.
+         */
+        void feedFile(const boost::filesystem::path& file);
+
+        /**
+         * Returns whether the hash for the given algorithm is calculated.
+         */
+        bool hasHash(const std::string& algorithm) const;
+        ByteArray getHash(const std::string& algorithm);
 
         ByteArray getSHA1Hash();
         ByteArray getMD5Hash();
@@ -37,11 +72,25 @@ namespace Swift {
         std::string getSHA1String();
         std::string getMD5String();
 
+        static bool isAlgorithmSupported(const std::string& algorithm, CryptoProvider* crypto);
+
     private:
-        Hash* md5Hasher;
-        Hash* sha1Hasher;
-        boost::optional<ByteArray> md5Hash;
-        boost::optional<ByteArray> sha1Hash;
+        void run();
+        void hashFile(const boost::filesystem::path& file);
+        void finish();
+
+    private:
+        std::map<std::string, Hash*> hashers;
+        std::map<std::string, ByteArray> hashes;
+        bool finished;
+
+        ByteArray pendingData;
+        boost::optional<boost::filesystem::path> pendingFile;
+        bool stopRequested;
+        bool abortRequested;
+        std::mutex queueMutex;
+        std::condition_variable queueChanged;
+        std::thread* thread;
     };
 
 }
@@ -5,7 +5,7 @@
  */
 
 /*
- * Copyright (c) 2013-2016 Isode Limited.
+ * Copyright (c) 2013-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -30,6 +30,7 @@
 #include <Swiften/Elements/JingleIBBTransportPayload.h>
 #include <Swiften/Elements/JingleS5BTransportPayload.h>
 #include <Swiften/Elements/JingleTransportPayload.h>
+#include <Swiften/FileTransfer/FileReadBytestream.h>
 #include <Swiften/FileTransfer/FileTransferTransporter.h>
 #include <Swiften/FileTransfer/FileTransferTransporterFactory.h>
 #include <Swiften/FileTransfer/IncrementalBytestreamHashCalculator.h>
@@ -43,6 +44,9 @@ using namespace Swift;
 
 static const int DEFAULT_BLOCK_SIZE = 4096;
 
+// MD5 and SHA-1 are kept for clients that don't support SHA-256 yet.
+static const std::vector<std::string> hashAlgorithms = {"sha-256", "sha-1", "md5"};
+
 OutgoingJingleFileTransfer::OutgoingJingleFileTransfer(
         const JID& toJID,
         JingleSession::ref session,
@@ -64,10 +68,14 @@ OutgoingJingleFileTransfer::OutgoingJingleFileTransfer(
 
     setFileInfo(fileInfo.getName(), fileInfo.getSize(), fileInfo.getDescription());
 
-    // calculate both, MD5 and SHA-1 since we don't know which one the other side supports
-    hashCalculator = new IncrementalBytestreamHashCalculator(true, true, crypto);
-    stream->onRead.connect(
-            boost::bind(&IncrementalBytestreamHashCalculator::feedData, hashCalculator, _1));
+    // calculate all hashes since we don't know which one the other side supports
+    hashCalculator = new IncrementalBytestreamHashCalculator(hashAlgorithms, crypto);
+    // Files are hashed by reading them separately once the transfer starts,
+    // so the transport can send them without reading every chunk
+    if (!std::dynamic_pointer_cast<FileReadBytestream>(stream)) {
+        stream->onRead.connect(
+                boost::bind(&IncrementalBytestreamHashCalculator::feedData, hashCalculator, _1));
+    }
 
     waitForRemoteTermination = timerFactory->createTimer(5000);
     waitForRemoteTermination->onTick.connect(boost::bind(&OutgoingJingleFileTransfer::handleWaitForRemoteTerminationTimeout, this));
@@ -184,8 +192,11 @@ void OutgoingJingleFileTransfer::sendSessionInfoHash() {
     SWIFT_LOG(debug) << std::endl;
 
     JingleFileTransferHash::ref hashElement = std::make_shared<JingleFileTransferHash>();
-    hashElement->getFileInfo().addHash(HashElement("sha-1", hashCalculator->getSHA1Hash()));
-    hashElement->getFileInfo().addHash(HashElement("md5", hashCalculator->getMD5Hash()));
+    for (const auto& algorithm : hashAlgorithms) {
+        if (hashCalculator->hasHash(algorithm)) {
+            hashElement->getFileInfo().addHash(HashElement(algorithm, hashCalculator->getHash(algorithm)));
+        }
+    }
     session->sendInfo(hashElement);
 }
 
@@ -197,8 +208,11 @@ void OutgoingJingleFileTransfer::handleLocalTransportCandidatesGenerated(
     fillCandidateMap(localCandidates, candidates);
 
     JingleFileTransferDescription::ref description = std::make_shared<JingleFileTransferDescription>();
-    fileInfo.addHash(HashElement("sha-1", ByteArray()));
-    fileInfo.addHash(HashElement("md5", ByteArray()));
+    for (const auto& algorithm : hashAlgorithms) {
+        if (hashCalculator->hasHash(algorithm)) {
+            fileInfo.addHash(HashElement(algorithm, ByteArray()));
+        }
+    }
     description->setFileInfo(fileInfo);
 
     JingleTransportPayload::ref transport;
@@ -259,6 +273,9 @@ void OutgoingJingleFileTransfer::startTransferring(std::shared_ptr<TransportSess
     SWIFT_LOG(debug) << std::endl;
 
     this->transportSession = transportSession;
+    if (std::shared_ptr<FileReadBytestream> fileStream = std::dynamic_pointer_cast<FileReadBytestream>(stream)) {
+        hashCalculator->feedFile(fileStream->getFile());
+    }
     processedBytesConnection = transportSession->onBytesSent.connect(
             boost::bind(boost::ref(onProcessedBytes), _1));
     transferFinishedConnection = transportSession->onFinished.connect(
@@ -5,7 +5,7 @@
  */
 
 /*
- * Copyright (c) 2013-2016 Isode Limited.
+ * Copyright (c) 2013-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -21,6 +21,7 @@
 #include <Swiften/Base/Log.h>
 #include <Swiften/Base/SafeByteArray.h>
 #include <Swiften/FileTransfer/BytestreamException.h>
+#include <Swiften/FileTransfer/FileReadBytestream.h>
 #include <Swiften/Network/TimerFactory.h>
 #include <Swiften/StringCodecs/Hexify.h>
 
@@ -66,6 +67,7 @@ void SOCKS5BytestreamClientSession::stop() {
     }
     closeConnection();
     readBytestream.reset();
+    fileBytestream.reset();
     state = Finished;
 }
 
@@ -176,6 +178,16 @@ void SOCKS5BytestreamClientSession::startSending(std::shared_ptr<ReadBytestream>
     if (state == Ready) {
         state = Writing;
         readBytestream = readStream;
+        if (connection->canWriteFile()) {
+            // Send straight from the file. If onRead has listeners, every chunk has
+            // to be read for them anyway, and sending the chunk that was read beats
+            // reading it a second time. Jingle transfers hash the file separately
+            // (see IncrementalBytestreamHashCalculator::feedFile()), so they have none.
+            fileBytestream = std::dynamic_pointer_cast<FileReadBytestream>(readStream);
+            if (fileBytestream && !fileBytestream->onRead.empty()) {
+                fileBytestream.reset();
+            }
+        }
         dataWrittenConnection = connection->onDataWritten.connect(
                 boost::bind(&SOCKS5BytestreamClientSession::sendData, this));
         sendData();
@@ -189,7 +201,10 @@ HostAddressPort SOCKS5BytestreamClientSession::getAddressPort() const {
 }
 
 void SOCKS5BytestreamClientSession::sendData() {
-    if (!readBytestream->isFinished()) {
+    if (fileBytestream) {
+        sendFileData();
+    }
+    else if (!readBytestream->isFinished()) {
         try {
             std::shared_ptr<ByteArray> dataToSend = readBytestream->read(boost::numeric_cast<size_t>(chunkSize));
             connection->write(createSafeByteArray(*dataToSend));
@@ -204,6 +219,18 @@ void SOCKS5BytestreamClientSession::sendData() {
     }
 }
 
+void SOCKS5BytestreamClientSession::sendFileData() {
+    if (!fileBytestream->isFinished()) {
+        std::pair<unsigned long long, size_t> chunk = fileBytestream->skip(boost::numeric_cast<size_t>(chunkSize));
+        if (chunk.second > 0) {
+            connection->writeFile(fileBytestream->getFile(), chunk.first, chunk.second);
+            onBytesSent(chunk.second);
+            return;
+        }
+    }
+    finish(false);
+}
+
 void SOCKS5BytestreamClientSession::finish(bool error) {
     SWIFT_LOG(debug) << std::endl;
     if (state < Ready) {
@@ -211,6 +238,7 @@ void SOCKS5BytestreamClientSession::finish(bool error) {
     }
     closeConnection();
     readBytestream.reset();
+    fileBytestream.reset();
     if (state == Initial || state == Hello || state == Authenticating) {
         onSessionReady(true);
     }
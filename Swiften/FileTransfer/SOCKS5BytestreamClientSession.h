@@ -5,7 +5,7 @@
  */
 
 /*
- * Copyright (c) 2015-2017 Isode Limited.
+ * Copyright (c) 2015-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -29,6 +29,7 @@
 namespace Swift {
 
 class Connection;
+class FileReadBytestream;
 class TimerFactory;
 
 /**
@@ -84,6 +85,7 @@ private:
 
     void finish(bool error);
     void sendData();
+    void sendFileData();
     void closeConnection();
 
 private:
@@ -99,6 +101,7 @@ private:
     int chunkSize;
     std::shared_ptr<WriteBytestream> writeBytestream;
     std::shared_ptr<ReadBytestream> readBytestream;
+    std::shared_ptr<FileReadBytestream> fileBytestream;
 
     Timer::ref weFailedTimeout;
 
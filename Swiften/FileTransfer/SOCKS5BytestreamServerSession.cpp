@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -15,6 +15,7 @@
 #include <Swiften/Base/Log.h>
 #include <Swiften/Base/SafeByteArray.h>
 #include <Swiften/FileTransfer/BytestreamException.h>
+#include <Swiften/FileTransfer/FileReadBytestream.h>
 #include <Swiften/FileTransfer/SOCKS5BytestreamRegistry.h>
 #include <Swiften/Network/HostAddressPort.h>
 
@@ -53,6 +54,16 @@ void SOCKS5BytestreamServerSession::startSending(std::shared_ptr<ReadBytestream>
     if (state != ReadyForTransfer) { SWIFT_LOG(debug) << "Not ready for transfer!" << std::endl; return; }
 
     readBytestream = stream;
+    if (connection->canWriteFile()) {
+        // Send straight from the file. If onRead has listeners, every chunk has
+        // to be read for them anyway, and sending the chunk that was read beats
+        // reading it a second time. Jingle transfers hash the file separately
+        // (see IncrementalBytestreamHashCalculator::feedFile()), so they have none.
+        fileBytestream = std::dynamic_pointer_cast<FileReadBytestream>(stream);
+        if (fileBytestream && !fileBytestream->onRead.empty()) {
+            fileBytestream.reset();
+        }
+    }
     state = WritingData;
     dataAvailableConnection = readBytestream->onDataAvailable.connect(
             boost::bind(&SOCKS5BytestreamServerSession::handleDataAvailable, this));
@@ -156,7 +167,10 @@ void SOCKS5BytestreamServerSession::process() {
 }
 
 void SOCKS5BytestreamServerSession::sendData() {
-    if (!readBytestream->isFinished()) {
+    if (fileBytestream) {
+        sendFileData();
+    }
+    else if (!readBytestream->isFinished()) {
         try {
             SafeByteArray dataToSend = createSafeByteArray(*readBytestream->read(boost::numeric_cast<size_t>(chunkSize)));
             if (!dataToSend.empty()) {
@@ -177,6 +191,18 @@ void SOCKS5BytestreamServerSession::sendData() {
     }
 }
 
+void SOCKS5BytestreamServerSession::sendFileData() {
+    if (!fileBytestream->isFinished()) {
+        std::pair<unsigned long long, size_t> chunk = fileBytestream->skip(boost::numeric_cast<size_t>(chunkSize));
+        if (chunk.second > 0) {
+            connection->writeFile(fileBytestream->getFile(), chunk.first, chunk.second);
+            onBytesSent(chunk.second);
+            return;
+        }
+    }
+    finish();
+}
+
 void SOCKS5BytestreamServerSession::finish(const boost::optional<FileTransferError>& error) {
     SWIFT_LOG(debug) << "state: " << state << std::endl;
     if (state == Finished) {
@@ -188,6 +214,7 @@ void SOCKS5BytestreamServerSession::finish(const boost::optional<FileTransferErr
     dataWrittenConnection.disconnect();
     dataAvailableConnection.disconnect();
     readBytestream.reset();
+    fileBytestream.reset();
     state = Finished;
     onFinished(error);
 }
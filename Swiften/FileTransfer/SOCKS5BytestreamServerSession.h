@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -17,6 +17,7 @@
 #include <Swiften/Network/Connection.h>
 
 namespace Swift {
+    class FileReadBytestream;
     class SOCKS5BytestreamRegistry;
 
     class SWIFTEN_API SOCKS5BytestreamServerSession {
@@ -63,6 +64,7 @@ namespace Swift {
             void handleDisconnected(const boost::optional<Connection::Error>&);
             void handleDataAvailable();
             void sendData();
+            void sendFileData();
 
         private:
             std::shared_ptr<Connection> connection;
@@ -72,6 +74,7 @@ namespace Swift {
             int chunkSize;
             std::string streamID;
             std::shared_ptr<ReadBytestream> readBytestream;
+            std::shared_ptr<FileReadBytestream> fileBytestream;
             std::shared_ptr<WriteBytestream> writeBytestream;
             bool waitingForData;
 
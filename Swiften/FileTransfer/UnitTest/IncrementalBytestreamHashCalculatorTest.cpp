@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <memory>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <QA/Checker/IO.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+
+#include <Swiften/Base/ByteArray.h>
+#include <Swiften/Crypto/CryptoProvider.h>
+#include <Swiften/Crypto/PlatformCryptoProvider.h>
+#include <Swiften/FileTransfer/IncrementalBytestreamHashCalculator.h>
+#include <Swiften/StringCodecs/Hexify.h>
+
+using namespace Swift;
+
+class IncrementalBytestreamHashCalculatorTest : public CppUnit::TestFixture {
+        CPPUNIT_TEST_SUITE(IncrementalBytestreamHashCalculatorTest);
+        CPPUNIT_TEST(testGetHash);
+        CPPUNIT_TEST(testGetHash_NoData);
+        CPPUNIT_TEST(testGetHash_ManyChunks);
+        CPPUNIT_TEST(testGetHash_Twice);
+        CPPUNIT_TEST(testHasHash);
+        CPPUNIT_TEST(testDestroyWithoutGettingHash);
+        CPPUNIT_TEST(testFeedData_NoHashes);
+        CPPUNIT_TEST(testFeedFile);
+        CPPUNIT_TEST(testDestroyWhileHashingFile);
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+        void setUp() {
+            crypto = std::shared_ptr<CryptoProvider>(PlatformCryptoProvider::create());
+        }
+
+        void testGetHash() {
+            IncrementalBytestreamHashCalculator testling({"md5", "sha-1", "sha-256"}, crypto.get());
+            testling.feedData(createByteArray("The quick brown fox "));
+            testling.feedData(createByteArray("jumps over the lazy dog"));
+
+            CPPUNIT_ASSERT_EQUAL(std::string("9e107d9d372bb6826bd81d3542a419d6"), testling.getMD5String());
+            CPPUNIT_ASSERT_EQUAL(std::string("2fd4e1c67a2d28fced849ee1bb76e7391b93eb12"), testling.getSHA1String());
+            if (testling.hasHash("sha-256")) {
+                CPPUNIT_ASSERT_EQUAL(std::string("d7a8fbb307d7809469ca9abcb0082e4f8d5651e46d3cdb762d02d0bf37c9e592"), Hexify::hexify(testling.getHash("sha-256")));
+            }
+        }
+
+        void testGetHash_NoData() {
+            IncrementalBytestreamHashCalculator testling(true, true, crypto.get());
+
+            CPPUNIT_ASSERT_EQUAL(std::string("d41d8cd98f00b204e9800998ecf8427e"), testling.getMD5String());
+            CPPUNIT_ASSERT_EQUAL(std::string("da39a3ee5e6b4b0d3255bfef95601890afd80709"), testling.getSHA1String());
+        }
+
+        void testGetHash_ManyChunks() {
+            IncrementalBytestreamHashCalculator testling({"sha-1"}, crypto.get());
+            ByteArray data;
+            ByteArray chunk(4096);
+            for (size_t i = 0; i < 4096; ++i) {
+                for (size_t j = 0; j < chunk.size(); ++j) {
+                    chunk[j] = static_cast<unsigned char>(i + j);
+                }
+                testling.feedData(chunk);
+                data.insert(data.end(), chunk.begin(), chunk.end());
+            }
+
+            CPPUNIT_ASSERT_EQUAL(crypto->getSHA1Hash(data), testling.getSHA1Hash());
+        }
+
+        void testGetHash_Twice() {
+            IncrementalBytestreamHashCalculator testling({"sha-1"}, crypto.get());
+            testling.feedData(createByteArray("abc"));
+
+            CPPUNIT_ASSERT_EQUAL(std::string("a9993e364706816aba3e25717850c26c9cd0d89d"), testling.getSHA1String());
+            CPPUNIT_ASSERT_EQUAL(std::string("a9993e364706816aba3e25717850c26c9cd0d89d"), testling.getSHA1String());
+        }
+
+        void testHasHash() {
+            IncrementalBytestreamHashCalculator testling({"sha-1", "blake2b-256"}, crypto.get());
+
+            CPPUNIT_ASSERT(testling.hasHash("sha-1"));
+            CPPUNIT_ASSERT(!testling.hasHash("md5"));
+            CPPUNIT_ASSERT(!testling.hasHash("blake2b-256"));
+        }
+
+        void testDestroyWithoutGettingHash() {
+            std::unique_ptr<IncrementalBytestreamHashCalculator> testling(new IncrementalBytestreamHashCalculator({"sha-1"}, crypto.get()));
+            testling->feedData(ByteArray(1024 * 1024));
+            testling.reset();
+        }
+
+        void testFeedData_NoHashes() {
+            IncrementalBytestreamHashCalculator testling(std::vector<std::string>(), crypto.get());
+            testling.feedData(createByteArray("abc"));
+
+            CPPUNIT_ASSERT(!testling.hasHash("sha-1"));
+        }
+
+        void testFeedFile() {
+            ByteArray data;
+            for (size_t i = 0; i < 3 * 1024 * 1024 + 17; ++i) {
+                data.push_back(static_cast<unsigned char>(i * 7));
+            }
+            boost::filesystem::path file = writeFile(data);
+            IncrementalBytestreamHashCalculator testling({"md5", "sha-1"}, crypto.get());
+            testling.feedFile(file);
+
+            CPPUNIT_ASSERT_EQUAL(crypto->getSHA1Hash(data), testling.getSHA1Hash());
+            CPPUNIT_ASSERT_EQUAL(crypto->getMD5Hash(data), testling.getMD5Hash());
+            boost::filesystem::remove(file);
+        }
+
+        void testDestroyWhileHashingFile() {
+            boost::filesystem::path file = writeFile(ByteArray(16 * 1024 * 1024));
+            std::unique_ptr<IncrementalBytestreamHashCalculator> testling(new IncrementalBytestreamHashCalculator({"sha-1"}, crypto.get()));
+            testling->feedFile(file);
+            testling.reset();
+            boost::filesystem::remove(file);
+        }
+
+    private:
+        boost::filesystem::path writeFile(const ByteArray& data) {
+            boost::filesystem::path file = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("swift-hash-test-%%%%%%%%");
+            boost::filesystem::ofstream stream(file, std::ios_base::out|std::ios_base::binary);
+            stream.write(reinterpret_cast<const char*>(vecptr(data)), static_cast<std::streamsize>(data.size()));
+            return file;
+        }
+
+    private:
+        std::shared_ptr<CryptoProvider> crypto;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(IncrementalBytestreamHashCalculatorTest);
@@ -1,10 +1,12 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <boost/bind.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
 
 #include <cppunit/extensions/HelperMacros.h>
 #include <cppunit/extensions/TestFactoryRegistry.h>
@@ -12,11 +14,16 @@
 #include <Swiften/Base/ByteArray.h>
 #include <Swiften/Base/Concat.h>
 #include <Swiften/Base/StartStopper.h>
+#include <Swiften/Crypto/CryptoProvider.h>
+#include <Swiften/Crypto/PlatformCryptoProvider.h>
 #include <Swiften/EventLoop/DummyEventLoop.h>
 #include <Swiften/FileTransfer/ByteArrayReadBytestream.h>
+#include <Swiften/FileTransfer/FileReadBytestream.h>
+#include <Swiften/FileTransfer/IncrementalBytestreamHashCalculator.h>
 #include <Swiften/FileTransfer/SOCKS5BytestreamRegistry.h>
 #include <Swiften/FileTransfer/SOCKS5BytestreamServerSession.h>
 #include <Swiften/Network/DummyConnection.h>
+#include <Swiften/StringCodecs/Hexify.h>
 
 using namespace Swift;
 
@@ -28,6 +35,8 @@ class SOCKS5BytestreamServerSessionTest : public CppUnit::TestFixture {
         CPPUNIT_TEST(testRequest_UnknownBytestream);
         CPPUNIT_TEST(testReceiveData);
         CPPUNIT_TEST(testReceiveData_Chunked);
+        CPPUNIT_TEST(testReceiveData_WrittenFromFile);
+        CPPUNIT_TEST(testReceiveData_WrittenFromFileWithReadListener);
         CPPUNIT_TEST(testDataStreamPauseStopsSendingData);
         CPPUNIT_TEST(testDataStreamResumeAfterPauseSendsData);
         CPPUNIT_TEST_SUITE_END();
@@ -120,6 +129,53 @@ class SOCKS5BytestreamServerSessionTest : public CppUnit::TestFixture {
             CPPUNIT_ASSERT_EQUAL(4, receivedDataChunks);
         }
 
+        void testReceiveData_WrittenFromFile() {
+            boost::filesystem::path file = createFile("abcdefg");
+            std::shared_ptr<SOCKS5BytestreamServerSession> testling(createSession());
+            testling->setChunkSize(3);
+            connection->fileWritesSupported = true;
+            StartStopper<SOCKS5BytestreamServerSession> stopper(testling.get());
+            bytestreams->setHasBytestream("abcdef", true);
+            authenticate();
+            request("abcdef");
+            eventLoop->processEvents();
+            testling->startSending(std::make_shared<FileReadBytestream>(file));
+            eventLoop->processEvents();
+            skipHeader("abcdef");
+            boost::filesystem::remove(file);
+
+            CPPUNIT_ASSERT(createByteArray("abcdefg") == receivedData);
+            CPPUNIT_ASSERT_EQUAL(4, receivedDataChunks);
+            CPPUNIT_ASSERT_EQUAL(3, connection->fileWrites);
+            CPPUNIT_ASSERT(finished);
+            CPPUNIT_ASSERT(!error);
+        }
+
+        void testReceiveData_WrittenFromFileWithReadListener() {
+            boost::filesystem::path file = createFile("abcdefg");
+            std::shared_ptr<FileReadBytestream> stream = std::make_shared<FileReadBytestream>(file);
+            std::shared_ptr<CryptoProvider> crypto(PlatformCryptoProvider::create());
+            IncrementalBytestreamHashCalculator hashCalculator({"sha-1"}, crypto.get());
+            stream->onRead.connect(boost::bind(&IncrementalBytestreamHashCalculator::feedData, &hashCalculator, _1));
+            std::shared_ptr<SOCKS5BytestreamServerSession> testling(createSession());
+            testling->setChunkSize(3);
+            connection->fileWritesSupported = true;
+            StartStopper<SOCKS5BytestreamServerSession> stopper(testling.get());
+            bytestreams->setHasBytestream("abcdef", true);
+            authenticate();
+            request("abcdef");
+            eventLoop->processEvents();
+            testling->startSending(stream);
+            eventLoop->processEvents();
+            skipHeader("abcdef");
+            boost::filesystem::remove(file);
+
+            // The chunks are read for hashing, so they are sent as read instead of reading them again
+            CPPUNIT_ASSERT(createByteArray("abcdefg") == receivedData);
+            CPPUNIT_ASSERT_EQUAL(0, connection->fileWrites);
+            CPPUNIT_ASSERT_EQUAL(std::string("2fb5e13419fc89246865e7a324f476ec624e8740"), Hexify::hexify(hashCalculator.getHash("sha-1")));
+        }
+
         void testDataStreamPauseStopsSendingData() {
             std::shared_ptr<SOCKS5BytestreamServerSession> testling(createSession());
             testling->setChunkSize(3);
@@ -187,6 +243,13 @@ class SOCKS5BytestreamServerSessionTest : public CppUnit::TestFixture {
             receivedDataChunks++;
         }
 
+        boost::filesystem::path createFile(const std::string& data) {
+            boost::filesystem::path file = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("swift-s5b-test-%%%%%%%%");
+            boost::filesystem::ofstream stream(file, std::ios_base::out|std::ios_base::binary);
+            stream << data;
+            return file;
+        }
+
     private:
         SOCKS5BytestreamServerSession* createSession() {
             SOCKS5BytestreamServerSession* session = new SOCKS5BytestreamServerSession(connection, bytestreams);
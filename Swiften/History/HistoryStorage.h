@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -19,6 +19,19 @@
 namespace Swift {
     typedef std::map<JID, std::set<boost::gregorian::date> > ContactsMap;
 
+    /**
+     * One page of results from HistoryStorage::searchMessages(), newest first.
+     */
+    struct HistorySearchResult {
+        std::vector<HistoryMessage> messages;
+
+        /**
+         * The cursor to pass to searchMessages() to get the next page, or 0
+         * if this is the last page.
+         */
+        long long nextCursor = 0;
+    };
+
     class SWIFTEN_API HistoryStorage {
         /**
          * Messages are stored using localtime timestamps.
@@ -32,5 +45,16 @@ namespace Swift {
             virtual std::vector<HistoryMessage> getMessagesFromPreviousDate(const JID& selfJID, const JID& contactJID, HistoryMessage::Type type, const boost::gregorian::date& date) const = 0;
             virtual ContactsMap getContacts(const JID& selfJID, HistoryMessage::Type type, const std::string& keyword) const = 0;
             virtual boost::posix_time::ptime getLastTimeStampFromMUC(const JID& selfJID, const JID& mucJID) const = 0;
+
+            /**
+             * Searches the messages sent or received by selfJID for query. It
+             * matches if it occurs anywhere in the message, ignoring case, like
+             * the keyword of getContacts().
+             *
+             * @param limit The maximum number of messages to return.
+             * @param cursor 0 to get the newest matches, or the nextCursor of
+             *  a previous result to continue from there.
+             */
+            virtual HistorySearchResult searchMessages(const JID& selfJID, const std::string& query, size_t limit, long long cursor = 0) const = 0;
     };
 }
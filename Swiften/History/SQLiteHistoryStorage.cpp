@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -7,6 +7,7 @@
 #include <Swiften/History/SQLiteHistoryStorage.h>
 
 #include <iostream>
+#include <limits>
 
 #include <boost/bind.hpp>
 #include <boost/date_time/gregorian/gregorian.hpp>
@@ -17,6 +18,10 @@
 
 #include <Swiften/Base/Path.h>
 
+// SQLITE_STATIC, without its C-style cast. The bound text has to stay alive
+// until the statement is reset.
+static const sqlite3_destructor_type staticText = nullptr;
+
 inline std::string getEscapedString(const std::string& s) {
     std::string result(s);
 
@@ -28,56 +33,256 @@ inline std::string getEscapedString(const std::string& s) {
     return result;
 }
 
-namespace Swift {
+inline size_t getCharacterCount(const std::string& s) {
+    size_t result = 0;
+    for (char c : s) {
+        // Count everything but UTF-8 continuation bytes
+        if ((static_cast<unsigned char>(c) & 0xC0) != 0x80) {
+            ++result;
+        }
+    }
+    return result;
+}
 
-SQLiteHistoryStorage::SQLiteHistoryStorage(const boost::filesystem::path& file) : db_(nullptr) {
-    thread_ = new std::thread(boost::bind(&SQLiteHistoryStorage::run, this));
+/**
+ * Turns a user-entered keyword into a trigram FTS5 phrase query matching
+ * messages that contain it.
+ *
+ * The trigram index can't look up keywords shorter than three characters, so
+ * these give an empty query. The index is only used to narrow down the
+ * candidates for the LIKE pattern, which decides what matches.
+ */
+inline std::string getFullTextQuery(const std::string& keyword) {
+    if (getCharacterCount(keyword) < 3) {
+        return std::string();
+    }
+    std::string result("\"");
+    for (char c : keyword) {
+        result += c;
+        if (c == '"') {
+            result += '"';
+        }
+    }
+    result += "\"";
+    return result;
+}
 
+/**
+ * Turns a keyword into a LIKE pattern matching any text containing it.
+ */
+inline std::string getLikePattern(const std::string& keyword) {
+    std::string result("%");
+    for (char c : keyword) {
+        if (c == '%' || c == '_' || c == '\\') {
+            result += '\\';
+        }
+        result += c;
+    }
+    result += "%";
+    return result;
+}
+
+namespace Swift {
+
+SQLiteHistoryStorage::SQLiteHistoryStorage(const boost::filesystem::path& file) : db_(nullptr), insertMessageStatement_(nullptr), insertJIDStatement_(nullptr), selectIDFromJIDStatement_(nullptr), selectJIDFromIDStatement_(nullptr), fullTextSearch_(false), stopRequested_(false) {
     sqlite3_open(pathToString(file).c_str(), &db_);
     if (!db_) {
         std::cerr << "Error opening database " << pathToString(file) << std::endl;
     }
 
-    char* errorMessage;
-    int result = sqlite3_exec(db_, "CREATE TABLE IF NOT EXISTS messages('message' STRING, 'fromBare' INTEGER, 'fromResource' STRING, 'toBare' INTEGER, 'toResource' STRING, 'type' INTEGER, 'time' INTEGER, 'offset' INTEGER)", nullptr, nullptr, &errorMessage);
-    if (result != SQLITE_OK) {
-        std::cerr << "SQL Error: " << errorMessage << std::endl;
-        sqlite3_free(errorMessage);
-    }
+    // The id comes last, so 'SELECT *' still returns the message columns from the first one on.
+    executeStatement("CREATE TABLE IF NOT EXISTS messages('message' STRING, 'fromBare' INTEGER, 'fromResource' STRING, 'toBare' INTEGER, 'toResource' STRING, 'type' INTEGER, 'time' INTEGER, 'offset' INTEGER, 'id' INTEGER PRIMARY KEY)");
+    addMessageIDs();
+    executeStatement("CREATE TABLE IF NOT EXISTS jids('id' INTEGER PRIMARY KEY ASC AUTOINCREMENT, 'jid' STRING UNIQUE NOT NULL)");
+    executeStatement("CREATE INDEX IF NOT EXISTS messages_conversation ON messages('fromBare', 'toBare', 'type', 'time')");
+    fullTextSearch_ = setUpFullTextSearch();
 
-    result = sqlite3_exec(db_, "CREATE TABLE IF NOT EXISTS jids('id' INTEGER PRIMARY KEY ASC AUTOINCREMENT, 'jid' STRING UNIQUE NOT NULL)", nullptr, nullptr, &errorMessage);
-    if (result != SQLITE_OK) {
-        std::cerr << "SQL Error: " << errorMessage << std::endl;
-        sqlite3_free(errorMessage);
-    }
+    insertMessageStatement_ = prepareStatement("INSERT INTO messages('message', 'fromBare', 'fromResource', 'toBare', 'toResource', 'type', 'time', 'offset') VALUES(?, ?, ?, ?, ?, ?, ?, ?)");
+    insertJIDStatement_ = prepareStatement("INSERT INTO jids('jid') VALUES(?)");
+    selectIDFromJIDStatement_ = prepareStatement("SELECT id FROM jids WHERE jid=?");
+    selectJIDFromIDStatement_ = prepareStatement("SELECT jid FROM jids WHERE id=?");
+
+    thread_ = new std::thread(boost::bind(&SQLiteHistoryStorage::run, this));
 }
 
 SQLiteHistoryStorage::~SQLiteHistoryStorage() {
-    sqlite3_close(db_);
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        stopRequested_ = true;
+    }
+    queueNonEmpty_.notify_one();
+    thread_->join();
     delete thread_;
+
+    flush();
+
+    sqlite3_finalize(insertMessageStatement_);
+    sqlite3_finalize(insertJIDStatement_);
+    sqlite3_finalize(selectIDFromJIDStatement_);
+    sqlite3_finalize(selectJIDFromIDStatement_);
+    sqlite3_close(db_);
 }
 
 void SQLiteHistoryStorage::addMessage(const HistoryMessage& message) {
-    int secondsSinceEpoch = (message.getTime() - boost::posix_time::ptime(boost::gregorian::date(1970, 1, 1))).total_seconds();
-
-    std::string statement = std::string("INSERT INTO messages('message', 'fromBare', 'fromResource', 'toBare', 'toResource', 'type', 'time', 'offset') VALUES(") +
-                    "'" + getEscapedString(message.getMessage()) + "', " +
-                    boost::lexical_cast<std::string>(getIDForJID(message.getFromJID().toBare())) + ", '" +
-                    getEscapedString(message.getFromJID().getResource()) + "', " +
-                    boost::lexical_cast<std::string>(getIDForJID(message.getToJID().toBare())) + ", '" +
-                    getEscapedString(message.getToJID().getResource()) + "', " +
-                    boost::lexical_cast<std::string>(message.getType()) + ", " +
-                    boost::lexical_cast<std::string>(secondsSinceEpoch) + ", " +
-                    boost::lexical_cast<std::string>(message.getOffset()) + ")";
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        pendingMessages_.push_back(message);
+    }
+    queueNonEmpty_.notify_one();
+}
+
+void SQLiteHistoryStorage::flush() const {
+    std::lock_guard<std::mutex> lock(dbMutex_);
+    writePendingMessages();
+}
+
+void SQLiteHistoryStorage::run() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(queueMutex_);
+            while (pendingMessages_.empty() && !stopRequested_) {
+                queueNonEmpty_.wait(lock);
+            }
+            if (pendingMessages_.empty()) {
+                break;
+            }
+        }
+        // Messages that arrive while a batch is being committed are picked
+        // up together by the next iteration.
+        flush();
+    }
+}
+
+void SQLiteHistoryStorage::writePendingMessages() const {
+    std::vector<HistoryMessage> messages;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        messages.swap(pendingMessages_);
+    }
+    if (messages.empty()) {
+        return;
+    }
+
+    executeStatement("BEGIN TRANSACTION");
+    for (const auto& message : messages) {
+        writeMessage(message);
+    }
+    executeStatement("COMMIT TRANSACTION");
+}
+
+void SQLiteHistoryStorage::writeMessage(const HistoryMessage& message) const {
+    long long secondsSinceEpoch = (message.getTime() - boost::posix_time::ptime(boost::gregorian::date(1970, 1, 1))).total_seconds();
+    boost::optional<long long> fromID = getIDForJID(message.getFromJID().toBare());
+    boost::optional<long long> toID = getIDForJID(message.getToJID().toBare());
+    if (!fromID || !toID) {
+        return;
+    }
+
+    sqlite3_bind_text(insertMessageStatement_, 1, message.getMessage().c_str(), boost::numeric_cast<int>(message.getMessage().size()), staticText);
+    sqlite3_bind_int64(insertMessageStatement_, 2, *fromID);
+    sqlite3_bind_text(insertMessageStatement_, 3, message.getFromJID().getResource().c_str(), boost::numeric_cast<int>(message.getFromJID().getResource().size()), staticText);
+    sqlite3_bind_int64(insertMessageStatement_, 4, *toID);
+    sqlite3_bind_text(insertMessageStatement_, 5, message.getToJID().getResource().c_str(), boost::numeric_cast<int>(message.getToJID().getResource().size()), staticText);
+    sqlite3_bind_int(insertMessageStatement_, 6, message.getType());
+    sqlite3_bind_int64(insertMessageStatement_, 7, secondsSinceEpoch);
+    sqlite3_bind_int(insertMessageStatement_, 8, message.getOffset());
+    if (sqlite3_step(insertMessageStatement_) != SQLITE_DONE) {
+        std::cerr << "SQL Error: " << sqlite3_errmsg(db_) << std::endl;
+    }
+    sqlite3_reset(insertMessageStatement_);
+    sqlite3_clear_bindings(insertMessageStatement_);
+}
+
+void SQLiteHistoryStorage::executeStatement(const char* statement) const {
     char* errorMessage;
-    int result = sqlite3_exec(db_, statement.c_str(), nullptr, nullptr, &errorMessage);
+    int result = sqlite3_exec(db_, statement, nullptr, nullptr, &errorMessage);
     if (result != SQLITE_OK) {
         std::cerr << "SQL Error: " << errorMessage << std::endl;
         sqlite3_free(errorMessage);
     }
 }
 
+sqlite3_stmt* SQLiteHistoryStorage::prepareStatement(const char* statement) const {
+    sqlite3_stmt* result = nullptr;
+    if (sqlite3_prepare_v2(db_, statement, -1, &result, nullptr) != SQLITE_OK) {
+        std::cerr << "SQL Error: " << sqlite3_errmsg(db_) << std::endl;
+    }
+    return result;
+}
+
+void SQLiteHistoryStorage::addMessageIDs() {
+    bool hasID = false;
+    sqlite3_stmt* columnsStatement = prepareStatement("PRAGMA table_info(messages)");
+    while (sqlite3_step(columnsStatement) == SQLITE_ROW) {
+        if (std::string(reinterpret_cast<const char*>(sqlite3_column_text(columnsStatement, 1))) == "id") {
+            hasID = true;
+        }
+    }
+    sqlite3_finalize(columnsStatement);
+    if (hasID) {
+        return;
+    }
+
+    // Databases from before the search index keep messages by implicit rowid,
+    // which a VACUUM may renumber. Copy them into a table with a stable id,
+    // and drop any index that refers to the old rowids.
+    executeStatement("BEGIN TRANSACTION");
+    executeStatement("DROP TRIGGER IF EXISTS messages_search_insert");
+    executeStatement("DROP TRIGGER IF EXISTS messages_search_delete");
+    executeStatement("DROP TRIGGER IF EXISTS messages_search_update");
+    executeStatement("DROP TABLE IF EXISTS messages_search");
+    executeStatement("ALTER TABLE messages RENAME TO messages_old");
+    executeStatement("CREATE TABLE messages('message' STRING, 'fromBare' INTEGER, 'fromResource' STRING, 'toBare' INTEGER, 'toResource' STRING, 'type' INTEGER, 'time' INTEGER, 'offset' INTEGER, 'id' INTEGER PRIMARY KEY)");
+    executeStatement("INSERT INTO messages('message', 'fromBare', 'fromResource', 'toBare', 'toResource', 'type', 'time', 'offset') "
+            "SELECT message, fromBare, fromResource, toBare, toResource, type, time, offset FROM messages_old ORDER BY rowid");
+    executeStatement("DROP TABLE messages_old");
+    executeStatement("COMMIT TRANSACTION");
+}
+
+bool SQLiteHistoryStorage::setUpFullTextSearch() {
+    sqlite3_stmt* selectStatement = prepareStatement("SELECT sql FROM sqlite_master WHERE name='messages_search'");
+    bool exists = false;
+    if (sqlite3_step(selectStatement) == SQLITE_ROW) {
+        exists = true;
+        if (std::string(reinterpret_cast<const char*>(sqlite3_column_text(selectStatement, 0))).find("trigram") == std::string::npos) {
+            // A word index can't find arbitrary substrings like LIKE does, so replace it.
+            exists = false;
+        }
+    }
+    sqlite3_finalize(selectStatement);
+
+    if (!exists) {
+        executeStatement("DROP TABLE IF EXISTS messages_search");
+        executeStatement("DROP TRIGGER IF EXISTS messages_search_insert");
+        executeStatement("DROP TRIGGER IF EXISTS messages_search_delete");
+        executeStatement("DROP TRIGGER IF EXISTS messages_search_update");
+        // Not every SQLite build has FTS5 with the trigram tokenizer (3.34 and
+        // later), so failing here only disables the index.
+        if (sqlite3_exec(db_, "CREATE VIRTUAL TABLE messages_search USING fts5(message, content='messages', content_rowid='id', tokenize='trigram')", nullptr, nullptr, nullptr) != SQLITE_OK) {
+            return false;
+        }
+    }
+    executeStatement("CREATE TRIGGER IF NOT EXISTS messages_search_insert AFTER INSERT ON messages BEGIN "
+            "INSERT INTO messages_search(rowid, message) VALUES(new.id, new.message); END");
+    executeStatement("CREATE TRIGGER IF NOT EXISTS messages_search_delete AFTER DELETE ON messages BEGIN "
+            "INSERT INTO messages_search(messages_search, rowid, message) VALUES('delete', old.id, old.message); END");
+    executeStatement("CREATE TRIGGER IF NOT EXISTS messages_search_update AFTER UPDATE ON messages BEGIN "
+            "INSERT INTO messages_search(messages_search, rowid, message) VALUES('delete', old.id, old.message); "
+            "INSERT INTO messages_search(rowid, message) VALUES(new.id, new.message); END");
+    if (!exists) {
+        // Index the messages stored before the index existed.
+        executeStatement("INSERT INTO messages_search(messages_search) VALUES('rebuild')");
+    }
+    return true;
+}
+
 std::vector<HistoryMessage> SQLiteHistoryStorage::getMessagesFromDate(const JID& selfJID, const JID& contactJID, HistoryMessage::Type type, const boost::gregorian::date& date) const {
+    std::lock_guard<std::mutex> lock(dbMutex_);
+    writePendingMessages();
+    return queryMessagesFromDate(selfJID, contactJID, type, date);
+}
+
+std::vector<HistoryMessage> SQLiteHistoryStorage::queryMessagesFromDate(const JID& selfJID, const JID& contactJID, HistoryMessage::Type type, const boost::gregorian::date& date) const {
     sqlite3_stmt* selectStatement;
 
     boost::optional<long long> selfID = getIDFromJID(selfJID.toBare());
@@ -122,33 +327,7 @@ std::vector<HistoryMessage> SQLiteHistoryStorage::getMessagesFromDate(const JID&
     // Retrieve result
     std::vector<HistoryMessage> result;
     while (r == SQLITE_ROW) {
-        std::string message(reinterpret_cast<const char*>(sqlite3_column_text(selectStatement, 0)));
-
-        // fromJID
-        boost::optional<JID> fromJID(getJIDFromID(sqlite3_column_int(selectStatement, 1)));
-        std::string fromResource(reinterpret_cast<const char*>(sqlite3_column_text(selectStatement, 2)));
-        if (fromJID) {
-            fromJID = boost::optional<JID>(JID(fromJID->getNode(), fromJID->getDomain(), fromResource));
-        }
-
-        // toJID
-        boost::optional<JID> toJID(getJIDFromID(sqlite3_column_int(selectStatement, 3)));
-        std::string toResource(reinterpret_cast<const char*>(sqlite3_column_text(selectStatement, 4)));
-        if (toJID) {
-            toJID = boost::optional<JID>(JID(toJID->getNode(), toJID->getDomain(), toResource));
-        }
-
-        // message type
-        HistoryMessage::Type type = static_cast<HistoryMessage::Type>(sqlite3_column_int(selectStatement, 5));
-
-        // timestamp
-        int secondsSinceEpoch(sqlite3_column_int(selectStatement, 6));
-        boost::posix_time::ptime time(boost::gregorian::date(1970, 1, 1), boost::posix_time::seconds(secondsSinceEpoch));
-
-        // offset from utc
-        int offset = sqlite3_column_int(selectStatement, 7);
-
-        result.push_back(HistoryMessage(message, (fromJID ? *fromJID : JID()), (toJID ? *toJID : JID()), type, time, offset));
+        result.push_back(getMessageFromRow(selectStatement, 0));
         r = sqlite3_step(selectStatement);
     }
     if (r != SQLITE_DONE) {
@@ -159,60 +338,106 @@ std::vector<HistoryMessage> SQLiteHistoryStorage::getMessagesFromDate(const JID&
     return result;
 }
 
-long long SQLiteHistoryStorage::getIDForJID(const JID& jid) {
+HistoryMessage SQLiteHistoryStorage::getMessageFromRow(sqlite3_stmt* statement, int firstColumn) const {
+    std::string message(reinterpret_cast<const char*>(sqlite3_column_text(statement, firstColumn)));
+
+    // fromJID
+    boost::optional<JID> fromJID(getJIDFromID(sqlite3_column_int64(statement, firstColumn + 1)));
+    std::string fromResource(reinterpret_cast<const char*>(sqlite3_column_text(statement, firstColumn + 2)));
+    if (fromJID && !fromResource.empty()) {
+        fromJID = boost::optional<JID>(JID(fromJID->getNode(), fromJID->getDomain(), fromResource));
+    }
+
+    // toJID
+    boost::optional<JID> toJID(getJIDFromID(sqlite3_column_int64(statement, firstColumn + 3)));
+    std::string toResource(reinterpret_cast<const char*>(sqlite3_column_text(statement, firstColumn + 4)));
+    if (toJID && !toResource.empty()) {
+        toJID = boost::optional<JID>(JID(toJID->getNode(), toJID->getDomain(), toResource));
+    }
+
+    // message type
+    HistoryMessage::Type type = static_cast<HistoryMessage::Type>(sqlite3_column_int(statement, firstColumn + 5));
+
+    // timestamp
+    long long secondsSinceEpoch(sqlite3_column_int64(statement, firstColumn + 6));
+    boost::posix_time::ptime time(boost::gregorian::date(1970, 1, 1), boost::posix_time::seconds(secondsSinceEpoch));
+
+    // offset from utc
+    int offset = sqlite3_column_int(statement, firstColumn + 7);
+
+    return HistoryMessage(message, (fromJID ? *fromJID : JID()), (toJID ? *toJID : JID()), type, time, offset);
+}
+
+boost::optional<long long> SQLiteHistoryStorage::getIDForJID(const JID& jid) const {
     boost::optional<long long> id = getIDFromJID(jid);
     if (id) {
-        return *id;
+        return id;
     }
     else {
         return addJID(jid);
     }
 }
 
-long long SQLiteHistoryStorage::addJID(const JID& jid) {
-    std::string statement = std::string("INSERT INTO jids('jid') VALUES('") + getEscapedString(jid.toString()) + "')";
-    char* errorMessage;
-    int result = sqlite3_exec(db_, statement.c_str(), nullptr, nullptr, &errorMessage);
-    if (result != SQLITE_OK) {
-        std::cerr << "SQL Error: " << errorMessage << std::endl;
-        sqlite3_free(errorMessage);
+boost::optional<long long> SQLiteHistoryStorage::addJID(const JID& jid) const {
+    std::string jidString = jid.toString();
+    sqlite3_bind_text(insertJIDStatement_, 1, jidString.c_str(), boost::numeric_cast<int>(jidString.size()), staticText);
+    int result = sqlite3_step(insertJIDStatement_);
+    if (result != SQLITE_DONE) {
+        std::cerr << "SQL Error: " << sqlite3_errmsg(db_) << std::endl;
+    }
+    sqlite3_reset(insertJIDStatement_);
+    sqlite3_clear_bindings(insertJIDStatement_);
+    if (result != SQLITE_DONE) {
+        // The last inserted row isn't this JID, so don't remember it
+        return boost::optional<long long>();
     }
-    return sqlite3_last_insert_rowid(db_);
+
+    long long id = sqlite3_last_insert_rowid(db_);
+    jidToID_[jid] = id;
+    idToJID_[id] = jid;
+    return id;
 }
 
 boost::optional<JID> SQLiteHistoryStorage::getJIDFromID(long long id) const {
-    boost::optional<JID> result;
-    sqlite3_stmt* selectStatement;
-    std::string selectQuery("SELECT jid FROM jids WHERE id=" + boost::lexical_cast<std::string>(id));
-    int r = sqlite3_prepare(db_, selectQuery.c_str(), boost::numeric_cast<int>(selectQuery.size()), &selectStatement, nullptr);
-    if (r != SQLITE_OK) {
-        std::cout << "Error: " << sqlite3_errmsg(db_) << std::endl;
+    auto i = idToJID_.find(id);
+    if (i != idToJID_.end()) {
+        return i->second;
     }
-    r = sqlite3_step(selectStatement);
-    if (r == SQLITE_ROW) {
-        result = boost::optional<JID>(reinterpret_cast<const char*>(sqlite3_column_text(selectStatement, 0)));
+
+    boost::optional<JID> result;
+    sqlite3_bind_int64(selectJIDFromIDStatement_, 1, id);
+    if (sqlite3_step(selectJIDFromIDStatement_) == SQLITE_ROW) {
+        result = boost::optional<JID>(reinterpret_cast<const char*>(sqlite3_column_text(selectJIDFromIDStatement_, 0)));
+        idToJID_[id] = *result;
+        jidToID_[*result] = id;
     }
-    sqlite3_finalize(selectStatement);
+    sqlite3_reset(selectJIDFromIDStatement_);
     return result;
 }
 
 boost::optional<long long> SQLiteHistoryStorage::getIDFromJID(const JID& jid) const {
-    boost::optional<long long> result;
-    sqlite3_stmt* selectStatement;
-    std::string selectQuery("SELECT id FROM jids WHERE jid='" + jid.toString() + "'");
-    long long r = sqlite3_prepare(db_, selectQuery.c_str(), boost::numeric_cast<int>(selectQuery.size()), &selectStatement, nullptr);
-    if (r != SQLITE_OK) {
-        std::cout << "Error: " << sqlite3_errmsg(db_) << std::endl;
+    auto i = jidToID_.find(jid);
+    if (i != jidToID_.end()) {
+        return i->second;
     }
-    r = sqlite3_step(selectStatement);
-    if (r == SQLITE_ROW) {
-        result = boost::optional<long long>(sqlite3_column_int(selectStatement, 0));
-    }
-    sqlite3_finalize(selectStatement);
+
+    boost::optional<long long> result;
+    std::string jidString = jid.toString();
+    sqlite3_bind_text(selectIDFromJIDStatement_, 1, jidString.c_str(), boost::numeric_cast<int>(jidString.size()), staticText);
+    if (sqlite3_step(selectIDFromJIDStatement_) == SQLITE_ROW) {
+        result = boost::optional<long long>(sqlite3_column_int64(selectIDFromJIDStatement_, 0));
+        jidToID_[jid] = *result;
+        idToJID_[*result] = jid;
+    }
+    sqlite3_reset(selectIDFromJIDStatement_);
+    sqlite3_clear_bindings(selectIDFromJIDStatement_);
     return result;
 }
 
 ContactsMap SQLiteHistoryStorage::getContacts(const JID& selfJID, HistoryMessage::Type type, const std::string& keyword) const {
+    std::lock_guard<std::mutex> lock(dbMutex_);
+    writePendingMessages();
+
     ContactsMap result;
     sqlite3_stmt* selectStatement;
 
@@ -222,8 +447,8 @@ ContactsMap SQLiteHistoryStorage::getContacts(const JID& selfJID, HistoryMessage
         return result;
     }
 
-    // get contacts
-    std::string query = "SELECT DISTINCT messages.'fromBare', messages.'fromResource', messages.'toBare', messages.'toResource', messages.'time' "
+    // get contacts, with one row per contact and day rather than per message
+    std::string query = "SELECT DISTINCT messages.'fromBare', messages.'fromResource', messages.'toBare', messages.'toResource', messages.'time' / 86400 "
         "FROM messages WHERE (type="
         + boost::lexical_cast<std::string>(type) + " AND (toBare="
         + boost::lexical_cast<std::string>(*id) + " OR fromBare=" + boost::lexical_cast<std::string>(*id) + "))";
@@ -231,6 +456,12 @@ ContactsMap SQLiteHistoryStorage::getContacts(const JID& selfJID, HistoryMessage
     // match keyword
     if (getEscapedString(keyword).length()) {
         query += " AND message LIKE '%" + getEscapedString(keyword) + "%'";
+        // Let the index narrow down the candidates, unless the keyword has
+        // LIKE wildcards that the index can't handle.
+        std::string fullTextQuery = getFullTextQuery(keyword);
+        if (fullTextSearch_ && !fullTextQuery.empty() && keyword.find_first_of("%_") == std::string::npos) {
+            query += " AND id IN (SELECT rowid FROM messages_search WHERE messages_search MATCH '" + getEscapedString(fullTextQuery) + "')";
+        }
     }
 
     int r = sqlite3_prepare(db_, query.c_str(), boost::numeric_cast<int>(query.size()), &selectStatement, nullptr);
@@ -246,8 +477,8 @@ ContactsMap SQLiteHistoryStorage::getContacts(const JID& selfJID, HistoryMessage
         std::string toResource(reinterpret_cast<const char*>(sqlite3_column_text(selectStatement, 3)));
         std::string resource;
 
-        int secondsSinceEpoch(sqlite3_column_int(selectStatement, 4));
-        boost::posix_time::ptime time(boost::gregorian::date(1970, 1, 1), boost::posix_time::seconds(secondsSinceEpoch));
+        int daysSinceEpoch(sqlite3_column_int(selectStatement, 4));
+        boost::gregorian::date date = boost::gregorian::date(1970, 1, 1) + boost::gregorian::days(daysSinceEpoch);
 
         boost::optional<JID> contactJID;
 
@@ -266,7 +497,7 @@ ContactsMap SQLiteHistoryStorage::getContacts(const JID& selfJID, HistoryMessage
         }
 
         if (contactJID) {
-            result[*contactJID].insert(time.date());
+            result[*contactJID].insert(date);
         }
 
         r = sqlite3_step(selectStatement);
@@ -322,33 +553,44 @@ boost::gregorian::date SQLiteHistoryStorage::getNextDateWithLogs(const JID& self
         int secondsSinceEpoch(sqlite3_column_int(selectStatement, 0));
         boost::posix_time::ptime time(boost::gregorian::date(1970, 1, 1), boost::posix_time::seconds(secondsSinceEpoch));
         std::cout << "next day is: " << time.date() << "\n";
+        sqlite3_finalize(selectStatement);
         return time.date();
     }
+    sqlite3_finalize(selectStatement);
 
     return boost::gregorian::date(boost::gregorian::not_a_date_time);
 }
 
 std::vector<HistoryMessage> SQLiteHistoryStorage::getMessagesFromNextDate(const JID& selfJID, const JID& contactJID, HistoryMessage::Type type, const boost::gregorian::date& date) const {
+    std::lock_guard<std::mutex> lock(dbMutex_);
+    writePendingMessages();
+
     boost::gregorian::date nextDate = getNextDateWithLogs(selfJID, contactJID, type, date, false);
 
     if (nextDate.is_not_a_date()) {
         return std::vector<HistoryMessage>();
     }
 
-    return getMessagesFromDate(selfJID, contactJID, type, nextDate);
+    return queryMessagesFromDate(selfJID, contactJID, type, nextDate);
 }
 
 std::vector<HistoryMessage> SQLiteHistoryStorage::getMessagesFromPreviousDate(const JID& selfJID, const JID& contactJID, HistoryMessage::Type type, const boost::gregorian::date& date) const {
+    std::lock_guard<std::mutex> lock(dbMutex_);
+    writePendingMessages();
+
     boost::gregorian::date previousDate = getNextDateWithLogs(selfJID, contactJID, type, date, true);
 
     if (previousDate.is_not_a_date()) {
         return std::vector<HistoryMessage>();
     }
 
-    return getMessagesFromDate(selfJID, contactJID, type, previousDate);
+    return queryMessagesFromDate(selfJID, contactJID, type, previousDate);
 }
 
 boost::posix_time::ptime SQLiteHistoryStorage::getLastTimeStampFromMUC(const JID& selfJID, const JID& mucJID) const {
+    std::lock_guard<std::mutex> lock(dbMutex_);
+    writePendingMessages();
+
     boost::optional<long long> selfID = getIDFromJID(selfJID.toBare());
     boost::optional<long long> mucID = getIDFromJID(mucJID.toBare());
 
@@ -357,7 +599,6 @@ boost::posix_time::ptime SQLiteHistoryStorage::getLastTimeStampFromMUC(const JID
         return boost::posix_time::ptime(boost::posix_time::not_a_date_time);
     }
 
-
     sqlite3_stmt* selectStatement;
     std::string selectQuery = "SELECT messages.'time', messages.'offset' from messages WHERE type=1 AND (toBare=" +
                 boost::lexical_cast<std::string>(*selfID) + " AND fromBare=" +
@@ -373,14 +614,66 @@ boost::posix_time::ptime SQLiteHistoryStorage::getLastTimeStampFromMUC(const JID
         int secondsSinceEpoch(sqlite3_column_int(selectStatement, 0));
         boost::posix_time::ptime time(boost::gregorian::date(1970, 1, 1), boost::posix_time::seconds(secondsSinceEpoch));
         int offset = sqlite3_column_int(selectStatement, 1);
+        sqlite3_finalize(selectStatement);
 
         return time - boost::posix_time::hours(offset);
     }
+    sqlite3_finalize(selectStatement);
 
     return boost::posix_time::ptime(boost::posix_time::not_a_date_time);
 }
 
-void SQLiteHistoryStorage::run() {
+HistorySearchResult SQLiteHistoryStorage::searchMessages(const JID& selfJID, const std::string& query, size_t limit, long long cursor) const {
+    std::lock_guard<std::mutex> lock(dbMutex_);
+    writePendingMessages();
+
+    HistorySearchResult result;
+    boost::optional<long long> selfID = getIDFromJID(selfJID.toBare());
+    if (query.empty() || limit == 0 || !selfID) {
+        return result;
+    }
+
+    // ?1 is the own JID, ?2 the cursor, ?3 the page size, ?4 the full-text
+    // query and ?5 the LIKE pattern. The query matches like a LIKE substring,
+    // whether or not the index is used to find the candidates.
+    std::string fullTextQuery = fullTextSearch_ ? getFullTextQuery(query) : std::string();
+    std::string selectQuery = "SELECT id, * FROM messages WHERE id<?2 AND (fromBare=?1 OR toBare=?1)";
+    if (!fullTextQuery.empty()) {
+        selectQuery += " AND id IN (SELECT rowid FROM messages_search WHERE messages_search MATCH ?4)";
+    }
+    selectQuery += " AND message LIKE ?5 ESCAPE '\\' ORDER BY id DESC LIMIT ?3";
+
+    sqlite3_stmt* selectStatement = prepareStatement(selectQuery.c_str());
+    if (!selectStatement) {
+        return result;
+    }
+    sqlite3_bind_int64(selectStatement, 1, *selfID);
+    sqlite3_bind_int64(selectStatement, 2, cursor > 0 ? cursor : std::numeric_limits<sqlite3_int64>::max());
+    // Fetch one extra row to find out whether there is a next page
+    sqlite3_bind_int64(selectStatement, 3, boost::numeric_cast<sqlite3_int64>(limit) + 1);
+    if (!fullTextQuery.empty()) {
+        sqlite3_bind_text(selectStatement, 4, fullTextQuery.c_str(), -1, staticText);
+    }
+    std::string likePattern = getLikePattern(query);
+    sqlite3_bind_text(selectStatement, 5, likePattern.c_str(), -1, staticText);
+
+    long long lastRowID = 0;
+    int r = sqlite3_step(selectStatement);
+    while (r == SQLITE_ROW) {
+        if (result.messages.size() == limit) {
+            result.nextCursor = lastRowID;
+            break;
+        }
+        lastRowID = sqlite3_column_int64(selectStatement, 0);
+        result.messages.push_back(getMessageFromRow(selectStatement, 1));
+        r = sqlite3_step(selectStatement);
+    }
+    if (r != SQLITE_ROW && r != SQLITE_DONE) {
+        std::cout << "Error: " << sqlite3_errmsg(db_) << std::endl;
+    }
+    sqlite3_finalize(selectStatement);
+
+    return result;
 }
 
 }
@@ -1,12 +1,16 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #pragma once
 
+#include <condition_variable>
+#include <mutex>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 
 #include <boost/filesystem/path.hpp>
 #include <boost/optional.hpp>
@@ -15,8 +19,22 @@
 #include <Swiften/History/HistoryStorage.h>
 
 struct sqlite3;
+struct sqlite3_stmt;
 
 namespace Swift {
+    /**
+     * A HistoryStorage backed by an SQLite database.
+     *
+     * Messages passed to addMessage() are queued and written in batches, one
+     * transaction per batch, by a background thread. Queries write out any
+     * queued messages first, so they always see everything added before them.
+     *
+     * If SQLite has FTS5 with the trigram tokenizer, message text is indexed
+     * for searchMessages() and keyword lookups in getContacts(); otherwise
+     * these scan the messages. Either way, keywords match as case-insensitive
+     * substrings, like LIKE does; the index only narrows down the messages
+     * to check.
+     */
     class SWIFTEN_API SQLiteHistoryStorage : public HistoryStorage {
         public:
             SQLiteHistoryStorage(const boost::filesystem::path& file);
@@ -28,17 +46,48 @@ namespace Swift {
             std::vector<HistoryMessage> getMessagesFromNextDate(const JID& selfJID, const JID& contactJID, HistoryMessage::Type type, const boost::gregorian::date& date) const;
             std::vector<HistoryMessage> getMessagesFromPreviousDate(const JID& selfJID, const JID& contactJID, HistoryMessage::Type type, const boost::gregorian::date& date) const;
             boost::posix_time::ptime getLastTimeStampFromMUC(const JID& selfJID, const JID& mucJID) const;
+            HistorySearchResult searchMessages(const JID& selfJID, const std::string& query, size_t limit, long long cursor = 0) const;
+
+            /**
+             * Blocks until all queued messages have been written to the database.
+             */
+            void flush() const;
 
         private:
             void run();
+            void writePendingMessages() const;
+            void writeMessage(const HistoryMessage& message) const;
+            void executeStatement(const char* statement) const;
+            sqlite3_stmt* prepareStatement(const char* statement) const;
+            void addMessageIDs();
+            bool setUpFullTextSearch();
+            HistoryMessage getMessageFromRow(sqlite3_stmt* statement, int firstColumn) const;
+
+            std::vector<HistoryMessage> queryMessagesFromDate(const JID& selfJID, const JID& contactJID, HistoryMessage::Type type, const boost::gregorian::date& date) const;
             boost::gregorian::date getNextDateWithLogs(const JID& selfJID, const JID& contactJID, HistoryMessage::Type type, const boost::gregorian::date& date, bool reverseOrder) const;
-            long long getIDForJID(const JID&);
-            long long addJID(const JID&);
+            boost::optional<long long> getIDForJID(const JID&) const;
+            boost::optional<long long> addJID(const JID&) const;
 
             boost::optional<JID> getJIDFromID(long long id) const;
             boost::optional<long long> getIDFromJID(const JID& jid) const;
 
+        private:
             sqlite3* db_;
+            sqlite3_stmt* insertMessageStatement_;
+            sqlite3_stmt* insertJIDStatement_;
+            sqlite3_stmt* selectIDFromJIDStatement_;
+            sqlite3_stmt* selectJIDFromIDStatement_;
+            bool fullTextSearch_;
+
+            // Guards the database handle, its statements and the JID caches.
+            mutable std::mutex dbMutex_;
+            mutable std::unordered_map<JID, long long> jidToID_;
+            mutable std::unordered_map<long long, JID> idToJID_;
+
+            mutable std::vector<HistoryMessage> pendingMessages_;
+            mutable std::mutex queueMutex_;
+            std::condition_variable queueNonEmpty_;
+            bool stopRequested_;
             std::thread* thread_;
     };
 }
@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <memory>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/filesystem.hpp>
+
+#include <sqlite3.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+
+#include <Swiften/Base/Path.h>
+#include <Swiften/History/SQLiteHistoryStorage.h>
+
+using namespace Swift;
+
+class SQLiteHistoryStorageTest : public CppUnit::TestFixture {
+        CPPUNIT_TEST_SUITE(SQLiteHistoryStorageTest);
+        CPPUNIT_TEST(testAddMessage);
+        CPPUNIT_TEST(testAddMessage_ManyMessages);
+        CPPUNIT_TEST(testAddMessage_QuotesAreStoredVerbatim);
+        CPPUNIT_TEST(testGetContacts);
+        CPPUNIT_TEST(testGetMessagesFromNextDate);
+        CPPUNIT_TEST(testGetLastTimeStampFromMUC);
+        CPPUNIT_TEST(testGetContacts_Keyword);
+        CPPUNIT_TEST(testGetContacts_KeywordInsideWord);
+        CPPUNIT_TEST(testGetContacts_KeywordAllDates);
+        CPPUNIT_TEST(testSearchMessages);
+        CPPUNIT_TEST(testSearchMessages_Phrase);
+        CPPUNIT_TEST(testSearchMessages_OtherAccount);
+        CPPUNIT_TEST(testSearchMessages_Paging);
+        CPPUNIT_TEST(testSearchMessages_Substrings);
+        CPPUNIT_TEST(testOpenDatabaseWithoutMessageIDs);
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+        void setUp() {
+            testling_ = std::unique_ptr<SQLiteHistoryStorage>(new SQLiteHistoryStorage(":memory:"));
+        }
+
+        void tearDown() {
+            testling_.reset();
+        }
+
+        void testAddMessage() {
+            HistoryMessage message("Hello", JID("alice@wonderland.lit/rabbithole"), JID("bob@wonderland.lit/garden"), HistoryMessage::Chat, time("2018-01-21 22:03:00"));
+            testling_->addMessage(message);
+
+            std::vector<HistoryMessage> messages = testling_->getMessagesFromDate(JID("alice@wonderland.lit"), JID("bob@wonderland.lit"), HistoryMessage::Chat, date("2018-01-21"));
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), messages.size());
+            CPPUNIT_ASSERT(message == messages[0]);
+        }
+
+        void testAddMessage_ManyMessages() {
+            for (int i = 0; i < 500; ++i) {
+                testling_->addMessage(HistoryMessage("Message " + std::to_string(i), JID("alice@wonderland.lit"), JID("bob@wonderland.lit"), HistoryMessage::Chat, time("2018-01-21 10:00:00") + boost::posix_time::seconds(i)));
+            }
+
+            std::vector<HistoryMessage> messages = testling_->getMessagesFromDate(JID("bob@wonderland.lit"), JID("alice@wonderland.lit"), HistoryMessage::Chat, date("2018-01-21"));
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(500), messages.size());
+            for (size_t i = 0; i < messages.size(); ++i) {
+                CPPUNIT_ASSERT_EQUAL("Message " + std::to_string(i), messages[i].getMessage());
+            }
+        }
+
+        void testAddMessage_QuotesAreStoredVerbatim() {
+            HistoryMessage message("It's a 'quoted' \"message\"", JID("alice@wonderland.lit/it's"), JID("bob@wonderland.lit/garden"), HistoryMessage::Chat, time("2018-01-21 22:03:00"));
+            testling_->addMessage(message);
+
+            std::vector<HistoryMessage> messages = testling_->getMessagesFromDate(JID("alice@wonderland.lit"), JID("bob@wonderland.lit"), HistoryMessage::Chat, date("2018-01-21"));
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), messages.size());
+            CPPUNIT_ASSERT(message == messages[0]);
+        }
+
+        void testGetContacts() {
+            testling_->addMessage(HistoryMessage("Hi", JID("alice@wonderland.lit"), JID("bob@wonderland.lit"), HistoryMessage::Chat, time("2018-01-21 10:00:00")));
+            testling_->addMessage(HistoryMessage("Hi", JID("carol@wonderland.lit"), JID("alice@wonderland.lit"), HistoryMessage::Chat, time("2018-01-22 10:00:00")));
+            testling_->addMessage(HistoryMessage("Hi", JID("carol@wonderland.lit"), JID("bob@wonderland.lit"), HistoryMessage::Chat, time("2018-01-22 10:00:00")));
+
+            ContactsMap contacts = testling_->getContacts(JID("alice@wonderland.lit"), HistoryMessage::Chat, "");
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), contacts.size());
+            CPPUNIT_ASSERT(contacts[JID("bob@wonderland.lit")].count(date("2018-01-21")));
+            CPPUNIT_ASSERT(contacts[JID("carol@wonderland.lit")].count(date("2018-01-22")));
+        }
+
+        void testGetMessagesFromNextDate() {
+            testling_->addMessage(HistoryMessage("First", JID("alice@wonderland.lit"), JID("bob@wonderland.lit"), HistoryMessage::Chat, time("2018-01-21 10:00:00")));
+            testling_->addMessage(HistoryMessage("Second", JID("bob@wonderland.lit"), JID("alice@wonderland.lit"), HistoryMessage::Chat, time("2018-01-25 10:00:00")));
+
+            std::vector<HistoryMessage> messages = testling_->getMessagesFromNextDate(JID("alice@wonderland.lit"), JID("bob@wonderland.lit"), HistoryMessage::Chat, date("2018-01-21"));
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), messages.size());
+            CPPUNIT_ASSERT_EQUAL(std::string("Second"), messages[0].getMessage());
+        }
+
+        void testGetLastTimeStampFromMUC() {
+            testling_->addMessage(HistoryMessage("First", JID("room@muc.wonderland.lit/bob"), JID("alice@wonderland.lit"), HistoryMessage::Groupchat, time("2018-01-21 10:00:00")));
+            testling_->addMessage(HistoryMessage("Second", JID("room@muc.wonderland.lit/bob"), JID("alice@wonderland.lit"), HistoryMessage::Groupchat, time("2018-01-21 11:00:00")));
+
+            CPPUNIT_ASSERT_EQUAL(time("2018-01-21 11:00:00"), testling_->getLastTimeStampFromMUC(JID("alice@wonderland.lit"), JID("room@muc.wonderland.lit")));
+        }
+
+        void testGetContacts_Keyword() {
+            testling_->addMessage(HistoryMessage("Where is the rabbit?", JID("alice@wonderland.lit"), JID("bob@wonderland.lit"), HistoryMessage::Chat, time("2018-01-21 10:00:00")));
+            testling_->addMessage(HistoryMessage("Off with her head", JID("queen@wonderland.lit"), JID("alice@wonderland.lit"), HistoryMessage::Chat, time("2018-01-22 10:00:00")));
+
+            ContactsMap contacts = testling_->getContacts(JID("alice@wonderland.lit"), HistoryMessage::Chat, "rabbit");
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), contacts.size());
+            CPPUNIT_ASSERT(contacts.count(JID("bob@wonderland.lit")));
+        }
+
+        void testGetContacts_KeywordInsideWord() {
+            testling_->addMessage(HistoryMessage("Where is the rabbit?", JID("alice@wonderland.lit"), JID("bob@wonderland.lit"), HistoryMessage::Chat, time("2018-01-21 10:00:00")));
+            testling_->addMessage(HistoryMessage("Off with her head", JID("queen@wonderland.lit"), JID("alice@wonderland.lit"), HistoryMessage::Chat, time("2018-01-22 10:00:00")));
+
+            CPPUNIT_ASSERT(testling_->getContacts(JID("alice@wonderland.lit"), HistoryMessage::Chat, "ABBI").count(JID("bob@wonderland.lit")));
+            CPPUNIT_ASSERT(testling_->getContacts(JID("alice@wonderland.lit"), HistoryMessage::Chat, "he rab").count(JID("bob@wonderland.lit")));
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), testling_->getContacts(JID("alice@wonderland.lit"), HistoryMessage::Chat, "e").size());
+            CPPUNIT_ASSERT(testling_->getContacts(JID("alice@wonderland.lit"), HistoryMessage::Chat, "rabbits").empty());
+        }
+
+        void testGetContacts_KeywordAllDates() {
+            testling_->addMessage(HistoryMessage("Where is the rabbit?", JID("alice@wonderland.lit"), JID("bob@wonderland.lit"), HistoryMessage::Chat, time("2017-03-01 10:00:00")));
+            testling_->addMessage(HistoryMessage("The rabbit is late", JID("bob@wonderland.lit"), JID("alice@wonderland.lit"), HistoryMessage::Chat, time("2017-03-01 11:00:00")));
+            for (int i = 0; i < 600; ++i) {
+                testling_->addMessage(HistoryMessage("Rabbit " + std::to_string(i), JID("alice@wonderland.lit"), JID("carol@wonderland.lit"), HistoryMessage::Chat, time("2018-01-21 10:00:00") + boost::posix_time::seconds(i)));
+            }
+
+            ContactsMap contacts = testling_->getContacts(JID("alice@wonderland.lit"), HistoryMessage::Chat, "rabbit");
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), contacts.size());
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), contacts[JID("bob@wonderland.lit")].size());
+            CPPUNIT_ASSERT_EQUAL(boost::gregorian::date(2017, 3, 1), *contacts[JID("bob@wonderland.lit")].begin());
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), contacts[JID("carol@wonderland.lit")].size());
+        }
+
+        void testSearchMessages() {
+            testling_->addMessage(HistoryMessage("Where is the white rabbit?", JID("alice@wonderland.lit"), JID("bob@wonderland.lit"), HistoryMessage::Chat, time("2018-01-21 10:00:00")));
+            testling_->addMessage(HistoryMessage("Off with her head", JID("queen@wonderland.lit"), JID("alice@wonderland.lit"), HistoryMessage::Chat, time("2018-01-22 10:00:00")));
+            testling_->addMessage(HistoryMessage("The Rabbit is late", JID("bob@wonderland.lit/garden"), JID("alice@wonderland.lit"), HistoryMessage::Chat, time("2018-01-23 10:00:00")));
+
+            HistorySearchResult result = testling_->searchMessages(JID("alice@wonderland.lit"), "rabbit", 10);
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), result.messages.size());
+            CPPUNIT_ASSERT_EQUAL(std::string("The Rabbit is late"), result.messages[0].getMessage());
+            CPPUNIT_ASSERT_EQUAL(JID("bob@wonderland.lit/garden"), result.messages[0].getFromJID());
+            CPPUNIT_ASSERT_EQUAL(JID("alice@wonderland.lit"), result.messages[0].getToJID());
+            CPPUNIT_ASSERT_EQUAL(std::string("Where is the white rabbit?"), result.messages[1].getMessage());
+            CPPUNIT_ASSERT_EQUAL(0LL, result.nextCursor);
+        }
+
+        void testSearchMessages_Phrase() {
+            testling_->addMessage(HistoryMessage("Where is the white rabbit?", JID("alice@wonderland.lit"), JID("bob@wonderland.lit"), HistoryMessage::Chat, time("2018-01-21 10:00:00")));
+            testling_->addMessage(HistoryMessage("The rabbit is late", JID("bob@wonderland.lit"), JID("alice@wonderland.lit"), HistoryMessage::Chat, time("2018-01-23 10:00:00")));
+
+            HistorySearchResult result = testling_->searchMessages(JID("alice@wonderland.lit"), "white rab", 10);
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), result.messages.size());
+            CPPUNIT_ASSERT_EQUAL(std::string("Where is the white rabbit?"), result.messages[0].getMessage());
+            CPPUNIT_ASSERT(testling_->searchMessages(JID("alice@wonderland.lit"), "rabbit white", 10).messages.empty());
+        }
+
+        void testSearchMessages_OtherAccount() {
+            testling_->addMessage(HistoryMessage("Where is the white rabbit?", JID("alice@wonderland.lit"), JID("bob@wonderland.lit"), HistoryMessage::Chat, time("2018-01-21 10:00:00")));
+
+            CPPUNIT_ASSERT(testling_->searchMessages(JID("queen@wonderland.lit"), "rabbit", 10).messages.empty());
+            CPPUNIT_ASSERT(testling_->searchMessages(JID("carol@wonderland.lit"), "rabbit", 10).messages.empty());
+        }
+
+        void testSearchMessages_Paging() {
+            for (int i = 0; i < 25; ++i) {
+                testling_->addMessage(HistoryMessage("Rabbit " + std::to_string(i), JID("alice@wonderland.lit"), JID("bob@wonderland.lit"), HistoryMessage::Chat, time("2018-01-21 10:00:00") + boost::posix_time::seconds(i)));
+            }
+
+            std::vector<HistoryMessage> messages;
+            HistorySearchResult result = testling_->searchMessages(JID("alice@wonderland.lit"), "rabbit", 10);
+            int pages = 1;
+            messages.insert(messages.end(), result.messages.begin(), result.messages.end());
+            while (result.nextCursor) {
+                result = testling_->searchMessages(JID("alice@wonderland.lit"), "rabbit", 10, result.nextCursor);
+                messages.insert(messages.end(), result.messages.begin(), result.messages.end());
+                ++pages;
+            }
+
+            CPPUNIT_ASSERT_EQUAL(3, pages);
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(25), messages.size());
+            for (size_t i = 0; i < messages.size(); ++i) {
+                CPPUNIT_ASSERT_EQUAL("Rabbit " + std::to_string(24 - i), messages[i].getMessage());
+            }
+        }
+
+        void testSearchMessages_Substrings() {
+            testling_->addMessage(HistoryMessage("Where is the white rabbit?", JID("alice@wonderland.lit"), JID("bob@wonderland.lit"), HistoryMessage::Chat, time("2018-01-21 10:00:00")));
+            testling_->addMessage(HistoryMessage("Off with her head", JID("queen@wonderland.lit"), JID("alice@wonderland.lit"), HistoryMessage::Chat, time("2018-01-22 10:00:00")));
+
+            // The query matches anywhere in the message, also when it's too short for the index
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), testling_->searchMessages(JID("alice@wonderland.lit"), "ABBI", 10).messages.size());
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), testling_->searchMessages(JID("alice@wonderland.lit"), "hite rab", 10).messages.size());
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), testling_->searchMessages(JID("alice@wonderland.lit"), "he", 10).messages.size());
+            CPPUNIT_ASSERT(testling_->searchMessages(JID("alice@wonderland.lit"), "rabbit xy", 10).messages.empty());
+        }
+
+        void testOpenDatabaseWithoutMessageIDs() {
+            boost::filesystem::path file = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("swift-history-test-%%%%%%%%");
+            sqlite3* db = nullptr;
+            sqlite3_open(pathToString(file).c_str(), &db);
+            sqlite3_exec(db, "CREATE TABLE messages('message' STRING, 'fromBare' INTEGER, 'fromResource' STRING, 'toBare' INTEGER, 'toResource' STRING, 'type' INTEGER, 'time' INTEGER, 'offset' INTEGER)", nullptr, nullptr, nullptr);
+            sqlite3_exec(db, "CREATE TABLE jids('id' INTEGER PRIMARY KEY ASC AUTOINCREMENT, 'jid' STRING UNIQUE NOT NULL)", nullptr, nullptr, nullptr);
+            sqlite3_exec(db, "INSERT INTO jids('jid') VALUES('alice@wonderland.lit'), ('bob@wonderland.lit')", nullptr, nullptr, nullptr);
+            sqlite3_exec(db, "INSERT INTO messages VALUES('Where is the rabbit?', 1, '', 2, '', 0, 1516528800, 0)", nullptr, nullptr, nullptr);
+            sqlite3_exec(db, "INSERT INTO messages VALUES('The rabbit is late', 2, '', 1, '', 0, 1516615200, 0)", nullptr, nullptr, nullptr);
+            sqlite3_close(db);
+
+            testling_ = std::unique_ptr<SQLiteHistoryStorage>(new SQLiteHistoryStorage(file));
+            testling_->addMessage(HistoryMessage("Rabbit stew", JID("alice@wonderland.lit"), JID("bob@wonderland.lit"), HistoryMessage::Chat, time("2018-01-23 10:00:00")));
+            HistorySearchResult result = testling_->searchMessages(JID("alice@wonderland.lit"), "rabbit", 10);
+            testling_.reset();
+            boost::filesystem::remove(file);
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), result.messages.size());
+            CPPUNIT_ASSERT_EQUAL(std::string("Rabbit stew"), result.messages[0].getMessage());
+            CPPUNIT_ASSERT_EQUAL(std::string("The rabbit is late"), result.messages[1].getMessage());
+            CPPUNIT_ASSERT_EQUAL(std::string("Where is the rabbit?"), result.messages[2].getMessage());
+        }
+
+    private:
+        static boost::posix_time::ptime time(const std::string& s) {
+            return boost::posix_time::time_from_string(s);
+        }
+
+        static boost::gregorian::date date(const std::string& s) {
+            return boost::gregorian::from_simple_string(s);
+        }
+
+    private:
+        std::unique_ptr<SQLiteHistoryStorage> testling_;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SQLiteHistoryStorageTest);
@@ -1,22 +1,28 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #define SWIFTEN_CACHE_JID_PREP
 
+#include <atomic>
+#include <cstdint>
 #include <sstream>
 #include <string>
 #include <vector>
 
 #ifdef SWIFTEN_CACHE_JID_PREP
+#include <array>
+#include <functional>
 #include <mutex>
-#include <unordered_map>
 #endif
 
 #include <boost/optional.hpp>
 
+#ifdef SWIFTEN_CACHE_JID_PREP
+#include <Swiften/Base/LRUCache.h>
+#endif
 #include <Swiften/Base/String.h>
 #include <Swiften/IDN/IDNConverter.h>
 #include <Swiften/JID/JID.h>
@@ -28,15 +34,6 @@
 
 using namespace Swift;
 
-#ifdef SWIFTEN_CACHE_JID_PREP
-typedef std::unordered_map<std::string, std::string> PrepCache;
-
-static std::mutex namePrepCacheMutex;
-static PrepCache nodePrepCache;
-static PrepCache domainPrepCache;
-static PrepCache resourcePrepCache;
-#endif
-
 static const std::vector<char> escapedChars = {' ', '"', '&', '\'', '/', '<', '>', '@', ':'};
 
 static IDNConverter* idnConverter = nullptr;
@@ -65,6 +62,176 @@ static bool getEscapeSequenceValue(const std::string& sequence, unsigned char& v
     return (!s.fail() && !s.bad() && (value == 0x5C || std::find(escapedChars.begin(), escapedChars.end(), value) != escapedChars.end()));
 }
 
+namespace {
+    // Longest input that is handed to the fast path. LibIDN refuses to prepare
+    // anything that does not fit in 1024 bytes, so longer strings have to go
+    // through the converter to get the same result.
+    const size_t MAX_FAST_PATH_SIZE = 1000;
+
+    // Checks whether an ASCII string is left untouched by the given stringprep
+    // profile, in which case the converter does not need to be called.
+    // Anything that is not plain ASCII, or that the profile would map or
+    // reject, returns false and takes the slow path.
+    bool isPreparedASCII(const std::string& s, IDNConverter::StringPrepProfile profile) {
+        if (s.size() > MAX_FAST_PATH_SIZE) {
+            return false;
+        }
+        switch (profile) {
+            case IDNConverter::XMPPNodePrep:
+                for (char c : s) {
+                    if (c <= 0x20 || c >= 0x7F || (c >= 'A' && c <= 'Z')) {
+                        return false;
+                    }
+                    switch (c) {
+                        case '"': case '&': case '\'': case '/': case ':': case '<': case '>': case '@':
+                            return false;
+                        default:
+                            break;
+                    }
+                }
+                return true;
+            case IDNConverter::XMPPResourcePrep:
+                for (char c : s) {
+                    if (c < 0x20 || c >= 0x7F) {
+                        return false;
+                    }
+                }
+                return true;
+            case IDNConverter::NamePrep: {
+                // Only accept what IDNA ToASCII with the STD3 rules accepts
+                // unchanged: non-empty lowercase LDH labels of at most 63
+                // characters, not starting or ending with a hyphen.
+                if (s.empty() || s.size() > 253) {
+                    return false;
+                }
+                size_t labelSize = 0;
+                char previous = '.';
+                for (char c : s) {
+                    if (c == '.') {
+                        if (labelSize == 0 || previous == '-') {
+                            return false;
+                        }
+                        labelSize = 0;
+                    }
+                    else if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || (c == '-' && previous != '.')) {
+                        if (++labelSize > 63) {
+                            return false;
+                        }
+                    }
+                    else {
+                        return false;
+                    }
+                    previous = c;
+                }
+                return labelSize > 0 && previous != '-';
+            }
+            case IDNConverter::SASLPrep:
+                break;
+        }
+        return false;
+    }
+
+#ifdef SWIFTEN_CACHE_JID_PREP
+    /**
+     * A bounded cache of prepared strings, split into shards with their own
+     * lock so that JIDs constructed on different threads rarely contend.
+     * Each shard evicts its least recently used entry when full.
+     */
+    class PrepCache {
+        public:
+            bool get(const std::string& key, std::string& result) {
+                Shard& shard = getShard(key);
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                boost::optional<std::string> cached = shard.cache.get(key);
+                if (!cached) {
+                    shard.misses++;
+                    return false;
+                }
+                shard.hits++;
+                result = std::move(*cached);
+                return true;
+            }
+
+            void insert(const std::string& key, const std::string& value) {
+                Shard& shard = getShard(key);
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                shard.cache.insert(key, value);
+            }
+
+            void addStatistics(JID::PrepStatistics& statistics) {
+                for (auto& shard : shards_) {
+                    std::lock_guard<std::mutex> lock(shard.mutex);
+                    statistics.cacheHits += shard.hits;
+                    statistics.cacheMisses += shard.misses;
+                }
+            }
+
+        private:
+            static const size_t SHARD_COUNT = 16;
+            static const size_t SHARD_SIZE = 256;
+
+            struct Shard {
+                std::mutex mutex;
+                LRUCache<std::string, std::string, SHARD_SIZE> cache;
+                std::uint64_t hits = 0;
+                std::uint64_t misses = 0;
+            };
+
+            Shard& getShard(const std::string& key) {
+                // The LRU cache hashes with boost::hash, so use the other hash to pick the shard
+                return shards_[std::hash<std::string>()(key) % SHARD_COUNT];
+            }
+
+            std::array<Shard, SHARD_COUNT> shards_;
+    };
+
+    PrepCache& getPrepCache(IDNConverter::StringPrepProfile profile) {
+        static PrepCache nodePrepCache;
+        static PrepCache domainPrepCache;
+        static PrepCache resourcePrepCache;
+        switch (profile) {
+            case IDNConverter::XMPPNodePrep: return nodePrepCache;
+            case IDNConverter::NamePrep: return domainPrepCache;
+            case IDNConverter::XMPPResourcePrep: return resourcePrepCache;
+            case IDNConverter::SASLPrep: break;
+        }
+        assert(false);
+        return resourcePrepCache;
+    }
+#endif
+
+    std::atomic<std::uint64_t> asciiFastPathCount(0);
+
+    bool prepare(const std::string& s, IDNConverter::StringPrepProfile profile, std::string& result) {
+        if (isPreparedASCII(s, profile)) {
+            asciiFastPathCount.fetch_add(1, std::memory_order_relaxed);
+            result = s;
+            return true;
+        }
+#ifdef SWIFTEN_CACHE_JID_PREP
+        PrepCache& cache = getPrepCache(profile);
+        if (cache.get(s, result)) {
+            return true;
+        }
+#endif
+        try {
+            // Domains are also checked to be IDNA-encodable, so only valid
+            // ones end up in the cache.
+            if (profile == IDNConverter::NamePrep && (s.empty() || !idnConverter->getIDNAEncoded(s))) {
+                return false;
+            }
+            result = idnConverter->getStringPrepared(s, profile);
+        }
+        catch (...) {
+            return false;
+        }
+#ifdef SWIFTEN_CACHE_JID_PREP
+        cache.insert(s, result);
+#endif
+        return true;
+    }
+}
+
 namespace Swift {
 
 JID::JID(const char* jid) : valid_(true) {
@@ -115,63 +282,15 @@ void JID::initializeFromString(const std::string& jid) {
 
 
 void JID::nameprepAndSetComponents(const std::string& node, const std::string& domain, const std::string& resource) {
-    if (domain.empty() || !idnConverter->getIDNAEncoded(domain)) {
+    if (hasResource_ && resource.empty()) {
         valid_ = false;
         return;
     }
 
-    if (hasResource_ && resource.empty()) {
+    if (!prepare(domain, IDNConverter::NamePrep, domain_) || !prepare(node, IDNConverter::XMPPNodePrep, node_) || !prepare(resource, IDNConverter::XMPPResourcePrep, resource_)) {
         valid_ = false;
         return;
     }
-#ifndef SWIFTEN_CACHE_JID_PREP
-    node_ = idnConverter->getStringPrepared(node, IDNConverter::XMPPNodePrep);
-    domain_ = idnConverter->getStringPrepared(domain, IDNConverter::NamePrep);
-    resource_ = idnConverter->getStringPrepared(resource, IDNConverter::XMPPResourcePrep);
-#else
-    std::unique_lock<std::mutex> lock(namePrepCacheMutex);
-
-    std::pair<PrepCache::iterator, bool> r;
-
-    r = nodePrepCache.insert(std::make_pair(node, std::string()));
-    if (r.second) {
-        try {
-            r.first->second = idnConverter->getStringPrepared(node, IDNConverter::XMPPNodePrep);
-        }
-        catch (...) {
-            nodePrepCache.erase(r.first);
-            valid_ = false;
-            return;
-        }
-    }
-    node_ = r.first->second;
-
-    r = domainPrepCache.insert(std::make_pair(domain, std::string()));
-    if (r.second) {
-        try {
-            r.first->second = idnConverter->getStringPrepared(domain, IDNConverter::NamePrep);
-        }
-        catch (...) {
-            domainPrepCache.erase(r.first);
-            valid_ = false;
-            return;
-        }
-    }
-    domain_ = r.first->second;
-
-    r = resourcePrepCache.insert(std::make_pair(resource, std::string()));
-    if (r.second) {
-        try {
-            r.first->second = idnConverter->getStringPrepared(resource, IDNConverter::XMPPResourcePrep);
-        }
-        catch (...) {
-            resourcePrepCache.erase(r.first);
-            valid_ = false;
-            return;
-        }
-    }
-    resource_ = r.first->second;
-#endif
 
     if (domain_.empty()) {
         valid_ = false;
@@ -179,6 +298,17 @@ void JID::nameprepAndSetComponents(const std::string& node, const std::string& d
     }
 }
 
+JID::PrepStatistics JID::getPrepStatistics() {
+    PrepStatistics statistics;
+    statistics.asciiFastPath = asciiFastPathCount.load(std::memory_order_relaxed);
+#ifdef SWIFTEN_CACHE_JID_PREP
+    getPrepCache(IDNConverter::XMPPNodePrep).addStatistics(statistics);
+    getPrepCache(IDNConverter::NamePrep).addStatistics(statistics);
+    getPrepCache(IDNConverter::XMPPResourcePrep).addStatistics(statistics);
+#endif
+    return statistics;
+}
+
 std::string JID::toString() const {
     std::string string;
     if (!node_.empty()) {
@@ -1,11 +1,13 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #pragma once
 
+#include <cstdint>
+#include <functional>
 #include <iosfwd>
 #include <string>
 
@@ -182,6 +184,34 @@ namespace Swift {
              */
             static void setIDNConverter(IDNConverter*);
 
+            /**
+             * Counters of how the JID parts were prepared.
+             */
+            struct PrepStatistics {
+                /**
+                 * Parts that were plain ASCII and already prepared, and so
+                 * did not need to go through the IDN converter or the cache.
+                 */
+                std::uint64_t asciiFastPath = 0;
+
+                /**
+                 * Parts found in the stringprep cache.
+                 */
+                std::uint64_t cacheHits = 0;
+
+                /**
+                 * Parts that were not in the stringprep cache, and had to be
+                 * prepared by the IDN converter.
+                 */
+                std::uint64_t cacheMisses = 0;
+            };
+
+            /**
+             * Returns the counters of all JIDs constructed so far, e.g. to
+             * compute the hit rate of the stringprep cache.
+             */
+            static PrepStatistics getPrepStatistics();
+
         private:
             void nameprepAndSetComponents(const std::string& node, const std::string& domain, const std::string& resource);
             void initializeFromString(const std::string&);
@@ -196,3 +226,22 @@ namespace Swift {
 
     SWIFTEN_API std::ostream& operator<<(std::ostream& os, const Swift::JID& j);
 }
+
+namespace std {
+    /**
+     * Hashes a JID consistently with operator==, so JIDs can be used as keys
+     * of unordered containers.
+     */
+    template<>
+    struct hash<Swift::JID> {
+        size_t operator()(const Swift::JID& jid) const {
+            std::hash<std::string> stringHash;
+            size_t result = stringHash(jid.getDomain());
+            result ^= stringHash(jid.getNode()) + 0x9e3779b9 + (result << 6) + (result >> 2);
+            if (!jid.isBare()) {
+                result ^= stringHash(jid.getResource()) + 0x9e3779b9 + (result << 6) + (result >> 2);
+            }
+            return result;
+        }
+    };
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -29,6 +29,9 @@ class JIDTest : public CppUnit::TestFixture
         CPPUNIT_TEST(testConstructorWithString_EmptyDomainWithResource);
         CPPUNIT_TEST(testConstructorWithString_IllegalResource);
         CPPUNIT_TEST(testConstructorWithString_SpacesInNode);
+        CPPUNIT_TEST(testConstructorWithString_ControlCharacterInResource);
+        CPPUNIT_TEST(testConstructorWithString_InvalidDomainLabels);
+        CPPUNIT_TEST(testConstructorWithString_LongDomainLabel);
         CPPUNIT_TEST(testConstructorWithStrings);
         CPPUNIT_TEST(testConstructorWithStrings_EmptyDomain);
         CPPUNIT_TEST(testConstructorWithStrings_EmptyResource);
@@ -64,6 +67,9 @@ class JIDTest : public CppUnit::TestFixture
         CPPUNIT_TEST(testGetEscapedNode_BackslashAtEnd);
         CPPUNIT_TEST(testGetUnescapedNode);
         CPPUNIT_TEST(testGetUnescapedNode_XEP106Examples);
+        CPPUNIT_TEST(testHash);
+        CPPUNIT_TEST(testGetPrepStatistics_ASCII);
+        CPPUNIT_TEST(testGetPrepStatistics_CacheHit);
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -176,6 +182,24 @@ class JIDTest : public CppUnit::TestFixture
             CPPUNIT_ASSERT(!JID("alice   @wonderland.lit").isValid());
         }
 
+        void testConstructorWithString_ControlCharacterInResource() {
+            CPPUNIT_ASSERT(!JID("foo@bar.com/b\x01z").isValid());
+            CPPUNIT_ASSERT(!JID("foo@bar.com/b\x7Fz").isValid());
+        }
+
+        void testConstructorWithString_InvalidDomainLabels() {
+            CPPUNIT_ASSERT(!JID("foo@-bar.com").isValid());
+            CPPUNIT_ASSERT(!JID("foo@bar-.com").isValid());
+            CPPUNIT_ASSERT(!JID("foo@bar..com").isValid());
+            CPPUNIT_ASSERT(!JID("foo@bar_baz.com").isValid());
+            CPPUNIT_ASSERT(JID("foo@b-a-r.com").isValid());
+        }
+
+        void testConstructorWithString_LongDomainLabel() {
+            CPPUNIT_ASSERT(JID("foo@" + std::string(63, 'a') + ".com").isValid());
+            CPPUNIT_ASSERT(!JID("foo@" + std::string(64, 'a') + ".com").isValid());
+        }
+
         void testConstructorWithStrings() {
             JID testling("foo", "bar", "baz");
 
@@ -439,6 +463,34 @@ class JIDTest : public CppUnit::TestFixture
             CPPUNIT_ASSERT_EQUAL(std::string("c:\\cool stuff"), JID("c\\3a\\cool\\20stuff@example.com").getUnescapedNode());
             CPPUNIT_ASSERT_EQUAL(std::string("c:\\5commas"), JID("c\\3a\\5c5commas@example.com").getUnescapedNode());
         }
+
+        void testHash() {
+            std::hash<JID> hash;
+            CPPUNIT_ASSERT_EQUAL(hash(JID("foo@bar/baz")), hash(JID("Foo@Bar/baz")));
+            CPPUNIT_ASSERT(hash(JID("foo@bar/baz")) != hash(JID("foo@bar")));
+            CPPUNIT_ASSERT(hash(JID("foo@bar")) != hash(JID("bar")));
+        }
+
+        void testGetPrepStatistics_ASCII() {
+            JID::PrepStatistics before = JID::getPrepStatistics();
+            JID testling("foo@bar.com/baz");
+            JID::PrepStatistics after = JID::getPrepStatistics();
+
+            CPPUNIT_ASSERT_EQUAL(before.asciiFastPath + 3, after.asciiFastPath);
+            CPPUNIT_ASSERT_EQUAL(before.cacheHits, after.cacheHits);
+            CPPUNIT_ASSERT_EQUAL(before.cacheMisses, after.cacheMisses);
+        }
+
+        void testGetPrepStatistics_CacheHit() {
+            JID first("PrepStatistics@bar.com");
+            JID::PrepStatistics before = JID::getPrepStatistics();
+            JID second("PrepStatistics@bar.com");
+            JID::PrepStatistics after = JID::getPrepStatistics();
+
+            CPPUNIT_ASSERT_EQUAL(std::string("prepstatistics"), second.getNode());
+            CPPUNIT_ASSERT_EQUAL(before.cacheHits + 1, after.cacheHits);
+            CPPUNIT_ASSERT_EQUAL(before.cacheMisses, after.cacheMisses);
+        }
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(JIDTest);
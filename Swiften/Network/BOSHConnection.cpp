@@ -5,7 +5,7 @@
  */
 
 /*
- * Copyright (c) 2011-2017 Isode Limited.
+ * Copyright (c) 2011-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -19,7 +19,6 @@
 #include <boost/lexical_cast.hpp>
 
 #include <Swiften/Base/ByteArray.h>
-#include <Swiften/Base/Concat.h>
 #include <Swiften/Base/Log.h>
 #include <Swiften/Base/String.h>
 #include <Swiften/Network/HostAddressPort.h>
@@ -38,11 +37,22 @@ BOSHConnection::BOSHConnection(const URL& boshURL, Connector::ref connector, XML
       sid_(),
       waitingForStartResponse_(false),
         rid_(~0ULL),
-      pending_(false),
+      responseError_(false),
+      parseError_(false),
+      parsingData_(false),
+      pendingRequests_(0),
+      persistent_(false),
       connectionReady_(false)
 {
+    httpParser_.onResponseHeader.connect(boost::bind(&BOSHConnection::handleHTTPResponseHeader, this, _1, _2));
+    httpParser_.onBodyData.connect(boost::bind(&BOSHConnection::handleHTTPBodyData, this, _1));
+    httpParser_.onResponseFinished.connect(boost::bind(&BOSHConnection::handleHTTPResponseFinished, this, _1));
     if (boshURL_.getScheme() == "https") {
-        tlsLayer_ = std::make_shared<TLSLayer>(tlsContextFactory, tlsOptions);
+        TLSOptions options = tlsOptions;
+        if (options.sessionCacheKey.empty()) {
+            options.sessionCacheKey = boshURL_.getHost() + ":" + std::to_string(boshURL_.getPort() ? *boshURL_.getPort() : 443);
+        }
+        tlsLayer_ = std::make_shared<TLSLayer>(tlsContextFactory, options);
         // The following dummyLayer_ is needed as the TLSLayer will pass the decrypted data to its parent layer.
         // The dummyLayer_ will serve as the parent layer.
         dummyLayer_ = std::make_shared<DummyStreamLayer>(tlsLayer_.get());
@@ -207,7 +217,7 @@ void BOSHConnection::write(const SafeByteArray& data, bool streamRestart, bool t
 
     onBOSHDataWritten(safeHeader);
     writeData(safeHeader);
-    pending_ = true;
+    pendingRequests_++;
 
     SWIFT_LOG(debug) << "write data: " << safeByteArrayToString(safeHeader) << std::endl;
 }
@@ -270,6 +280,7 @@ void BOSHConnection::startStream(const std::string& to, unsigned long long rid)
             << contentString;
 
     waitingForStartResponse_ = true;
+    pendingRequests_++;
     SafeByteArray safeHeader = createSafeByteArray(header.str());
     onBOSHDataWritten(safeHeader);
     writeData(safeHeader);
@@ -278,27 +289,64 @@ void BOSHConnection::startStream(const std::string& to, unsigned long long rid)
 
 void BOSHConnection::handleDataRead(std::shared_ptr<SafeByteArray> data) {
     onBOSHDataRead(*data);
-    buffer_ = concat(buffer_, *data);
-    std::string response = safeByteArrayToString(buffer_);
-    if (response.find("\r\n\r\n") == std::string::npos) {
-        onBOSHDataRead(createSafeByteArray("[[Previous read incomplete, pending]]"));
+    parsingData_ = true;
+    bool parsed = httpParser_.parse(*data);
+    parsingData_ = false;
+    if (!parsed) {
+        if (!parseError_) {
+            parseError_ = true;
+            onHTTPError("");
+        }
         return;
     }
+    if (httpParser_.isInResponse()) {
+        onBOSHDataRead(createSafeByteArray("[[Previous read incomplete, pending]]"));
+    }
+}
 
-    std::string httpCode = response.substr(response.find(" ") + 1, 3);
-    if (httpCode != "200") {
-        onHTTPError(httpCode);
-        return;
+void BOSHConnection::handleHTTPResponseHeader(int statusCode, const HTTPResponseParser::HeaderFields&) {
+    responseError_ = statusCode != 200;
+    if (responseError_) {
+        onHTTPError(std::to_string(statusCode));
+    }
+}
+
+void BOSHConnection::handleHTTPBodyData(const SafeByteArray& data) {
+    if (!responseError_) {
+        body_.insert(body_.end(), data.begin(), data.end());
+    }
+}
+
+void BOSHConnection::handleHTTPResponseFinished(bool keepAlive) {
+    SafeByteArray body;
+    body.swap(body_);
+    if (pendingRequests_ > 0) {
+        pendingRequests_--;
+    }
+
+    /* Make sure nothing is sent anymore if the server is going to close the connection */
+    bool wasReady = connectionReady_;
+    persistent_ = keepAlive;
+    if (!keepAlive) {
+        connectionReady_ = false;
     }
 
-    BOSHBodyExtractor parser(parserFactory_, createByteArray(response.substr(response.find("\r\n\r\n") + 4)));
+    if (!responseError_) {
+        handleResponseBody(body);
+    }
+    if (!keepAlive && wasReady) {
+        disconnect();
+    }
+}
+
+void BOSHConnection::handleResponseBody(const SafeByteArray& body) {
+    BOSHBodyExtractor parser(parserFactory_, ByteArray(body.begin(), body.end()));
     if (parser.getBody()) {
         if (parser.getBody()->attributes.getAttribute("type") == "terminate") {
             BOSHError::Type errorType = parseTerminationCondition(parser.getBody()->attributes.getAttribute("condition"));
             onSessionTerminated(errorType == BOSHError::NoError ? std::shared_ptr<BOSHError>() : std::make_shared<BOSHError>(errorType));
             return;
         }
-        buffer_.clear();
         if (waitingForStartResponse_) {
             waitingForStartResponse_ = false;
             sid_ = parser.getBody()->attributes.getAttribute("sid");
@@ -314,11 +362,8 @@ void BOSHConnection::handleDataRead(std::shared_ptr<SafeByteArray> data) {
             onSessionStarted(sid_, requests);
         }
         SafeByteArray payload = createSafeByteArray(parser.getBody()->content);
-        /* Say we're good to go again, so don't add anything after here in the method */
-        pending_ = false;
         onXMPPDataRead(payload);
     }
-
 }
 
 BOSHError::Type BOSHConnection::parseTerminationCondition(const std::string& text) {
@@ -379,16 +424,27 @@ void BOSHConnection::setSID(const std::string& sid) {
 
 void BOSHConnection::handleDisconnected(const boost::optional<Connection::Error>& error) {
     cancelConnector();
+    connectionReady_ = false;
+    /* A response without a length ends when the connection is closed. If we're
+     * disconnecting while handling a response, the parser is still busy. */
+    if (!parsingData_) {
+        httpParser_.finish();
+    }
     onDisconnected(error ? true : false);
     sid_ = "";
-    connectionReady_ = false;
 }
 
-
 bool BOSHConnection::isReadyToSend() {
-    /* Without pipelining you need to not send more without first receiving the response */
-    /* With pipelining you can. Assuming we can't, here */
-    return connectionReady_ && !pending_ && !waitingForStartResponse_ && !sid_.empty();
+    return connectionReady_ && pendingRequests_ == 0 && !waitingForStartResponse_ && !sid_.empty();
+}
+
+bool BOSHConnection::canPipelineRequest() {
+    /* Only pipeline once the server has shown it keeps the connection open */
+    return connectionReady_ && persistent_ && !waitingForStartResponse_ && !sid_.empty();
+}
+
+size_t BOSHConnection::getPendingRequestCount() const {
+    return pendingRequests_;
 }
 
 }
@@ -5,7 +5,7 @@
  */
 
 /*
- * Copyright (c) 2011-2017 Isode Limited.
+ * Copyright (c) 2011-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -21,6 +21,7 @@
 #include <Swiften/Base/URL.h>
 #include <Swiften/Network/Connection.h>
 #include <Swiften/Network/Connector.h>
+#include <Swiften/Network/HTTPResponseParser.h>
 #include <Swiften/Network/HostAddressPort.h>
 #include <Swiften/Session/SessionStream.h>
 #include <Swiften/TLS/TLSError.h>
@@ -66,9 +67,26 @@ namespace Swift {
             void setSID(const std::string& sid);
             void startStream(const std::string& to, unsigned long long rid);
             void terminateStream();
-            bool isReadyToSend();
             void restartStream();
 
+            /**
+             * Returns whether the connection is idle, i.e. whether a request
+             * can be sent without waiting for the responses to earlier ones.
+             */
+            bool isReadyToSend();
+
+            /**
+             * Returns whether another request can be pipelined on this
+             * connection, i.e. sent before the responses to the pending
+             * requests have been read.
+             */
+            bool canPipelineRequest();
+
+            /**
+             * Returns the number of requests that haven't been answered yet.
+             */
+            size_t getPendingRequestCount() const;
+
             bool setClientCertificate(CertificateWithKey::ref cert);
             Certificate::ref getPeerCertificate() const;
             std::vector<Certificate::ref> getPeerCertificateChain() const;
@@ -91,6 +109,10 @@ namespace Swift {
             static std::pair<SafeByteArray, size_t> createHTTPRequest(const SafeByteArray& data, bool streamRestart, bool terminate, unsigned long long rid, const std::string& sid, const URL& boshURL);
             void handleConnectFinished(Connection::ref);
             void handleDataRead(std::shared_ptr<SafeByteArray> data);
+            void handleHTTPResponseHeader(int statusCode, const HTTPResponseParser::HeaderFields&);
+            void handleHTTPBodyData(const SafeByteArray& data);
+            void handleHTTPResponseFinished(bool keepAlive);
+            void handleResponseBody(const SafeByteArray& body);
             void handleDisconnected(const boost::optional<Connection::Error>& error);
             void write(const SafeByteArray& data, bool streamRestart, bool terminate); /* FIXME: refactor */
             BOSHError::Type parseTerminationCondition(const std::string& text);
@@ -112,8 +134,13 @@ namespace Swift {
             std::string sid_;
             bool waitingForStartResponse_;
             unsigned long long rid_;
-            SafeByteArray buffer_;
-            bool pending_;
+            HTTPResponseParser httpParser_;
+            SafeByteArray body_;
+            bool responseError_;
+            bool parseError_;
+            bool parsingData_;
+            size_t pendingRequests_;
+            bool persistent_;
             bool connectionReady_;
     };
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2011-2016 Isode Limited.
+ * Copyright (c) 2011-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -12,11 +12,10 @@
 
 #include <Swiften/Base/Log.h>
 #include <Swiften/Base/SafeString.h>
-#include <Swiften/Network/CachingDomainNameResolver.h>
 #include <Swiften/Network/HTTPConnectProxiedConnectionFactory.h>
 
 namespace Swift {
-BOSHConnectionPool::BOSHConnectionPool(const URL& boshURL, DomainNameResolver* realResolver, ConnectionFactory* connectionFactoryParameter, XMLParserFactory* parserFactory, TLSContextFactory* tlsFactory, TimerFactory* timerFactory, EventLoop* eventLoop, const std::string& to, unsigned long long initialRID, const URL& boshHTTPConnectProxyURL, const SafeString& boshHTTPConnectProxyAuthID, const SafeString& boshHTTPConnectProxyAuthPassword, const TLSOptions& tlsOptions, std::shared_ptr<HTTPTrafficFilter> trafficFilter) :
+BOSHConnectionPool::BOSHConnectionPool(const URL& boshURL, DomainNameResolver* resolver, ConnectionFactory* connectionFactoryParameter, XMLParserFactory* parserFactory, TLSContextFactory* tlsFactory, TimerFactory* timerFactory, const std::string& to, unsigned long long initialRID, const URL& boshHTTPConnectProxyURL, const SafeString& boshHTTPConnectProxyAuthID, const SafeString& boshHTTPConnectProxyAuthPassword, const TLSOptions& tlsOptions, std::shared_ptr<HTTPTrafficFilter> trafficFilter) :
         boshURL(boshURL),
         connectionFactory(connectionFactoryParameter),
         xmlParserFactory(parserFactory),
@@ -27,13 +26,14 @@ BOSHConnectionPool::BOSHConnectionPool(const URL& boshURL, DomainNameResolver* r
         requestLimit(2),
         restartCount(0),
         pendingRestart(false),
+        pipeliningEnabled(false),
+        resolver(resolver),
         tlsContextFactory_(tlsFactory),
         tlsOptions_(tlsOptions) {
 
     if (!boshHTTPConnectProxyURL.isEmpty()) {
-        connectionFactory = new HTTPConnectProxiedConnectionFactory(realResolver, connectionFactory, timerFactory, boshHTTPConnectProxyURL.getHost(), URL::getPortOrDefaultPort(boshHTTPConnectProxyURL), boshHTTPConnectProxyAuthID, boshHTTPConnectProxyAuthPassword, trafficFilter);
+        connectionFactory = new HTTPConnectProxiedConnectionFactory(resolver, connectionFactory, timerFactory, boshHTTPConnectProxyURL.getHost(), URL::getPortOrDefaultPort(boshHTTPConnectProxyURL), boshHTTPConnectProxyAuthID, boshHTTPConnectProxyAuthPassword, trafficFilter);
     }
-    resolver = new CachingDomainNameResolver(realResolver, eventLoop);
 }
 
 BOSHConnectionPool::~BOSHConnectionPool() {
@@ -48,7 +48,6 @@ BOSHConnectionPool::~BOSHConnectionPool() {
     for (auto factory : myConnectionFactories) {
         delete factory;
     }
-    delete resolver;
 }
 
 void BOSHConnectionPool::write(const SafeByteArray& data) {
@@ -75,6 +74,10 @@ void BOSHConnectionPool::restartStream() {
     }
 }
 
+void BOSHConnectionPool::setPipeliningEnabled(bool enabled) {
+    pipeliningEnabled = enabled;
+}
+
 void BOSHConnectionPool::setTLSCertificate(CertificateWithKey::ref certWithKey) {
     clientCertificate = certWithKey;
 }
@@ -157,6 +160,11 @@ void BOSHConnectionPool::handleConnectFinished(bool error, BOSHConnection::ref c
 
 BOSHConnection::ref BOSHConnectionPool::getSuitableConnection() {
     BOSHConnection::ref suitableConnection;
+    if (pipeliningEnabled && getPendingRequestCount() >= requestLimit) {
+        /* Wait until the server has answered a request, also on new connections */
+        return suitableConnection;
+    }
+
     for (auto&& connection : connections) {
         if (connection->isReadyToSend()) {
             suitableConnection = connection;
@@ -169,11 +177,27 @@ BOSHConnection::ref BOSHConnectionPool::getSuitableConnection() {
         BOSHConnection::ref newConnection = createConnection();
         newConnection->setSID(sid);
     }
+    else if (!suitableConnection && pipeliningEnabled) {
+        /* No more connections may be opened, so pipeline on the one with the fewest requests waiting for a response */
+        for (auto&& connection : connections) {
+            if (connection->canPipelineRequest() && (!suitableConnection || connection->getPendingRequestCount() < suitableConnection->getPendingRequestCount())) {
+                suitableConnection = connection;
+            }
+        }
+    }
     assert(connections.size() <= requestLimit);
-    assert((!suitableConnection) || suitableConnection->isReadyToSend());
+    assert((!suitableConnection) || suitableConnection->isReadyToSend() || suitableConnection->canPipelineRequest());
     return suitableConnection;
 }
 
+size_t BOSHConnectionPool::getPendingRequestCount() const {
+    size_t count = 0;
+    for (const auto& connection : connections) {
+        count += connection->getPendingRequestCount();
+    }
+    return count;
+}
+
 void BOSHConnectionPool::tryToSendQueuedData() {
     if (sid.empty()) {
         /* If we've not got as far as stream start yet, pend */
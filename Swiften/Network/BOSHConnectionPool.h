@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2011-2017 Isode Limited.
+ * Copyright (c) 2011-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -16,16 +16,13 @@
 #include <Swiften/TLS/TLSOptions.h>
 
 namespace Swift {
-    class CachingDomainNameResolver;
-    class EventLoop;
+    class DomainNameResolver;
     class HTTPTrafficFilter;
     class TLSContextFactory;
-    class CachingDomainNameResolver;
-    class EventLoop;
 
     class SWIFTEN_API BOSHConnectionPool : public boost::signals2::trackable {
         public:
-            BOSHConnectionPool(const URL& boshURL, DomainNameResolver* resolver, ConnectionFactory* connectionFactory, XMLParserFactory* parserFactory, TLSContextFactory* tlsFactory, TimerFactory* timerFactory, EventLoop* eventLoop, const std::string& to, unsigned long long initialRID, const URL& boshHTTPConnectProxyURL, const SafeString& boshHTTPConnectProxyAuthID, const SafeString& boshHTTPConnectProxyAuthPassword, const TLSOptions& tlsOptions, std::shared_ptr<HTTPTrafficFilter> trafficFilter = std::shared_ptr<HTTPTrafficFilter>());
+            BOSHConnectionPool(const URL& boshURL, DomainNameResolver* resolver, ConnectionFactory* connectionFactory, XMLParserFactory* parserFactory, TLSContextFactory* tlsFactory, TimerFactory* timerFactory, const std::string& to, unsigned long long initialRID, const URL& boshHTTPConnectProxyURL, const SafeString& boshHTTPConnectProxyAuthID, const SafeString& boshHTTPConnectProxyAuthPassword, const TLSOptions& tlsOptions, std::shared_ptr<HTTPTrafficFilter> trafficFilter = std::shared_ptr<HTTPTrafficFilter>());
             ~BOSHConnectionPool();
 
             void open();
@@ -34,6 +31,16 @@ namespace Swift {
             void close();
             void restartStream();
 
+            /**
+             * Allows requests to be pipelined on the open connections when
+             * none of them is idle and no more connections may be opened.
+             * The server is still never sent more requests at once than it
+             * allows.
+             *
+             * Default: disabled
+             */
+            void setPipeliningEnabled(bool enabled);
+
             void setTLSCertificate(CertificateWithKey::ref certWithKey);
             bool isTLSEncrypted() const;
             Certificate::ref getPeerCertificate() const;
@@ -62,6 +69,7 @@ namespace Swift {
             void destroyConnection(BOSHConnection::ref connection);
             void tryToSendQueuedData();
             BOSHConnection::ref getSuitableConnection();
+            size_t getPendingRequestCount() const;
 
         private:
             URL boshURL;
@@ -77,8 +85,9 @@ namespace Swift {
             size_t requestLimit;
             int restartCount;
             bool pendingRestart;
+            bool pipeliningEnabled;
             std::vector<ConnectionFactory*> myConnectionFactories;
-            CachingDomainNameResolver* resolver;
+            DomainNameResolver* resolver;
             CertificateWithKey::ref clientCertificate;
             TLSContextFactory* tlsContextFactory_;
             TLSOptions tlsOptions_;
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -16,46 +16,117 @@
 #include <boost/bind.hpp>
 #include <boost/numeric/conversion/cast.hpp>
 
-#include <Swiften/Base/Algorithm.h>
 #include <Swiften/Base/ByteArray.h>
 #include <Swiften/Base/Log.h>
+#include <Swiften/Base/Platform.h>
 #include <Swiften/Base/SafeAllocator.h>
 #include <Swiften/Base/sleep.h>
 #include <Swiften/EventLoop/EventLoop.h>
 #include <Swiften/Network/HostAddressPort.h>
 
+#if defined(SWIFTEN_PLATFORM_LINUX)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/sendfile.h>
+#include <unistd.h>
+#endif
+
 namespace Swift {
 
 static const size_t BUFFER_SIZE = 4096;
 
 // -----------------------------------------------------------------------------
 
-// A reference-counted non-modifiable buffer class.
-class SharedBuffer {
+// A reference-counted sequence of non-modifiable buffers, which are sent
+// with a single gather write.
+class SharedBufferSequence {
     public:
-        SharedBuffer(const SafeByteArray& data) :
-                data_(new std::vector<char, SafeAllocator<char> >(data.begin(), data.end())),
-                buffer_(boost::asio::buffer(*data_)) {
+        SharedBufferSequence(std::vector<std::shared_ptr<SafeByteArray> >& data) :
+                data_(std::make_shared<std::vector<std::shared_ptr<SafeByteArray> > >()),
+                buffers_(std::make_shared<std::vector<boost::asio::const_buffer> >()) {
+            data_->swap(data);
+            buffers_->reserve(data_->size());
+            for (const auto& buffer : *data_) {
+                buffers_->push_back(boost::asio::buffer(*buffer));
+            }
         }
 
         // ConstBufferSequence requirements.
         typedef boost::asio::const_buffer value_type;
-        typedef const boost::asio::const_buffer* const_iterator;
-        const boost::asio::const_buffer* begin() const { return &buffer_; }
-        const boost::asio::const_buffer* end() const { return &buffer_ + 1; }
+        typedef std::vector<boost::asio::const_buffer>::const_iterator const_iterator;
+        const_iterator begin() const { return buffers_->begin(); }
+        const_iterator end() const { return buffers_->end(); }
+
+    private:
+        std::shared_ptr< std::vector<std::shared_ptr<SafeByteArray> > > data_;
+        std::shared_ptr< std::vector<boost::asio::const_buffer> > buffers_;
+};
+
+// -----------------------------------------------------------------------------
+
+// Recycles the buffers that incoming data is read into.
+// A buffer returns to the pool once the last reference to it (typically
+// held by an onDataRead event or handler) goes away, which may happen on
+// a different thread than the one reading from the socket.
+class BoostConnection::ReadBufferPool : public std::enable_shared_from_this<ReadBufferPool> {
+    public:
+        std::shared_ptr<SafeByteArray> getBuffer() {
+            SafeByteArray* buffer = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!buffers_.empty()) {
+                    buffer = buffers_.back().release();
+                    buffers_.pop_back();
+                }
+            }
+            if (buffer) {
+                // Shrunk to the number of bytes read last time; growing it back
+                // does not reallocate.
+                buffer->resize(BUFFER_SIZE);
+            }
+            else {
+                buffer = new SafeByteArray(BUFFER_SIZE);
+            }
+            std::weak_ptr<ReadBufferPool> pool = shared_from_this();
+            return std::shared_ptr<SafeByteArray>(buffer, [pool](SafeByteArray* returnedBuffer) {
+                std::shared_ptr<ReadBufferPool> strongPool = pool.lock();
+                if (strongPool) {
+                    strongPool->returnBuffer(returnedBuffer);
+                }
+                else {
+                    delete returnedBuffer;
+                }
+            });
+        }
+
+    private:
+        void returnBuffer(SafeByteArray* buffer) {
+            std::unique_ptr<SafeByteArray> ownedBuffer(buffer);
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (buffers_.size() < MAX_POOLED_BUFFERS && buffer->capacity() >= BUFFER_SIZE) {
+                buffers_.push_back(std::move(ownedBuffer));
+            }
+        }
 
     private:
-        std::shared_ptr< std::vector<char, SafeAllocator<char> > > data_;
-        boost::asio::const_buffer buffer_;
+        static const size_t MAX_POOLED_BUFFERS = 4;
+
+        std::mutex mutex_;
+        std::vector<std::unique_ptr<SafeByteArray> > buffers_;
 };
 
 // -----------------------------------------------------------------------------
 
 BoostConnection::BoostConnection(std::shared_ptr<boost::asio::io_service> ioService, EventLoop* eventLoop) :
-    eventLoop(eventLoop), ioService(ioService), socket_(*ioService), writing_(false), closeSocketAfterNextWrite_(false) {
+    eventLoop(eventLoop), ioService(ioService), socket_(*ioService), readBufferPool_(std::make_shared<ReadBufferPool>()), writing_(false), writeQueueSize_(0), corked_(false), flushThreshold_(DEFAULT_FLUSH_THRESHOLD), flushPosted_(false), closeSocketAfterNextWrite_(false), fileDescriptor_(-1) {
 }
 
 BoostConnection::~BoostConnection() {
+#if defined(SWIFTEN_PLATFORM_LINUX)
+    if (fileDescriptor_ >= 0) {
+        ::close(fileDescriptor_);
+    }
+#endif
 }
 
 void BoostConnection::listen() {
@@ -77,6 +148,11 @@ void BoostConnection::disconnect() {
     // See e.g. http://bugs.python.org/issue7401
     // We therefore wait until any pending write finishes, which hopefully should fix our hang on exit during close().
     std::lock_guard<std::mutex> lock(writeMutex_);
+    if (!writing_ && (!writeQueue_.empty() || !fileWriteQueue_.empty())) {
+        // Send what corking held back before closing
+        writing_ = true;
+        doWrite();
+    }
     if (writing_) {
         closeSocketAfterNextWrite_ = true;
     } else {
@@ -91,20 +167,136 @@ void BoostConnection::closeSocket() {
     socket_.close();
 }
 
+void BoostConnection::setCorked(bool corked, size_t flushThreshold) {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    corked_ = corked;
+    flushThreshold_ = flushThreshold;
+}
+
 void BoostConnection::write(const SafeByteArray& data) {
     std::lock_guard<std::mutex> lock(writeMutex_);
+    writeQueue_.push_back(std::make_shared<SafeByteArray>(data));
+    writeQueueSize_ += data.size();
+    if (writing_) {
+        // Sent when the current write finishes
+        return;
+    }
+    if (!corked_ || writeQueueSize_ >= flushThreshold_) {
+        writing_ = true;
+        doWrite();
+    }
+    else if (!flushPosted_) {
+        // Not owned by this connection, so that removing the events of the
+        // connection does not leave data behind in the queue.
+        flushPosted_ = true;
+        eventLoop->postEvent(boost::bind(&BoostConnection::flush, shared_from_this()));
+    }
+}
+
+bool BoostConnection::canWriteFile() const {
+#if defined(SWIFTEN_PLATFORM_LINUX)
+    return true;
+#else
+    return false;
+#endif
+}
+
+void BoostConnection::writeFile(const boost::filesystem::path& file, unsigned long long offset, size_t size) {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    FileWrite fileWrite = { file, offset, size, writeQueue_.size() };
+    fileWriteQueue_.push_back(fileWrite);
+    // Corking doesn't apply, there is nothing to coalesce the file with
     if (!writing_) {
         writing_ = true;
-        doWrite(data);
+        doWrite();
+    }
+}
+
+void BoostConnection::flush() {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    flushPosted_ = false;
+    if (!writing_ && !writeQueue_.empty()) {
+        writing_ = true;
+        doWrite();
+    }
+}
+
+void BoostConnection::doWrite() {
+    if (fileWriteQueue_.empty()) {
+        boost::asio::async_write(socket_, SharedBufferSequence(writeQueue_),
+                boost::bind(&BoostConnection::handleDataWritten, shared_from_this(), boost::asio::placeholders::error));
+        writeQueue_.clear();
+        writeQueueSize_ = 0;
+    }
+    else if (fileWriteQueue_.front().queuePosition == 0) {
+        currentFileWrite_ = fileWriteQueue_.front();
+        fileWriteQueue_.pop_front();
+        doWriteFile();
     }
     else {
-        append(writeQueue_, data);
+        // Only send the buffers that were queued before the next file
+        size_t count = fileWriteQueue_.front().queuePosition;
+        std::vector<std::shared_ptr<SafeByteArray> > buffers(writeQueue_.begin(), writeQueue_.begin() + static_cast<std::ptrdiff_t>(count));
+        writeQueue_.erase(writeQueue_.begin(), writeQueue_.begin() + static_cast<std::ptrdiff_t>(count));
+        for (const auto& buffer : buffers) {
+            writeQueueSize_ -= buffer->size();
+        }
+        for (auto& fileWrite : fileWriteQueue_) {
+            fileWrite.queuePosition -= count;
+        }
+        boost::asio::async_write(socket_, SharedBufferSequence(buffers),
+                boost::bind(&BoostConnection::handleDataWritten, shared_from_this(), boost::asio::placeholders::error));
     }
 }
 
-void BoostConnection::doWrite(const SafeByteArray& data) {
-    boost::asio::async_write(socket_, SharedBuffer(data),
-            boost::bind(&BoostConnection::handleDataWritten, shared_from_this(), boost::asio::placeholders::error));
+void BoostConnection::doWriteFile() {
+    // The file is sent from the I/O thread once the socket can take data
+    socket_.async_write_some(boost::asio::null_buffers(),
+            boost::bind(&BoostConnection::handleSocketWritable, shared_from_this(), boost::asio::placeholders::error));
+}
+
+void BoostConnection::handleSocketWritable(const boost::system::error_code& error) {
+    if (error) {
+        handleDataWritten(error);
+        return;
+    }
+    boost::system::error_code writeError;
+#if defined(SWIFTEN_PLATFORM_LINUX)
+    if (fileDescriptor_ < 0 || openFile_ != currentFileWrite_.file) {
+        if (fileDescriptor_ >= 0) {
+            ::close(fileDescriptor_);
+        }
+        openFile_ = currentFileWrite_.file;
+        fileDescriptor_ = ::open(openFile_.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fileDescriptor_ < 0) {
+            handleDataWritten(boost::system::error_code(errno, boost::system::system_category()));
+            return;
+        }
+    }
+    socket_.native_non_blocking(true, writeError);
+    while (!writeError && currentFileWrite_.size > 0) {
+        off_t offset = static_cast<off_t>(currentFileWrite_.offset);
+        ssize_t sent = ::sendfile(socket_.native_handle(), fileDescriptor_, &offset, currentFileWrite_.size);
+        if (sent > 0) {
+            currentFileWrite_.offset += static_cast<unsigned long long>(sent);
+            currentFileWrite_.size -= static_cast<size_t>(sent);
+        }
+        else if (sent == 0) {
+            // The file is shorter than announced
+            writeError = boost::asio::error::eof;
+        }
+        else if (errno == EAGAIN) {
+            doWriteFile();
+            return;
+        }
+        else if (errno != EINTR) {
+            writeError = boost::system::error_code(errno, boost::system::system_category());
+        }
+    }
+#else
+    writeError = boost::asio::error::operation_not_supported;
+#endif
+    handleDataWritten(writeError);
 }
 
 void BoostConnection::handleConnectFinished(const boost::system::error_code& error) {
@@ -119,7 +311,7 @@ void BoostConnection::handleConnectFinished(const boost::system::error_code& err
 }
 
 void BoostConnection::doRead() {
-    readBuffer_ = std::make_shared<SafeByteArray>(BUFFER_SIZE);
+    readBuffer_ = readBufferPool_->getBuffer();
     std::lock_guard<std::mutex> lock(readCloseMutex_);
     socket_.async_read_some(
             boost::asio::buffer(*readBuffer_),
@@ -154,15 +346,14 @@ void BoostConnection::handleDataWritten(const boost::system::error_code& error)
     }
     {
         std::lock_guard<std::mutex> lock(writeMutex_);
-        if (writeQueue_.empty()) {
+        if (writeQueue_.empty() && fileWriteQueue_.empty()) {
             writing_ = false;
             if (closeSocketAfterNextWrite_) {
                 closeSocket();
             }
         }
         else {
-            doWrite(writeQueue_);
-            writeQueue_.clear();
+            doWrite();
         }
     }
 }
@@ -1,13 +1,15 @@
 /*
- * Copyright (c) 2010-2017 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #pragma once
 
+#include <deque>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 #include <boost/asio/io_service.hpp>
 #include <boost/asio/ip/tcp.hpp>
@@ -38,6 +40,26 @@ namespace Swift {
             virtual void disconnect();
             virtual void write(const SafeByteArray& data);
 
+            /**
+             * Supported on Linux, where the file is sent with sendfile().
+             */
+            virtual bool canWriteFile() const;
+            virtual void writeFile(const boost::filesystem::path& file, unsigned long long offset, size_t size);
+
+            /**
+             * Enables or disables corking of writes (disabled by default).
+             *
+             * Writes made while another write is in progress are always queued, and
+             * sent together with a single gather write when it finishes.
+             * When corked, writes are also held back while no write is in progress,
+             * until the events that are pending on the event loop have been handled,
+             * or until \p flushThreshold bytes are queued. This way, all data written
+             * in response to one batch of events goes out in one system call.
+             */
+            void setCorked(bool corked, size_t flushThreshold = DEFAULT_FLUSH_THRESHOLD);
+
+            static const size_t DEFAULT_FLUSH_THRESHOLD = 65536;
+
             boost::asio::ip::tcp::socket& getSocket() {
                 return socket_;
             }
@@ -57,19 +79,44 @@ namespace Swift {
             void handleConnectFinished(const boost::system::error_code& error);
             void handleSocketRead(const boost::system::error_code& error, size_t bytesTransferred);
             void handleDataWritten(const boost::system::error_code& error);
+            void handleSocketWritable(const boost::system::error_code& error);
             void doRead();
-            void doWrite(const SafeByteArray& data);
+            void doWrite();
+            void doWriteFile();
+            void flush();
             void closeSocket();
 
+        private:
+            class ReadBufferPool;
+
+            struct FileWrite {
+                boost::filesystem::path file;
+                unsigned long long offset;
+                size_t size;
+                // Number of queued buffers that are sent before the file
+                size_t queuePosition;
+            };
+
         private:
             EventLoop* eventLoop;
             std::shared_ptr<boost::asio::io_service> ioService;
             boost::asio::ip::tcp::socket socket_;
+            std::shared_ptr<ReadBufferPool> readBufferPool_;
             std::shared_ptr<SafeByteArray> readBuffer_;
             std::mutex writeMutex_;
             bool writing_;
-            SafeByteArray writeQueue_;
+            std::vector<std::shared_ptr<SafeByteArray> > writeQueue_;
+            size_t writeQueueSize_;
+            std::deque<FileWrite> fileWriteQueue_;
+            bool corked_;
+            size_t flushThreshold_;
+            bool flushPosted_;
             bool closeSocketAfterNextWrite_;
             std::mutex readCloseMutex_;
+
+            // Set when a file write starts, and then only used by the I/O thread
+            FileWrite currentFileWrite_;
+            int fileDescriptor_;
+            boost::filesystem::path openFile_;
     };
 }
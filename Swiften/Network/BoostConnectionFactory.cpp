@@ -1,20 +1,37 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <Swiften/Network/BoostConnectionFactory.h>
 
+#include <cassert>
+
 #include <Swiften/Network/BoostConnection.h>
 
 namespace Swift {
 
-BoostConnectionFactory::BoostConnectionFactory(std::shared_ptr<boost::asio::io_service> ioService, EventLoop* eventLoop) : ioService(ioService), eventLoop(eventLoop) {
+BoostConnectionFactory::BoostConnectionFactory(std::shared_ptr<boost::asio::io_service> ioService, EventLoop* eventLoop) : ioServices(1, ioService), nextIOService(0), corked(false), flushThreshold(BoostConnection::DEFAULT_FLUSH_THRESHOLD), eventLoop(eventLoop) {
+}
+
+BoostConnectionFactory::BoostConnectionFactory(const BoostIOServiceThread::IOServiceList& ioServices, EventLoop* eventLoop) : ioServices(ioServices), nextIOService(0), corked(false), flushThreshold(BoostConnection::DEFAULT_FLUSH_THRESHOLD), eventLoop(eventLoop) {
+    assert(!ioServices.empty());
 }
 
 std::shared_ptr<Connection> BoostConnectionFactory::createConnection() {
-    return BoostConnection::create(ioService, eventLoop);
+    std::shared_ptr<boost::asio::io_service> ioService = ioServices[nextIOService];
+    nextIOService = (nextIOService + 1) % ioServices.size();
+    BoostConnection::ref connection = BoostConnection::create(ioService, eventLoop);
+    if (corked) {
+        connection->setCorked(corked, flushThreshold);
+    }
+    return connection;
+}
+
+void BoostConnectionFactory::setCorked(bool corked, size_t flushThreshold) {
+    this->corked = corked;
+    this->flushThreshold = flushThreshold;
 }
 
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2017 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -10,6 +10,7 @@
 
 #include <Swiften/Base/API.h>
 #include <Swiften/Network/BoostConnection.h>
+#include <Swiften/Network/BoostIOServiceThread.h>
 #include <Swiften/Network/ConnectionFactory.h>
 
 namespace Swift {
@@ -17,10 +18,24 @@ namespace Swift {
         public:
             BoostConnectionFactory(std::shared_ptr<boost::asio::io_service>, EventLoop* eventLoop);
 
+            /**
+             * Creates connections on the given io_services in turn.
+             */
+            BoostConnectionFactory(const BoostIOServiceThread::IOServiceList& ioServices, EventLoop* eventLoop);
+
             virtual std::shared_ptr<Connection> createConnection();
 
+            /**
+             * Sets the corking of writes for connections created from now on.
+             * @see BoostConnection::setCorked
+             */
+            void setCorked(bool corked, size_t flushThreshold = BoostConnection::DEFAULT_FLUSH_THRESHOLD);
+
         private:
-            std::shared_ptr<boost::asio::io_service> ioService;
+            BoostIOServiceThread::IOServiceList ioServices;
+            size_t nextIOService;
+            bool corked;
+            size_t flushThreshold;
             EventLoop* eventLoop;
     };
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -19,10 +19,13 @@
 
 namespace Swift {
 
-BoostConnectionServer::BoostConnectionServer(int port, std::shared_ptr<boost::asio::io_service> ioService, EventLoop* eventLoop) : port_(port), ioService_(ioService), eventLoop(eventLoop), acceptor_(nullptr) {
+BoostConnectionServer::BoostConnectionServer(int port, std::shared_ptr<boost::asio::io_service> ioService, EventLoop* eventLoop) : port_(port), ioService_(ioService), connectionIOServices_(1, ioService), nextConnectionIOService_(0), eventLoop(eventLoop), acceptor_(nullptr) {
 }
 
-BoostConnectionServer::BoostConnectionServer(const HostAddress &address, int port, std::shared_ptr<boost::asio::io_service> ioService, EventLoop* eventLoop) : address_(address), port_(port), ioService_(ioService), eventLoop(eventLoop), acceptor_(nullptr) {
+BoostConnectionServer::BoostConnectionServer(const HostAddress &address, int port, std::shared_ptr<boost::asio::io_service> ioService, EventLoop* eventLoop) : address_(address), port_(port), ioService_(ioService), connectionIOServices_(1, ioService), nextConnectionIOService_(0), eventLoop(eventLoop), acceptor_(nullptr) {
+}
+
+BoostConnectionServer::BoostConnectionServer(const HostAddress &address, int port, const BoostIOServiceThread::IOServiceList& ioServices, EventLoop* eventLoop) : address_(address), port_(port), ioService_(ioServices.front()), connectionIOServices_(ioServices), nextConnectionIOService_(0), eventLoop(eventLoop), acceptor_(nullptr) {
 }
 
 void BoostConnectionServer::start() {
@@ -76,7 +79,11 @@ void BoostConnectionServer::stop(boost::optional<Error> e) {
 }
 
 void BoostConnectionServer::acceptNextConnection() {
-    BoostConnection::ref newConnection(BoostConnection::create(ioService_, eventLoop));
+    // Accepting into a socket of another io_service is fine, the connection
+    // is run by that io_service from then on.
+    std::shared_ptr<boost::asio::io_service> connectionIOService = connectionIOServices_[nextConnectionIOService_];
+    nextConnectionIOService_ = (nextConnectionIOService_ + 1) % connectionIOServices_.size();
+    BoostConnection::ref newConnection(BoostConnection::create(connectionIOService, eventLoop));
     acceptor_->async_accept(newConnection->getSocket(),
         boost::bind(&BoostConnectionServer::handleAccept, shared_from_this(), newConnection, boost::asio::placeholders::error));
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -16,6 +16,7 @@
 #include <Swiften/Base/API.h>
 #include <Swiften/EventLoop/EventOwner.h>
 #include <Swiften/Network/BoostConnection.h>
+#include <Swiften/Network/BoostIOServiceThread.h>
 #include <Swiften/Network/ConnectionServer.h>
 
 namespace Swift {
@@ -31,6 +32,18 @@ namespace Swift {
                 return ref(new BoostConnectionServer(address, port, ioService, eventLoop));
             }
 
+            /**
+             * Creates a server that accepts on the first of the given io_services, and
+             * hands out the accepted connections to all of them in turn.
+             */
+            static ref create(int port, const BoostIOServiceThread::IOServiceList& ioServices, EventLoop* eventLoop) {
+                return ref(new BoostConnectionServer(HostAddress(), port, ioServices, eventLoop));
+            }
+
+            static ref create(const HostAddress &address, int port, const BoostIOServiceThread::IOServiceList& ioServices, EventLoop* eventLoop) {
+                return ref(new BoostConnectionServer(address, port, ioServices, eventLoop));
+            }
+
             virtual boost::optional<Error> tryStart(); // FIXME: This should become the new start
             virtual void start();
             virtual void stop();
@@ -42,6 +55,7 @@ namespace Swift {
         private:
             BoostConnectionServer(int port, std::shared_ptr<boost::asio::io_service> ioService, EventLoop* eventLoop);
             BoostConnectionServer(const HostAddress &address, int port, std::shared_ptr<boost::asio::io_service> ioService, EventLoop* eventLoop);
+            BoostConnectionServer(const HostAddress &address, int port, const BoostIOServiceThread::IOServiceList& ioServices, EventLoop* eventLoop);
 
             void stop(boost::optional<Error> e);
             void acceptNextConnection();
@@ -51,6 +65,8 @@ namespace Swift {
             HostAddress address_;
             int port_;
             std::shared_ptr<boost::asio::io_service> ioService_;
+            BoostIOServiceThread::IOServiceList connectionIOServices_;
+            size_t nextConnectionIOService_;
             EventLoop* eventLoop;
             boost::asio::ip::tcp::acceptor* acceptor_;
     };
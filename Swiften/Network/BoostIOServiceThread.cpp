@@ -1,39 +1,48 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <Swiften/Network/BoostIOServiceThread.h>
 
+#include <algorithm>
 #include <memory>
 
 #include <boost/bind.hpp>
 
 namespace Swift {
 
-BoostIOServiceThread::BoostIOServiceThread(std::shared_ptr<boost::asio::io_service> ioService) {
+BoostIOServiceThread::BoostIOServiceThread(std::shared_ptr<boost::asio::io_service> ioService, size_t threadCount) {
     if (!!ioService) {
-        ioService_ = ioService;
-        thread_ = nullptr;
+        ioServices_.push_back(ioService);
     }
     else {
-        ioService_ = std::make_shared<boost::asio::io_service>();
-        thread_ = new std::thread(boost::bind(&BoostIOServiceThread::doRun, this));
+        if (threadCount == 0) {
+            threadCount = std::max(1U, std::thread::hardware_concurrency());
+        }
+        for (size_t i = 0; i < threadCount; ++i) {
+            ioServices_.push_back(std::make_shared<boost::asio::io_service>());
+            threads_.push_back(new std::thread(boost::bind(&BoostIOServiceThread::doRun, this, ioServices_.back())));
+        }
     }
 }
 
 BoostIOServiceThread::~BoostIOServiceThread() {
-    if (thread_) {
-        ioService_->stop();
-        thread_->join();
-        delete thread_;
+    if (!threads_.empty()) {
+        for (const auto& ioService : ioServices_) {
+            ioService->stop();
+        }
+        for (auto thread : threads_) {
+            thread->join();
+            delete thread;
+        }
     }
 }
 
-void BoostIOServiceThread::doRun() {
-    boost::asio::io_service::work work(*ioService_);
-    ioService_->run();
+void BoostIOServiceThread::doRun(std::shared_ptr<boost::asio::io_service> ioService) {
+    boost::asio::io_service::work work(*ioService);
+    ioService->run();
 }
 
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -8,6 +8,7 @@
 
 #include <memory>
 #include <thread>
+#include <vector>
 
 #include <boost/asio/io_service.hpp>
 
@@ -16,6 +17,8 @@
 namespace Swift {
     class SWIFTEN_API BoostIOServiceThread {
         public:
+            typedef std::vector<std::shared_ptr<boost::asio::io_service> > IOServiceList;
+
             /**
              * Construct the object.
              * @param ioService If this optional parameter is provided, the behaviour
@@ -23,19 +26,34 @@ namespace Swift {
              * and instead acts as a simple wrapper of the io_service. Use this if
              * you are re-using an io_service from elsewhere (particularly if you
            * are using the BoostASIOEventLoop).
+             * @param threadCount The number of io_services to create, each run by
+             * its own thread. 0 creates one per processor core. This is ignored if
+             * \p ioService is provided.
              */
-            BoostIOServiceThread(std::shared_ptr<boost::asio::io_service> ioService = std::shared_ptr<boost::asio::io_service>());
+            BoostIOServiceThread(std::shared_ptr<boost::asio::io_service> ioService = std::shared_ptr<boost::asio::io_service>(), size_t threadCount = 1);
             ~BoostIOServiceThread();
 
+            /**
+             * Returns the first io_service, for work that is not tied to a connection.
+             */
             std::shared_ptr<boost::asio::io_service> getIOService() const {
-                return ioService_;
+                return ioServices_.front();
+            }
+
+            /**
+             * Returns all io_services. Connections can be spread over these;
+             * since each io_service is run by one thread, the handlers of a
+             * connection never run concurrently.
+             */
+            const IOServiceList& getIOServices() const {
+                return ioServices_;
             }
 
         private:
-            void doRun();
+            void doRun(std::shared_ptr<boost::asio::io_service> ioService);
 
         private:
-            std::shared_ptr<boost::asio::io_service> ioService_;
-            std::thread* thread_;
+            IOServiceList ioServices_;
+            std::vector<std::thread*> threads_;
     };
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -13,6 +13,7 @@
 #include <Swiften/Network/BoostConnectionFactory.h>
 #include <Swiften/Network/BoostConnectionServerFactory.h>
 #include <Swiften/Network/BoostTimerFactory.h>
+#include <Swiften/Network/CachingDomainNameResolver.h>
 #include <Swiften/Network/NullNATTraverser.h>
 #include <Swiften/Network/PlatformNATTraversalWorker.h>
 #include <Swiften/Network/PlatformNetworkEnvironment.h>
@@ -28,10 +29,10 @@
 
 namespace Swift {
 
-BoostNetworkFactories::BoostNetworkFactories(EventLoop* eventLoop, std::shared_ptr<boost::asio::io_service> ioService) : ioServiceThread(ioService), eventLoop(eventLoop) {
+BoostNetworkFactories::BoostNetworkFactories(EventLoop* eventLoop, std::shared_ptr<boost::asio::io_service> ioService, size_t ioThreadCount) : ioServiceThread(ioService, ioThreadCount), eventLoop(eventLoop) {
     timerFactory = new BoostTimerFactory(ioServiceThread.getIOService(), eventLoop);
-    connectionFactory = new BoostConnectionFactory(ioServiceThread.getIOService(), eventLoop);
-    connectionServerFactory = new BoostConnectionServerFactory(ioServiceThread.getIOService(), eventLoop);
+    connectionFactory = new BoostConnectionFactory(ioServiceThread.getIOServices(), eventLoop);
+    connectionServerFactory = new BoostConnectionServerFactory(ioServiceThread.getIOServices(), eventLoop);
 #ifdef SWIFT_EXPERIMENTAL_FT
     natTraverser = new PlatformNATTraversalWorker(eventLoop);
 #else
@@ -44,16 +45,19 @@ BoostNetworkFactories::BoostNetworkFactories(EventLoop* eventLoop, std::shared_p
     idnConverter = PlatformIDNConverter::create();
 #ifdef USE_UNBOUND
     // TODO: What to do about idnConverter.
-    domainNameResolver = new UnboundDomainNameResolver(idnConverter, ioServiceThread.getIOService(), eventLoop);
+    platformDomainNameResolver = new UnboundDomainNameResolver(idnConverter, ioServiceThread.getIOService(), eventLoop);
 #else
-    domainNameResolver = new PlatformDomainNameResolver(idnConverter, eventLoop);
+    platformDomainNameResolver = new PlatformDomainNameResolver(idnConverter, eventLoop);
 #endif
+    // Reconnects and proxy lookups resolve the same names over and over
+    domainNameResolver = new CachingDomainNameResolver(platformDomainNameResolver, eventLoop, timerFactory);
     cryptoProvider = PlatformCryptoProvider::create();
 }
 
 BoostNetworkFactories::~BoostNetworkFactories() {
     delete cryptoProvider;
     delete domainNameResolver;
+    delete platformDomainNameResolver;
     delete idnConverter;
     delete proxyProvider;
     delete tlsFactories;
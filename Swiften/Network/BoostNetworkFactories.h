@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2017 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -21,8 +21,11 @@ namespace Swift {
              * Construct the network factories, using the provided EventLoop.
              * @param ioService If this optional parameter is provided, it will be
              * used for the construction of the BoostIOServiceThread.
+             * @param ioThreadCount The number of network threads to spread the
+             * connections over, 0 meaning one per processor core. Only used if no
+             * \p ioService is provided.
              */
-            BoostNetworkFactories(EventLoop* eventLoop, std::shared_ptr<boost::asio::io_service> ioService = std::shared_ptr<boost::asio::io_service>());
+            BoostNetworkFactories(EventLoop* eventLoop, std::shared_ptr<boost::asio::io_service> ioService = std::shared_ptr<boost::asio::io_service>(), size_t ioThreadCount = 1);
             virtual ~BoostNetworkFactories() override;
 
             virtual TimerFactory* getTimerFactory() const override {
@@ -79,6 +82,7 @@ namespace Swift {
             BoostIOServiceThread ioServiceThread;
             TimerFactory* timerFactory;
             ConnectionFactory* connectionFactory;
+            DomainNameResolver* platformDomainNameResolver;
             DomainNameResolver* domainNameResolver;
             ConnectionServerFactory* connectionServerFactory;
             NATTraverser* natTraverser;
@@ -1,30 +1,383 @@
 /*
- * Copyright (c) 2012-2016 Isode Limited.
+ * Copyright (c) 2012-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <Swiften/Network/CachingDomainNameResolver.h>
 
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <list>
 #include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <boost/bind.hpp>
+#include <boost/optional.hpp>
+
+#include <Swiften/Base/StdRandomGenerator.h>
+#include <Swiften/EventLoop/EventLoop.h>
+#include <Swiften/EventLoop/EventOwner.h>
+#include <Swiften/Network/Timer.h>
+#include <Swiften/Network/TimerFactory.h>
+
+namespace {
+    class CachingDomainNameResolverEventOwner : public Swift::EventOwner {
+    };
+}
 
 namespace Swift {
 
-CachingDomainNameResolver::CachingDomainNameResolver(DomainNameResolver* realResolver, EventLoop*) : realResolver(realResolver) {
+struct CachingDomainNameResolver::ServiceLookup {
+    typedef DomainNameServiceQuery Query;
+    typedef std::vector<DomainNameServiceQuery::Result> Result;
+
+    static boost::signals2::connection connect(Query& query, const std::function<void (const Result&)>& handler) {
+        return query.onResult.connect(handler);
+    }
+
+    static void emit(Query& query, Result result, RandomGenerator& generator) {
+        // Shuffle records of the same priority again, so that cached results
+        // still spread the load by weight.
+        DomainNameServiceQuery::sortResults(result, generator);
+        query.onResult(result);
+    }
+
+    static bool isNegative(const Result& result) {
+        return result.empty();
+    }
+
+    static int getTTL(const Result& result) {
+        int ttl = -1;
+        for (const auto& record : result) {
+            if (record.ttl >= 0 && (ttl < 0 || record.ttl < ttl)) {
+                ttl = record.ttl;
+            }
+        }
+        return ttl;
+    }
+};
+
+struct CachingDomainNameResolver::AddressLookup {
+    typedef DomainNameAddressQuery Query;
+
+    struct Result {
+        std::vector<HostAddress> addresses;
+        boost::optional<DomainNameResolveError> error;
+    };
+
+    static boost::signals2::connection connect(Query& query, const std::function<void (const Result&)>& handler) {
+        return query.onResult.connect([handler](const std::vector<HostAddress>& addresses, boost::optional<DomainNameResolveError> error) {
+            Result result;
+            result.addresses = addresses;
+            result.error = error;
+            handler(result);
+        });
+    }
+
+    static void emit(Query& query, const Result& result, RandomGenerator&) {
+        query.onResult(result.addresses, result.error);
+    }
+
+    static bool isNegative(const Result& result) {
+        return result.error || result.addresses.empty();
+    }
+
+    static int getTTL(const Result&) {
+        // None of the resolvers report TTLs for addresses.
+        return -1;
+    }
+};
+
+template<typename Lookup>
+class CachingDomainNameResolver::Cache {
+    public:
+        typedef typename Lookup::Query Query;
+        typedef typename Lookup::Result Result;
+        typedef std::function<std::shared_ptr<Query> ()> LookupFactory;
+
+        Cache(CachingDomainNameResolver* resolver) : resolver(resolver) {
+        }
+
+        std::shared_ptr<Query> createQuery(const std::string& name, const LookupFactory& createLookup) {
+            return std::make_shared<CachedQuery>(this, name, createLookup);
+        }
+
+        /**
+         * Drops the results of the names matching \p matches, and returns
+         * the results that were dropped.
+         */
+        template<typename Predicate>
+        std::vector<Result> invalidate(Predicate matches) {
+            std::vector<Result> results;
+            typename EntryList::iterator entry = entries.begin();
+            while (entry != entries.end()) {
+                if (!matches(entry->name)) {
+                    ++entry;
+                    continue;
+                }
+                if (entry->result) {
+                    results.push_back(*entry->result);
+                }
+                if (entry->lookup) {
+                    // Keep the entry for the queries waiting on the lookup
+                    entry->stopTimer();
+                    entry->result.reset();
+                    entry->stale = false;
+                    ++entry;
+                }
+                else {
+                    index.erase(entry->name);
+                    entry = entries.erase(entry);
+                }
+            }
+            return results;
+        }
+
+    private:
+        class CachedQuery : public Query, public std::enable_shared_from_this<CachedQuery> {
+            public:
+                CachedQuery(Cache* cache, const std::string& name, const LookupFactory& createLookup) : cache(cache), name(name), createLookup(createLookup) {
+                }
+
+                virtual void run() {
+                    cache->run(this->shared_from_this());
+                }
+
+                void emitResult(const Result& result) {
+                    Lookup::emit(*this, result, cache->randomGenerator);
+                }
+
+                Cache* cache;
+                std::string name;
+                LookupFactory createLookup;
+        };
+
+        struct Entry {
+            Entry(const std::string& name) : name(name), stale(false) {
+            }
+
+            ~Entry() {
+                lookupConnection.disconnect();
+                stopTimer();
+            }
+
+            void stopTimer() {
+                if (timer) {
+                    timerConnection.disconnect();
+                    timer->stop();
+                    timer.reset();
+                }
+            }
+
+            std::string name;
+            boost::optional<Result> result;
+            bool stale;
+            std::shared_ptr<Query> lookup;
+            boost::signals2::connection lookupConnection;
+            std::vector<std::weak_ptr<CachedQuery> > waitingQueries;
+            std::shared_ptr<Timer> timer;
+            boost::signals2::connection timerConnection;
+        };
+
+        // Most recently used entries first
+        typedef std::list<Entry> EntryList;
+
+    private:
+        void run(std::shared_ptr<CachedQuery> query) {
+            typename EntryList::iterator entry = getEntry(query->name);
+            if (entry->result) {
+                resolver->eventLoop->postEvent(boost::bind(&CachedQuery::emitResult, query, *entry->result), resolver->owner);
+                if (entry->stale && !entry->lookup) {
+                    startLookup(entry, query->createLookup);
+                }
+            }
+            else {
+                entry->waitingQueries.push_back(query);
+                if (!entry->lookup) {
+                    startLookup(entry, query->createLookup);
+                }
+            }
+            removeLeastRecentlyUsed();
+        }
+
+        typename EntryList::iterator getEntry(const std::string& name) {
+            typename std::unordered_map<std::string, typename EntryList::iterator>::const_iterator i = index.find(name);
+            if (i != index.end()) {
+                entries.splice(entries.begin(), entries, i->second);
+                return i->second;
+            }
+            entries.emplace_front(name);
+            index[name] = entries.begin();
+            return entries.begin();
+        }
+
+        void removeLeastRecentlyUsed() {
+            // Entries with a lookup in progress have queries waiting on them,
+            // so they are kept even if the cache grows beyond its size.
+            typename EntryList::iterator entry = entries.end();
+            while (index.size() > resolver->maximumSize && entry != entries.begin()) {
+                --entry;
+                if (!entry->lookup) {
+                    index.erase(entry->name);
+                    entry = entries.erase(entry);
+                }
+            }
+        }
+
+        void startLookup(typename EntryList::iterator entry, const LookupFactory& createLookup) {
+            std::shared_ptr<Query> lookup = createLookup();
+            entry->lookup = lookup;
+            entry->lookupConnection = Lookup::connect(*lookup, boost::bind(&Cache::handleLookupResult, this, entry->name, _1));
+            lookup->run();
+        }
+
+        void handleLookupResult(const std::string& name, const Result& result) {
+            typename std::unordered_map<std::string, typename EntryList::iterator>::const_iterator i = index.find(name);
+            if (i == index.end()) {
+                return;
+            }
+            Entry& entry = *i->second;
+            entry.lookupConnection.disconnect();
+            entry.lookup.reset();
+
+            if (Lookup::isNegative(result) && entry.result && !Lookup::isNegative(*entry.result)) {
+                // The refresh of a stale result failed. Keep returning the
+                // stale result until it is dropped.
+            }
+            else {
+                entry.result = result;
+                entry.stale = false;
+                startTimer(entry, getTTL(result));
+            }
+
+            std::vector<std::weak_ptr<CachedQuery> > waitingQueries;
+            waitingQueries.swap(entry.waitingQueries);
+            Result entryResult = *entry.result;
+            for (const auto& waitingQuery : waitingQueries) {
+                if (std::shared_ptr<CachedQuery> query = waitingQuery.lock()) {
+                    query->emitResult(entryResult);
+                }
+            }
+        }
+
+        int getTTL(const Result& result) const {
+            if (Lookup::isNegative(result)) {
+                return resolver->negativeTTL;
+            }
+            int ttl = Lookup::getTTL(result);
+            return std::min(ttl < 0 ? resolver->defaultTTL : ttl, resolver->maximumTTL);
+        }
+
+        void startTimer(Entry& entry, int seconds) {
+            entry.stopTimer();
+            entry.timer = resolver->timerFactory->createTimer(std::min(std::max(seconds, 0), std::numeric_limits<int>::max() / 1000) * 1000);
+            entry.timerConnection = entry.timer->onTick.connect(boost::bind(&Cache::handleTimerTick, this, entry.name));
+            entry.timer->start();
+        }
+
+        void handleTimerTick(const std::string& name) {
+            typename std::unordered_map<std::string, typename EntryList::iterator>::iterator i = index.find(name);
+            if (i == index.end()) {
+                return;
+            }
+            Entry& entry = *i->second;
+            entry.stopTimer();
+            if (!entry.stale && resolver->staleTTL > 0 && !Lookup::isNegative(*entry.result)) {
+                entry.stale = true;
+                startTimer(entry, resolver->staleTTL);
+            }
+            else if (entry.lookup) {
+                // New queries wait for the lookup in progress
+                entry.result.reset();
+                entry.stale = false;
+            }
+            else {
+                typename EntryList::iterator entryIterator = i->second;
+                index.erase(i);
+                entries.erase(entryIterator);
+            }
+        }
+
+    private:
+        CachingDomainNameResolver* resolver;
+        StdRandomGenerator randomGenerator;
+        EntryList entries;
+        std::unordered_map<std::string, typename EntryList::iterator> index;
+};
+
+CachingDomainNameResolver::CachingDomainNameResolver(DomainNameResolver* realResolver, EventLoop* eventLoop, TimerFactory* timerFactory) : realResolver(realResolver), eventLoop(eventLoop), timerFactory(timerFactory), owner(std::make_shared<CachingDomainNameResolverEventOwner>()), maximumSize(256), defaultTTL(300), maximumTTL(3600), negativeTTL(30), staleTTL(60) {
+    serviceCache = std::unique_ptr<Cache<ServiceLookup> >(new Cache<ServiceLookup>(this));
+    addressCache = std::unique_ptr<Cache<AddressLookup> >(new Cache<AddressLookup>(this));
 }
 
 CachingDomainNameResolver::~CachingDomainNameResolver() {
-
+    eventLoop->removeEventsFromOwner(owner);
 }
 
 DomainNameServiceQuery::ref CachingDomainNameResolver::createServiceQuery(const std::string& serviceLookupPrefix, const std::string& domain) {
-    //TODO: Cache
-    return realResolver->createServiceQuery(serviceLookupPrefix, domain);
+    DomainNameResolver* resolver = realResolver;
+    return serviceCache->createQuery(serviceLookupPrefix + domain, [resolver, serviceLookupPrefix, domain]() {
+        return resolver->createServiceQuery(serviceLookupPrefix, domain);
+    });
 }
 
 DomainNameAddressQuery::ref CachingDomainNameResolver::createAddressQuery(const std::string& name) {
-    //TODO: Cache
-    return realResolver->createAddressQuery(name);
+    DomainNameResolver* resolver = realResolver;
+    return addressCache->createQuery(name, [resolver, name]() {
+        return resolver->createAddressQuery(name);
+    });
+}
+
+void CachingDomainNameResolver::setMaximumSize(size_t size) {
+    maximumSize = size;
+}
+
+void CachingDomainNameResolver::setDefaultTTL(int seconds) {
+    defaultTTL = seconds;
+}
+
+void CachingDomainNameResolver::setMaximumTTL(int seconds) {
+    maximumTTL = seconds;
+}
+
+void CachingDomainNameResolver::setNegativeTTL(int seconds) {
+    negativeTTL = seconds;
+}
+
+void CachingDomainNameResolver::setStaleTTL(int seconds) {
+    staleTTL = seconds;
+}
+
+void CachingDomainNameResolver::invalidate(const std::string& domain) {
+    // Service names are the domain with a prefix of '_' labels, e.g. "_xmpp-client._tcp."
+    std::vector<ServiceLookup::Result> services = serviceCache->invalidate([&domain](const std::string& name) {
+        if (name.size() <= domain.size() + 1 || name.compare(name.size() - domain.size(), domain.size(), domain) != 0) {
+            return false;
+        }
+        size_t prefixSize = name.size() - domain.size();
+        size_t labelStart = name.rfind('.', prefixSize - 2);
+        labelStart = labelStart == std::string::npos ? 0 : labelStart + 1;
+        return name[prefixSize - 1] == '.' && name[labelStart] == '_';
+    });
+    std::unordered_set<std::string> hosts;
+    hosts.insert(domain);
+    for (const auto& service : services) {
+        for (const auto& record : service) {
+            hosts.insert(record.hostname);
+        }
+    }
+    addressCache->invalidate([&hosts](const std::string& name) {
+        return hosts.count(name) > 0;
+    });
+}
+
+void CachingDomainNameResolver::clear() {
+    serviceCache->invalidate([](const std::string&) { return true; });
+    addressCache->invalidate([](const std::string&) { return true; });
 }
 
 }
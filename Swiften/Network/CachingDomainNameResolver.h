@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2012-2016 Isode Limited.
+ * Copyright (c) 2012-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -7,26 +7,96 @@
 #pragma once
 
 #include <memory>
+#include <string>
 
 #include <Swiften/Base/API.h>
+#include <Swiften/Network/DomainNameAddressQuery.h>
 #include <Swiften/Network/DomainNameResolver.h>
-#include <Swiften/Network/StaticDomainNameResolver.h>
+#include <Swiften/Network/DomainNameServiceQuery.h>
 
-/*
- * FIXME: Does not do any caching yet.
- */
 namespace Swift {
     class EventLoop;
+    class EventOwner;
+    class TimerFactory;
 
+    /**
+     * A DomainNameResolver that caches the results of another resolver.
+     *
+     * Results are kept for their DNS TTL, or for the default TTL if the
+     * resolver doesn't report one. Failed lookups are kept for the negative
+     * TTL. Once a result expires, it is still returned for the stale period,
+     * while a new lookup refreshes it in the background. Queries for a name
+     * that is already being looked up share that lookup.
+     *
+     * When the cache is full, the least recently used names are dropped.
+     */
     class SWIFTEN_API CachingDomainNameResolver : public DomainNameResolver {
         public:
-            CachingDomainNameResolver(DomainNameResolver* realResolver, EventLoop* eventLoop);
+            CachingDomainNameResolver(DomainNameResolver* realResolver, EventLoop* eventLoop, TimerFactory* timerFactory);
             ~CachingDomainNameResolver();
 
             virtual DomainNameServiceQuery::ref createServiceQuery(const std::string& serviceLookupPrefix, const std::string& domain);
             virtual DomainNameAddressQuery::ref createAddressQuery(const std::string& name);
 
+            /**
+             * Sets the maximum number of names kept for each type of query.
+             */
+            void setMaximumSize(size_t size);
+
+            /**
+             * Sets the time (in seconds) results are kept if the resolver
+             * doesn't report a TTL.
+             */
+            void setDefaultTTL(int seconds);
+
+            /**
+             * Sets the maximum time (in seconds) results are kept, regardless
+             * of their TTL.
+             */
+            void setMaximumTTL(int seconds);
+
+            /**
+             * Sets the time (in seconds) failed lookups are kept.
+             */
+            void setNegativeTTL(int seconds);
+
+            /**
+             * Sets the time (in seconds) expired results are still returned
+             * while they are being refreshed.
+             */
+            void setStaleTTL(int seconds);
+
+            /**
+             * Drops the cached results for \p domain: its service records,
+             * its addresses, and the addresses of the hosts its service
+             * records point to.
+             *
+             * CoreClient calls this when its connection fails, as the cached
+             * addresses may be stale after e.g. a network change.
+             */
+            void invalidate(const std::string& domain);
+
+            /**
+             * Drops all cached results.
+             */
+            void clear();
+
+        private:
+            template<typename Lookup> class Cache;
+            struct ServiceLookup;
+            struct AddressLookup;
+
         private:
             DomainNameResolver* realResolver;
+            EventLoop* eventLoop;
+            TimerFactory* timerFactory;
+            std::shared_ptr<EventOwner> owner;
+            size_t maximumSize;
+            int defaultTTL;
+            int maximumTTL;
+            int negativeTTL;
+            int staleTTL;
+            std::unique_ptr<Cache<ServiceLookup> > serviceCache;
+            std::unique_ptr<Cache<AddressLookup> > addressCache;
     };
 }
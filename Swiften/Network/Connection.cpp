@@ -1,11 +1,13 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <Swiften/Network/Connection.h>
 
+#include <cassert>
+
 using namespace Swift;
 
 Connection::Connection() {
@@ -13,3 +15,11 @@ Connection::Connection() {
 
 Connection::~Connection() {
 }
+
+bool Connection::canWriteFile() const {
+    return false;
+}
+
+void Connection::writeFile(const boost::filesystem::path&, unsigned long long, size_t) {
+    assert(false);
+}
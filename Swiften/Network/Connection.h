@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -8,6 +8,7 @@
 
 #include <memory>
 
+#include <boost/filesystem/path.hpp>
 #include <boost/signals2.hpp>
 
 #include <Swiften/Base/API.h>
@@ -33,6 +34,21 @@ namespace Swift {
             virtual void disconnect() = 0;
             virtual void write(const SafeByteArray& data) = 0;
 
+            /**
+             * Returns whether writeFile() is supported by this connection.
+             */
+            virtual bool canWriteFile() const;
+
+            /**
+             * Sends \p size bytes of \p file, starting at \p offset, directly
+             * from the file, without copying them through the caller.
+             *
+             * The data is sent in order with the data passed to write(), and
+             * onDataWritten is emitted when it has been sent.
+             * May only be called if canWriteFile() returns true.
+             */
+            virtual void writeFile(const boost::filesystem::path& file, unsigned long long offset, size_t size);
+
             virtual HostAddressPort getLocalAddress() const = 0;
             virtual HostAddressPort getRemoteAddress() const = 0;
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -24,11 +24,17 @@ namespace Swift {
             typedef std::shared_ptr<DomainNameServiceQuery> ref;
 
             struct Result {
-                Result(const std::string& hostname = "", int port = -1, int priority = -1, int weight = -1) : hostname(hostname), port(port), priority(priority), weight(weight) {}
+                Result(const std::string& hostname = "", int port = -1, int priority = -1, int weight = -1, int ttl = -1) : hostname(hostname), port(port), priority(priority), weight(weight), ttl(ttl) {}
                 std::string hostname;
                 int port;
                 int priority;
                 int weight;
+
+                /**
+                 * The time (in seconds) the record may be cached, or -1 if
+                 * the resolver doesn't know.
+                 */
+                int ttl;
             };
 
             virtual ~DomainNameServiceQuery();
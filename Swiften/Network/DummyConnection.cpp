@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -10,10 +10,23 @@
 #include <memory>
 
 #include <boost/bind.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/numeric/conversion/cast.hpp>
 
 namespace Swift {
 
-DummyConnection::DummyConnection(EventLoop* eventLoop) : eventLoop(eventLoop) {
+DummyConnection::DummyConnection(EventLoop* eventLoop) : eventLoop(eventLoop), fileWritesSupported(false), fileWrites(0) {
+}
+
+void DummyConnection::writeFile(const boost::filesystem::path& file, unsigned long long offset, size_t size) {
+    assert(fileWritesSupported);
+    fileWrites++;
+    boost::filesystem::ifstream stream(file, std::ios_base::in|std::ios_base::binary);
+    stream.seekg(boost::numeric_cast<std::streamoff>(offset));
+    SafeByteArray data(size);
+    stream.read(reinterpret_cast<char*>(vecptr(data)), boost::numeric_cast<std::streamsize>(size));
+    data.resize(boost::numeric_cast<size_t>(stream.gcount()));
+    write(data);
 }
 
 void DummyConnection::receive(const SafeByteArray& data) {
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -31,6 +31,15 @@ namespace Swift {
                 onDataSent(data);
             }
 
+            bool canWriteFile() const {
+                return fileWritesSupported;
+            }
+
+            /**
+             * Reads the data from the file, and writes it like write().
+             */
+            void writeFile(const boost::filesystem::path& file, unsigned long long offset, size_t size);
+
             void receive(const SafeByteArray& data);
 
             HostAddressPort getLocalAddress() const {
@@ -46,5 +55,7 @@ namespace Swift {
             EventLoop* eventLoop;
             HostAddressPort localAddress;
             HostAddressPort remoteAddress;
+            bool fileWritesSupported;
+            int fileWrites;
     };
 }
@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <Swiften/Network/HTTPResponseParser.h>
+
+#include <algorithm>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/optional.hpp>
+
+namespace Swift {
+
+namespace {
+    // Status and header lines longer than this are rejected, so a broken
+    // peer can't make the line buffer grow without bounds.
+    const size_t maximumLineSize = 64 * 1024;
+
+    bool parseSize(const std::string& s, int base, unsigned long long& size) {
+        if (s.empty()) {
+            return false;
+        }
+        size = 0;
+        for (char c : s) {
+            int digit;
+            if (c >= '0' && c <= '9') {
+                digit = c - '0';
+            }
+            else if (base == 16 && c >= 'a' && c <= 'f') {
+                digit = c - 'a' + 10;
+            }
+            else if (base == 16 && c >= 'A' && c <= 'F') {
+                digit = c - 'A' + 10;
+            }
+            else {
+                return false;
+            }
+            if (size > (~0ULL - static_cast<unsigned long long>(digit)) / static_cast<unsigned long long>(base)) {
+                return false;
+            }
+            size = size * static_cast<unsigned long long>(base) + static_cast<unsigned long long>(digit);
+        }
+        return true;
+    }
+}
+
+HTTPResponseParser::HTTPResponseParser() : state(StatusLine), statusCode(0), keepAlive(true), remainingSize(0) {
+}
+
+bool HTTPResponseParser::parse(const SafeByteArray& data) {
+    size_t position = 0;
+    while (position < data.size() && state != Error) {
+        switch (state) {
+            case StatusLine:
+                if (readLine(data, position) && !handleStatusLine()) {
+                    state = Error;
+                }
+                break;
+            case HeaderLine:
+                if (readLine(data, position) && !handleHeaderLine()) {
+                    state = Error;
+                }
+                break;
+            case Body:
+                emitBodyData(data, position, remainingSize);
+                if (remainingSize == 0) {
+                    finishResponse();
+                }
+                break;
+            case BodyUntilClose:
+                emitBodyData(data, position, data.size() - position);
+                break;
+            case ChunkSize:
+                if (readLine(data, position) && !handleChunkSize()) {
+                    state = Error;
+                }
+                break;
+            case ChunkData:
+                emitBodyData(data, position, remainingSize);
+                if (remainingSize == 0) {
+                    state = ChunkDataEnd;
+                }
+                break;
+            case ChunkDataEnd:
+                if (readLine(data, position)) {
+                    state = line.empty() ? ChunkSize : Error;
+                    line.clear();
+                }
+                break;
+            case Trailer:
+                if (readLine(data, position)) {
+                    if (line.empty()) {
+                        finishResponse();
+                    }
+                    line.clear();
+                }
+                break;
+            case Error:
+                break;
+        }
+    }
+    return state != Error;
+}
+
+bool HTTPResponseParser::finish() {
+    if (state == BodyUntilClose) {
+        finishResponse();
+    }
+    bool complete = !isInResponse();
+    state = StatusLine;
+    line.clear();
+    return complete;
+}
+
+bool HTTPResponseParser::isInResponse() const {
+    return state != Error && (state != StatusLine || !line.empty());
+}
+
+bool HTTPResponseParser::readLine(const SafeByteArray& data, size_t& position) {
+    SafeByteArray::const_iterator begin = data.begin() + static_cast<std::ptrdiff_t>(position);
+    SafeByteArray::const_iterator end = std::find(begin, data.end(), '\n');
+    if (end == data.end()) {
+        line.append(begin, end);
+        position = data.size();
+        if (line.size() > maximumLineSize) {
+            state = Error;
+        }
+        return false;
+    }
+    line.append(begin, end);
+    position += static_cast<size_t>(std::distance(begin, end)) + 1;
+    if (!line.empty() && line[line.size() - 1] == '\r') {
+        line.erase(line.size() - 1);
+    }
+    if (line.size() > maximumLineSize) {
+        state = Error;
+        return false;
+    }
+    return true;
+}
+
+bool HTTPResponseParser::handleStatusLine() {
+    // Servers may send empty lines between responses
+    if (line.empty()) {
+        return true;
+    }
+    // HTTP/1.1 200 OK
+    if (!boost::starts_with(line, "HTTP/1.") || line.size() < 12 || line[8] != ' ') {
+        return false;
+    }
+    unsigned long long code;
+    if (!parseSize(line.substr(9, 3), 10, code)) {
+        return false;
+    }
+    statusCode = static_cast<int>(code);
+    keepAlive = line[7] != '0';
+    headerFields.clear();
+    line.clear();
+    state = HeaderLine;
+    return true;
+}
+
+bool HTTPResponseParser::handleHeaderLine() {
+    if (line.empty()) {
+        return handleEndOfHeader();
+    }
+    std::string::size_type splitIndex = line.find(':');
+    if (splitIndex == std::string::npos) {
+        return false;
+    }
+    headerFields.push_back(std::make_pair(boost::trim_copy(line.substr(0, splitIndex)), boost::trim_copy(line.substr(splitIndex + 1))));
+    line.clear();
+    return true;
+}
+
+bool HTTPResponseParser::handleEndOfHeader() {
+    bool chunked = false;
+    boost::optional<unsigned long long> contentLength;
+    for (const auto& field : headerFields) {
+        if (boost::iequals(field.first, "Content-Length")) {
+            unsigned long long size;
+            if (!parseSize(field.second, 10, size) || (contentLength && *contentLength != size)) {
+                return false;
+            }
+            contentLength = size;
+        }
+        else if (boost::iequals(field.first, "Transfer-Encoding")) {
+            chunked = boost::iends_with(field.second, "chunked");
+        }
+        else if (boost::iequals(field.first, "Connection")) {
+            if (boost::icontains(field.second, "close")) {
+                keepAlive = false;
+            }
+            else if (boost::icontains(field.second, "keep-alive")) {
+                keepAlive = true;
+            }
+        }
+    }
+
+    // Informational responses are followed by the real response
+    if (statusCode >= 100 && statusCode < 200) {
+        line.clear();
+        state = StatusLine;
+        return true;
+    }
+
+    onResponseHeader(statusCode, headerFields);
+    if (statusCode == 204 || statusCode == 304 || (!chunked && contentLength && *contentLength == 0)) {
+        finishResponse();
+    }
+    else if (chunked) {
+        state = ChunkSize;
+    }
+    else if (contentLength) {
+        remainingSize = *contentLength;
+        state = Body;
+    }
+    else {
+        keepAlive = false;
+        state = BodyUntilClose;
+    }
+    return true;
+}
+
+bool HTTPResponseParser::handleChunkSize() {
+    // Ignore chunk extensions
+    std::string size = boost::trim_copy(line.substr(0, line.find(';')));
+    line.clear();
+    if (!parseSize(size, 16, remainingSize)) {
+        return false;
+    }
+    state = remainingSize == 0 ? Trailer : ChunkData;
+    return true;
+}
+
+void HTTPResponseParser::emitBodyData(const SafeByteArray& data, size_t& position, unsigned long long size) {
+    size_t available = data.size() - position;
+    size_t bodySize = size < available ? static_cast<size_t>(size) : available;
+    SafeByteArray::const_iterator begin = data.begin() + static_cast<std::ptrdiff_t>(position);
+    position += bodySize;
+    if (state != BodyUntilClose) {
+        remainingSize -= bodySize;
+    }
+    if (bodySize > 0) {
+        onBodyData(SafeByteArray(begin, begin + static_cast<std::ptrdiff_t>(bodySize)));
+    }
+}
+
+void HTTPResponseParser::finishResponse() {
+    line.clear();
+    state = StatusLine;
+    onResponseFinished(keepAlive);
+}
+
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/signals2.hpp>
+
+#include <Swiften/Base/API.h>
+#include <Swiften/Base/SafeByteArray.h>
+
+namespace Swift {
+    /**
+     * An incremental parser for the HTTP/1.1 responses read from a connection.
+     *
+     * Responses can be split over any number of parse() calls, and a single
+     * call can contain several (pipelined) responses. Body data is emitted
+     * as soon as it arrives, with any chunked transfer encoding removed.
+     */
+    class SWIFTEN_API HTTPResponseParser {
+        public:
+            typedef std::vector<std::pair<std::string, std::string> > HeaderFields;
+
+            HTTPResponseParser();
+
+            /**
+             * Parses the next part of the stream.
+             *
+             * @return false if the data isn't a valid HTTP response. All data
+             *         after an error is ignored.
+             */
+            bool parse(const SafeByteArray& data);
+
+            /**
+             * Signals that the connection was closed, which ends a response
+             * that has no length.
+             *
+             * @return false if a response was cut off.
+             */
+            bool finish();
+
+            /**
+             * Returns whether part of a response has been parsed.
+             */
+            bool isInResponse() const;
+
+        public:
+            /**
+             * Emitted when the header of a (non-informational) response is
+             * parsed.
+             */
+            boost::signals2::signal<void (int /* statusCode */, const HeaderFields&)> onResponseHeader;
+            boost::signals2::signal<void (const SafeByteArray&)> onBodyData;
+
+            /**
+             * Emitted at the end of a response. If keepAlive is false, the
+             * server will close the connection.
+             */
+            boost::signals2::signal<void (bool /* keepAlive */)> onResponseFinished;
+
+        private:
+            enum State {
+                StatusLine,
+                HeaderLine,
+                Body,
+                BodyUntilClose,
+                ChunkSize,
+                ChunkData,
+                ChunkDataEnd,
+                Trailer,
+                Error
+            };
+
+            bool readLine(const SafeByteArray& data, size_t& position);
+            bool handleStatusLine();
+            bool handleHeaderLine();
+            bool handleEndOfHeader();
+            bool handleChunkSize();
+            void emitBodyData(const SafeByteArray& data, size_t& position, unsigned long long size);
+            void finishResponse();
+
+        private:
+            State state;
+            std::string line;
+            int statusCode;
+            bool keepAlive;
+            HeaderFields headerFields;
+            unsigned long long remainingSize;
+    };
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -12,6 +12,8 @@
 
 #include <Swiften/Base/Platform.h>
 #include <stdlib.h>
+#include <algorithm>
+#include <limits>
 #include <boost/numeric/conversion/cast.hpp>
 #ifdef SWIFTEN_PLATFORM_WINDOWS
 #undef UNICODE
@@ -77,6 +79,7 @@ void PlatformDomainNameServiceQuery::runBlocking() {
             record.priority = currentEntry->Data.SRV.wPriority;
             record.weight = currentEntry->Data.SRV.wWeight;
             record.port = currentEntry->Data.SRV.wPort;
+            record.ttl = boost::numeric_cast<int>(currentEntry->dwTtl);
 
             // The pNameTarget is actually a PCWSTR, so I would have expected this
             // conversion to not work at all, but it does.
@@ -127,6 +130,13 @@ void PlatformDomainNameServiceQuery::runBlocking() {
 
         int entryLength = dn_skipname(currentEntry, messageEnd);
         currentEntry += entryLength;
+        if (entryLength < 0 || currentEntry + NS_RRFIXEDSZ >= messageEnd) {
+            emitError();
+            return;
+        }
+
+        // TTL (after the type and class)
+        record.ttl = boost::numeric_cast<int>(std::min<unsigned long>(ns_get32(currentEntry + 4), static_cast<unsigned long>(std::numeric_limits<int>::max())));
         currentEntry += NS_RRFIXEDSZ;
 
         // Priority
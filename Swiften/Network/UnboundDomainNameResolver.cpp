@@ -5,17 +5,20 @@
  */
 
 /*
- * Copyright (c) 2016 Isode Limited.
+ * Copyright (c) 2016-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <Swiften/Network/UnboundDomainNameResolver.h>
 
+#include <algorithm>
+#include <limits>
 #include <memory>
 #include <vector>
 
 #include <boost/bind.hpp>
+#include <boost/numeric/conversion/cast.hpp>
 
 #include <arpa/inet.h>
 #include <ldns/ldns.h>
@@ -92,6 +95,7 @@ class UnboundDomainNameServiceQuery : public DomainNameServiceQuery, public Unbo
                             serviceRecord.priority = ldns_rdf2native_int16(ldns_rr_rdf(rr, 0));
                             serviceRecord.weight = ldns_rdf2native_int16(ldns_rr_rdf(rr, 1));
                             serviceRecord.port = ldns_rdf2native_int16(ldns_rr_rdf(rr, 2));
+                            serviceRecord.ttl = boost::numeric_cast<int>(std::min<uint32_t>(ldns_rr_ttl(rr), static_cast<uint32_t>(std::numeric_limits<int>::max())));
 
                             ldns_buffer_rewind(buffer);
                             if ((ldns_rdf2buffer_str_dname(buffer, ldns_rr_rdf(rr, 3)) != LDNS_STATUS_OK) ||
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2011-2016 Isode Limited.
+ * Copyright (c) 2011-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -41,6 +41,7 @@ class BOSHConnectionPoolTest : public CppUnit::TestFixture {
     CPPUNIT_TEST(testConnectionCount_ThreeWritesTwoReads);
     CPPUNIT_TEST(testSession);
     CPPUNIT_TEST(testWrite_Empty);
+    CPPUNIT_TEST(testWrite_Pipelined);
     CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -318,11 +319,47 @@ class BOSHConnectionPoolTest : public CppUnit::TestFixture {
 
         }
 
+        void testWrite_Pipelined() {
+            PoolRef testling = createTestling();
+            testling->setPipeliningEnabled(true);
+            std::shared_ptr<MockConnection> c0 = connectionFactory->connections[0];
+            readResponse(initial, c0);
+            testling->restartStream();
+            eventLoop->processEvents();
+            readResponse("<body/>", c0);
+            eventLoop->processEvents();
+            CPPUNIT_ASSERT_EQUAL(st(3), boshDataWritten.size()); /* Empty request held by the server */
+
+            testling->write(createSafeByteArray("<blah/>"));
+            CPPUNIT_ASSERT_EQUAL(st(3), boshDataWritten.size()); /* Opens a second connection instead of pipelining */
+
+            testling->write(createSafeByteArray("<bleh/>"));
+            CPPUNIT_ASSERT_EQUAL(st(4), boshDataWritten.size()); /* Pipelined after the held request while the second connection is connecting */
+            CPPUNIT_ASSERT_EQUAL(std::string("<body rid='" + boost::lexical_cast<std::string>(initialRID + 3) + "' sid='" + sid + "' xmlns='http://jabber.org/protocol/httpbind'><blah/><bleh/></body>"), lastBody());
+
+            testling->write(createSafeByteArray("<blub/>"));
+            eventLoop->processEvents();
+            CPPUNIT_ASSERT_EQUAL(st(4), boshDataWritten.size()); /* The server allows only 2 requests */
+            CPPUNIT_ASSERT_EQUAL(st(2), connectionFactory->connections.size());
+
+            std::string body1 = "<body xmlns='http://jabber.org/protocol/httpbind'><message/></body>";
+            std::string body2 = "<body xmlns='http://jabber.org/protocol/httpbind'/>";
+            c0->onDataRead(std::make_shared<SafeByteArray>(createSafeByteArray(
+                "HTTP/1.1 200 OK\r\n"
+                "Content-Length: " + boost::lexical_cast<std::string>(body1.size()) + "\r\n\r\n" + body1 +
+                "HTTP/1.1 200 OK\r\n"
+                "Content-Length: " + boost::lexical_cast<std::string>(body2.size()) + "\r\n\r\n" + body2)));
+            eventLoop->processEvents();
+            CPPUNIT_ASSERT_EQUAL(std::string("<message/>"), xmppDataRead[xmppDataRead.size() - 2]);
+            CPPUNIT_ASSERT_EQUAL(std::string("<body rid='" + boost::lexical_cast<std::string>(initialRID + 4) + "' sid='" + sid + "' xmlns='http://jabber.org/protocol/httpbind'><blub/></body>"), boshDataWritten[4].substr(boshDataWritten[4].find("\r\n\r\n") + 4));
+            CPPUNIT_ASSERT_EQUAL(st(2), connectionFactory->connections.size());
+        }
+
     private:
 
         PoolRef createTestling() {
             // make_shared is limited to 9 arguments; instead new is used here.
-            PoolRef pool = PoolRef(new BOSHConnectionPool(boshURL, resolver, connectionFactory, &parserFactory, static_cast<TLSContextFactory*>(nullptr), timerFactory, eventLoop, to, initialRID, URL(), SafeString(""), SafeString(""), TLSOptions()));
+            PoolRef pool = PoolRef(new BOSHConnectionPool(boshURL, resolver, connectionFactory, &parserFactory, static_cast<TLSContextFactory*>(nullptr), timerFactory, to, initialRID, URL(), SafeString(""), SafeString(""), TLSOptions()));
             pool->open();
             pool->onXMPPDataRead.connect(boost::bind(&BOSHConnectionPoolTest::handleXMPPDataRead, this, _1));
             pool->onBOSHDataRead.connect(boost::bind(&BOSHConnectionPoolTest::handleBOSHDataRead, this, _1));
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2011-2017 Isode Limited.
+ * Copyright (c) 2011-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -38,6 +38,10 @@ class BOSHConnectionTest : public CppUnit::TestFixture {
     CPPUNIT_TEST(testWrite_Receive);
     CPPUNIT_TEST(testWrite_ReceiveTwice);
     CPPUNIT_TEST(testRead_Fragment);
+    CPPUNIT_TEST(testRead_Chunked);
+    CPPUNIT_TEST(testRead_ConnectionClose);
+    CPPUNIT_TEST(testRead_HTTPError);
+    CPPUNIT_TEST(testWrite_Pipelined);
     CPPUNIT_TEST(testHTTPRequest);
     CPPUNIT_TEST(testHTTPRequest_Empty);
     CPPUNIT_TEST(testTerminate);
@@ -56,6 +60,7 @@ class BOSHConnectionTest : public CppUnit::TestFixture {
             disconnectedError = false;
             sessionTerminatedError.reset();
             dataRead.clear();
+            httpError.clear();
         }
 
         void tearDown() {
@@ -174,6 +179,82 @@ class BOSHConnectionTest : public CppUnit::TestFixture {
             CPPUNIT_ASSERT_EQUAL(std::string("<blah/>"), byteArrayToString(dataRead));
         }
 
+        void testRead_Chunked() {
+            BOSHConnection::ref testling = createTestling();
+            testling->connect();
+            eventLoop->processEvents();
+            testling->setSID("mySID");
+            testling->write(createSafeByteArray("<mypayload/>"));
+            std::shared_ptr<MockConnection> connection = connectionFactory->connections[0];
+            connection->onDataRead(std::make_shared<SafeByteArray>(createSafeByteArray(
+                "HTTP/1.1 200 OK\r\n"
+                "Transfer-Encoding: chunked\r\n"
+                "\r\n"
+                "35\r\n"
+                "<body xmlns='http://jabber.org/protocol/httpbind'><bl\r\n")));
+            connection->onDataRead(std::make_shared<SafeByteArray>(createSafeByteArray(
+                "b\r\n"
+                "ah/></body>\r\n"
+                "0\r\n"
+                "\r\n")));
+            CPPUNIT_ASSERT_EQUAL(std::string("<blah/>"), byteArrayToString(dataRead));
+            CPPUNIT_ASSERT(testling->isReadyToSend());
+        }
+
+        void testRead_ConnectionClose() {
+            BOSHConnection::ref testling = createTestling();
+            testling->connect();
+            eventLoop->processEvents();
+            testling->setSID("mySID");
+            testling->write(createSafeByteArray("<mypayload/>"));
+            std::string body = "<body xmlns='http://jabber.org/protocol/httpbind'><blah/></body>";
+            connectionFactory->connections[0]->onDataRead(std::make_shared<SafeByteArray>(createSafeByteArray(
+                "HTTP/1.1 200 OK\r\n"
+                "Connection: close\r\n"
+                "Content-Length: " + boost::lexical_cast<std::string>(body.size()) + "\r\n"
+                "\r\n" + body)));
+            CPPUNIT_ASSERT_EQUAL(std::string("<blah/>"), byteArrayToString(dataRead));
+            CPPUNIT_ASSERT(connectionFactory->connections[0]->disconnected);
+            CPPUNIT_ASSERT(!testling->isReadyToSend());
+        }
+
+        void testRead_HTTPError() {
+            BOSHConnection::ref testling = createTestling();
+            testling->connect();
+            eventLoop->processEvents();
+            testling->setSID("mySID");
+            testling->write(createSafeByteArray("<mypayload/>"));
+            connectionFactory->connections[0]->onDataRead(std::make_shared<SafeByteArray>(createSafeByteArray(
+                "HTTP/1.1 404 Not Found\r\n"
+                "Content-Length: 9\r\n"
+                "\r\n"
+                "Not Found")));
+            CPPUNIT_ASSERT_EQUAL(std::string("404"), httpError);
+            CPPUNIT_ASSERT(dataRead.empty());
+        }
+
+        void testWrite_Pipelined() {
+            BOSHConnection::ref testling = createTestling();
+            testling->connect();
+            eventLoop->processEvents();
+            testling->setSID("mySID");
+            CPPUNIT_ASSERT(!testling->canPipelineRequest()); /* Not known to be persistent yet */
+            testling->write(createSafeByteArray("<mypayload/>"));
+            readResponse("<body/>", connectionFactory->connections[0]);
+            CPPUNIT_ASSERT(testling->canPipelineRequest());
+
+            testling->write(createSafeByteArray("<mypayload1/>"));
+            testling->write(createSafeByteArray("<mypayload2/>"));
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), testling->getPendingRequestCount());
+            CPPUNIT_ASSERT(!testling->isReadyToSend());
+            CPPUNIT_ASSERT(testling->canPipelineRequest());
+
+            readResponses(std::vector<std::string>({"<body><a/></body>", "<body><b/></body>"}), connectionFactory->connections[0]);
+            CPPUNIT_ASSERT_EQUAL(std::string("<a/><b/>"), byteArrayToString(dataRead));
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), testling->getPendingRequestCount());
+            CPPUNIT_ASSERT(testling->isReadyToSend());
+        }
+
         void testHTTPRequest() {
             std::string data = "<blah/>";
             std::string sid = "wigglebloom";
@@ -237,6 +318,7 @@ class BOSHConnectionTest : public CppUnit::TestFixture {
             c->onXMPPDataRead.connect(boost::bind(&BOSHConnectionTest::handleDataRead, this, _1));
             c->onSessionStarted.connect(boost::bind(&BOSHConnectionTest::handleSID, this, _1));
             c->onSessionTerminated.connect(boost::bind(&BOSHConnectionTest::handleSessionTerminated, this, _1));
+            c->onHTTPError.connect(boost::bind(&BOSHConnectionTest::handleHTTPError, this, _1));
             c->setRID(42);
             return c;
         }
@@ -263,6 +345,10 @@ class BOSHConnectionTest : public CppUnit::TestFixture {
             sessionTerminatedError = error;
         }
 
+        void handleHTTPError(const std::string& e) {
+            httpError = e;
+        }
+
         struct MockConnection : public Connection {
             public:
                 MockConnection(const std::vector<HostAddressPort>& failingPorts, EventLoop* eventLoop) : eventLoop(eventLoop), failingPorts(failingPorts), disconnected(false) {
@@ -326,6 +412,16 @@ class BOSHConnectionTest : public CppUnit::TestFixture {
             connection->onDataRead(data4);
         }
 
+        void readResponses(const std::vector<std::string>& responses, std::shared_ptr<MockConnection> connection) {
+            std::string data;
+            for (const auto& response : responses) {
+                data += "HTTP/1.1 200 OK\r\n"
+                        "Content-Length: " + boost::lexical_cast<std::string>(response.size()) + "\r\n"
+                        "\r\n" + response;
+            }
+            connection->onDataRead(std::make_shared<SafeByteArray>(createSafeByteArray(data)));
+        }
+
 
     private:
         DummyEventLoop* eventLoop;
@@ -341,6 +437,7 @@ class BOSHConnectionTest : public CppUnit::TestFixture {
         TimerFactory* timerFactory;
         TLSContextFactory* tlsContextFactory;
         std::string sid;
+        std::string httpError;
 
 };
 
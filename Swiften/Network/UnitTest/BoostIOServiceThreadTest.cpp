@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include <boost/version.hpp>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+
+#include <Swiften/Base/sleep.h>
+#include <Swiften/EventLoop/DummyEventLoop.h>
+#include <Swiften/Network/BoostConnection.h>
+#include <Swiften/Network/BoostConnectionFactory.h>
+#include <Swiften/Network/BoostIOServiceThread.h>
+
+using namespace Swift;
+
+class BoostIOServiceThreadTest : public CppUnit::TestFixture {
+        CPPUNIT_TEST_SUITE(BoostIOServiceThreadTest);
+        CPPUNIT_TEST(testConstructor);
+        CPPUNIT_TEST(testConstructor_ThreadCount);
+        CPPUNIT_TEST(testConstructor_ThreadPerCore);
+        CPPUNIT_TEST(testConstructor_IOService);
+        CPPUNIT_TEST(testIOServicesRunOnOwnThreads);
+        CPPUNIT_TEST(testCreateConnection_RoundRobin);
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+        void testConstructor() {
+            BoostIOServiceThread testling;
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), testling.getIOServices().size());
+            CPPUNIT_ASSERT(testling.getIOService() == testling.getIOServices()[0]);
+        }
+
+        void testConstructor_ThreadCount() {
+            BoostIOServiceThread testling(std::shared_ptr<boost::asio::io_service>(), 3);
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), testling.getIOServices().size());
+            std::set<boost::asio::io_service*> ioServices;
+            for (const auto& ioService : testling.getIOServices()) {
+                ioServices.insert(ioService.get());
+            }
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), ioServices.size());
+        }
+
+        void testConstructor_ThreadPerCore() {
+            BoostIOServiceThread testling(std::shared_ptr<boost::asio::io_service>(), 0);
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(std::max(1U, std::thread::hardware_concurrency())), testling.getIOServices().size());
+        }
+
+        void testConstructor_IOService() {
+            auto ioService = std::make_shared<boost::asio::io_service>();
+            BoostIOServiceThread testling(ioService, 3);
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), testling.getIOServices().size());
+            CPPUNIT_ASSERT(ioService == testling.getIOService());
+        }
+
+        void testIOServicesRunOnOwnThreads() {
+            BoostIOServiceThread testling(std::shared_ptr<boost::asio::io_service>(), 3);
+
+            std::mutex mutex;
+            std::set<std::thread::id> threads;
+            for (const auto& ioService : testling.getIOServices()) {
+                ioService->post([&]() {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    threads.insert(std::this_thread::get_id());
+                });
+            }
+            for (int i = 0; i < 500; ++i) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (threads.size() == 3) {
+                        break;
+                    }
+                }
+                Swift::sleep(10);
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), threads.size());
+            CPPUNIT_ASSERT(!threads.count(std::this_thread::get_id()));
+        }
+
+        void testCreateConnection_RoundRobin() {
+            DummyEventLoop eventLoop;
+            BoostIOServiceThread ioServiceThread(std::shared_ptr<boost::asio::io_service>(), 3);
+            BoostConnectionFactory testling(ioServiceThread.getIOServices(), &eventLoop);
+
+            for (size_t i = 0; i < 6; ++i) {
+                BoostConnection::ref connection = std::dynamic_pointer_cast<BoostConnection>(testling.createConnection());
+                CPPUNIT_ASSERT(getIOService(connection) == ioServiceThread.getIOServices()[i % 3].get());
+            }
+        }
+
+    private:
+        static boost::asio::io_service* getIOService(BoostConnection::ref connection) {
+#if BOOST_VERSION >= 107000
+            return &static_cast<boost::asio::io_service&>(connection->getSocket().get_executor().context());
+#else
+            return &connection->getSocket().get_io_service();
+#endif
+        }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(BoostIOServiceThreadTest);
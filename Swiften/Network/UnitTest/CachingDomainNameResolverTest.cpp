@@ -0,0 +1,361 @@
+/*
+ * Copyright (c) 2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/bind.hpp>
+#include <boost/optional.hpp>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+
+#include <Swiften/EventLoop/DummyEventLoop.h>
+#include <Swiften/Network/CachingDomainNameResolver.h>
+#include <Swiften/Network/DomainNameAddressQuery.h>
+#include <Swiften/Network/DomainNameServiceQuery.h>
+#include <Swiften/Network/DummyTimerFactory.h>
+#include <Swiften/Network/HostAddress.h>
+
+using namespace Swift;
+
+class CachingDomainNameResolverTest : public CppUnit::TestFixture {
+        CPPUNIT_TEST_SUITE(CachingDomainNameResolverTest);
+        CPPUNIT_TEST(testServiceQuery);
+        CPPUNIT_TEST(testServiceQuery_ResultIsCached);
+        CPPUNIT_TEST(testServiceQuery_ExpiresAfterTTL);
+        CPPUNIT_TEST(testServiceQuery_ExpiresAfterMaximumTTL);
+        CPPUNIT_TEST(testServiceQuery_StaleResultIsReturnedWhileRefreshing);
+        CPPUNIT_TEST(testServiceQuery_StaleResultIsKeptIfRefreshFails);
+        CPPUNIT_TEST(testAddressQuery_ConcurrentQueriesShareLookup);
+        CPPUNIT_TEST(testAddressQuery_ExpiresAfterDefaultTTL);
+        CPPUNIT_TEST(testAddressQuery_NegativeResultIsCached);
+        CPPUNIT_TEST(testAddressQuery_NegativeResultExpires);
+        CPPUNIT_TEST(testAddressQuery_DeletedQueryIsNotNotified);
+        CPPUNIT_TEST(testMaximumSize_LeastRecentlyUsedNameIsDropped);
+        CPPUNIT_TEST(testClear);
+        CPPUNIT_TEST(testInvalidate);
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+        void setUp() {
+            eventLoop = std::make_shared<DummyEventLoop>();
+            timerFactory = std::make_shared<DummyTimerFactory>();
+            resolver = std::make_shared<MockResolver>();
+            testling = std::make_shared<CachingDomainNameResolver>(resolver.get(), eventLoop.get(), timerFactory.get());
+            testling->setDefaultTTL(100);
+            testling->setMaximumTTL(1000);
+            testling->setNegativeTTL(10);
+            testling->setStaleTTL(0);
+            serviceResults.clear();
+            addressResults.clear();
+            addressErrors = 0;
+            time = 0;
+        }
+
+        void tearDown() {
+            eventLoop->processEvents();
+            testling.reset();
+            resolver.reset();
+            timerFactory.reset();
+            eventLoop.reset();
+        }
+
+        void testServiceQuery() {
+            runServiceQuery();
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), resolver->serviceQueries.size());
+            CPPUNIT_ASSERT_EQUAL(std::string("_xmpp-client._tcp.foo.com"), resolver->serviceQueries[0]->service);
+
+            resolver->serviceQueries[0]->onResult(createServiceResults("host1", 60));
+            eventLoop->processEvents();
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), serviceResults.size());
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), serviceResults[0].size());
+            CPPUNIT_ASSERT_EQUAL(std::string("host1"), serviceResults[0][0].hostname);
+        }
+
+        void testServiceQuery_ResultIsCached() {
+            runServiceQuery();
+            resolver->serviceQueries[0]->onResult(createServiceResults("host1", 60));
+
+            runServiceQuery();
+            eventLoop->processEvents();
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), resolver->serviceQueries.size());
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), serviceResults.size());
+            CPPUNIT_ASSERT_EQUAL(std::string("host1"), serviceResults[1][0].hostname);
+            CPPUNIT_ASSERT_EQUAL(5222, serviceResults[1][0].port);
+        }
+
+        void testServiceQuery_ExpiresAfterTTL() {
+            runServiceQuery();
+            resolver->serviceQueries[0]->onResult(createServiceResults("host1", 60));
+
+            advanceTime(59);
+            runServiceQuery();
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), resolver->serviceQueries.size());
+
+            advanceTime(2);
+            runServiceQuery();
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), resolver->serviceQueries.size());
+        }
+
+        void testServiceQuery_ExpiresAfterMaximumTTL() {
+            runServiceQuery();
+            resolver->serviceQueries[0]->onResult(createServiceResults("host1", 86400));
+
+            advanceTime(1001);
+            runServiceQuery();
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), resolver->serviceQueries.size());
+        }
+
+        void testServiceQuery_StaleResultIsReturnedWhileRefreshing() {
+            testling->setStaleTTL(30);
+            runServiceQuery();
+            resolver->serviceQueries[0]->onResult(createServiceResults("host1", 60));
+
+            advanceTime(61);
+            runServiceQuery();
+            eventLoop->processEvents();
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), serviceResults.size());
+            CPPUNIT_ASSERT_EQUAL(std::string("host1"), serviceResults[1][0].hostname);
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), resolver->serviceQueries.size());
+
+            // Only one refresh is started
+            runServiceQuery();
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), resolver->serviceQueries.size());
+
+            resolver->serviceQueries[1]->onResult(createServiceResults("host2", 60));
+            runServiceQuery();
+            eventLoop->processEvents();
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), serviceResults.size());
+            CPPUNIT_ASSERT_EQUAL(std::string("host2"), serviceResults[3][0].hostname);
+        }
+
+        void testServiceQuery_StaleResultIsKeptIfRefreshFails() {
+            testling->setStaleTTL(30);
+            runServiceQuery();
+            resolver->serviceQueries[0]->onResult(createServiceResults("host1", 60));
+
+            advanceTime(61);
+            runServiceQuery();
+            resolver->serviceQueries[1]->onResult(std::vector<DomainNameServiceQuery::Result>());
+            runServiceQuery();
+            eventLoop->processEvents();
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), serviceResults.size());
+            CPPUNIT_ASSERT_EQUAL(std::string("host1"), serviceResults[2][0].hostname);
+
+            // Stale results are dropped at the end of the stale period
+            advanceTime(30);
+            runServiceQuery();
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), resolver->serviceQueries.size());
+            eventLoop->processEvents();
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), serviceResults.size());
+        }
+
+        void testAddressQuery_ConcurrentQueriesShareLookup() {
+            runAddressQuery("foo.com");
+            runAddressQuery("foo.com");
+            runAddressQuery("bar.com");
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), resolver->addressQueries.size());
+
+            resolver->addressQueries[0]->onResult(createAddresses("1.2.3.4"), boost::optional<DomainNameResolveError>());
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), addressResults.size());
+            CPPUNIT_ASSERT_EQUAL(std::string("1.2.3.4"), addressResults[0][0].toString());
+            CPPUNIT_ASSERT_EQUAL(std::string("1.2.3.4"), addressResults[1][0].toString());
+        }
+
+        void testAddressQuery_ExpiresAfterDefaultTTL() {
+            runAddressQuery("foo.com");
+            resolver->addressQueries[0]->onResult(createAddresses("1.2.3.4"), boost::optional<DomainNameResolveError>());
+
+            advanceTime(99);
+            runAddressQuery("foo.com");
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), resolver->addressQueries.size());
+
+            advanceTime(2);
+            runAddressQuery("foo.com");
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), resolver->addressQueries.size());
+        }
+
+        void testAddressQuery_NegativeResultIsCached() {
+            runAddressQuery("foo.com");
+            resolver->addressQueries[0]->onResult(std::vector<HostAddress>(), boost::optional<DomainNameResolveError>(DomainNameResolveError()));
+
+            runAddressQuery("foo.com");
+            eventLoop->processEvents();
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), resolver->addressQueries.size());
+            CPPUNIT_ASSERT_EQUAL(2, addressErrors);
+        }
+
+        void testAddressQuery_NegativeResultExpires() {
+            runAddressQuery("foo.com");
+            resolver->addressQueries[0]->onResult(std::vector<HostAddress>(), boost::optional<DomainNameResolveError>(DomainNameResolveError()));
+
+            advanceTime(11);
+            runAddressQuery("foo.com");
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), resolver->addressQueries.size());
+        }
+
+        void testAddressQuery_DeletedQueryIsNotNotified() {
+            {
+                DomainNameAddressQuery::ref query = testling->createAddressQuery("foo.com");
+                query->onResult.connect(boost::bind(&CachingDomainNameResolverTest::handleAddressResult, this, _1, _2));
+                query->run();
+            }
+            runAddressQuery("foo.com");
+
+            resolver->addressQueries[0]->onResult(createAddresses("1.2.3.4"), boost::optional<DomainNameResolveError>());
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), addressResults.size());
+        }
+
+        void testMaximumSize_LeastRecentlyUsedNameIsDropped() {
+            testling->setMaximumSize(2);
+            runAddressQuery("foo.com");
+            resolver->addressQueries[0]->onResult(createAddresses("1.1.1.1"), boost::optional<DomainNameResolveError>());
+            runAddressQuery("bar.com");
+            resolver->addressQueries[1]->onResult(createAddresses("2.2.2.2"), boost::optional<DomainNameResolveError>());
+            runAddressQuery("foo.com");
+            runAddressQuery("baz.com");
+            resolver->addressQueries[2]->onResult(createAddresses("3.3.3.3"), boost::optional<DomainNameResolveError>());
+
+            runAddressQuery("foo.com");
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), resolver->addressQueries.size());
+            runAddressQuery("bar.com");
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), resolver->addressQueries.size());
+        }
+
+        void testClear() {
+            runAddressQuery("foo.com");
+            resolver->addressQueries[0]->onResult(createAddresses("1.2.3.4"), boost::optional<DomainNameResolveError>());
+
+            testling->clear();
+            runAddressQuery("foo.com");
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), resolver->addressQueries.size());
+        }
+
+        void testInvalidate() {
+            runServiceQuery();
+            resolver->serviceQueries[0]->onResult(createServiceResults("host1", 60));
+            runAddressQuery("host1");
+            resolver->addressQueries[0]->onResult(createAddresses("1.2.3.4"), boost::optional<DomainNameResolveError>());
+            runAddressQuery("foo.com");
+            resolver->addressQueries[1]->onResult(createAddresses("1.2.3.5"), boost::optional<DomainNameResolveError>());
+            runAddressQuery("bar.com");
+            resolver->addressQueries[2]->onResult(createAddresses("1.2.3.6"), boost::optional<DomainNameResolveError>());
+
+            testling->invalidate("foo.com");
+            runServiceQuery();
+            runAddressQuery("host1");
+            runAddressQuery("foo.com");
+            runAddressQuery("bar.com");
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), resolver->serviceQueries.size());
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), resolver->addressQueries.size());
+            CPPUNIT_ASSERT_EQUAL(std::string("host1"), resolver->addressQueries[3]->name);
+            CPPUNIT_ASSERT_EQUAL(std::string("foo.com"), resolver->addressQueries[4]->name);
+        }
+
+    private:
+        struct MockServiceQuery : public DomainNameServiceQuery {
+            MockServiceQuery(const std::string& service) : service(service) {}
+            virtual void run() {}
+            std::string service;
+        };
+
+        struct MockAddressQuery : public DomainNameAddressQuery {
+            MockAddressQuery(const std::string& name) : name(name) {}
+            virtual void run() {}
+            std::string name;
+        };
+
+        struct MockResolver : public DomainNameResolver {
+            virtual DomainNameServiceQuery::ref createServiceQuery(const std::string& serviceLookupPrefix, const std::string& domain) {
+                serviceQueries.push_back(std::make_shared<MockServiceQuery>(serviceLookupPrefix + domain));
+                return serviceQueries.back();
+            }
+
+            virtual DomainNameAddressQuery::ref createAddressQuery(const std::string& name) {
+                addressQueries.push_back(std::make_shared<MockAddressQuery>(name));
+                return addressQueries.back();
+            }
+
+            std::vector<std::shared_ptr<MockServiceQuery> > serviceQueries;
+            std::vector<std::shared_ptr<MockAddressQuery> > addressQueries;
+        };
+
+        void runServiceQuery() {
+            DomainNameServiceQuery::ref query = testling->createServiceQuery("_xmpp-client._tcp.", "foo.com");
+            query->onResult.connect(boost::bind(&CachingDomainNameResolverTest::handleServiceResult, this, _1));
+            query->run();
+            queries.push_back(query);
+        }
+
+        void runAddressQuery(const std::string& name) {
+            DomainNameAddressQuery::ref query = testling->createAddressQuery(name);
+            query->onResult.connect(boost::bind(&CachingDomainNameResolverTest::handleAddressResult, this, _1, _2));
+            query->run();
+            queries.push_back(query);
+        }
+
+        void handleServiceResult(const std::vector<DomainNameServiceQuery::Result>& result) {
+            serviceResults.push_back(result);
+        }
+
+        void handleAddressResult(const std::vector<HostAddress>& result, boost::optional<DomainNameResolveError> error) {
+            if (error) {
+                ++addressErrors;
+            }
+            else {
+                addressResults.push_back(result);
+            }
+        }
+
+        void advanceTime(int seconds) {
+            // Timers started from a tick measure from the previous time, so
+            // move on in small steps.
+            for (int i = 0; i < seconds; ++i) {
+                time += 1000;
+                timerFactory->setTime(time);
+            }
+            eventLoop->processEvents();
+        }
+
+        static std::vector<DomainNameServiceQuery::Result> createServiceResults(const std::string& hostname, int ttl) {
+            std::vector<DomainNameServiceQuery::Result> results;
+            results.push_back(DomainNameServiceQuery::Result(hostname, 5222, 0, 0, ttl));
+            results.push_back(DomainNameServiceQuery::Result("backup-" + hostname, 5222, 10, 0, ttl + 100));
+            return results;
+        }
+
+        static std::vector<HostAddress> createAddresses(const std::string& address) {
+            return std::vector<HostAddress>(1, HostAddress::fromString(address).get());
+        }
+
+    private:
+        std::shared_ptr<DummyEventLoop> eventLoop;
+        std::shared_ptr<DummyTimerFactory> timerFactory;
+        std::shared_ptr<MockResolver> resolver;
+        std::shared_ptr<CachingDomainNameResolver> testling;
+        std::vector<std::shared_ptr<void> > queries;
+        std::vector<std::vector<DomainNameServiceQuery::Result> > serviceResults;
+        std::vector<std::vector<HostAddress> > addressResults;
+        int addressErrors;
+        int time;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(CachingDomainNameResolverTest);
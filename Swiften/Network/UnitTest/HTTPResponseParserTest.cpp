@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <string>
+#include <vector>
+
+#include <boost/bind.hpp>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+
+#include <Swiften/Base/Algorithm.h>
+#include <Swiften/Network/HTTPResponseParser.h>
+
+using namespace Swift;
+
+class HTTPResponseParserTest : public CppUnit::TestFixture {
+        CPPUNIT_TEST_SUITE(HTTPResponseParserTest);
+        CPPUNIT_TEST(testParse_ContentLength);
+        CPPUNIT_TEST(testParse_ContentLengthByteByByte);
+        CPPUNIT_TEST(testParse_Chunked);
+        CPPUNIT_TEST(testParse_ChunkedByteByByte);
+        CPPUNIT_TEST(testParse_PipelinedResponses);
+        CPPUNIT_TEST(testParse_InformationalResponse);
+        CPPUNIT_TEST(testParse_NoContent);
+        CPPUNIT_TEST(testParse_ConnectionClose);
+        CPPUNIT_TEST(testParse_HTTP10);
+        CPPUNIT_TEST(testParse_BodyUntilClose);
+        CPPUNIT_TEST(testParse_InvalidStatusLine);
+        CPPUNIT_TEST(testParse_InvalidChunkSize);
+        CPPUNIT_TEST(testParse_LineTooLong);
+        CPPUNIT_TEST(testFinish_IncompleteResponse);
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+        void setUp() {
+            testling = new HTTPResponseParser();
+            testling->onResponseHeader.connect(boost::bind(&HTTPResponseParserTest::handleResponseHeader, this, _1, _2));
+            testling->onBodyData.connect(boost::bind(&HTTPResponseParserTest::handleBodyData, this, _1));
+            testling->onResponseFinished.connect(boost::bind(&HTTPResponseParserTest::handleResponseFinished, this, _1));
+        }
+
+        void tearDown() {
+            delete testling;
+        }
+
+        void testParse_ContentLength() {
+            CPPUNIT_ASSERT(parse(
+                "HTTP/1.1 200 OK\r\n"
+                "Content-Type: text/xml; charset=utf-8\r\n"
+                "Content-Length: 17\r\n"
+                "\r\n"
+                "<body><a/></body>"));
+
+            CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(statusCodes.size()));
+            CPPUNIT_ASSERT_EQUAL(200, statusCodes[0]);
+            CPPUNIT_ASSERT_EQUAL(2, static_cast<int>(headerFields.size()));
+            CPPUNIT_ASSERT_EQUAL(std::string("Content-Type"), headerFields[0].first);
+            CPPUNIT_ASSERT_EQUAL(std::string("text/xml; charset=utf-8"), headerFields[0].second);
+            CPPUNIT_ASSERT_EQUAL(std::string("<body><a/></body>"), body);
+            CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(finishedResponses.size()));
+            CPPUNIT_ASSERT(finishedResponses[0]);
+            CPPUNIT_ASSERT(!testling->isInResponse());
+        }
+
+        void testParse_ContentLengthByteByByte() {
+            std::string response =
+                "HTTP/1.1 200 OK\r\n"
+                "Content-Length: 17\r\n"
+                "\r\n"
+                "<body><a/></body>";
+            for (char c : response) {
+                CPPUNIT_ASSERT(parse(std::string(1, c)));
+            }
+
+            CPPUNIT_ASSERT_EQUAL(std::string("<body><a/></body>"), body);
+            CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(finishedResponses.size()));
+            CPPUNIT_ASSERT(!testling->isInResponse());
+        }
+
+        void testParse_Chunked() {
+            CPPUNIT_ASSERT(parse(
+                "HTTP/1.1 200 OK\r\n"
+                "Transfer-Encoding: chunked\r\n"
+                "\r\n"
+                "6\r\n"
+                "<body>\r\n"
+                "b;name=value\r\n"
+                "<a/></body>\r\n"
+                "0\r\n"
+                "Trailer: foo\r\n"
+                "\r\n"));
+
+            CPPUNIT_ASSERT_EQUAL(std::string("<body><a/></body>"), body);
+            CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(finishedResponses.size()));
+            CPPUNIT_ASSERT(!testling->isInResponse());
+        }
+
+        void testParse_ChunkedByteByByte() {
+            std::string response =
+                "HTTP/1.1 200 OK\r\n"
+                "Transfer-Encoding: chunked\r\n"
+                "\r\n"
+                "A\r\n"
+                "<body><a/>\r\n"
+                "7\r\n"
+                "</body>\r\n"
+                "0\r\n"
+                "\r\n";
+            for (char c : response) {
+                CPPUNIT_ASSERT(parse(std::string(1, c)));
+            }
+
+            CPPUNIT_ASSERT_EQUAL(std::string("<body><a/></body>"), body);
+            CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(finishedResponses.size()));
+        }
+
+        void testParse_PipelinedResponses() {
+            CPPUNIT_ASSERT(parse(
+                "HTTP/1.1 200 OK\r\n"
+                "Content-Length: 3\r\n"
+                "\r\n"
+                "foo"
+                "HTTP/1.1 404 Not Found\r\n"
+                "Transfer-Encoding: chunked\r\n"
+                "\r\n"
+                "3\r\nbar\r\n0\r\n\r\n"
+                "HTTP/1.1 200 OK\r\n"
+                "Content-Length: 3\r\n"
+                "\r\n"
+                "ba"));
+
+            CPPUNIT_ASSERT_EQUAL(3, static_cast<int>(statusCodes.size()));
+            CPPUNIT_ASSERT_EQUAL(404, statusCodes[1]);
+            CPPUNIT_ASSERT_EQUAL(2, static_cast<int>(finishedResponses.size()));
+            CPPUNIT_ASSERT_EQUAL(std::string("foobarba"), body);
+            CPPUNIT_ASSERT(testling->isInResponse());
+
+            CPPUNIT_ASSERT(parse("z"));
+
+            CPPUNIT_ASSERT_EQUAL(3, static_cast<int>(finishedResponses.size()));
+            CPPUNIT_ASSERT_EQUAL(std::string("foobarbaz"), body);
+        }
+
+        void testParse_InformationalResponse() {
+            CPPUNIT_ASSERT(parse(
+                "HTTP/1.1 100 Continue\r\n"
+                "\r\n"
+                "HTTP/1.1 200 OK\r\n"
+                "Content-Length: 3\r\n"
+                "\r\n"
+                "foo"));
+
+            CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(statusCodes.size()));
+            CPPUNIT_ASSERT_EQUAL(200, statusCodes[0]);
+            CPPUNIT_ASSERT_EQUAL(std::string("foo"), body);
+        }
+
+        void testParse_NoContent() {
+            CPPUNIT_ASSERT(parse(
+                "HTTP/1.1 204 No Content\r\n"
+                "\r\n"));
+
+            CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(finishedResponses.size()));
+            CPPUNIT_ASSERT(body.empty());
+        }
+
+        void testParse_ConnectionClose() {
+            CPPUNIT_ASSERT(parse(
+                "HTTP/1.1 200 OK\r\n"
+                "Connection: close\r\n"
+                "Content-Length: 3\r\n"
+                "\r\n"
+                "foo"));
+
+            CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(finishedResponses.size()));
+            CPPUNIT_ASSERT(!finishedResponses[0]);
+        }
+
+        void testParse_HTTP10() {
+            CPPUNIT_ASSERT(parse(
+                "HTTP/1.0 200 OK\r\n"
+                "Content-Length: 3\r\n"
+                "\r\n"
+                "foo"
+                "HTTP/1.0 200 OK\r\n"
+                "Connection: Keep-Alive\r\n"
+                "Content-Length: 3\r\n"
+                "\r\n"
+                "bar"));
+
+            CPPUNIT_ASSERT_EQUAL(2, static_cast<int>(finishedResponses.size()));
+            CPPUNIT_ASSERT(!finishedResponses[0]);
+            CPPUNIT_ASSERT(finishedResponses[1]);
+        }
+
+        void testParse_BodyUntilClose() {
+            CPPUNIT_ASSERT(parse(
+                "HTTP/1.1 200 OK\r\n"
+                "\r\n"
+                "foo"));
+            CPPUNIT_ASSERT(parse("bar"));
+            CPPUNIT_ASSERT(finishedResponses.empty());
+
+            CPPUNIT_ASSERT(testling->finish());
+
+            CPPUNIT_ASSERT_EQUAL(std::string("foobar"), body);
+            CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(finishedResponses.size()));
+            CPPUNIT_ASSERT(!finishedResponses[0]);
+        }
+
+        void testParse_InvalidStatusLine() {
+            CPPUNIT_ASSERT(!parse("<body/>\r\n"));
+            CPPUNIT_ASSERT(!parse("HTTP/1.1 200 OK\r\n"));
+            CPPUNIT_ASSERT(statusCodes.empty());
+        }
+
+        void testParse_InvalidChunkSize() {
+            CPPUNIT_ASSERT(!parse(
+                "HTTP/1.1 200 OK\r\n"
+                "Transfer-Encoding: chunked\r\n"
+                "\r\n"
+                "foo\r\n"));
+        }
+
+        void testParse_LineTooLong() {
+            CPPUNIT_ASSERT(parse("HTTP/1.1 200 OK\r\n"));
+            CPPUNIT_ASSERT(!parse("X-Foo: " + std::string(65 * 1024, 'a')));
+        }
+
+        void testFinish_IncompleteResponse() {
+            CPPUNIT_ASSERT(parse(
+                "HTTP/1.1 200 OK\r\n"
+                "Content-Length: 6\r\n"
+                "\r\n"
+                "foo"));
+
+            CPPUNIT_ASSERT(!testling->finish());
+            CPPUNIT_ASSERT(finishedResponses.empty());
+            CPPUNIT_ASSERT(!testling->isInResponse());
+        }
+
+    private:
+        bool parse(const std::string& data) {
+            return testling->parse(createSafeByteArray(data));
+        }
+
+        void handleResponseHeader(int statusCode, const HTTPResponseParser::HeaderFields& fields) {
+            statusCodes.push_back(statusCode);
+            headerFields = fields;
+        }
+
+        void handleBodyData(const SafeByteArray& data) {
+            body += safeByteArrayToString(data);
+        }
+
+        void handleResponseFinished(bool keepAlive) {
+            finishedResponses.push_back(keepAlive);
+        }
+
+    private:
+        HTTPResponseParser* testling;
+        std::vector<int> statusCodes;
+        HTTPResponseParser::HeaderFields headerFields;
+        std::string body;
+        std::vector<bool> finishedResponses;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(HTTPResponseParserTest);
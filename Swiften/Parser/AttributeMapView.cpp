@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <Swiften/Parser/AttributeMapView.h>
+
+using namespace Swift;
+
+AttributeMapView::AttributeMapView() {
+}
+
+AttributeMapView::AttributeMapView(const AttributeMap& attributes) {
+    this->attributes.reserve(attributes.getEntries().size());
+    for (const auto& entry : attributes.getEntries()) {
+        addAttribute(entry.getAttribute().getName(), entry.getAttribute().getNamespace(), entry.getValue());
+    }
+}
+
+const AttributeMapView::Entry* AttributeMapView::findEntry(const StringView& attribute, const StringView& ns) const {
+    for (const auto& entry : attributes) {
+        if (entry.getName() == attribute && entry.getNamespace() == ns) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+StringView AttributeMapView::getAttribute(const StringView& attribute, const StringView& ns) const {
+    const Entry* entry = findEntry(attribute, ns);
+    return entry ? entry->getValue() : StringView();
+}
+
+bool AttributeMapView::getBoolAttribute(const StringView& attribute, bool defaultValue) const {
+    const Entry* entry = findEntry(attribute, StringView());
+    if (!entry) {
+        return defaultValue;
+    }
+    return entry->getValue() == "true" || entry->getValue() == "1";
+}
+
+boost::optional<StringView> AttributeMapView::getAttributeValue(const StringView& attribute) const {
+    const Entry* entry = findEntry(attribute, StringView());
+    if (!entry) {
+        return boost::optional<StringView>();
+    }
+    return entry->getValue();
+}
+
+void AttributeMapView::addAttribute(const StringView& name, const StringView& ns, const StringView& value) {
+    attributes.push_back(Entry(name, ns, value));
+}
+
+AttributeMap AttributeMapView::toAttributeMap() const {
+    AttributeMap result;
+    for (const auto& entry : attributes) {
+        result.addAttribute(entry.getName().toString(), entry.getNamespace().toString(), entry.getValue().toString());
+    }
+    return result;
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <boost/optional/optional.hpp>
+
+#include <Swiften/Base/API.h>
+#include <Swiften/Base/StringView.h>
+#include <Swiften/Parser/AttributeMap.h>
+
+namespace Swift {
+    /**
+     * An attribute map that borrows the storage of its names, namespaces
+     * and values.
+     *
+     * The XML parsers keep one instance around and clear it for every
+     * element, so that reporting attributes does not allocate once the
+     * entry vector has grown to its working size.
+     */
+    class SWIFTEN_API AttributeMapView {
+        public:
+            class Entry {
+                public:
+                    Entry(const StringView& name, const StringView& ns, const StringView& value) : name(name), ns(ns), value(value) {
+                    }
+
+                    const StringView& getName() const {
+                        return name;
+                    }
+
+                    const StringView& getNamespace() const {
+                        return ns;
+                    }
+
+                    const StringView& getValue() const {
+                        return value;
+                    }
+
+                private:
+                    StringView name;
+                    StringView ns;
+                    StringView value;
+            };
+
+            AttributeMapView();
+
+            /**
+             * Creates a view on the entries of an owning attribute map.
+             * The map has to outlive the view.
+             */
+            explicit AttributeMapView(const AttributeMap& attributes);
+
+            StringView getAttribute(const StringView& attribute, const StringView& ns = StringView()) const;
+            bool getBoolAttribute(const StringView& attribute, bool defaultValue = false) const;
+            boost::optional<StringView> getAttributeValue(const StringView&) const;
+
+            void addAttribute(const StringView& name, const StringView& ns, const StringView& value);
+
+            void clear() {
+                attributes.clear();
+            }
+
+            const std::vector<Entry>& getEntries() const {
+                return attributes;
+            }
+
+            /**
+             * Copies the attributes into an owning AttributeMap.
+             */
+            AttributeMap toAttributeMap() const;
+
+        private:
+            const Entry* findEntry(const StringView& attribute, const StringView& ns) const;
+
+        private:
+            std::vector<Entry> attributes;
+    };
+}
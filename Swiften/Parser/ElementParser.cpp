@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -11,4 +11,16 @@ namespace Swift {
 ElementParser::~ElementParser() {
 }
 
+void ElementParser::handleStartElementView(const StringView& element, const StringView& ns, const AttributeMapView& attributes) {
+    handleStartElement(element.toString(), ns.toString(), attributes.toAttributeMap());
+}
+
+void ElementParser::handleEndElementView(const StringView& element, const StringView& ns) {
+    handleEndElement(element.toString(), ns.toString());
+}
+
+void ElementParser::handleCharacterDataView(const StringView& data) {
+    handleCharacterData(data.toString());
+}
+
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -10,8 +10,10 @@
 #include <string>
 
 #include <Swiften/Base/API.h>
+#include <Swiften/Base/StringView.h>
 #include <Swiften/Elements/ToplevelElement.h>
 #include <Swiften/Parser/AttributeMap.h>
+#include <Swiften/Parser/AttributeMapView.h>
 
 namespace Swift {
     class SWIFTEN_API ElementParser {
@@ -22,6 +24,15 @@ namespace Swift {
             virtual void handleEndElement(const std::string& element, const std::string& ns) = 0;
             virtual void handleCharacterData(const std::string& data) = 0;
 
+            /**
+             * Zero-copy variants of the callbacks above, called by XMPPParser.
+             * The default implementations copy the data and forward it to
+             * the std::string based callbacks.
+             */
+            virtual void handleStartElementView(const StringView& element, const StringView& ns, const AttributeMapView& attributes);
+            virtual void handleEndElementView(const StringView& element, const StringView& ns);
+            virtual void handleCharacterDataView(const StringView& data);
+
             virtual std::shared_ptr<ToplevelElement> getElement() const = 0;
     };
 }
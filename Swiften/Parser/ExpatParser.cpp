@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -7,6 +7,7 @@
 #include <Swiften/Parser/ExpatParser.h>
 
 #include <cassert>
+#include <cstring>
 #include <memory>
 #include <string>
 
@@ -14,7 +15,8 @@
 
 #include <boost/numeric/conversion/cast.hpp>
 
-#include <Swiften/Base/String.h>
+#include <Swiften/Base/StringView.h>
+#include <Swiften/Parser/AttributeMapView.h>
 #include <Swiften/Parser/XMLParserClient.h>
 
 #pragma clang diagnostic ignored "-Wdisabled-macro-expansion"
@@ -25,41 +27,52 @@ static const char NAMESPACE_SEPARATOR = '\x01';
 
 struct ExpatParser::Private {
     XML_Parser parser_;
+    AttributeMapView attributes_;
 };
 
-static void handleStartElement(void* parser, const XML_Char* name, const XML_Char** attributes) {
-    std::pair<std::string,std::string> nsTagPair = String::getSplittedAtFirst(name, NAMESPACE_SEPARATOR);
-    if (nsTagPair.second == "") {
-        nsTagPair.second = nsTagPair.first;
-        nsTagPair.first = "";
+// Splits an expat "namespace<separator>name" string into its parts, without copying.
+static void splitQualifiedName(const XML_Char* qualifiedName, StringView& name, StringView& ns) {
+    const char* separator = std::strchr(qualifiedName, NAMESPACE_SEPARATOR);
+    if (separator) {
+        ns = StringView(qualifiedName, static_cast<size_t>(separator - qualifiedName));
+        name = StringView(separator + 1);
     }
-    AttributeMap attributeValues;
+    else {
+        ns = StringView();
+        name = StringView(qualifiedName);
+    }
+}
+
+static void handleStartElement(void* data, const XML_Char* name, const XML_Char** attributes) {
+    ExpatParser* parser = static_cast<ExpatParser*>(data);
+    StringView tag;
+    StringView ns;
+    splitQualifiedName(name, tag, ns);
+
+    AttributeMapView& attributeValues = parser->getAttributeBuffer();
+    attributeValues.clear();
     const XML_Char** currentAttribute = attributes;
     while (*currentAttribute) {
-        std::pair<std::string,std::string> nsAttributePair = String::getSplittedAtFirst(*currentAttribute, NAMESPACE_SEPARATOR);
-        if (nsAttributePair.second == "") {
-            nsAttributePair.second = nsAttributePair.first;
-            nsAttributePair.first = "";
-        }
-        attributeValues.addAttribute(nsAttributePair.second, nsAttributePair.first, std::string(*(currentAttribute+1)));
+        StringView attributeName;
+        StringView attributeNS;
+        splitQualifiedName(*currentAttribute, attributeName, attributeNS);
+        attributeValues.addAttribute(attributeName, attributeNS, StringView(*(currentAttribute+1)));
         currentAttribute += 2;
     }
 
-    static_cast<XMLParser*>(parser)->getClient()->handleStartElement(nsTagPair.second, nsTagPair.first, attributeValues);
+    parser->getClient()->handleStartElementView(tag, ns, attributeValues);
 }
 
 static void handleEndElement(void* parser, const XML_Char* name) {
-    std::pair<std::string,std::string> nsTagPair = String::getSplittedAtFirst(name, NAMESPACE_SEPARATOR);
-    if (nsTagPair.second == "") {
-        nsTagPair.second = nsTagPair.first;
-        nsTagPair.first = "";
-    }
-    static_cast<XMLParser*>(parser)->getClient()->handleEndElement(nsTagPair.second, nsTagPair.first);
+    StringView tag;
+    StringView ns;
+    splitQualifiedName(name, tag, ns);
+    static_cast<XMLParser*>(parser)->getClient()->handleEndElementView(tag, ns);
 }
 
 static void handleCharacterData(void* parser, const XML_Char* data, int len) {
     assert(len >= 0);
-    static_cast<XMLParser*>(parser)->getClient()->handleCharacterData(std::string(data, static_cast<size_t>(len)));
+    static_cast<XMLParser*>(parser)->getClient()->handleCharacterDataView(StringView(data, static_cast<size_t>(len)));
 }
 
 static void handleXMLDeclaration(void*, const XML_Char*, const XML_Char*, int) {
@@ -83,14 +96,20 @@ ExpatParser::~ExpatParser() {
     XML_ParserFree(p->parser_);
 }
 
-bool ExpatParser::parse(const std::string& data) {
-    bool success = XML_Parse(p->parser_, data.c_str(), boost::numeric_cast<int>(data.size()), false) == XML_STATUS_OK;
+bool ExpatParser::parse(const unsigned char* data, size_t size) {
+    // XML_Parse tokenizes straight from the caller's buffer, and only copies
+    // the trailing incomplete token into expat's own buffer.
+    bool success = XML_Parse(p->parser_, reinterpret_cast<const char*>(data), boost::numeric_cast<int>(size), false) == XML_STATUS_OK;
     /*if (!success) {
         std::cout << "ERROR: " << XML_ErrorString(XML_GetErrorCode(p->parser_)) << " while parsing " << data << std::endl;
     }*/
     return success;
 }
 
+AttributeMapView& ExpatParser::getAttributeBuffer() {
+    return p->attributes_;
+}
+
 void ExpatParser::stopParser() {
     XML_StopParser(p->parser_, static_cast<XML_Bool>(0));
 }
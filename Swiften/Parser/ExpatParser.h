@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -14,15 +14,24 @@
 #include <Swiften/Parser/XMLParser.h>
 
 namespace Swift {
+    class AttributeMapView;
+
     class SWIFTEN_API ExpatParser : public XMLParser, public boost::noncopyable {
         public:
             ExpatParser(XMLParserClient* client);
             ~ExpatParser();
 
-            bool parse(const std::string& data);
+            using XMLParser::parse;
+            bool parse(const unsigned char* data, size_t size);
 
             void stopParser();
 
+            /**
+             * The attribute storage that is reused for every start element.
+             * For use by the expat callbacks only.
+             */
+            AttributeMapView& getAttributeBuffer();
+
         private:
             struct Private;
             const std::unique_ptr<Private> p;
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -28,6 +28,10 @@ namespace Swift {
                 return (tag_.empty() ? true : element == tag_) && (xmlns_.empty() ? true : xmlns_ == ns);
             }
 
+            virtual boost::optional<DispatchKey> getDispatchKey() const {
+                return DispatchKey(tag_, xmlns_);
+            }
+
             virtual PayloadParser* createPayloadParser() {
                 return new PARSER_TYPE();
             }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -16,6 +16,8 @@
 #include <libxml/parser.h>
 
 #include <Swiften/Base/Log.h>
+#include <Swiften/Base/StringView.h>
+#include <Swiften/Parser/AttributeMapView.h>
 #include <Swiften/Parser/XMLParserClient.h>
 
 namespace Swift {
@@ -23,34 +25,37 @@ namespace Swift {
 struct LibXMLParser::Private {
     xmlSAXHandler handler_;
     xmlParserCtxtPtr context_;
+    AttributeMapView attributes_;
 };
 
-static void handleStartElement(void* parser, const xmlChar* name, const xmlChar*, const xmlChar* xmlns, int, const xmlChar**, int nbAttributes, int nbDefaulted, const xmlChar ** attributes) {
-    AttributeMap attributeValues;
+static StringView toStringView(const xmlChar* s) {
+    return s ? StringView(reinterpret_cast<const char*>(s)) : StringView();
+}
+
+static void handleStartElement(void* data, const xmlChar* name, const xmlChar*, const xmlChar* xmlns, int, const xmlChar**, int nbAttributes, int nbDefaulted, const xmlChar ** attributes) {
+    LibXMLParser* parser = static_cast<LibXMLParser*>(data);
+    AttributeMapView& attributeValues = parser->getAttributeBuffer();
+    attributeValues.clear();
     if (nbDefaulted != 0) {
         // Just because i don't understand what this means yet :-)
         SWIFT_LOG(error) << "Unexpected nbDefaulted on XML element" << std::endl;
     }
     for (int i = 0; i < nbAttributes*5; i += 5) {
-        std::string attributeNS = "";
-        if (attributes[i+2]) {
-            attributeNS = std::string(reinterpret_cast<const char*>(attributes[i+2]));
-        }
         attributeValues.addAttribute(
-                std::string(reinterpret_cast<const char*>(attributes[i])),
-                attributeNS,
-                std::string(reinterpret_cast<const char*>(attributes[i+3]),
+                toStringView(attributes[i]),
+                toStringView(attributes[i+2]),
+                StringView(reinterpret_cast<const char*>(attributes[i+3]),
                     boost::numeric_cast<size_t>(attributes[i+4]-attributes[i+3])));
     }
-    static_cast<XMLParser*>(parser)->getClient()->handleStartElement(reinterpret_cast<const char*>(name), (xmlns ? reinterpret_cast<const char*>(xmlns) : std::string()), attributeValues);
+    parser->getClient()->handleStartElementView(toStringView(name), toStringView(xmlns), attributeValues);
 }
 
 static void handleEndElement(void *parser, const xmlChar* name, const xmlChar*, const xmlChar* xmlns) {
-    static_cast<XMLParser*>(parser)->getClient()->handleEndElement(reinterpret_cast<const char*>(name), (xmlns ? reinterpret_cast<const char*>(xmlns) : std::string()));
+    static_cast<XMLParser*>(parser)->getClient()->handleEndElementView(toStringView(name), toStringView(xmlns));
 }
 
 static void handleCharacterData(void* parser, const xmlChar* data, int len) {
-    static_cast<XMLParser*>(parser)->getClient()->handleCharacterData(std::string(reinterpret_cast<const char*>(data), boost::numeric_cast<size_t>(len)));
+    static_cast<XMLParser*>(parser)->getClient()->handleCharacterDataView(StringView(reinterpret_cast<const char*>(data), boost::numeric_cast<size_t>(len)));
 }
 
 static void handleError(void*, const char* /*m*/, ... ) {
@@ -93,8 +98,12 @@ LibXMLParser::~LibXMLParser() {
     }
 }
 
-bool LibXMLParser::parse(const std::string& data) {
-    if (xmlParseChunk(p->context_, data.c_str(), boost::numeric_cast<int>(data.size()), false) == XML_ERR_OK) {
+AttributeMapView& LibXMLParser::getAttributeBuffer() {
+    return p->attributes_;
+}
+
+bool LibXMLParser::parse(const unsigned char* data, size_t size) {
+    if (xmlParseChunk(p->context_, reinterpret_cast<const char*>(data), boost::numeric_cast<int>(size), false) == XML_ERR_OK) {
         return true;
     }
     xmlError* error = xmlCtxtGetLastError(p->context_);
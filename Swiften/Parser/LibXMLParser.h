@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -13,6 +13,8 @@
 #include <Swiften/Parser/XMLParser.h>
 
 namespace Swift {
+    class AttributeMapView;
+
     /**
      * Warning: This constructor is not thread-safe, because it depends on global state to
      * check whether it is initialized.
@@ -22,7 +24,14 @@ namespace Swift {
             LibXMLParser(XMLParserClient* client);
             virtual ~LibXMLParser();
 
-            bool parse(const std::string& data);
+            using XMLParser::parse;
+            bool parse(const unsigned char* data, size_t size);
+
+            /**
+             * The attribute storage that is reused for every start element.
+             * For use by the libxml2 callbacks only.
+             */
+            AttributeMapView& getAttributeBuffer();
 
         private:
             static bool initialized;
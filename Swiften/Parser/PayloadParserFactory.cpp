@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -11,4 +11,8 @@ namespace Swift {
 PayloadParserFactory::~PayloadParserFactory() {
 }
 
+boost::optional<PayloadParserFactory::DispatchKey> PayloadParserFactory::getDispatchKey() const {
+    return boost::optional<DispatchKey>();
+}
+
 }
@@ -1,11 +1,16 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #pragma once
 
+#include <string>
+#include <utility>
+
+#include <boost/optional.hpp>
+
 #include <Swiften/Base/API.h>
 #include <Swiften/Parser/AttributeMap.h>
 
@@ -17,6 +22,12 @@ namespace Swift {
      * A factory for PayloadParsers.
      */
     class SWIFTEN_API PayloadParserFactory {
+        public:
+            /**
+             * A (top-level element, namespace) pair.
+             */
+            typedef std::pair<std::string, std::string> DispatchKey;
+
         public:
             virtual ~PayloadParserFactory();
 
@@ -25,6 +36,18 @@ namespace Swift {
              */
             virtual bool canParse(const std::string& element, const std::string& ns, const AttributeMap& attributes) const = 0;
 
+            /**
+             * Returns the top-level element and namespace this factory is restricted to.
+             *
+             * PayloadParserFactoryCollection uses this key to index the factory, and only calls
+             * canParse() for elements that match it, so canParse() must return false for any
+             * element that does not match the key. An empty element or namespace in the key
+             * matches any element or namespace.
+             *
+             * Factories that return no key (the default) are asked about every element.
+             */
+            virtual boost::optional<DispatchKey> getDispatchKey() const;
+
             /**
              * Creates a new payload parser.
              */
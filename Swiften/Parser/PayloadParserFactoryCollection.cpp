@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -8,24 +8,61 @@
 
 #include <algorithm>
 
-#include <boost/bind.hpp>
+#include <boost/numeric/conversion/cast.hpp>
 
 #include <Swiften/Parser/PayloadParserFactory.h>
 
 namespace Swift {
 
-PayloadParserFactoryCollection::PayloadParserFactoryCollection() : defaultFactory_(nullptr) {
+PayloadParserFactoryCollection::PayloadParserFactoryCollection() : defaultFactory_(nullptr), nextOrder_(0) {
 }
 
 PayloadParserFactoryCollection::~PayloadParserFactoryCollection() {
 }
 
+PayloadParserFactoryCollection::Atom PayloadParserFactoryCollection::internName(const std::string& name) {
+    if (name.empty()) {
+        return 0;
+    }
+    auto i = names_.find(name);
+    if (i != names_.end()) {
+        return i->second;
+    }
+    Atom atom = boost::numeric_cast<Atom>(names_.size() + 1);
+    names_[name] = atom;
+    return atom;
+}
+
+PayloadParserFactoryCollection::Atom PayloadParserFactoryCollection::getName(const std::string& name) const {
+    if (name.empty()) {
+        return 0;
+    }
+    auto i = names_.find(name);
+    return i != names_.end() ? i->second : 0;
+}
+
+PayloadParserFactoryCollection::EntryList& PayloadParserFactoryCollection::getEntryList(PayloadParserFactory* factory) {
+    boost::optional<PayloadParserFactory::DispatchKey> key = factory->getDispatchKey();
+    if (!key || (key->first.empty() && key->second.empty())) {
+        return unindexedFactories_;
+    }
+    return index_[getIndexKey(internName(key->first), internName(key->second))];
+}
+
+const PayloadParserFactoryCollection::EntryList* PayloadParserFactoryCollection::findIndexedEntries(Atom element, Atom ns) const {
+    auto i = index_.find(getIndexKey(element, ns));
+    return i != index_.end() ? &i->second : nullptr;
+}
+
 void PayloadParserFactoryCollection::addFactory(PayloadParserFactory* factory) {
-    factories_.push_back(factory);
+    getEntryList(factory).push_back(Entry(factory, nextOrder_++));
 }
 
 void PayloadParserFactoryCollection::removeFactory(PayloadParserFactory* factory) {
-    factories_.erase(std::remove(factories_.begin(), factories_.end(), factory), factories_.end());
+    EntryList& entries = getEntryList(factory);
+    entries.erase(std::remove_if(entries.begin(), entries.end(), [&](const Entry& entry) {
+        return entry.factory == factory;
+    }), entries.end());
 }
 
 void PayloadParserFactoryCollection::setDefaultFactory(PayloadParserFactory* factory) {
@@ -33,10 +70,38 @@ void PayloadParserFactoryCollection::setDefaultFactory(PayloadParserFactory* fac
 }
 
 PayloadParserFactory* PayloadParserFactoryCollection::getPayloadParserFactory(const std::string& element, const std::string& ns, const AttributeMap& attributes) {
-    std::vector<PayloadParserFactory*>::reverse_iterator i = std::find_if(
-            factories_.rbegin(), factories_.rend(),
-            boost::bind(&PayloadParserFactory::canParse, _1, element, ns, attributes));
-    return (i != factories_.rend() ? *i : defaultFactory_);
+    // Each candidate list is in registration order. Pick the most recently
+    // added factory that can parse the element, across all candidate lists.
+    const Entry* match = nullptr;
+    auto findMatch = [&](const EntryList* entries) {
+        if (!entries) {
+            return;
+        }
+        for (EntryList::const_reverse_iterator i = entries->rbegin(); i != entries->rend(); ++i) {
+            if (match && i->order < match->order) {
+                return;
+            }
+            if (i->factory->canParse(element, ns, attributes)) {
+                match = &*i;
+                return;
+            }
+        }
+    };
+
+    Atom elementAtom = getName(element);
+    Atom nsAtom = getName(ns);
+    if (elementAtom && nsAtom) {
+        findMatch(findIndexedEntries(elementAtom, nsAtom));
+    }
+    if (nsAtom) {
+        findMatch(findIndexedEntries(0, nsAtom));
+    }
+    if (elementAtom) {
+        findMatch(findIndexedEntries(elementAtom, 0));
+    }
+    findMatch(&unindexedFactories_);
+
+    return match ? match->factory : defaultFactory_;
 }
 
 }
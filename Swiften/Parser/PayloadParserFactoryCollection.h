@@ -1,11 +1,13 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #pragma once
 
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <Swiften/Base/API.h>
@@ -14,6 +16,16 @@
 namespace Swift {
     class PayloadParserFactory;
 
+    /**
+     * A collection of payload parser factories.
+     *
+     * When more than one factory can parse an element, the one that was added last wins.
+     *
+     * Factories that provide a dispatch key (see PayloadParserFactory::getDispatchKey())
+     * are kept in a hash index on interned (element, namespace) names, so that looking up
+     * a factory does not depend on the number of registered factories. Factories
+     * without a key are checked one by one for every lookup.
+     */
     class SWIFTEN_API PayloadParserFactoryCollection {
         public:
             PayloadParserFactoryCollection();
@@ -26,7 +38,32 @@ namespace Swift {
             PayloadParserFactory* getPayloadParserFactory(const std::string& element, const std::string& ns, const AttributeMap& attributes);
 
         private:
-            std::vector<PayloadParserFactory*> factories_;
+            // Interned element or namespace name. 0 is used for the empty
+            // name (which acts as a wildcard in keys) and for unknown names.
+            typedef unsigned int Atom;
+
+            struct Entry {
+                Entry(PayloadParserFactory* factory, unsigned long long order) : factory(factory), order(order) {}
+
+                PayloadParserFactory* factory;
+                unsigned long long order;
+            };
+            typedef std::vector<Entry> EntryList;
+
+            Atom internName(const std::string& name);
+            Atom getName(const std::string& name) const;
+            EntryList& getEntryList(PayloadParserFactory* factory);
+            const EntryList* findIndexedEntries(Atom element, Atom ns) const;
+
+            static unsigned long long getIndexKey(Atom element, Atom ns) {
+                return (static_cast<unsigned long long>(ns) << 32) | element;
+            }
+
+        private:
             PayloadParserFactory* defaultFactory_;
+            unsigned long long nextOrder_;
+            std::unordered_map<std::string, Atom> names_;
+            std::unordered_map<unsigned long long, EntryList> index_;
+            EntryList unindexedFactories_;
     };
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2017 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -22,6 +22,10 @@ namespace Swift {
                      || element == "paused" || element == "inactive" || element == "gone");
             }
 
+            virtual boost::optional<DispatchKey> getDispatchKey() const {
+                return DispatchKey("", "http://jabber.org/protocol/chatstates");
+            }
+
             virtual PayloadParser* createPayloadParser() {
                 return new ChatStateParser();
             }
@@ -5,7 +5,7 @@
  */
 
 /*
- * Copyright (c) 2017 Isode Limited.
+ * Copyright (c) 2017-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -27,6 +27,10 @@ namespace Swift {
                     (element == "active" || element == "inactive");
             }
 
+            virtual boost::optional<DispatchKey> getDispatchKey() const {
+                return DispatchKey("", "urn:xmpp:csi:0");
+            }
+
             virtual PayloadParser* createPayloadParser() {
                 return new ClientStateParser();
             }
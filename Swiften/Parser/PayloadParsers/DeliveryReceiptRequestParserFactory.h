@@ -5,7 +5,7 @@
  */
 
 /*
- * Copyright (c) 2015-2017 Isode Limited.
+ * Copyright (c) 2015-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -26,6 +26,10 @@ namespace Swift {
                 return ns == "urn:xmpp:receipts" && element == "request";
             }
 
+            virtual boost::optional<DispatchKey> getDispatchKey() const {
+                return DispatchKey("request", "urn:xmpp:receipts");
+            }
+
             virtual PayloadParser* createPayloadParser() {
                 return new DeliveryReceiptRequestParser();
             }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2011-2015 Isode Limited.
+ * Copyright (c) 2011-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -22,6 +22,10 @@ namespace Swift {
                 return element == "error";
             }
 
+            virtual boost::optional<DispatchKey> getDispatchKey() const {
+                return DispatchKey("error", "");
+            }
+
             virtual PayloadParser* createPayloadParser() {
                 return new ErrorParser(factories);
             }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2017 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -20,6 +20,10 @@ namespace Swift {
                 return ns == "jabber:x:data";
             }
 
+            virtual boost::optional<DispatchKey> getDispatchKey() const {
+                return DispatchKey("", "jabber:x:data");
+            }
+
             virtual PayloadParser* createPayloadParser() {
                 return new FormParser();
             }
@@ -5,7 +5,7 @@
  */
 
 /*
- * Copyright (c) 2014-2015 Isode Limited.
+ * Copyright (c) 2014-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -29,6 +29,10 @@ namespace Swift {
                 return element == "description" && ns == "urn:xmpp:jingle:apps:file-transfer:4";
             }
 
+            virtual boost::optional<DispatchKey> getDispatchKey() const {
+                return DispatchKey("description", "urn:xmpp:jingle:apps:file-transfer:4");
+            }
+
             virtual PayloadParser* createPayloadParser() {
                 return new JingleFileTransferDescriptionParser(factories);
             }
@@ -20,6 +20,10 @@ namespace Swift {
                 return element == "join" && ns == "urn:xmpp:mix:0";
             }
 
+            virtual boost::optional<DispatchKey> getDispatchKey() const {
+                return DispatchKey("join", "urn:xmpp:mix:0");
+            }
+
             virtual PayloadParser* createPayloadParser() {
                 return new MIXJoinParser();
             }
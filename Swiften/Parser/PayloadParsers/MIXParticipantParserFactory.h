@@ -20,6 +20,10 @@ namespace Swift {
                 return element == "participant" && ns == "urn:xmpp:mix:0";
             }
 
+            virtual boost::optional<DispatchKey> getDispatchKey() const {
+                return DispatchKey("participant", "urn:xmpp:mix:0");
+            }
+
             virtual PayloadParser* createPayloadParser() {
                 return new MIXParticipantParser();
             }
@@ -20,6 +20,10 @@ namespace Swift {
                 return element == "register" && ns == "urn:xmpp:mix:0";
             }
 
+            virtual boost::optional<DispatchKey> getDispatchKey() const override {
+                return DispatchKey("register", "urn:xmpp:mix:0");
+            }
+
             virtual PayloadParser* createPayloadParser() override {
                 return new MIXRegisterNickParser();
             }
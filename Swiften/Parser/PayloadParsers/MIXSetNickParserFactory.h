@@ -5,7 +5,7 @@
  */
 
 /*
- * Copyright (c) 2017 Isode Limited.
+ * Copyright (c) 2017-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -26,6 +26,10 @@ namespace Swift {
                 return element == "setnick" && ns == "urn:xmpp:mix:0";
             }
 
+            virtual boost::optional<DispatchKey> getDispatchKey() const override {
+                return DispatchKey("setnick", "urn:xmpp:mix:0");
+            }
+
             virtual PayloadParser* createPayloadParser() override {
                 return new MIXSetNickParser();
             }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2015 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -22,6 +22,10 @@ namespace Swift {
                 return element == "query" && ns == "jabber:iq:private";
             }
 
+            virtual boost::optional<DispatchKey> getDispatchKey() const {
+                return DispatchKey("query", "jabber:iq:private");
+            }
+
             virtual PayloadParser* createPayloadParser() {
                 return new PrivateStorageParser(factories);
             }
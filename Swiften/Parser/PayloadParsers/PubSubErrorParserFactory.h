@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015 Isode Limited.
+ * Copyright (c) 2013-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -21,6 +21,10 @@ namespace Swift {
                 return ns == "http://jabber.org/protocol/pubsub#errors";
             }
 
+            virtual boost::optional<DispatchKey> getDispatchKey() const {
+                return DispatchKey("", "http://jabber.org/protocol/pubsub#errors");
+            }
+
             virtual PayloadParser* createPayloadParser() {
                 return new PubSubErrorParser();
             }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -16,8 +16,8 @@ PresenceParser::PresenceParser(PayloadParserFactoryCollection* factories) :
         GenericStanzaParser<Presence>(factories) {
 }
 
-void PresenceParser::handleStanzaAttributes(const AttributeMap& attributes) {
-    boost::optional<std::string> type = attributes.getAttributeValue("type");
+void PresenceParser::handleStanzaAttributes(const AttributeMapView& attributes) {
+    boost::optional<StringView> type = attributes.getAttributeValue("type");
     if (type) {
         if (*type == "unavailable") {
             getStanzaGeneric()->setType(Presence::Unavailable);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -25,10 +25,19 @@ StanzaParser::~StanzaParser() {
 }
 
 void StanzaParser::handleStartElement(const std::string& element, const std::string& ns, const AttributeMap& attributes) {
+    handleStartElementView(element, ns, AttributeMapView(attributes));
+}
+
+void StanzaParser::handleStartElementView(const StringView& element, const StringView& ns, const AttributeMapView& attributes) {
     if (inStanza()) {
+        // Payload parsers still work on owning strings, so this is where the
+        // parser data gets copied.
+        std::string payloadElement = element.toString();
+        std::string payloadNS = ns.toString();
+        AttributeMap payloadAttributes = attributes.toAttributeMap();
         if (!inPayload()) {
             assert(!currentPayloadParser_);
-            PayloadParserFactory* payloadParserFactory = factories_->getPayloadParserFactory(element, ns, attributes);
+            PayloadParserFactory* payloadParserFactory = factories_->getPayloadParserFactory(payloadElement, payloadNS, payloadAttributes);
             if (payloadParserFactory) {
                 currentPayloadParser_.reset(payloadParserFactory->createPayloadParser());
             }
@@ -37,20 +46,20 @@ void StanzaParser::handleStartElement(const std::string& element, const std::str
             }
         }
         assert(currentPayloadParser_);
-        currentPayloadParser_->handleStartElement(element, ns, attributes);
+        currentPayloadParser_->handleStartElement(payloadElement, payloadNS, payloadAttributes);
     }
     else {
-        boost::optional<std::string> from = attributes.getAttributeValue("from");
+        boost::optional<StringView> from = attributes.getAttributeValue("from");
         if (from) {
-            getStanza()->setFrom(JID(*from));
+            getStanza()->setFrom(JID(from->toString()));
         }
-        boost::optional<std::string> to = attributes.getAttributeValue("to");
+        boost::optional<StringView> to = attributes.getAttributeValue("to");
         if (to) {
-            getStanza()->setTo(JID(*to));
+            getStanza()->setTo(JID(to->toString()));
         }
-        boost::optional<std::string> id = attributes.getAttributeValue("id");
+        boost::optional<StringView> id = attributes.getAttributeValue("id");
         if (id) {
-            getStanza()->setID(*id);
+            getStanza()->setID(id->toString());
         }
         handleStanzaAttributes(attributes);
     }
@@ -58,10 +67,14 @@ void StanzaParser::handleStartElement(const std::string& element, const std::str
 }
 
 void StanzaParser::handleEndElement(const std::string& element, const std::string& ns) {
+    handleEndElementView(element, ns);
+}
+
+void StanzaParser::handleEndElementView(const StringView& element, const StringView& ns) {
     assert(inStanza());
     if (inPayload()) {
         assert(currentPayloadParser_);
-        currentPayloadParser_->handleEndElement(element, ns);
+        currentPayloadParser_->handleEndElement(element.toString(), ns.toString());
         --currentDepth_;
         if (!inPayload()) {
             std::shared_ptr<Payload> payload(currentPayloadParser_->getPayload());
@@ -77,8 +90,12 @@ void StanzaParser::handleEndElement(const std::string& element, const std::strin
 }
 
 void StanzaParser::handleCharacterData(const std::string& data) {
+    handleCharacterDataView(data);
+}
+
+void StanzaParser::handleCharacterDataView(const StringView& data) {
     if (currentPayloadParser_) {
-        currentPayloadParser_->handleCharacterData(data);
+        currentPayloadParser_->handleCharacterData(data.toString());
     }
 }
 
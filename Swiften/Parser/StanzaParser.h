@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -14,6 +14,7 @@
 #include <Swiften/Base/API.h>
 #include <Swiften/Elements/Stanza.h>
 #include <Swiften/Parser/AttributeMap.h>
+#include <Swiften/Parser/AttributeMapView.h>
 #include <Swiften/Parser/ElementParser.h>
 
 namespace Swift {
@@ -29,8 +30,12 @@ namespace Swift {
             void handleEndElement(const std::string& element, const std::string& ns);
             void handleCharacterData(const std::string& data);
 
+            void handleStartElementView(const StringView& element, const StringView& ns, const AttributeMapView& attributes);
+            void handleEndElementView(const StringView& element, const StringView& ns);
+            void handleCharacterDataView(const StringView& data);
+
             virtual std::shared_ptr<ToplevelElement> getElement() const = 0;
-            virtual void handleStanzaAttributes(const AttributeMap&) {}
+            virtual void handleStanzaAttributes(const AttributeMapView&) {}
 
             virtual std::shared_ptr<Stanza> getStanza() const {
                 return std::dynamic_pointer_cast<Stanza>(getElement());
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -20,6 +20,11 @@ class PayloadParserFactoryCollectionTest : public CppUnit::TestFixture
         CPPUNIT_TEST(testGetPayloadParserFactory_TwoMatchingFactories);
         CPPUNIT_TEST(testGetPayloadParserFactory_MatchWithDefaultFactory);
         CPPUNIT_TEST(testGetPayloadParserFactory_NoMatchWithDefaultFactory);
+        CPPUNIT_TEST(testGetPayloadParserFactory_Indexed);
+        CPPUNIT_TEST(testGetPayloadParserFactory_IndexedNamespaceOnly);
+        CPPUNIT_TEST(testGetPayloadParserFactory_IndexedAndUnindexedUseRegistrationOrder);
+        CPPUNIT_TEST(testGetPayloadParserFactory_IndexedFactoryRejects);
+        CPPUNIT_TEST(testRemoveFactory_Indexed);
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -88,6 +93,75 @@ class PayloadParserFactoryCollectionTest : public CppUnit::TestFixture
             CPPUNIT_ASSERT(factory == &factory2);
         }
 
+        void testGetPayloadParserFactory_Indexed() {
+            PayloadParserFactoryCollection testling;
+            KeyedFactory factory1("query", "jabber:iq:roster");
+            testling.addFactory(&factory1);
+            KeyedFactory factory2("query", "jabber:iq:version");
+            testling.addFactory(&factory2);
+            KeyedFactory factory3("x", "jabber:iq:version");
+            testling.addFactory(&factory3);
+
+            CPPUNIT_ASSERT(testling.getPayloadParserFactory("query", "jabber:iq:version", AttributeMap()) == &factory2);
+            CPPUNIT_ASSERT(testling.getPayloadParserFactory("x", "jabber:iq:version", AttributeMap()) == &factory3);
+            CPPUNIT_ASSERT(!testling.getPayloadParserFactory("x", "jabber:iq:roster", AttributeMap()));
+            CPPUNIT_ASSERT(!testling.getPayloadParserFactory("query", "", AttributeMap()));
+            CPPUNIT_ASSERT(!testling.getPayloadParserFactory("unknown", "urn:unknown", AttributeMap()));
+        }
+
+        void testGetPayloadParserFactory_IndexedNamespaceOnly() {
+            PayloadParserFactoryCollection testling;
+            KeyedFactory factory1("", "jabber:x:data");
+            testling.addFactory(&factory1);
+            KeyedFactory factory2("error", "");
+            testling.addFactory(&factory2);
+
+            CPPUNIT_ASSERT(testling.getPayloadParserFactory("x", "jabber:x:data", AttributeMap()) == &factory1);
+            CPPUNIT_ASSERT(testling.getPayloadParserFactory("error", "jabber:client", AttributeMap()) == &factory2);
+            CPPUNIT_ASSERT(testling.getPayloadParserFactory("error", "", AttributeMap()) == &factory2);
+        }
+
+        void testGetPayloadParserFactory_IndexedAndUnindexedUseRegistrationOrder() {
+            PayloadParserFactoryCollection testling;
+            DummyFactory factory1("foo");
+            testling.addFactory(&factory1);
+            KeyedFactory factory2("foo", "urn:foo");
+            testling.addFactory(&factory2);
+            KeyedFactory factory3("", "urn:bar");
+            testling.addFactory(&factory3);
+            DummyFactory factory4("bar");
+            testling.addFactory(&factory4);
+
+            CPPUNIT_ASSERT(testling.getPayloadParserFactory("foo", "urn:foo", AttributeMap()) == &factory2);
+            CPPUNIT_ASSERT(testling.getPayloadParserFactory("foo", "urn:baz", AttributeMap()) == &factory1);
+            CPPUNIT_ASSERT(testling.getPayloadParserFactory("bar", "urn:bar", AttributeMap()) == &factory4);
+            CPPUNIT_ASSERT(testling.getPayloadParserFactory("baz", "urn:bar", AttributeMap()) == &factory3);
+        }
+
+        void testGetPayloadParserFactory_IndexedFactoryRejects() {
+            PayloadParserFactoryCollection testling;
+            KeyedFactory factory1("foo", "urn:foo");
+            testling.addFactory(&factory1);
+            KeyedFactory factory2("foo", "urn:foo", "type");
+            testling.addFactory(&factory2);
+
+            AttributeMap attributes;
+            attributes.addAttribute("type", "", "bar");
+            CPPUNIT_ASSERT(testling.getPayloadParserFactory("foo", "urn:foo", attributes) == &factory2);
+            CPPUNIT_ASSERT(testling.getPayloadParserFactory("foo", "urn:foo", AttributeMap()) == &factory1);
+        }
+
+        void testRemoveFactory_Indexed() {
+            PayloadParserFactoryCollection testling;
+            KeyedFactory factory1("foo", "urn:foo");
+            testling.addFactory(&factory1);
+            KeyedFactory factory2("foo", "urn:foo");
+            testling.addFactory(&factory2);
+
+            testling.removeFactory(&factory2);
+
+            CPPUNIT_ASSERT(testling.getPayloadParserFactory("foo", "urn:foo", AttributeMap()) == &factory1);
+        }
 
     private:
         struct DummyFactory : public PayloadParserFactory {
@@ -98,6 +172,20 @@ class PayloadParserFactoryCollectionTest : public CppUnit::TestFixture
             virtual PayloadParser* createPayloadParser() { return nullptr; }
             std::string element;
         };
+
+        struct KeyedFactory : public PayloadParserFactory {
+            KeyedFactory(const std::string& element, const std::string& ns, const std::string& requiredAttribute = "") : element(element), ns(ns), requiredAttribute(requiredAttribute) {}
+            virtual bool canParse(const std::string& e, const std::string& n, const AttributeMap& attributes) const {
+                return (element.empty() || element == e) && (ns.empty() || ns == n) && (requiredAttribute.empty() || !attributes.getAttribute(requiredAttribute).empty());
+            }
+            virtual boost::optional<DispatchKey> getDispatchKey() const {
+                return DispatchKey(element, ns);
+            }
+            virtual PayloadParser* createPayloadParser() { return nullptr; }
+            std::string element;
+            std::string ns;
+            std::string requiredAttribute;
+        };
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(PayloadParserFactoryCollectionTest);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -36,6 +36,8 @@ class XMLParserTest : public CppUnit::TestFixture {
         CPPUNIT_TEST(testParse_AttributeWithNamespace);
         CPPUNIT_TEST(testParse_BillionLaughs);
         CPPUNIT_TEST(testParse_InternalEntity);
+        CPPUNIT_TEST(testParse_ViewCallbacks);
+        CPPUNIT_TEST(testParse_Buffer);
         //CPPUNIT_TEST(testParse_UndefinedPrefix);
         //CPPUNIT_TEST(testParse_UndefinedAttributePrefix);
         CPPUNIT_TEST_SUITE_END();
@@ -281,6 +283,54 @@ class XMLParserTest : public CppUnit::TestFixture {
             CPPUNIT_ASSERT(!testling.parse("<!DOCTYPE foo [<!ENTITY bar \"Bar\">]><foo>&bar;</foo>"));
         }
 
+        void testParse_ViewCallbacks() {
+            ViewClient client;
+            ParserType testling(&client);
+
+            CPPUNIT_ASSERT(testling.parse(
+                "<message xmlns='jabber:client' xmlns:f='http://swift.im/f' type='chat' f:attr='3'>"
+                    "<body>Hello</body>"
+                "</message>"));
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), client.events.size());
+
+            CPPUNIT_ASSERT_EQUAL(Client::StartElement, client.events[0].type);
+            CPPUNIT_ASSERT_EQUAL(std::string("message"), client.events[0].data);
+            CPPUNIT_ASSERT_EQUAL(std::string("jabber:client"), client.events[0].ns);
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), client.events[0].attributes.getEntries().size());
+            CPPUNIT_ASSERT_EQUAL(std::string("chat"), client.events[0].attributes.getAttribute("type"));
+            CPPUNIT_ASSERT_EQUAL(std::string("3"), client.events[0].attributes.getAttribute("attr", "http://swift.im/f"));
+
+            CPPUNIT_ASSERT_EQUAL(Client::StartElement, client.events[1].type);
+            CPPUNIT_ASSERT_EQUAL(std::string("body"), client.events[1].data);
+            CPPUNIT_ASSERT_EQUAL(std::string("jabber:client"), client.events[1].ns);
+
+            CPPUNIT_ASSERT_EQUAL(Client::CharacterData, client.events[2].type);
+            CPPUNIT_ASSERT_EQUAL(std::string("Hello"), client.events[2].data);
+
+            CPPUNIT_ASSERT_EQUAL(Client::EndElement, client.events[3].type);
+            CPPUNIT_ASSERT_EQUAL(std::string("body"), client.events[3].data);
+
+            CPPUNIT_ASSERT_EQUAL(Client::EndElement, client.events[4].type);
+            CPPUNIT_ASSERT_EQUAL(std::string("message"), client.events[4].data);
+            CPPUNIT_ASSERT_EQUAL(std::string("jabber:client"), client.events[4].ns);
+
+            CPPUNIT_ASSERT(client_.events.empty());
+        }
+
+        void testParse_Buffer() {
+            ParserType testling(&client_);
+            const unsigned char data[] = "<iq type='get'/><garbage";
+
+            CPPUNIT_ASSERT(testling.parse(data, 16));
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), client_.events.size());
+            CPPUNIT_ASSERT_EQUAL(Client::StartElement, client_.events[0].type);
+            CPPUNIT_ASSERT_EQUAL(std::string("iq"), client_.events[0].data);
+            CPPUNIT_ASSERT_EQUAL(std::string("get"), client_.events[0].attributes.getAttribute("type"));
+            CPPUNIT_ASSERT_EQUAL(Client::EndElement, client_.events[1].type);
+        }
+
         void testParse_UndefinedPrefix() {
             ParserType testling(&client_);
 
@@ -352,6 +402,33 @@ class XMLParserTest : public CppUnit::TestFixture {
 
                 std::vector<Event> events;
         } client_;
+
+        class ViewClient : public Client {
+            public:
+                virtual void handleStartElement(const std::string&, const std::string&, const AttributeMap&) {
+                    CPPUNIT_FAIL("Unexpected std::string callback");
+                }
+
+                virtual void handleEndElement(const std::string&, const std::string&) {
+                    CPPUNIT_FAIL("Unexpected std::string callback");
+                }
+
+                virtual void handleCharacterData(const std::string&) {
+                    CPPUNIT_FAIL("Unexpected std::string callback");
+                }
+
+                virtual void handleStartElementView(const StringView& element, const StringView& ns, const AttributeMapView& attributes) {
+                    Client::events.push_back(typename Client::Event(Client::StartElement, element.toString(), ns.toString(), attributes.toAttributeMap()));
+                }
+
+                virtual void handleEndElementView(const StringView& element, const StringView& ns) {
+                    Client::events.push_back(typename Client::Event(Client::EndElement, element.toString(), ns.toString()));
+                }
+
+                virtual void handleCharacterDataView(const StringView& data) {
+                    Client::events.push_back(typename Client::Event(Client::CharacterData, data.toString()));
+                }
+        };
 };
 
 #ifdef HAVE_EXPAT
@@ -1,11 +1,12 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #pragma once
 
+#include <cstddef>
 #include <string>
 
 #include <Swiften/Base/API.h>
@@ -18,7 +19,14 @@ namespace Swift {
             XMLParser(XMLParserClient* client);
             virtual ~XMLParser();
 
-            virtual bool parse(const std::string& data) = 0;
+            /**
+             * Feeds data to the parser, straight from the caller's buffer.
+             */
+            virtual bool parse(const unsigned char* data, size_t size) = 0;
+
+            bool parse(const std::string& data) {
+                return parse(reinterpret_cast<const unsigned char*>(data.data()), data.size());
+            }
 
             XMLParserClient* getClient() const {
                 return client_;
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -7,7 +7,9 @@
 #pragma once
 
 #include <Swiften/Base/API.h>
+#include <Swiften/Base/StringView.h>
 #include <Swiften/Parser/AttributeMap.h>
+#include <Swiften/Parser/AttributeMapView.h>
 
 namespace Swift {
     class SWIFTEN_API XMLParserClient {
@@ -17,5 +19,17 @@ namespace Swift {
             virtual void handleStartElement(const std::string& element, const std::string& ns, const AttributeMap& attributes) = 0;
             virtual void handleEndElement(const std::string& element, const std::string& ns) = 0;
             virtual void handleCharacterData(const std::string& data) = 0;
+
+            /**
+             * Zero-copy variants of the callbacks above, which is what the XML
+             * parsers call. The views point straight into the buffers of the
+             * underlying parser, and are only valid for the duration of the call.
+             *
+             * The default implementations copy the data and forward it to the
+             * std::string based callbacks.
+             */
+            virtual void handleStartElementView(const StringView& element, const StringView& ns, const AttributeMapView& attributes);
+            virtual void handleEndElementView(const StringView& element, const StringView& ns);
+            virtual void handleCharacterDataView(const StringView& data);
     };
 }
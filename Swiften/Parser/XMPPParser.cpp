@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -67,15 +67,24 @@ bool XMPPParser::parse(const std::string& data) {
     return xmlParseResult && !parseErrorOccurred_;
 }
 
+bool XMPPParser::parse(const unsigned char* data, size_t size) {
+    bool xmlParseResult = xmlParser_->parse(data, size);
+    return xmlParseResult && !parseErrorOccurred_;
+}
+
 void XMPPParser::handleStartElement(const std::string& element, const std::string& ns, const AttributeMap& attributes) {
+    handleStartElementView(element, ns, AttributeMapView(attributes));
+}
+
+void XMPPParser::handleStartElementView(const StringView& element, const StringView& ns, const AttributeMapView& attributes) {
     if (!parseErrorOccurred_) {
         if (level_ == TopLevel) {
             if (element == "stream" && ns == "http://etherx.jabber.org/streams") {
                 ProtocolHeader header;
-                header.setFrom(attributes.getAttribute("from"));
-                header.setTo(attributes.getAttribute("to"));
-                header.setID(attributes.getAttribute("id"));
-                header.setVersion(attributes.getAttribute("version"));
+                header.setFrom(attributes.getAttribute("from").toString());
+                header.setTo(attributes.getAttribute("to").toString());
+                header.setID(attributes.getAttribute("id").toString());
+                header.setVersion(attributes.getAttribute("version").toString());
                 client_->handleStreamStart(header);
             }
             else {
@@ -87,13 +96,17 @@ void XMPPParser::handleStartElement(const std::string& element, const std::strin
                 assert(!currentElementParser_);
                 currentElementParser_ = createElementParser(element, ns);
             }
-            currentElementParser_->handleStartElement(element, ns, attributes);
+            currentElementParser_->handleStartElementView(element, ns, attributes);
         }
     }
     ++level_;
 }
 
 void XMPPParser::handleEndElement(const std::string& element, const std::string& ns) {
+    handleEndElementView(element, ns);
+}
+
+void XMPPParser::handleEndElementView(const StringView& element, const StringView& ns) {
     assert(level_ > TopLevel);
     --level_;
     if (!parseErrorOccurred_) {
@@ -103,7 +116,7 @@ void XMPPParser::handleEndElement(const std::string& element, const std::string&
         }
         else {
             assert(currentElementParser_);
-            currentElementParser_->handleEndElement(element, ns);
+            currentElementParser_->handleEndElementView(element, ns);
             if (level_ == StreamLevel) {
                 client_->handleElement(currentElementParser_->getElement());
                 delete currentElementParser_;
@@ -114,9 +127,13 @@ void XMPPParser::handleEndElement(const std::string& element, const std::string&
 }
 
 void XMPPParser::handleCharacterData(const std::string& data) {
+    handleCharacterDataView(data);
+}
+
+void XMPPParser::handleCharacterDataView(const StringView& data) {
     if (!parseErrorOccurred_) {
         if (currentElementParser_) {
-            currentElementParser_->handleCharacterData(data);
+            currentElementParser_->handleCharacterDataView(data);
         }
     //else {
     //    std::cerr << "XMPPParser: Ignoring stray character data: " << data << std::endl;
@@ -124,7 +141,7 @@ void XMPPParser::handleCharacterData(const std::string& data) {
     }
 }
 
-ElementParser* XMPPParser::createElementParser(const std::string& element, const std::string& ns) {
+ElementParser* XMPPParser::createElementParser(const StringView& element, const StringView& ns) {
     if (element == "presence") {
         return new PresenceParser(payloadParserFactories_);
     }
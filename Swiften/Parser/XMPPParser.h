@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -30,6 +30,7 @@ namespace Swift {
             virtual ~XMPPParser();
 
             bool parse(const std::string&);
+            bool parse(const unsigned char* data, size_t size);
 
         private:
             virtual void handleStartElement(
@@ -39,7 +40,14 @@ namespace Swift {
             virtual void handleEndElement(const std::string& element, const std::string& ns);
             virtual void handleCharacterData(const std::string& data);
 
-            ElementParser* createElementParser(const std::string& element, const std::string& xmlns);
+            virtual void handleStartElementView(
+                    const StringView& element,
+                    const StringView& ns,
+                    const AttributeMapView& attributes);
+            virtual void handleEndElementView(const StringView& element, const StringView& ns);
+            virtual void handleCharacterDataView(const StringView& data);
+
+            ElementParser* createElementParser(const StringView& element, const StringView& xmlns);
 
         private:
             std::unique_ptr<XMLParser> xmlParser_;
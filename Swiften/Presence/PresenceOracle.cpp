@@ -1,11 +1,12 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <Swiften/Presence/PresenceOracle.h>
 
+#include <algorithm>
 #include <queue>
 
 #include <boost/bind.hpp>
@@ -47,20 +48,20 @@ void PresenceOracle::handleIncomingPresence(Presence::ref presence) {
             passedPresence->setFrom(bareJID);
             passedPresence->setStatus(presence->getStatus());
         }
-        PresenceMap jidMap = entries_[bareJID];
+        ContactPresences& contact = entries_[bareJID];
         if (passedPresence->getFrom().isBare() && presence->getType() == Presence::Unavailable) {
             /* Have a bare-JID only presence of offline */
-            jidMap.clear();
+            contact.resources.clear();
         } else if (passedPresence->getType() == Presence::Available) {
             /* Don't have a bare-JID only offline presence once there are available presences */
-            jidMap.erase(bareJID);
+            contact.removePresence(bareJID);
         }
-        if (passedPresence->getType() == Presence::Unavailable && jidMap.size() > 1) {
-            jidMap.erase(passedPresence->getFrom());
+        if (passedPresence->getType() == Presence::Unavailable && contact.resources.size() > 1) {
+            contact.removePresence(passedPresence->getFrom());
         } else {
-            jidMap[passedPresence->getFrom()] = passedPresence;
+            contact.setPresence(passedPresence->getFrom(), passedPresence);
         }
-        entries_[bareJID] = jidMap;
+        contact.update();
         onPresenceChange(passedPresence);
     }
 }
@@ -71,9 +72,11 @@ void PresenceOracle::handleJIDRemoved(const JID& removedJID) {
     unavailablePresence->setType(Presence::Unavailable);
     unavailablePresence->setFrom(removedJID);
 
-    if (entries_.find(removedJID) != entries_.end()) {
-        entries_[removedJID].clear();
-        entries_[removedJID][removedJID] = unavailablePresence;
+    PresencesMap::iterator i = entries_.find(removedJID);
+    if (i != entries_.end()) {
+        i->second.resources.clear();
+        i->second.setPresence(removedJID, unavailablePresence);
+        i->second.update();
     }
 
     onPresenceChange(unavailablePresence);
@@ -84,28 +87,15 @@ Presence::ref PresenceOracle::getLastPresence(const JID& jid) const {
     if (i == entries_.end()) {
         return Presence::ref();
     }
-    PresenceMap presenceMap = i->second;
-    PresenceMap::const_iterator j = presenceMap.find(jid);
-    if (j != presenceMap.end()) {
-        return j->second;
-    }
-    else {
-        return Presence::ref();
-    }
+    return i->second.getPresence(jid);
 }
 
 std::vector<Presence::ref> PresenceOracle::getAllPresence(const JID& bareJID) const {
-    std::vector<Presence::ref> results;
     PresencesMap::const_iterator i = entries_.find(bareJID);
     if (i == entries_.end()) {
-        return results;
+        return std::vector<Presence::ref>();
     }
-    for (const auto& jidPresence : i->second) {
-        if (jidPresence.second) {
-            results.push_back(jidPresence.second);
-        }
-    }
-    return results;
+    return i->second.getAllPresence();
 }
 
 struct PresenceAccountCmp {
@@ -187,10 +177,11 @@ Presence::ref PresenceOracle::getActivePresence(const std::vector<Presence::ref>
 }
 
 Presence::ref PresenceOracle::getAccountPresence(const JID& jid) const {
-    Presence::ref accountPresence;
-    std::vector<Presence::ref> allPresences = getAllPresence(jid.toBare());
-    accountPresence = getActivePresence(allPresences);
-    return accountPresence;
+    PresencesMap::const_iterator i = entries_.find(jid.toBare());
+    if (i == entries_.end()) {
+        return Presence::ref();
+    }
+    return i->second.accountPresence;
 }
 
 Presence::ref PresenceOracle::getHighestPriorityPresence(const JID& bareJID) const {
@@ -198,17 +189,61 @@ Presence::ref PresenceOracle::getHighestPriorityPresence(const JID& bareJID) con
     if (i == entries_.end()) {
         return Presence::ref();
     }
-    Presence::ref highest;
-    for (const auto& jidPresence : i->second) {
-        Presence::ref current = jidPresence.second;
-        if (!highest
-                || current->getPriority() > highest->getPriority()
-                || (current->getPriority() == highest->getPriority()
-                        && StatusShow::typeToAvailabilityOrdering(current->getShow()) > StatusShow::typeToAvailabilityOrdering(highest->getShow()))) {
-            highest = current;
+    return i->second.highestPriorityPresence;
+}
+
+static bool compareResourceJID(const std::pair<JID, Presence::ref>& resource, const JID& jid) {
+    return resource.first < jid;
+}
+
+Presence::ref PresenceOracle::ContactPresences::getPresence(const JID& jid) const {
+    auto i = std::lower_bound(resources.begin(), resources.end(), jid, &compareResourceJID);
+    if (i != resources.end() && i->first == jid) {
+        return i->second;
+    }
+    return Presence::ref();
+}
+
+void PresenceOracle::ContactPresences::setPresence(const JID& jid, Presence::ref presence) {
+    auto i = std::lower_bound(resources.begin(), resources.end(), jid, &compareResourceJID);
+    if (i != resources.end() && i->first == jid) {
+        i->second = presence;
+    }
+    else {
+        resources.insert(i, std::make_pair(jid, presence));
+    }
+}
+
+void PresenceOracle::ContactPresences::removePresence(const JID& jid) {
+    auto i = std::lower_bound(resources.begin(), resources.end(), jid, &compareResourceJID);
+    if (i != resources.end() && i->first == jid) {
+        resources.erase(i);
+    }
+}
+
+std::vector<Presence::ref> PresenceOracle::ContactPresences::getAllPresence() const {
+    std::vector<Presence::ref> results;
+    results.reserve(resources.size());
+    for (const auto& resource : resources) {
+        if (resource.second) {
+            results.push_back(resource.second);
+        }
+    }
+    return results;
+}
+
+void PresenceOracle::ContactPresences::update() {
+    highestPriorityPresence.reset();
+    for (const auto& resource : resources) {
+        const Presence::ref& current = resource.second;
+        if (!highestPriorityPresence
+                || current->getPriority() > highestPriorityPresence->getPriority()
+                || (current->getPriority() == highestPriorityPresence->getPriority()
+                        && StatusShow::typeToAvailabilityOrdering(current->getShow()) > StatusShow::typeToAvailabilityOrdering(highestPriorityPresence->getShow()))) {
+            highestPriorityPresence = current;
         }
     }
-    return highest;
+    accountPresence = getActivePresence(getAllPresence());
 }
 
 }
@@ -1,13 +1,15 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #pragma once
 
-#include <map>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <boost/signals2.hpp>
 
@@ -69,8 +71,23 @@ namespace Swift {
             void handleJIDRemoved(const JID& removedJID);
 
         private:
-            typedef std::map<JID, Presence::ref> PresenceMap;
-            typedef std::map<JID, PresenceMap> PresencesMap;
+            /**
+             * The presences of all resources of a contact, sorted by full
+             * JID, together with the highest priority and account presence
+             * computed from them.
+             */
+            struct ContactPresences {
+                std::vector< std::pair<JID, Presence::ref> > resources;
+                Presence::ref highestPriorityPresence;
+                Presence::ref accountPresence;
+
+                Presence::ref getPresence(const JID& jid) const;
+                void setPresence(const JID& jid, Presence::ref presence);
+                void removePresence(const JID& jid);
+                std::vector<Presence::ref> getAllPresence() const;
+                void update();
+            };
+            typedef std::unordered_map<JID, ContactPresences> PresencesMap;
             PresencesMap entries_;
             StanzaChannel* stanzaChannel_;
             XMPPRoster* xmppRoster_;
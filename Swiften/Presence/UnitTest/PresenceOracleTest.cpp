@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -30,6 +30,9 @@ class PresenceOracleTest : public CppUnit::TestFixture {
         CPPUNIT_TEST(testHighestPresenceGlobal);
         CPPUNIT_TEST(testHighestPresenceChangePriority);
         CPPUNIT_TEST(testGetActivePresence);
+        CPPUNIT_TEST(testGetAccountPresence);
+        CPPUNIT_TEST(testGetAllPresence);
+        CPPUNIT_TEST(testJIDRemoved);
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -188,6 +191,47 @@ class PresenceOracleTest : public CppUnit::TestFixture {
             }
         }
 
+        void testGetAccountPresence() {
+            JID bareJID("alice@wonderland.lit");
+            CPPUNIT_ASSERT(!oracle_->getAccountPresence(bareJID));
+
+            stanzaChannel_->onPresenceReceived(createPresence("alice@wonderland.lit/resourceA", 10, Presence::Available, StatusShow::Away));
+            CPPUNIT_ASSERT_EQUAL(JID("alice@wonderland.lit/resourceA"), oracle_->getAccountPresence(bareJID)->getFrom());
+
+            stanzaChannel_->onPresenceReceived(createPresence("alice@wonderland.lit/resourceB", 5, Presence::Available, StatusShow::Online));
+            CPPUNIT_ASSERT_EQUAL(JID("alice@wonderland.lit/resourceB"), oracle_->getAccountPresence(bareJID)->getFrom());
+            CPPUNIT_ASSERT_EQUAL(JID("alice@wonderland.lit/resourceB"), oracle_->getAccountPresence(JID("alice@wonderland.lit/resourceA"))->getFrom());
+
+            stanzaChannel_->onPresenceReceived(makeOffline("/resourceB"));
+            CPPUNIT_ASSERT_EQUAL(JID("alice@wonderland.lit/resourceA"), oracle_->getAccountPresence(bareJID)->getFrom());
+        }
+
+        void testGetAllPresence() {
+            JID bareJID("alice@wonderland.lit");
+            stanzaChannel_->onPresenceReceived(makeOnline("c", 1));
+            stanzaChannel_->onPresenceReceived(makeOnline("a", 1));
+            stanzaChannel_->onPresenceReceived(makeOnline("b", 1));
+            stanzaChannel_->onPresenceReceived(makeOffline("/a"));
+
+            std::vector<Presence::ref> presences = oracle_->getAllPresence(bareJID);
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), presences.size());
+            CPPUNIT_ASSERT_EQUAL(JID("alice@wonderland.lit/b"), presences[0]->getFrom());
+            CPPUNIT_ASSERT_EQUAL(JID("alice@wonderland.lit/c"), presences[1]->getFrom());
+            CPPUNIT_ASSERT(!oracle_->getLastPresence(JID("alice@wonderland.lit/a")));
+        }
+
+        void testJIDRemoved() {
+            JID bareJID("alice@wonderland.lit");
+            xmppRoster_->addContact(bareJID, "Alice", std::vector<std::string>(), RosterItemPayload::Both);
+            stanzaChannel_->onPresenceReceived(makeOnline("blah", 5));
+
+            xmppRoster_->removeContact(bareJID);
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), oracle_->getAllPresence(bareJID).size());
+            CPPUNIT_ASSERT_EQUAL(Presence::Unavailable, oracle_->getHighestPriorityPresence(bareJID)->getType());
+            CPPUNIT_ASSERT_EQUAL(Presence::Unavailable, oracle_->getAccountPresence(bareJID)->getType());
+        }
+
     private:
         Presence::ref createPresence(const JID &jid, int priority, Presence::Type type, const StatusShow::Type& statusShow) {
             Presence::ref presence = std::make_shared<Presence>();
@@ -238,7 +282,7 @@ class PresenceOracleTest : public CppUnit::TestFixture {
         PresenceOracle* oracle_;
         SubscriptionManager* subscriptionManager_;
         DummyStanzaChannel* stanzaChannel_;
-        XMPPRoster* xmppRoster_;
+        XMPPRosterImpl* xmppRoster_;
         std::vector<Presence::ref> changes;
         std::vector<SubscriptionRequestInfo> subscriptionRequests;
         JID user1;
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <Swiften/Base/SafeByteArray.h>
+#include <Swiften/Compress/ZLibCompressionOptions.h>
+#include <Swiften/Compress/ZLibCompressor.h>
+#include <Swiften/Compress/ZLibDecompressor.h>
+
+using namespace Swift;
+
+namespace {
+    std::vector<SafeByteArray> createStanzas(int count) {
+        std::vector<SafeByteArray> result;
+        for (int i = 0; i < count; ++i) {
+            std::string id = std::to_string(i);
+            std::string stanza;
+            switch (i % 4) {
+                case 0:
+                    stanza = "<message from=\"alice@wonderland.lit/rabbithole\" id=\"m" + id + "\" to=\"bob@example.com\" type=\"chat\"><body>Message number " + id + "</body><active xmlns=\"http://jabber.org/protocol/chatstates\"/><request xmlns=\"urn:xmpp:receipts\"/></message>";
+                    break;
+                case 1:
+                    stanza = "<presence from=\"user" + id + "@example.com/home\" to=\"bob@example.com\"><show>away</show><status>Out to lunch</status><c xmlns=\"http://jabber.org/protocol/caps\" hash=\"sha-1\" node=\"http://swift.im\" ver=\"QgayPKawpkPSDYmwT/WM94uAlu0=\"/></presence>";
+                    break;
+                case 2:
+                    stanza = "<iq from=\"bob@example.com/work\" id=\"i" + id + "\" to=\"example.com\" type=\"get\"><ping xmlns=\"urn:xmpp:ping\"/></iq>";
+                    break;
+                default:
+                    stanza = "<r xmlns=\"urn:xmpp:sm:3\"/>";
+                    break;
+            }
+            result.push_back(createSafeByteArray(stanza));
+        }
+        return result;
+    }
+
+    size_t estimateCompressorMemory(const ZLibCompressionOptions& options) {
+        // The formula documented in zconf.h; this is not measured
+        return (size_t(1) << (options.windowBits + 2)) + (size_t(1) << (options.memLevel + 9));
+    }
+
+    void run(const std::string& name, const ZLibCompressionOptions& options, const std::vector<SafeByteArray>& stanzas) {
+        ZLibCompressor compressor(options);
+        ZLibDecompressor decompressor(options);
+        size_t inputSize = 0;
+        size_t outputSize = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& stanza : stanzas) {
+            SafeByteArray compressed = compressor.process(stanza);
+            decompressor.process(compressed);
+            inputSize += stanza.size();
+            outputSize += compressed.size();
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        std::cout << std::left << std::setw(28) << name << std::right
+            << std::setw(10) << estimateCompressorMemory(options) / 1024 << " KB"
+            << std::setw(10) << std::fixed << std::setprecision(3) << static_cast<double>(outputSize) / static_cast<double>(inputSize)
+            << std::setw(10) << elapsed.count() << " ms" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int count = argc > 1 ? std::stoi(argv[1]) : 20000;
+    std::vector<SafeByteArray> stanzas = createStanzas(count);
+
+    std::cout << std::left << std::setw(28) << "Settings" << std::right << std::setw(13) << "Memory (est)" << std::setw(10) << "Ratio" << std::setw(13) << "Time" << std::endl;
+
+    ZLibCompressionOptions options;
+    run("default (15/8)", options, stanzas);
+
+    for (int windowBits : {13, 11, 9}) {
+        for (int memLevel : {8, 4, 1}) {
+            options.windowBits = windowBits;
+            options.memLevel = memLevel;
+            run("window " + std::to_string(windowBits) + ", mem " + std::to_string(memLevel), options, stanzas);
+        }
+    }
+
+    options = ZLibCompressionOptions();
+    options.dictionary = ZLibCompressionOptions::getXMPPDictionary();
+    run("default + dictionary", options, stanzas);
+    options.windowBits = 11;
+    options.memLevel = 4;
+    run("window 11, mem 4 + dict", options, stanzas);
+
+    return 0;
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/bind.hpp>
+
+#include <Swiften/Elements/IQ.h>
+#include <Swiften/Elements/RosterPayload.h>
+#include <Swiften/Queries/DummyIQChannel.h>
+#include <Swiften/Queries/IQRouter.h>
+#include <Swiften/Roster/RosterMemoryStorage.h>
+#include <Swiften/Roster/XMPPRosterController.h>
+#include <Swiften/Roster/XMPPRosterImpl.h>
+
+using namespace Swift;
+
+namespace {
+    std::shared_ptr<RosterPayload> createRoster(int size, const std::string& version) {
+        std::shared_ptr<RosterPayload> roster = std::make_shared<RosterPayload>();
+        roster->setVersion(version);
+        for (int i = 0; i < size; ++i) {
+            std::vector<std::string> groups;
+            groups.push_back("Group " + std::to_string(i % 20));
+            roster->addItem(RosterItemPayload(JID("contact" + std::to_string(i) + "@example.com"), "Contact " + std::to_string(i), RosterItemPayload::Both, groups));
+        }
+        return roster;
+    }
+
+    // Does what a typical roster listener does for every contact
+    void handleJIDsAdded(XMPPRoster* roster, const std::vector<JID>& jids, size_t* count) {
+        for (const auto& jid : jids) {
+            *count += roster->getGroupsForJID(jid).size() + roster->getNameForJID(jid).size();
+        }
+    }
+
+    double load(int size, bool fromCache) {
+        DummyIQChannel channel;
+        IQRouter router(&channel);
+        XMPPRosterImpl roster;
+        RosterMemoryStorage storage;
+        XMPPRosterController controller(&router, &roster, &storage);
+        controller.setUseVersioning(true);
+        size_t count = 0;
+        roster.onJIDsAdded.connect(boost::bind(&handleJIDsAdded, &roster, _1, &count));
+
+        std::shared_ptr<RosterPayload> payload = createRoster(size, "1");
+        if (fromCache) {
+            storage.setRoster(payload);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        controller.requestRoster();
+        channel.onIQReceived(IQ::createResult(JID(), "test-id", fromCache ? std::shared_ptr<Payload>() : payload));
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        if (roster.getItems().size() != static_cast<size_t>(size) || count == 0) {
+            std::cerr << "Roster was not loaded" << std::endl;
+        }
+        return std::chrono::duration<double, std::milli>(elapsed).count();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int maxSize = argc > 1 ? std::stoi(argv[1]) : 20000;
+
+    std::cout << std::setw(10) << "Items" << std::setw(16) << "Load (ms)" << std::setw(16) << "Cached (ms)" << std::endl;
+    for (int size = 1000; size <= maxSize; size *= 2) {
+        std::cout << std::setw(10) << size
+            << std::setw(16) << std::fixed << std::setprecision(2) << load(size, false)
+            << std::setw(16) << load(size, true) << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+/*
+ * Measures the throughput of a SOCKS5 bytestream sending a file over the
+ * loopback interface, with and without sending directly from the file.
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/bind.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <Swiften/EventLoop/SimpleEventLoop.h>
+#include <Swiften/FileTransfer/FileReadBytestream.h>
+#include <Swiften/FileTransfer/SOCKS5BytestreamClientSession.h>
+#include <Swiften/FileTransfer/SOCKS5BytestreamRegistry.h>
+#include <Swiften/FileTransfer/SOCKS5BytestreamServerSession.h>
+#include <Swiften/FileTransfer/WriteBytestream.h>
+#include <Swiften/Network/BoostNetworkFactories.h>
+#include <Swiften/Network/ConnectionFactory.h>
+#include <Swiften/Network/ConnectionServer.h>
+#include <Swiften/Network/ConnectionServerFactory.h>
+#include <Swiften/Network/HostAddress.h>
+
+using namespace Swift;
+
+namespace {
+    // Hides the file from the sessions, so they take the copying path.
+    class CopyingReadBytestream : public ReadBytestream {
+        public:
+            CopyingReadBytestream(std::shared_ptr<ReadBytestream> stream) : stream_(stream) {
+            }
+
+            virtual std::shared_ptr< std::vector<unsigned char> > read(size_t size) {
+                return stream_->read(size);
+            }
+
+            virtual bool isFinished() const {
+                return stream_->isFinished();
+            }
+
+        private:
+            std::shared_ptr<ReadBytestream> stream_;
+    };
+
+    class CountingWriteBytestream : public WriteBytestream {
+        public:
+            virtual bool write(const std::vector<unsigned char>& data) {
+                onBytesWritten(data.size());
+                return true;
+            }
+
+            boost::signals2::signal<void (size_t)> onBytesWritten;
+    };
+
+    class Transfer {
+        public:
+            Transfer(std::shared_ptr<ReadBytestream> stream, unsigned long long size) : networkFactories_(&eventLoop_), stream_(stream), size_(size), received_(0) {
+            }
+
+            std::chrono::milliseconds run() {
+                std::string streamID = registry_.generateSessionID();
+                registry_.setHasBytestream(streamID, true);
+
+                server_ = networkFactories_.getConnectionServerFactory()->createConnectionServer(HostAddress::fromString("127.0.0.1").get(), 0);
+                server_->onNewConnection.connect(boost::bind(&Transfer::handleNewConnection, this, _1));
+                server_->start();
+
+                client_ = std::make_shared<SOCKS5BytestreamClientSession>(networkFactories_.getConnectionFactory()->createConnection(), server_->getAddressPort(), streamID, networkFactories_.getTimerFactory());
+                client_->onSessionReady.connect(boost::bind(&Transfer::handleSessionReady, this, _1));
+
+                start_ = std::chrono::steady_clock::now();
+                client_->start();
+                eventLoop_.run();
+
+                server_->stop();
+                return std::chrono::duration_cast<std::chrono::milliseconds>(end_ - start_);
+            }
+
+        private:
+            void handleNewConnection(std::shared_ptr<Connection> connection) {
+                serverSession_ = std::make_shared<SOCKS5BytestreamServerSession>(connection, &registry_);
+                serverSession_->setChunkSize(1024 * 1024);
+                serverSession_->start();
+            }
+
+            void handleSessionReady(bool error) {
+                if (error || !serverSession_) {
+                    std::cerr << "Failed to set up the bytestream" << std::endl;
+                    eventLoop_.stop();
+                    return;
+                }
+                std::shared_ptr<CountingWriteBytestream> output = std::make_shared<CountingWriteBytestream>();
+                output->onBytesWritten.connect(boost::bind(&Transfer::handleBytesWritten, this, _1));
+                client_->startReceiving(output);
+                serverSession_->startSending(stream_);
+            }
+
+            void handleBytesWritten(size_t size) {
+                received_ += size;
+                if (received_ >= size_) {
+                    end_ = std::chrono::steady_clock::now();
+                    client_->stop();
+                    serverSession_->stop();
+                    eventLoop_.stop();
+                }
+            }
+
+        private:
+            SimpleEventLoop eventLoop_;
+            BoostNetworkFactories networkFactories_;
+            std::shared_ptr<ReadBytestream> stream_;
+            unsigned long long size_;
+            unsigned long long received_;
+            SOCKS5BytestreamRegistry registry_;
+            std::shared_ptr<ConnectionServer> server_;
+            std::shared_ptr<SOCKS5BytestreamServerSession> serverSession_;
+            std::shared_ptr<SOCKS5BytestreamClientSession> client_;
+            std::chrono::steady_clock::time_point start_;
+            std::chrono::steady_clock::time_point end_;
+    };
+
+    void createFile(const boost::filesystem::path& file, unsigned long long size) {
+        boost::filesystem::ofstream stream(file, std::ios_base::out | std::ios_base::binary);
+        std::vector<char> block(1024 * 1024);
+        for (size_t i = 0; i < block.size(); ++i) {
+            block[i] = static_cast<char>(i * 7);
+        }
+        for (unsigned long long written = 0; written < size; written += block.size()) {
+            stream.write(block.data(), static_cast<std::streamsize>(block.size()));
+        }
+    }
+
+    void run(const std::string& name, std::shared_ptr<ReadBytestream> stream, unsigned long long size) {
+        std::chrono::milliseconds elapsed = Transfer(stream, size).run();
+        double seconds = static_cast<double>(elapsed.count()) / 1000.0;
+        std::cout << std::left << std::setw(12) << name << std::right
+            << std::setw(10) << elapsed.count() << " ms"
+            << std::setw(10) << std::fixed << std::setprecision(1) << (seconds > 0 ? static_cast<double>(size) / (1024.0 * 1024.0) / seconds : 0.0) << " MB/s" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    unsigned long long size = (argc > 1 ? std::stoull(argv[1]) : 512) * 1024 * 1024;
+    boost::filesystem::path file = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("swift-s5b-benchmark-%%%%%%%%");
+    createFile(file, size);
+
+    std::cout << "Sending " << size / (1024 * 1024) << " MB over a local SOCKS5 bytestream" << std::endl;
+    run("copy", std::make_shared<CopyingReadBytestream>(std::make_shared<FileReadBytestream>(file)), size);
+    run("file", std::make_shared<FileReadBytestream>(file), size);
+
+    boost::filesystem::remove(file);
+    return 0;
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -16,6 +16,7 @@
 #include <Swiften/Base/sleep.h>
 #include <Swiften/EventLoop/DummyEventLoop.h>
 #include <Swiften/Network/BoostConnection.h>
+#include <Swiften/Network/BoostConnectionServer.h>
 #include <Swiften/Network/BoostIOServiceThread.h>
 #include <Swiften/Network/HostAddress.h>
 #include <Swiften/Network/HostAddressPort.h>
@@ -28,6 +29,10 @@ class BoostConnectionTest : public CppUnit::TestFixture {
         CPPUNIT_TEST(testDestructor_PendingEvents);
         CPPUNIT_TEST(testWrite);
         CPPUNIT_TEST(testWriteMultipleSimultaniouslyQueuesWrites);
+        CPPUNIT_TEST(testWrite_QueuedWritesKeepOrder);
+        CPPUNIT_TEST(testWrite_Corked);
+        CPPUNIT_TEST(testWrite_CorkedFlushThreshold);
+        CPPUNIT_TEST(testDisconnect_FlushesCorkedWrites);
 #ifdef TEST_IPV6
         CPPUNIT_TEST(testWrite_IPv6);
 #endif
@@ -40,10 +45,20 @@ class BoostConnectionTest : public CppUnit::TestFixture {
             boostIOService_ = std::make_shared<boost::asio::io_service>();
             disconnected_ = false;
             connectFinished_ = false;
+            serverEventLoop_ = new DummyEventLoop();
         }
 
         void tearDown() {
+            if (server_) {
+                server_->stop();
+                server_.reset();
+            }
+            serverConnection_.reset();
             delete boostIOServiceThread_;
+            while (serverEventLoop_->hasEvents()) {
+                serverEventLoop_->processEvents();
+            }
+            delete serverEventLoop_;
             while (eventLoop_->hasEvents()) {
                 eventLoop_->processEvents();
             }
@@ -150,6 +165,64 @@ class BoostConnectionTest : public CppUnit::TestFixture {
             }
         }
 
+        void testWrite_QueuedWritesKeepOrder() {
+            BoostConnection::ref testling = connectToLocalServer();
+
+            // Most of these are written while another write is in progress, and get sent together
+            std::string expectedData;
+            for (int i = 0; i < 1000; ++i) {
+                expectedData += std::to_string(i) + ",";
+                testling->write(createSafeByteArray(std::to_string(i) + ","));
+            }
+            waitForServerData(expectedData.size());
+
+            CPPUNIT_ASSERT_EQUAL(expectedData, byteArrayToString(serverData_));
+            testling->disconnect();
+        }
+
+        void testWrite_Corked() {
+            BoostConnection::ref testling = connectToLocalServer();
+            testling->setCorked(true);
+
+            testling->write(createSafeByteArray("<a/>"));
+            testling->write(createSafeByteArray("<b/>"));
+            testling->write(createSafeByteArray("<c/>"));
+            Swift::sleep(100);
+            serverEventLoop_->processEvents();
+            CPPUNIT_ASSERT(serverData_.empty());
+
+            // The writes are sent once the pending events are handled
+            eventLoop_->processEvents();
+            waitForServerData(12);
+
+            CPPUNIT_ASSERT_EQUAL(std::string("<a/><b/><c/>"), byteArrayToString(serverData_));
+            testling->disconnect();
+        }
+
+        void testWrite_CorkedFlushThreshold() {
+            BoostConnection::ref testling = connectToLocalServer();
+            testling->setCorked(true, 8);
+
+            testling->write(createSafeByteArray("<a/>"));
+            testling->write(createSafeByteArray("<b/>"));
+            waitForServerData(8);
+
+            CPPUNIT_ASSERT_EQUAL(std::string("<a/><b/>"), byteArrayToString(serverData_));
+            testling->disconnect();
+        }
+
+        void testDisconnect_FlushesCorkedWrites() {
+            BoostConnection::ref testling = connectToLocalServer();
+            testling->setCorked(true);
+
+            testling->write(createSafeByteArray("<a/>"));
+            testling->write(createSafeByteArray("</stream:stream>"));
+            testling->disconnect();
+            waitForServerData(20);
+
+            CPPUNIT_ASSERT_EQUAL(std::string("<a/></stream:stream>"), byteArrayToString(serverData_));
+        }
+
         void doWrite(BoostConnection* connection) {
             connection->write(createSafeByteArray("<stream:stream>"));
             connection->write(createSafeByteArray("\r\n\r\n")); // Temporarily, while we don't have an xmpp server running on ipv6
@@ -167,11 +240,48 @@ class BoostConnectionTest : public CppUnit::TestFixture {
             connectFinished_ = true;
         }
 
+    private:
+        BoostConnection::ref connectToLocalServer() {
+            server_ = BoostConnectionServer::create(HostAddress::fromString("127.0.0.1").get(), 9998, boostIOServiceThread_->getIOService(), serverEventLoop_);
+            server_->onNewConnection.connect(boost::bind(&BoostConnectionTest::handleNewServerConnection, this, _1));
+            server_->start();
+
+            BoostConnection::ref testling(BoostConnection::create(boostIOServiceThread_->getIOService(), eventLoop_));
+            testling->onConnectFinished.connect(boost::bind(&BoostConnectionTest::handleConnectFinished, this));
+            testling->connect(HostAddressPort(HostAddress::fromString("127.0.0.1").get(), 9998));
+            while (!connectFinished_ || !serverConnection_) {
+                Swift::sleep(10);
+                eventLoop_->processEvents();
+                serverEventLoop_->processEvents();
+            }
+            return testling;
+        }
+
+        void handleNewServerConnection(std::shared_ptr<Connection> connection) {
+            serverConnection_ = connection;
+            serverConnection_->onDataRead.connect(boost::bind(&BoostConnectionTest::handleServerDataRead, this, _1));
+        }
+
+        void handleServerDataRead(std::shared_ptr<SafeByteArray> data) {
+            append(serverData_, *data);
+        }
+
+        void waitForServerData(size_t size) {
+            for (int i = 0; i < 500 && serverData_.size() < size; ++i) {
+                Swift::sleep(10);
+                serverEventLoop_->processEvents();
+            }
+        }
+
     private:
         BoostIOServiceThread* boostIOServiceThread_;
         std::shared_ptr<boost::asio::io_service> boostIOService_;
         DummyEventLoop* eventLoop_;
+        DummyEventLoop* serverEventLoop_;
+        BoostConnectionServer::ref server_;
+        std::shared_ptr<Connection> serverConnection_;
         ByteArray receivedData_;
+        ByteArray serverData_;
         bool disconnected_;
         bool connectFinished_;
 };
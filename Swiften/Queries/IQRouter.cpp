@@ -1,15 +1,19 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <Swiften/Queries/IQRouter.h>
 
+#include <algorithm>
+
 #include <boost/bind.hpp>
 
 #include <Swiften/Base/Algorithm.h>
 #include <Swiften/Elements/ErrorPayload.h>
+#include <Swiften/Network/Timer.h>
+#include <Swiften/Network/TimerFactory.h>
 #include <Swiften/Queries/IQChannel.h>
 #include <Swiften/Queries/IQHandler.h>
 
@@ -17,11 +21,16 @@ namespace Swift {
 
 static void noop(IQHandler*) {}
 
-IQRouter::IQRouter(IQChannel* channel) : channel_(channel), queueRemoves_(false) {
+IQRouter::IQRouter(IQChannel* channel) : channel_(channel), timerFactory_(nullptr), queueRemoves_(false), nextResponseHandlerSequence_(0) {
     channel->onIQReceived.connect(boost::bind(&IQRouter::handleIQ, this, _1));
 }
 
 IQRouter::~IQRouter() {
+    for (auto&& responseHandler : responseHandlers_) {
+        if (responseHandler.second.timer) {
+            responseHandler.second.timer->stop();
+        }
+    }
     channel_->onIQReceived.disconnect(boost::bind(&IQRouter::handleIQ, this, _1));
 }
 
@@ -30,6 +39,10 @@ bool IQRouter::isAvailable() {
 }
 
 void IQRouter::handleIQ(std::shared_ptr<IQ> iq) {
+    if ((iq->getType() == IQ::Result || iq->getType() == IQ::Error) && handleResponse(iq)) {
+        return;
+    }
+
     queueRemoves_ = true;
 
     bool handled = false;
@@ -51,6 +64,44 @@ void IQRouter::handleIQ(std::shared_ptr<IQ> iq) {
     queueRemoves_ = false;
 }
 
+bool IQRouter::handleResponse(std::shared_ptr<IQ> iq) {
+    auto range = responseHandlers_.equal_range(iq->getID());
+    if (range.first == range.second) {
+        return false;
+    }
+    // Copy the candidates, as handlers remove themselves when handling the response
+    typedef std::pair<unsigned long long, std::shared_ptr<IQHandler> > Candidate;
+    std::vector<Candidate> handlers;
+    for (auto i = range.first; i != range.second; ++i) {
+        handlers.push_back(std::make_pair(i->second.sequence, i->second.handler));
+    }
+    // As for generic handlers, give precedence to the last added handler
+    std::sort(handlers.begin(), handlers.end(), [](const Candidate& a, const Candidate& b) {
+        return a.first > b.first;
+    });
+    for (auto&& handler : handlers) {
+        if (handler.second->handleIQ(iq)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void IQRouter::handleResponseTimeout(const std::string& id, IQHandler* handler) {
+    auto range = responseHandlers_.equal_range(id);
+    for (auto i = range.first; i != range.second; ++i) {
+        if (i->second.handler.get() == handler) {
+            // Keep the entry alive while the handler processes the error
+            ResponseHandler responseHandler = i->second;
+            std::shared_ptr<IQ> error = IQ::createError(jid_, responseHandler.expectedSender, id, ErrorPayload::RemoteServerTimeout, ErrorPayload::Wait);
+            if (!responseHandler.handler->handleIQ(error)) {
+                removeResponseHandler(id, handler);
+            }
+            return;
+        }
+    }
+}
+
 void IQRouter::processPendingRemoves() {
     for (auto&& handler : queuedRemoves_) {
         erase(handlers_, handler);
@@ -79,6 +130,32 @@ void IQRouter::removeHandler(std::shared_ptr<IQHandler> handler) {
     }
 }
 
+void IQRouter::addResponseHandler(const std::string& id, const JID& expectedSender, std::shared_ptr<IQHandler> handler, int timeoutMilliseconds) {
+    ResponseHandler responseHandler;
+    responseHandler.expectedSender = expectedSender;
+    responseHandler.handler = handler;
+    responseHandler.sequence = nextResponseHandlerSequence_++;
+    if (timeoutMilliseconds > 0 && timerFactory_) {
+        responseHandler.timer = timerFactory_->createTimer(timeoutMilliseconds);
+        responseHandler.timer->onTick.connect(boost::bind(&IQRouter::handleResponseTimeout, this, id, handler.get()));
+        responseHandler.timer->start();
+    }
+    responseHandlers_.insert(std::make_pair(id, responseHandler));
+}
+
+void IQRouter::removeResponseHandler(const std::string& id, IQHandler* handler) {
+    auto range = responseHandlers_.equal_range(id);
+    for (auto i = range.first; i != range.second; ++i) {
+        if (i->second.handler.get() == handler) {
+            if (i->second.timer) {
+                i->second.timer->stop();
+            }
+            responseHandlers_.erase(i);
+            return;
+        }
+    }
+}
+
 void IQRouter::sendIQ(std::shared_ptr<IQ> iq) {
     if (from_.isValid() && !iq->getFrom().isValid()) {
         iq->setFrom(from_);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -8,6 +8,7 @@
 
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <Swiften/Base/API.h>
@@ -16,6 +17,8 @@
 namespace Swift {
     class IQChannel;
     class IQHandler;
+    class Timer;
+    class TimerFactory;
 
     class SWIFTEN_API IQRouter {
         public:
@@ -47,11 +50,44 @@ namespace Swift {
                 from_ = from;
             }
 
+            /**
+             * Sets the timer factory used for response timeouts.
+             *
+             * Without a timer factory, responses never time out.
+             */
+            void setTimerFactory(TimerFactory* timerFactory) {
+                timerFactory_ = timerFactory;
+            }
+
             void addHandler(IQHandler* handler);
             void removeHandler(IQHandler* handler);
             void addHandler(std::shared_ptr<IQHandler> handler);
             void removeHandler(std::shared_ptr<IQHandler> handler);
 
+            /**
+             * Adds a handler for the response to the IQ with the given ID.
+             *
+             * Incoming results and errors are first looked up by ID in
+             * the table of response handlers, and only go through the
+             * handlers added with addHandler() if none of those handles
+             * them. When several handlers wait for the same ID, the last
+             * added one is tried first.
+             *
+             * If timeoutMilliseconds is positive and a timer factory is
+             * set, the handler gets a remote-server-timeout error from
+             * expectedSender when no response arrives in time.
+             */
+            void addResponseHandler(const std::string& id, const JID& expectedSender, std::shared_ptr<IQHandler> handler, int timeoutMilliseconds = 0);
+            void removeResponseHandler(const std::string& id, IQHandler* handler);
+
+            /**
+             * Returns the number of IQs for which a response handler is
+             * still waiting.
+             */
+            size_t getPendingResponseCount() const {
+                return responseHandlers_.size();
+            }
+
             /**
              * Sends an IQ stanza.
              *
@@ -77,13 +113,26 @@ namespace Swift {
         private:
             void handleIQ(std::shared_ptr<IQ> iq);
             void processPendingRemoves();
+            bool handleResponse(std::shared_ptr<IQ> iq);
+            void handleResponseTimeout(const std::string& id, IQHandler* handler);
 
         private:
+            struct ResponseHandler {
+                JID expectedSender;
+                std::shared_ptr<IQHandler> handler;
+                std::shared_ptr<Timer> timer;
+                unsigned long long sequence;
+            };
+            typedef std::unordered_multimap<std::string, ResponseHandler> ResponseHandlerMap;
+
             IQChannel* channel_;
+            TimerFactory* timerFactory_;
             JID jid_;
             JID from_;
             std::vector< std::shared_ptr<IQHandler> > handlers_;
             std::vector< std::shared_ptr<IQHandler> > queuedRemoves_;
             bool queueRemoves_;
+            ResponseHandlerMap responseHandlers_;
+            unsigned long long nextResponseHandlerSequence_;
     };
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -12,16 +12,16 @@
 
 namespace Swift {
 
-Request::Request(IQ::Type type, const JID& receiver, std::shared_ptr<Payload> payload, IQRouter* router) : router_(router), type_(type), receiver_(receiver), payload_(payload), sent_(false) {
+Request::Request(IQ::Type type, const JID& receiver, std::shared_ptr<Payload> payload, IQRouter* router) : router_(router), type_(type), receiver_(receiver), payload_(payload), sent_(false), timeoutMilliseconds_(0) {
 }
 
-Request::Request(IQ::Type type, const JID& receiver, IQRouter* router) : router_(router), type_(type), receiver_(receiver), sent_(false) {
+Request::Request(IQ::Type type, const JID& receiver, IQRouter* router) : router_(router), type_(type), receiver_(receiver), sent_(false), timeoutMilliseconds_(0) {
 }
 
-Request::Request(IQ::Type type, const JID& sender, const JID& receiver, std::shared_ptr<Payload> payload, IQRouter* router) : router_(router), type_(type), sender_(sender), receiver_(receiver), payload_(payload), sent_(false) {
+Request::Request(IQ::Type type, const JID& sender, const JID& receiver, std::shared_ptr<Payload> payload, IQRouter* router) : router_(router), type_(type), sender_(sender), receiver_(receiver), payload_(payload), sent_(false), timeoutMilliseconds_(0) {
 }
 
-Request::Request(IQ::Type type, const JID& sender, const JID& receiver, IQRouter* router) : router_(router), type_(type), sender_(sender), receiver_(receiver), sent_(false) {
+Request::Request(IQ::Type type, const JID& sender, const JID& receiver, IQRouter* router) : router_(router), type_(type), sender_(sender), receiver_(receiver), sent_(false), timeoutMilliseconds_(0) {
 }
 
 std::string Request::send() {
@@ -37,10 +37,10 @@ std::string Request::send() {
     iq->setID(id_);
 
     try {
-        router_->addHandler(shared_from_this());
+        router_->addResponseHandler(id_, receiver_, shared_from_this(), timeoutMilliseconds_);
     }
     catch (const std::exception&) {
-        router_->addHandler(this);
+        router_->addResponseHandler(id_, receiver_, std::shared_ptr<IQHandler>(this, [](IQHandler*) {}), timeoutMilliseconds_);
     }
 
     router_->sendIQ(iq);
@@ -68,7 +68,7 @@ bool Request::handleIQ(std::shared_ptr<IQ> iq) {
                         handleResponse(std::shared_ptr<Payload>(), ErrorPayload::ref(new ErrorPayload(ErrorPayload::UndefinedCondition)));
                     }
                 }
-                router_->removeHandler(this);
+                router_->removeResponseHandler(id_, this);
                 handled = true;
             }
         }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2017 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -40,6 +40,17 @@ namespace Swift {
                 return id_;
             }
 
+            /**
+             * Sets the time to wait for a response after send(), after which
+             * the request fails with a remote-server-timeout error.
+             *
+             * This only has an effect if a timer factory was set on the
+             * IQRouter. By default, requests do not time out.
+             */
+            void setTimeout(int milliseconds) {
+                timeoutMilliseconds_ = milliseconds;
+            }
+
 
         protected:
             /**
@@ -104,5 +115,6 @@ namespace Swift {
             std::shared_ptr<Payload> payload_;
             std::string id_;
             bool sent_;
+            int timeoutMilliseconds_;
     };
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -13,6 +13,7 @@
 
 #include <Swiften/Elements/Payload.h>
 #include <Swiften/Elements/RawXMLPayload.h>
+#include <Swiften/Network/DummyTimerFactory.h>
 #include <Swiften/Queries/DummyIQChannel.h>
 #include <Swiften/Queries/GenericRequest.h>
 #include <Swiften/Queries/IQRouter.h>
@@ -39,6 +40,11 @@ class RequestTest : public CppUnit::TestFixture {
         CPPUNIT_TEST(testHandleIQ_ServerRespondsWithBareJID);
         CPPUNIT_TEST(testHandleIQ_ServerRespondsWithoutFrom);
         CPPUNIT_TEST(testHandleIQ_ServerRespondsWithFullJID);
+        CPPUNIT_TEST(testHandleIQ_Timeout);
+        CPPUNIT_TEST(testHandleIQ_ResponseBeforeTimeout);
+        CPPUNIT_TEST(testHandleIQ_TimeoutWithoutTimerFactory);
+        CPPUNIT_TEST(testGetPendingResponseCount);
+        CPPUNIT_TEST(testHandleIQ_SameIDAsOtherRequest);
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -76,6 +82,7 @@ class RequestTest : public CppUnit::TestFixture {
             payload_ = std::make_shared<MyPayload>("foo");
             responsePayload_ = std::make_shared<MyPayload>("bar");
             responsesReceived_ = 0;
+            otherResponsesReceived_ = 0;
         }
 
         void tearDown() {
@@ -314,6 +321,83 @@ class RequestTest : public CppUnit::TestFixture {
 
 
 
+        void testHandleIQ_Timeout() {
+            DummyTimerFactory timerFactory;
+            router_->setTimerFactory(&timerFactory);
+            MyRequest testling(IQ::Get, JID("foo@bar.com/baz"), payload_, router_);
+            testling.onResponse.connect(boost::bind(&RequestTest::handleResponse, this, _1, _2));
+            testling.setTimeout(1000);
+            testling.send();
+
+            timerFactory.setTime(999);
+            CPPUNIT_ASSERT_EQUAL(0, static_cast<int>(receivedErrors.size()));
+
+            timerFactory.setTime(1000);
+            CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(receivedErrors.size()));
+            CPPUNIT_ASSERT_EQUAL(ErrorPayload::RemoteServerTimeout, receivedErrors[0].getCondition());
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), router_->getPendingResponseCount());
+
+            channel_->onIQReceived(createResponse(JID("foo@bar.com/baz"),"test-id"));
+            CPPUNIT_ASSERT_EQUAL(0, responsesReceived_);
+        }
+
+        void testHandleIQ_ResponseBeforeTimeout() {
+            DummyTimerFactory timerFactory;
+            router_->setTimerFactory(&timerFactory);
+            MyRequest testling(IQ::Get, JID("foo@bar.com/baz"), payload_, router_);
+            testling.onResponse.connect(boost::bind(&RequestTest::handleResponse, this, _1, _2));
+            testling.setTimeout(1000);
+            testling.send();
+
+            channel_->onIQReceived(createResponse(JID("foo@bar.com/baz"),"test-id"));
+            timerFactory.setTime(1000);
+
+            CPPUNIT_ASSERT_EQUAL(1, responsesReceived_);
+            CPPUNIT_ASSERT_EQUAL(0, static_cast<int>(receivedErrors.size()));
+        }
+
+        void testHandleIQ_TimeoutWithoutTimerFactory() {
+            MyRequest testling(IQ::Get, JID("foo@bar.com/baz"), payload_, router_);
+            testling.setTimeout(1000);
+            testling.send();
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), router_->getPendingResponseCount());
+        }
+
+        void testGetPendingResponseCount() {
+            MyRequest testling(IQ::Get, JID("foo@bar.com/baz"), payload_, router_);
+            testling.onResponse.connect(boost::bind(&RequestTest::handleResponse, this, _1, _2));
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), router_->getPendingResponseCount());
+            testling.send();
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), router_->getPendingResponseCount());
+            channel_->onIQReceived(createResponse(JID("foo@bar.com/other"),"test-id"));
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), router_->getPendingResponseCount());
+            channel_->onIQReceived(createResponse(JID("foo@bar.com/baz"),"test-id"));
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), router_->getPendingResponseCount());
+        }
+
+        void testHandleIQ_SameIDAsOtherRequest() {
+            MyRequest first(IQ::Get, JID("foo@bar.com/baz"), payload_, router_);
+            first.onResponse.connect(boost::bind(&RequestTest::handleOtherResponse, this, _1, _2));
+            first.send();
+            MyRequest second(IQ::Get, JID("foo@bar.com/baz"), payload_, router_);
+            second.onResponse.connect(boost::bind(&RequestTest::handleResponse, this, _1, _2));
+            second.send();
+
+            channel_->onIQReceived(createResponse(JID("foo@bar.com/baz"), "test-id"));
+
+            CPPUNIT_ASSERT_EQUAL(1, responsesReceived_);
+            CPPUNIT_ASSERT_EQUAL(0, otherResponsesReceived_);
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), router_->getPendingResponseCount());
+
+            channel_->onIQReceived(createResponse(JID("foo@bar.com/baz"), "test-id"));
+
+            CPPUNIT_ASSERT_EQUAL(1, responsesReceived_);
+            CPPUNIT_ASSERT_EQUAL(1, otherResponsesReceived_);
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), router_->getPendingResponseCount());
+        }
+
     private:
         void handleResponse(std::shared_ptr<Payload> p, ErrorPayload::ref e) {
             if (e) {
@@ -327,6 +411,11 @@ class RequestTest : public CppUnit::TestFixture {
             }
         }
 
+        void handleOtherResponse(std::shared_ptr<Payload>, ErrorPayload::ref e) {
+            CPPUNIT_ASSERT(!e);
+            ++otherResponsesReceived_;
+        }
+
         void handleDifferentResponse(std::shared_ptr<Payload> p, ErrorPayload::ref e) {
             CPPUNIT_ASSERT(!e);
             CPPUNIT_ASSERT(!p);
@@ -361,6 +450,7 @@ class RequestTest : public CppUnit::TestFixture {
         std::shared_ptr<Payload> payload_;
         std::shared_ptr<Payload> responsePayload_;
         int responsesReceived_;
+        int otherResponsesReceived_;
         std::vector<ErrorPayload> receivedErrors;
 };
 
@@ -1,10 +1,11 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <memory>
+#include <set>
 
 #include <boost/bind.hpp>
 
@@ -23,6 +24,9 @@ class XMPPRosterImplTest : public CppUnit::TestFixture {
         CPPUNIT_TEST(testJIDAdded);
         CPPUNIT_TEST(testJIDRemoved);
         CPPUNIT_TEST(testJIDUpdated);
+        CPPUNIT_TEST(testJIDsAdded);
+        CPPUNIT_TEST(testAddContacts);
+        CPPUNIT_TEST(testGetItems);
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -95,6 +99,56 @@ class XMPPRosterImplTest : public CppUnit::TestFixture {
             CPPUNIT_ASSERT(groups2_ == roster_->getGroupsForJID(jid1_));
         }
 
+        void testJIDsAdded() {
+            roster_->addContact(jid1_, "NewName", groups1_, RosterItemPayload::Both);
+            CPPUNIT_ASSERT_EQUAL(1, handler_->getJIDsAddedCount());
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), handler_->getLastAddedJIDs().size());
+            CPPUNIT_ASSERT_EQUAL(jid1_, handler_->getLastAddedJIDs()[0]);
+            handler_->reset();
+            roster_->addContact(jid1_, "NameTwo", groups1_, RosterItemPayload::Both);
+            CPPUNIT_ASSERT_EQUAL(1, handler_->getJIDsAddedCount());
+        }
+
+        void testAddContacts() {
+            roster_->addContact(jid1_, "NewName", groups1_, RosterItemPayload::Both);
+            handler_->reset();
+            int eventCount = handler_->getEventCount();
+
+            std::vector<XMPPRosterItem> items;
+            items.push_back(XMPPRosterItem(jid1_, "NameOne", groups2_, RosterItemPayload::Both));
+            items.push_back(XMPPRosterItem(jid2_, "NameTwo", groups1_, RosterItemPayload::Both));
+            items.push_back(XMPPRosterItem(jid3_, "NameThree", groups2_, RosterItemPayload::To));
+            roster_->addContacts(items);
+
+            CPPUNIT_ASSERT_EQUAL(eventCount + 3, handler_->getEventCount());
+            CPPUNIT_ASSERT_EQUAL(2, handler_->getJIDsAddedCount());
+            std::vector<JID> added = handler_->getLastAddedJIDs();
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), added.size());
+            CPPUNIT_ASSERT_EQUAL(jid2_, added[0]);
+            CPPUNIT_ASSERT_EQUAL(jid3_, added[1]);
+            CPPUNIT_ASSERT_EQUAL(std::string("NameOne"), roster_->getNameForJID(jid1_));
+            CPPUNIT_ASSERT(groups2_ == roster_->getGroupsForJID(jid1_));
+            CPPUNIT_ASSERT_EQUAL(std::string("NameThree"), roster_->getNameForJID(jid3_));
+            CPPUNIT_ASSERT_EQUAL(RosterItemPayload::To, roster_->getSubscriptionStateForJID(jid3_));
+        }
+
+        void testGetItems() {
+            roster_->addContact(jid3_, "NameThree", groups1_, RosterItemPayload::Both);
+            roster_->addContact(jid1_, "NewName", groups1_, RosterItemPayload::Both);
+            roster_->addContact(jid2_, "NameTwo", groups1_, RosterItemPayload::Both);
+
+            std::vector<XMPPRosterItem> items = roster_->getItems();
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), items.size());
+            std::set<JID> jids;
+            for (const auto& item : items) {
+                jids.insert(item.getJID());
+            }
+            CPPUNIT_ASSERT(jids.count(jid1_));
+            CPPUNIT_ASSERT(jids.count(jid2_));
+            CPPUNIT_ASSERT(jids.count(jid3_));
+        }
+
     private:
         std::unique_ptr<XMPPRosterImpl> roster_;
         std::unique_ptr<XMPPRosterSignalHandler> handler_;
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -41,6 +41,14 @@ public:
         return eventCount;
     }
 
+    std::vector<Swift::JID> getLastAddedJIDs() const {
+        return lastAddedJIDs_;
+    }
+
+    int getJIDsAddedCount() const {
+        return jidsAddedCount_;
+    }
+
 private:
     void handleJIDAdded(const Swift::JID& jid) {
         lastJID_ = jid;
@@ -48,6 +56,11 @@ private:
         eventCount++;
     }
 
+    void handleJIDsAdded(const std::vector<Swift::JID>& jids) {
+        lastAddedJIDs_ = jids;
+        jidsAddedCount_++;
+    }
+
     void handleJIDRemoved(const Swift::JID& jid) {
         lastJID_ = jid;
         lastEvent_ = Remove;
@@ -61,4 +74,6 @@ private:
     std::string lastOldName_;
     std::vector<std::string> lastOldGroups_;
     int eventCount;
+    std::vector<Swift::JID> lastAddedJIDs_;
+    int jidsAddedCount_;
 };
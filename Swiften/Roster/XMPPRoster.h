@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -51,7 +51,7 @@ namespace Swift {
             virtual std::vector<std::string> getGroupsForJID(const JID& jid) = 0;
 
             /**
-             * Retrieve the items in the roster.
+             * Retrieve the items in the roster, in no particular order.
              */
             virtual std::vector<XMPPRosterItem> getItems() const = 0;
 
@@ -71,6 +71,13 @@ namespace Swift {
              */
             boost::signals2::signal<void (const JID&)> onJIDAdded;
 
+            /**
+             * Emitted once with all the JIDs that were added to the roster in one
+             * go (e.g. when the roster is loaded), after onJIDAdded was emitted
+             * for each of them.
+             */
+            boost::signals2::signal<void (const std::vector<JID>&)> onJIDsAdded;
+
             /**
              * Emitted when the given JID is removed from the roster.
              */
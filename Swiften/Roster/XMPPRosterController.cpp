@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -50,25 +50,34 @@ void XMPPRosterController::requestRoster() {
 
 void XMPPRosterController::handleRosterReceived(std::shared_ptr<RosterPayload> rosterPayload, bool initial, std::shared_ptr<RosterPayload> previousRoster) {
     if (rosterPayload) {
+        std::vector<XMPPRosterItem> items;
+        items.reserve(rosterPayload->getItems().size());
         for (const auto& item : rosterPayload->getItems()) {
             //Don't worry about the updated case, the XMPPRoster sorts that out.
             if (item.getSubscription() == RosterItemPayload::Remove) {
+                // Add what came before first, to keep the order of the changes
+                xmppRoster_->addContacts(items);
+                items.clear();
                 xmppRoster_->removeContact(item.getJID());
             } else {
-                xmppRoster_->addContact(item.getJID(), item.getName(), item.getGroups(), item.getSubscription());
+                items.push_back(XMPPRosterItem(item.getJID(), item.getName(), item.getGroups(), item.getSubscription()));
             }
         }
+        xmppRoster_->addContacts(items);
     }
     else if (previousRoster) {
         // The cached version hasn't changed; emit all items
+        std::vector<XMPPRosterItem> items;
+        items.reserve(previousRoster->getItems().size());
         for (const auto& item : previousRoster->getItems()) {
             if (item.getSubscription() != RosterItemPayload::Remove) {
-                xmppRoster_->addContact(item.getJID(), item.getName(), item.getGroups(), item.getSubscription());
+                items.push_back(XMPPRosterItem(item.getJID(), item.getName(), item.getGroups(), item.getSubscription()));
             }
             else {
                 SWIFT_LOG(error) << "Stored invalid roster item" << std::endl;
             }
         }
+        xmppRoster_->addContacts(items);
     }
     if (initial) {
         xmppRoster_->onInitialRosterPopulated();
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -16,22 +16,47 @@ XMPPRosterImpl::~XMPPRosterImpl() {
 }
 
 void XMPPRosterImpl::addContact(const JID& jid, const std::string& name, const std::vector<std::string>& groups, RosterItemPayload::Subscription subscription) {
-    JID bareJID(jid.toBare());
-    std::map<JID, XMPPRosterItem>::iterator i = entries_.find(bareJID);
+    std::vector<JID> added;
+    addOrUpdateContact(XMPPRosterItem(jid, name, groups, subscription), added);
+    if (!added.empty()) {
+        onJIDsAdded(added);
+    }
+}
+
+void XMPPRosterImpl::addContacts(const std::vector<XMPPRosterItem>& items) {
+    size_t size = entries_.size() + items.size();
+    // reserve() can also shrink the table, so only call it to grow
+    if (static_cast<float>(size) > entries_.max_load_factor() * static_cast<float>(entries_.bucket_count())) {
+        entries_.reserve(size);
+    }
+    std::vector<JID> added;
+    added.reserve(items.size());
+    for (const auto& item : items) {
+        addOrUpdateContact(item, added);
+    }
+    if (!added.empty()) {
+        onJIDsAdded(added);
+    }
+}
+
+void XMPPRosterImpl::addOrUpdateContact(const XMPPRosterItem& item, std::vector<JID>& added) {
+    JID bareJID(item.getJID().toBare());
+    RosterMap::iterator i = entries_.find(bareJID);
     if (i != entries_.end()) {
         std::string oldName = i->second.getName();
         std::vector<std::string> oldGroups = i->second.getGroups();
-        i->second = XMPPRosterItem(jid, name, groups, subscription);
+        i->second = item;
         onJIDUpdated(bareJID, oldName, oldGroups);
     }
     else {
-        entries_.insert(std::make_pair(bareJID, XMPPRosterItem(jid, name, groups, subscription)));
+        entries_.insert(std::make_pair(bareJID, item));
         onJIDAdded(bareJID);
+        added.push_back(bareJID);
     }
 }
 
 void XMPPRosterImpl::removeContact(const JID& jid) {
-    entries_.erase(JID(jid.toBare()));
+    entries_.erase(jid.toBare());
     onJIDRemoved(jid);
 }
 
@@ -41,11 +66,11 @@ void XMPPRosterImpl::clear() {
 }
 
 bool XMPPRosterImpl::containsJID(const JID& jid) {
-    return entries_.find(JID(jid.toBare())) != entries_.end();
+    return entries_.find(jid.toBare()) != entries_.end();
 }
 
 std::string XMPPRosterImpl::getNameForJID(const JID& jid) const {
-    std::map<JID, XMPPRosterItem>::const_iterator i = entries_.find(jid.toBare());
+    RosterMap::const_iterator i = entries_.find(jid.toBare());
     if (i != entries_.end()) {
         return i->second.getName();
     }
@@ -55,7 +80,7 @@ std::string XMPPRosterImpl::getNameForJID(const JID& jid) const {
 }
 
 std::vector<std::string> XMPPRosterImpl::getGroupsForJID(const JID& jid) {
-    std::map<JID, XMPPRosterItem>::iterator i = entries_.find(jid.toBare());
+    RosterMap::iterator i = entries_.find(jid.toBare());
     if (i != entries_.end()) {
         return i->second.getGroups();
     }
@@ -65,7 +90,7 @@ std::vector<std::string> XMPPRosterImpl::getGroupsForJID(const JID& jid) {
 }
 
 RosterItemPayload::Subscription XMPPRosterImpl::getSubscriptionStateForJID(const JID& jid) {
-    std::map<JID, XMPPRosterItem>::iterator i = entries_.find(jid.toBare());
+    RosterMap::iterator i = entries_.find(jid.toBare());
     if (i != entries_.end()) {
         return i->second.getSubscription();
     }
@@ -76,6 +101,7 @@ RosterItemPayload::Subscription XMPPRosterImpl::getSubscriptionStateForJID(const
 
 std::vector<XMPPRosterItem> XMPPRosterImpl::getItems() const {
     std::vector<XMPPRosterItem> result;
+    result.reserve(entries_.size());
     for (const auto& entry : entries_) {
         result.push_back(entry.second);
     }
@@ -83,7 +109,7 @@ std::vector<XMPPRosterItem> XMPPRosterImpl::getItems() const {
 }
 
 boost::optional<XMPPRosterItem> XMPPRosterImpl::getItem(const JID& jid) const {
-    std::map<JID, XMPPRosterItem>::const_iterator i = entries_.find(jid.toBare());
+    RosterMap::const_iterator i = entries_.find(jid.toBare());
     if (i != entries_.end()) {
         return i->second;
     }
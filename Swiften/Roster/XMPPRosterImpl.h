@@ -1,13 +1,13 @@
 /*
- * Copyright (c) 2010-2015 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #pragma once
 
-#include <map>
 #include <set>
+#include <unordered_map>
 
 #include <Swiften/Base/API.h>
 #include <Swiften/Roster/XMPPRoster.h>
@@ -19,6 +19,11 @@ namespace Swift {
             virtual ~XMPPRosterImpl();
 
             void addContact(const JID& jid, const std::string& name, const std::vector<std::string>& groups, RosterItemPayload::Subscription subscription);
+            /**
+             * Adds or updates all the given contacts, and emits onJIDsAdded once
+             * for the ones that were new.
+             */
+            void addContacts(const std::vector<XMPPRosterItem>& items);
             void removeContact(const JID& jid);
             void clear();
 
@@ -32,7 +37,10 @@ namespace Swift {
             virtual std::set<std::string> getGroups() const;
 
         private:
-            typedef std::map<JID, XMPPRosterItem> RosterMap;
+            void addOrUpdateContact(const XMPPRosterItem& item, std::vector<JID>& added);
+
+        private:
+            typedef std::unordered_map<JID, XMPPRosterItem> RosterMap;
             RosterMap entries_;
     };
 }
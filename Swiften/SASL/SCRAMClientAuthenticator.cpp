@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2010-2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <Swiften/SASL/SCRAMClientAuthenticator.h>
+
+#include <cassert>
+#include <map>
+
+#include <boost/lexical_cast.hpp>
+
+#include <Swiften/Base/Concat.h>
+#include <Swiften/IDN/IDNConverter.h>
+#include <Swiften/SASL/SCRAMKeyCache.h>
+#include <Swiften/StringCodecs/Base64.h>
+
+namespace Swift {
+
+static std::string escape(const std::string& s) {
+    std::string result;
+    for (char i : s) {
+        if (i == ',') {
+            result += "=2C";
+        }
+        else if (i == '=') {
+            result += "=3D";
+        }
+        else {
+            result += i;
+        }
+    }
+    return result;
+}
+
+
+SCRAMClientAuthenticator::SCRAMClientAuthenticator(CryptoProvider::HashAlgorithm algorithm, const std::string& nonce, bool useChannelBinding, IDNConverter* idnConverter, CryptoProvider* crypto) : ClientAuthenticator(getMechanismName(algorithm, useChannelBinding)), step(Initial), algorithm(algorithm), clientnonce(nonce), iterations(0), useChannelBinding(useChannelBinding), idnConverter(idnConverter), crypto(crypto) {
+}
+
+std::string SCRAMClientAuthenticator::getMechanismName(CryptoProvider::HashAlgorithm algorithm, bool useChannelBinding) {
+    std::string name;
+    switch (algorithm) {
+        case CryptoProvider::HashAlgorithm::SHA1: name = "SCRAM-SHA-1"; break;
+        case CryptoProvider::HashAlgorithm::SHA256: name = "SCRAM-SHA-256"; break;
+        case CryptoProvider::HashAlgorithm::SHA512: name = "SCRAM-SHA-512"; break;
+    }
+    return useChannelBinding ? name + "-PLUS" : name;
+}
+
+boost::optional<SafeByteArray> SCRAMClientAuthenticator::getResponse() const {
+    if (step == Initial) {
+        return createSafeByteArray(concat(getGS2Header(), getInitialBareClientMessage()));
+    }
+    else if (step == Proof) {
+        ByteArray storedKey = crypto->getHash(algorithm, clientKey);
+        ByteArray clientSignature = crypto->getHMAC(algorithm, createSafeByteArray(storedKey), authMessage);
+        ByteArray clientProof(clientKey.begin(), clientKey.end());
+        for (unsigned int i = 0; i < clientProof.size(); ++i) {
+            clientProof[i] ^= clientSignature[i];
+        }
+        ByteArray result = concat(getFinalMessageWithoutProof(), createByteArray(",p="), createByteArray(Base64::encode(clientProof)));
+        return createSafeByteArray(result);
+    }
+    else {
+        return boost::optional<SafeByteArray>();
+    }
+}
+
+bool SCRAMClientAuthenticator::setChallenge(const boost::optional<ByteArray>& challenge) {
+    if (step == Initial) {
+        if (!challenge) {
+            return false;
+        }
+        initialServerMessage = *challenge;
+
+        std::map<char, std::string> keys = parseMap(byteArrayToString(initialServerMessage));
+
+        // Extract the salt
+        salt = Base64::decode(keys['s']);
+
+        // Extract the server nonce
+        std::string clientServerNonce = keys['r'];
+        if (clientServerNonce.size() <= clientnonce.size()) {
+            return false;
+        }
+        std::string receivedClientNonce = clientServerNonce.substr(0, clientnonce.size());
+        if (receivedClientNonce != clientnonce) {
+            return false;
+        }
+        serverNonce = createByteArray(clientServerNonce.substr(clientnonce.size(), clientServerNonce.npos));
+
+        // Extract the number of iterations
+        try {
+            iterations = boost::lexical_cast<int>(keys['i']);
+        }
+        catch (const boost::bad_lexical_cast&) {
+            return false;
+        }
+        if (iterations <= 0) {
+            return false;
+        }
+
+        // Compute all the values needed for the server signature
+        deriveKeys();
+        authMessage = concat(getInitialBareClientMessage(), createByteArray(","), initialServerMessage, createByteArray(","), getFinalMessageWithoutProof());
+        serverSignature = crypto->getHMAC(algorithm, serverKey, authMessage);
+
+        step = Proof;
+        return true;
+    }
+    else if (step == Proof) {
+        ByteArray result = concat(createByteArray("v="), createByteArray(Base64::encode(serverSignature)));
+        step = Final;
+        bool verified = challenge && challenge == result;
+        if (keyCache) {
+            if (verified) {
+                keyCache->setKeys(algorithm, getAuthenticationID(), preparedPassword, salt, iterations, SCRAMKeyCache::Keys{clientKey, serverKey});
+            }
+            else {
+                keyCache->removeKeys(algorithm, getAuthenticationID());
+            }
+        }
+        return verified;
+    }
+    else {
+        return true;
+    }
+}
+
+void SCRAMClientAuthenticator::deriveKeys() {
+    preparedPassword.clear();
+    try {
+        preparedPassword = idnConverter->getStringPrepared(getPassword(), IDNConverter::SASLPrep);
+    }
+    catch (const std::exception&) {
+    }
+
+    if (keyCache) {
+        if (boost::optional<SCRAMKeyCache::Keys> cachedKeys = keyCache->getKeys(algorithm, getAuthenticationID(), preparedPassword, salt, iterations)) {
+            clientKey = cachedKeys->clientKey;
+            serverKey = cachedKeys->serverKey;
+            return;
+        }
+    }
+
+    SafeByteArray saltedPassword = createSafeByteArray(crypto->getPBKDF2(algorithm, preparedPassword, salt, iterations));
+    clientKey = createSafeByteArray(crypto->getHMAC(algorithm, saltedPassword, createByteArray("Client Key")));
+    serverKey = createSafeByteArray(crypto->getHMAC(algorithm, saltedPassword, createByteArray("Server Key")));
+}
+
+std::map<char, std::string> SCRAMClientAuthenticator::parseMap(const std::string& s) {
+    std::map<char, std::string> result;
+    if (s.size() > 0) {
+        char key = 0;
+        std::string value;
+        size_t i = 0;
+        bool expectKey = true;
+        while (i < s.size()) {
+            if (expectKey) {
+                key = s[i];
+                expectKey = false;
+                i++;
+            }
+            else if (s[i] == ',') {
+                result[key] = value;
+                value = "";
+                expectKey = true;
+            }
+            else {
+                value += s[i];
+            }
+            i++;
+        }
+        result[key] = value;
+    }
+    return result;
+}
+
+ByteArray SCRAMClientAuthenticator::getInitialBareClientMessage() const {
+    std::string authenticationID;
+    try {
+        authenticationID = idnConverter->getStringPrepared(getAuthenticationID(), IDNConverter::SASLPrep);
+    }
+    catch (const std::exception&) {
+    }
+    return createByteArray(std::string("n=" + escape(authenticationID) + ",r=" + clientnonce));
+}
+
+ByteArray SCRAMClientAuthenticator::getGS2Header() const {
+    ByteArray channelBindingHeader(createByteArray("n"));
+    if (tlsChannelBindingData) {
+        if (useChannelBinding) {
+            channelBindingHeader = createByteArray("p=tls-unique");
+        }
+        else {
+            channelBindingHeader = createByteArray("y");
+        }
+    }
+    return concat(channelBindingHeader, createByteArray(","), (getAuthorizationID().empty() ? ByteArray() : createByteArray("a=" + escape(getAuthorizationID()))), createByteArray(","));
+}
+
+void SCRAMClientAuthenticator::setTLSChannelBindingData(const ByteArray& channelBindingData) {
+    this->tlsChannelBindingData = channelBindingData;
+}
+
+void SCRAMClientAuthenticator::setKeyCache(std::shared_ptr<SCRAMKeyCache> keyCache) {
+    this->keyCache = keyCache;
+}
+
+ByteArray SCRAMClientAuthenticator::getFinalMessageWithoutProof() const {
+    ByteArray channelBindData;
+    if (useChannelBinding && tlsChannelBindingData) {
+        channelBindData = *tlsChannelBindingData;
+    }
+    return concat(createByteArray("c=" + Base64::encode(concat(getGS2Header(), channelBindData)) + ",r=" + clientnonce), serverNonce);
+}
+
+
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2010-2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include <boost/optional.hpp>
+
+#include <Swiften/Base/API.h>
+#include <Swiften/Base/ByteArray.h>
+#include <Swiften/Crypto/CryptoProvider.h>
+#include <Swiften/SASL/ClientAuthenticator.h>
+
+namespace Swift {
+    class IDNConverter;
+    class SCRAMKeyCache;
+
+    /**
+     * SCRAM (RFC 5802) with SHA-1, SHA-256 (RFC 7677) or SHA-512.
+     */
+    class SWIFTEN_API SCRAMClientAuthenticator : public ClientAuthenticator {
+        public:
+            SCRAMClientAuthenticator(CryptoProvider::HashAlgorithm algorithm, const std::string& nonce, bool useChannelBinding, IDNConverter*, CryptoProvider*);
+
+            void setTLSChannelBindingData(const ByteArray& channelBindingData);
+
+            /**
+             * Takes the ClientKey and ServerKey from \p keyCache if they were
+             * derived before, and stores them there once the server has proven
+             * it knows them.
+             */
+            void setKeyCache(std::shared_ptr<SCRAMKeyCache> keyCache);
+
+            virtual boost::optional<SafeByteArray> getResponse() const;
+            virtual bool setChallenge(const boost::optional<ByteArray>&);
+
+            static std::string getMechanismName(CryptoProvider::HashAlgorithm algorithm, bool useChannelBinding);
+
+        private:
+            ByteArray getInitialBareClientMessage() const;
+            ByteArray getGS2Header() const;
+            ByteArray getFinalMessageWithoutProof() const;
+            void deriveKeys();
+
+            static std::map<char, std::string> parseMap(const std::string&);
+
+        private:
+            enum Step {
+                Initial,
+                Proof,
+                Final
+            } step;
+            CryptoProvider::HashAlgorithm algorithm;
+            std::string clientnonce;
+            ByteArray initialServerMessage;
+            ByteArray serverNonce;
+            ByteArray authMessage;
+            ByteArray salt;
+            int iterations;
+            SafeByteArray preparedPassword;
+            SafeByteArray clientKey;
+            SafeByteArray serverKey;
+            ByteArray serverSignature;
+            bool useChannelBinding;
+            IDNConverter* idnConverter;
+            CryptoProvider* crypto;
+            boost::optional<ByteArray> tlsChannelBindingData;
+            std::shared_ptr<SCRAMKeyCache> keyCache;
+    };
+}
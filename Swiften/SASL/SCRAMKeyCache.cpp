@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <Swiften/SASL/SCRAMKeyCache.h>
+
+namespace Swift {
+
+namespace {
+    // Doesn't stop at the first difference, so the time taken doesn't tell
+    // how much of the password matched.
+    bool equalsInConstantTime(const SafeByteArray& a, const SafeByteArray& b) {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        unsigned char difference = 0;
+        for (size_t i = 0; i < a.size(); ++i) {
+            difference |= static_cast<unsigned char>(a[i] ^ b[i]);
+        }
+        return difference == 0;
+    }
+}
+
+boost::optional<SCRAMKeyCache::Keys> SCRAMKeyCache::getKeys(CryptoProvider::HashAlgorithm algorithm, const std::string& authenticationID, const SafeByteArray& password, const ByteArray& salt, int iterations) const {
+    auto i = entries.find(std::make_pair(algorithm, authenticationID));
+    if (i == entries.end() || i->second.salt != salt || i->second.iterations != iterations || !equalsInConstantTime(i->second.password, password)) {
+        return boost::optional<Keys>();
+    }
+    return i->second.keys;
+}
+
+void SCRAMKeyCache::setKeys(CryptoProvider::HashAlgorithm algorithm, const std::string& authenticationID, const SafeByteArray& password, const ByteArray& salt, int iterations, const Keys& keys) {
+    // Only the keys for the latest salt are kept; the server will not use an older one again.
+    Entry& entry = entries[std::make_pair(algorithm, authenticationID)];
+    entry.password = password;
+    entry.salt = salt;
+    entry.iterations = iterations;
+    entry.keys = keys;
+}
+
+void SCRAMKeyCache::removeKeys(CryptoProvider::HashAlgorithm algorithm, const std::string& authenticationID) {
+    entries.erase(std::make_pair(algorithm, authenticationID));
+}
+
+void SCRAMKeyCache::clear() {
+    entries.clear();
+}
+
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <utility>
+
+#include <boost/optional.hpp>
+
+#include <Swiften/Base/API.h>
+#include <Swiften/Base/ByteArray.h>
+#include <Swiften/Base/SafeByteArray.h>
+#include <Swiften/Crypto/CryptoProvider.h>
+
+namespace Swift {
+    /**
+     * Remembers the ClientKey and ServerKey that SCRAM derives from a password,
+     * so authenticating again with the same salt and iteration count doesn't
+     * have to repeat the (deliberately slow) key derivation.
+     *
+     * Keys are stored per hash algorithm and authentication ID, together with
+     * the (SASLprep'ed) password they were derived from, so they are only
+     * handed out for the same password. The password is compared in constant
+     * time, and nothing derived from it more cheaply than the keys themselves
+     * is kept. Passwords and keys are held in SafeByteArrays, since they allow
+     * authenticating as the user.
+     */
+    class SWIFTEN_API SCRAMKeyCache {
+        public:
+            struct Keys {
+                SafeByteArray clientKey;
+                SafeByteArray serverKey;
+            };
+
+        public:
+            boost::optional<Keys> getKeys(CryptoProvider::HashAlgorithm algorithm, const std::string& authenticationID, const SafeByteArray& password, const ByteArray& salt, int iterations) const;
+            void setKeys(CryptoProvider::HashAlgorithm algorithm, const std::string& authenticationID, const SafeByteArray& password, const ByteArray& salt, int iterations, const Keys& keys);
+            void removeKeys(CryptoProvider::HashAlgorithm algorithm, const std::string& authenticationID);
+            void clear();
+
+        private:
+            struct Entry {
+                SafeByteArray password;
+                ByteArray salt;
+                int iterations;
+                Keys keys;
+            };
+
+            std::map<std::pair<CryptoProvider::HashAlgorithm, std::string>, Entry> entries;
+    };
+}
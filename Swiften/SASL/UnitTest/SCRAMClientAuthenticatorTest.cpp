@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <memory>
+
+#include <QA/Checker/IO.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+
+#include <Swiften/Base/ByteArray.h>
+#include <Swiften/Crypto/CryptoProvider.h>
+#include <Swiften/Crypto/PlatformCryptoProvider.h>
+#include <Swiften/IDN/IDNConverter.h>
+#include <Swiften/IDN/PlatformIDNConverter.h>
+#include <Swiften/SASL/SCRAMClientAuthenticator.h>
+#include <Swiften/SASL/SCRAMKeyCache.h>
+
+using namespace Swift;
+
+namespace {
+    class CountingCryptoProvider : public CryptoProvider {
+        public:
+            CountingCryptoProvider(CryptoProvider* crypto) : crypto(crypto) {
+            }
+
+            virtual Hash* createSHA1() override { return crypto->createSHA1(); }
+            virtual Hash* createMD5() override { return crypto->createMD5(); }
+            virtual Hash* createSHA256() override { return crypto->createSHA256(); }
+            virtual Hash* createSHA512() override { return crypto->createSHA512(); }
+            virtual ByteArray getHMACSHA1(const SafeByteArray& key, const ByteArray& data) override { return crypto->getHMACSHA1(key, data); }
+            virtual ByteArray getHMACSHA1(const ByteArray& key, const ByteArray& data) override { return crypto->getHMACSHA1(key, data); }
+            virtual bool isMD5AllowedForCrypto() const override { return crypto->isMD5AllowedForCrypto(); }
+
+            virtual ByteArray getPBKDF2(HashAlgorithm algorithm, const SafeByteArray& password, const ByteArray& salt, int iterations) override {
+                ++pbkdf2Count;
+                return crypto->getPBKDF2(algorithm, password, salt, iterations);
+            }
+
+            CryptoProvider* crypto;
+            int pbkdf2Count = 0;
+    };
+}
+
+class SCRAMClientAuthenticatorTest : public CppUnit::TestFixture {
+        CPPUNIT_TEST_SUITE(SCRAMClientAuthenticatorTest);
+        CPPUNIT_TEST(testGetName);
+        CPPUNIT_TEST(testSHA256);
+        CPPUNIT_TEST(testSHA512);
+        CPPUNIT_TEST(testKeyCache_KeysAreReused);
+        CPPUNIT_TEST(testKeyCache_OtherSalt);
+        CPPUNIT_TEST(testKeyCache_OtherPassword);
+        CPPUNIT_TEST(testKeyCache_InvalidServerSignature);
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+        void setUp() {
+            idnConverter = std::shared_ptr<IDNConverter>(PlatformIDNConverter::create());
+            platformCrypto = std::shared_ptr<CryptoProvider>(PlatformCryptoProvider::create());
+            crypto = std::make_shared<CountingCryptoProvider>(platformCrypto.get());
+            keyCache = std::make_shared<SCRAMKeyCache>();
+        }
+
+        void testGetName() {
+            CPPUNIT_ASSERT_EQUAL(std::string("SCRAM-SHA-1"), SCRAMClientAuthenticator(CryptoProvider::HashAlgorithm::SHA1, "abcdefgh", false, idnConverter.get(), crypto.get()).getName());
+            CPPUNIT_ASSERT_EQUAL(std::string("SCRAM-SHA-256-PLUS"), SCRAMClientAuthenticator(CryptoProvider::HashAlgorithm::SHA256, "abcdefgh", true, idnConverter.get(), crypto.get()).getName());
+            CPPUNIT_ASSERT_EQUAL(std::string("SCRAM-SHA-512"), SCRAMClientAuthenticator(CryptoProvider::HashAlgorithm::SHA512, "abcdefgh", false, idnConverter.get(), crypto.get()).getName());
+        }
+
+        // Example from RFC 7677
+        void testSHA256() {
+            if (!crypto->isHashAlgorithmSupported(CryptoProvider::HashAlgorithm::SHA256)) {
+                return;
+            }
+            SCRAMClientAuthenticator testling(CryptoProvider::HashAlgorithm::SHA256, "rOprNGfwEbeRWgbNEkqO", false, idnConverter.get(), crypto.get());
+            testling.setCredentials("user", createSafeByteArray("pencil"), "");
+
+            CPPUNIT_ASSERT_EQUAL(createSafeByteArray("n,,n=user,r=rOprNGfwEbeRWgbNEkqO"), *testling.getResponse());
+            CPPUNIT_ASSERT(testling.setChallenge(createByteArray("r=rOprNGfwEbeRWgbNEkqO%hvYDpWUa2RaTCAfuxFIlj)hNlF$k0,s=W22ZaJ0SNY7soEsUEjb6gQ==,i=4096")));
+            CPPUNIT_ASSERT_EQUAL(createSafeByteArray("c=biws,r=rOprNGfwEbeRWgbNEkqO%hvYDpWUa2RaTCAfuxFIlj)hNlF$k0,p=dHzbZapWIk4jUhN+Ute9ytag9zjfMHgsqmmiz7AndVQ="), *testling.getResponse());
+            CPPUNIT_ASSERT(testling.setChallenge(createByteArray("v=6rriTRBi23WpRR/wtup+mMhUZUn/dB5nLTJRsjl95G4=")));
+        }
+
+        void testSHA512() {
+            if (!crypto->isHashAlgorithmSupported(CryptoProvider::HashAlgorithm::SHA512)) {
+                return;
+            }
+            SCRAMClientAuthenticator testling(CryptoProvider::HashAlgorithm::SHA512, "rOprNGfwEbeRWgbNEkqO", false, idnConverter.get(), crypto.get());
+            testling.setCredentials("user", createSafeByteArray("pencil"), "");
+
+            CPPUNIT_ASSERT(testling.setChallenge(createByteArray("r=rOprNGfwEbeRWgbNEkqO%hvYDpWUa2RaTCAfuxFIlj)hNlF$k0,s=W22ZaJ0SNY7soEsUEjb6gQ==,i=4096")));
+            CPPUNIT_ASSERT_EQUAL(createSafeByteArray("c=biws,r=rOprNGfwEbeRWgbNEkqO%hvYDpWUa2RaTCAfuxFIlj)hNlF$k0,p=gMGXRcevScNtxZ6/8lQYpGtnsNAc3mGcmNomv+xnoOMw+3R2xNJdMNnzMlTN8PPC6wdp6dybEmDYXYTxwnYPJQ=="), *testling.getResponse());
+            CPPUNIT_ASSERT(testling.setChallenge(createByteArray("v=ZQnYEgWQMFmmsM8aQMF0nDDCy/AgCzkwk8CmMZYcMg0vSVlKDanekLtifDSeVGT4+5ZxXnJq199RVG2rR7N7Zw==")));
+        }
+
+        void testKeyCache_KeysAreReused() {
+            authenticate("pencil", "W22ZaJ0SNY7soEsUEjb6gQ==", true);
+            authenticate("pencil", "W22ZaJ0SNY7soEsUEjb6gQ==", true);
+
+            CPPUNIT_ASSERT_EQUAL(1, crypto->pbkdf2Count);
+        }
+
+        void testKeyCache_OtherSalt() {
+            authenticate("pencil", "W22ZaJ0SNY7soEsUEjb6gQ==", true);
+            authenticate("pencil", "MTIzNDU2NzgK", false);
+
+            CPPUNIT_ASSERT_EQUAL(2, crypto->pbkdf2Count);
+        }
+
+        void testKeyCache_OtherPassword() {
+            authenticate("pencil", "W22ZaJ0SNY7soEsUEjb6gQ==", true);
+            authenticate("crayon", "W22ZaJ0SNY7soEsUEjb6gQ==", false);
+
+            CPPUNIT_ASSERT_EQUAL(2, crypto->pbkdf2Count);
+        }
+
+        void testKeyCache_InvalidServerSignature() {
+            authenticate("crayon", "W22ZaJ0SNY7soEsUEjb6gQ==", false);
+            authenticate("crayon", "W22ZaJ0SNY7soEsUEjb6gQ==", false);
+
+            CPPUNIT_ASSERT_EQUAL(2, crypto->pbkdf2Count);
+        }
+
+    private:
+        /**
+         * Runs the SCRAM-SHA-1 equivalent of the RFC 7677 example. The server
+         * signature only matches for the password and salt of the example.
+         */
+        void authenticate(const std::string& password, const std::string& salt, bool expectSuccess) {
+            SCRAMClientAuthenticator testling(CryptoProvider::HashAlgorithm::SHA1, "rOprNGfwEbeRWgbNEkqO", false, idnConverter.get(), crypto.get());
+            testling.setKeyCache(keyCache);
+            testling.setCredentials("user", createSafeByteArray(password), "");
+            testling.getResponse();
+            CPPUNIT_ASSERT(testling.setChallenge(createByteArray("r=rOprNGfwEbeRWgbNEkqO%hvYDpWUa2RaTCAfuxFIlj)hNlF$k0,s=" + salt + ",i=4096")));
+            testling.getResponse();
+            CPPUNIT_ASSERT_EQUAL(expectSuccess, testling.setChallenge(createByteArray("v=Tq1dKKdFondzApGMADAzcCNmCr4=")));
+        }
+
+    private:
+        std::shared_ptr<IDNConverter> idnConverter;
+        std::shared_ptr<CryptoProvider> platformCrypto;
+        std::shared_ptr<CountingCryptoProvider> crypto;
+        std::shared_ptr<SCRAMKeyCache> keyCache;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SCRAMClientAuthenticatorTest);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -10,6 +10,7 @@
 
 #include <Swiften/Base/API.h>
 #include <Swiften/Serializer/PayloadSerializer.h>
+#include <Swiften/Serializer/XML/XMLWriter.h>
 
 namespace Swift {
     template<typename PAYLOAD_TYPE>
@@ -19,10 +20,18 @@ namespace Swift {
                 return serializePayload(std::dynamic_pointer_cast<PAYLOAD_TYPE>(element));
             }
 
+            virtual void write(std::shared_ptr<Payload> element, XMLWriter& writer) const {
+                writePayload(std::dynamic_pointer_cast<PAYLOAD_TYPE>(element), writer);
+            }
+
             virtual bool canSerialize(std::shared_ptr<Payload> element) const {
                 return !!std::dynamic_pointer_cast<PAYLOAD_TYPE>(element);
             }
 
             virtual std::string serializePayload(std::shared_ptr<PAYLOAD_TYPE>) const = 0;
+
+            virtual void writePayload(std::shared_ptr<PAYLOAD_TYPE> payload, XMLWriter& writer) const {
+                writer.writeRaw(serializePayload(payload));
+            }
     };
 }
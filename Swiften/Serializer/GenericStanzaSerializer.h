@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -21,13 +21,13 @@ namespace Swift {
 
             virtual void setStanzaSpecificAttributes(
                     std::shared_ptr<ToplevelElement> stanza,
-                    XMLElement& element) const {
+                    XMLWriter& writer) const {
                 setStanzaSpecificAttributesGeneric(
-                        std::dynamic_pointer_cast<STANZA_TYPE>(stanza), element);
+                        std::dynamic_pointer_cast<STANZA_TYPE>(stanza), writer);
             }
 
             virtual void setStanzaSpecificAttributesGeneric(
                     std::shared_ptr<STANZA_TYPE>,
-                    XMLElement&) const = 0;
+                    XMLWriter&) const = 0;
     };
 }
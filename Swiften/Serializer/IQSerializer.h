@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -11,7 +11,7 @@
 #include <Swiften/Base/API.h>
 #include <Swiften/Elements/IQ.h>
 #include <Swiften/Serializer/GenericStanzaSerializer.h>
-#include <Swiften/Serializer/XML/XMLElement.h>
+#include <Swiften/Serializer/XML/XMLWriter.h>
 
 namespace Swift {
     class SWIFTEN_API IQSerializer : public GenericStanzaSerializer<IQ> {
@@ -23,12 +23,12 @@ namespace Swift {
         private:
             virtual void setStanzaSpecificAttributesGeneric(
                     std::shared_ptr<IQ> iq,
-                    XMLElement& element) const {
+                    XMLWriter& writer) const {
                 switch (iq->getType()) {
-                    case IQ::Get: element.setAttribute("type","get"); break;
-                    case IQ::Set: element.setAttribute("type","set"); break;
-                    case IQ::Result: element.setAttribute("type","result"); break;
-                    case IQ::Error: element.setAttribute("type","error"); break;
+                    case IQ::Get: writer.addAttribute("type","get"); break;
+                    case IQ::Set: writer.addAttribute("type","set"); break;
+                    case IQ::Result: writer.addAttribute("type","result"); break;
+                    case IQ::Error: writer.addAttribute("type","error"); break;
                 }
             }
     };
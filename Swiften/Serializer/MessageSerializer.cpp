@@ -1,12 +1,12 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <Swiften/Serializer/MessageSerializer.h>
 
-#include <Swiften/Serializer/XML/XMLElement.h>
+#include <Swiften/Serializer/XML/XMLWriter.h>
 
 namespace Swift {
 
@@ -16,18 +16,18 @@ MessageSerializer::MessageSerializer(PayloadSerializerCollection* payloadSeriali
 
 void MessageSerializer::setStanzaSpecificAttributesGeneric(
         std::shared_ptr<Message> message,
-        XMLElement& element) const {
+        XMLWriter& writer) const {
     if (message->getType() == Message::Chat) {
-        element.setAttribute("type", "chat");
+        writer.addAttribute("type", "chat");
     }
     else if (message->getType() == Message::Groupchat) {
-        element.setAttribute("type", "groupchat");
+        writer.addAttribute("type", "groupchat");
     }
     else if (message->getType() == Message::Headline) {
-        element.setAttribute("type", "headline");
+        writer.addAttribute("type", "headline");
     }
     else if (message->getType() == Message::Error) {
-        element.setAttribute("type", "error");
+        writer.addAttribute("type", "error");
     }
 }
 
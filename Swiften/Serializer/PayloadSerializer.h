@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -13,6 +13,7 @@
 
 namespace Swift {
     class Payload;
+    class XMLWriter;
 
     class SWIFTEN_API PayloadSerializer {
         public:
@@ -20,5 +21,14 @@ namespace Swift {
 
             virtual bool canSerialize(std::shared_ptr<Payload>) const = 0;
             virtual std::string serialize(std::shared_ptr<Payload>) const = 0;
+
+            /**
+             * Appends the serialized payload to the writer.
+             *
+             * The default implementation appends the result of serialize().
+             * Serializers that can write straight into the writer should
+             * override this.
+             */
+            virtual void write(std::shared_ptr<Payload>, XMLWriter&) const;
     };
 }
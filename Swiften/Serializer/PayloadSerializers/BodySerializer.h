@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -9,7 +9,7 @@
 #include <Swiften/Base/API.h>
 #include <Swiften/Elements/Body.h>
 #include <Swiften/Serializer/GenericPayloadSerializer.h>
-#include <Swiften/Serializer/XML/XMLTextNode.h>
+#include <Swiften/Serializer/XML/XMLWriter.h>
 
 namespace Swift {
     class SWIFTEN_API BodySerializer : public GenericPayloadSerializer<Body> {
@@ -17,8 +17,13 @@ namespace Swift {
             BodySerializer() : GenericPayloadSerializer<Body>() {}
 
             virtual std::string serializePayload(std::shared_ptr<Body> body)  const {
-                XMLTextNode textNode(body->getText());
-                return "<body>" + textNode.serialize() + "</body>";
+                XMLWriter writer;
+                writePayload(body, writer);
+                return writer.getBuffer();
+            }
+
+            virtual void writePayload(std::shared_ptr<Body> body, XMLWriter& writer) const {
+                writer.writeTextElement("body", body->getText());
             }
     };
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -8,7 +8,7 @@
 
 #include <memory>
 
-#include <Swiften/Serializer/XML/XMLElement.h>
+#include <Swiften/Serializer/XML/XMLWriter.h>
 
 namespace Swift {
 
@@ -16,11 +16,17 @@ CapsInfoSerializer::CapsInfoSerializer() : GenericPayloadSerializer<CapsInfo>()
 }
 
 std::string CapsInfoSerializer::serializePayload(std::shared_ptr<CapsInfo> capsInfo)  const {
-    XMLElement capsElement("c", "http://jabber.org/protocol/caps");
-    capsElement.setAttribute("node", capsInfo->getNode());
-    capsElement.setAttribute("hash", capsInfo->getHash());
-    capsElement.setAttribute("ver", capsInfo->getVersion());
-    return capsElement.serialize();
+    XMLWriter writer;
+    writePayload(capsInfo, writer);
+    return writer.getBuffer();
+}
+
+void CapsInfoSerializer::writePayload(std::shared_ptr<CapsInfo> capsInfo, XMLWriter& writer) const {
+    writer.startElement("c", "http://jabber.org/protocol/caps");
+    writer.addAttribute("node", capsInfo->getNode());
+    writer.addAttribute("hash", capsInfo->getHash());
+    writer.addAttribute("ver", capsInfo->getVersion());
+    writer.endElement();
 }
 
 }
@@ -1,27 +1,35 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <Swiften/Serializer/PayloadSerializers/ChatStateSerializer.h>
 
+#include <Swiften/Serializer/XML/XMLWriter.h>
+
 namespace Swift {
 
 ChatStateSerializer::ChatStateSerializer() : GenericPayloadSerializer<ChatState>() {
 }
 
 std::string ChatStateSerializer::serializePayload(std::shared_ptr<ChatState> chatState)  const {
-    std::string result("<");
+    XMLWriter writer;
+    writePayload(chatState, writer);
+    return writer.getBuffer();
+}
+
+void ChatStateSerializer::writePayload(std::shared_ptr<ChatState> chatState, XMLWriter& writer) const {
+    std::string tag;
     switch (chatState->getChatState()) {
-        case ChatState::Active: result += "active"; break;
-        case ChatState::Composing: result += "composing"; break;
-        case ChatState::Paused: result += "paused"; break;
-        case ChatState::Inactive: result += "inactive"; break;
-        case ChatState::Gone: result += "gone"; break;
+        case ChatState::Active: tag = "active"; break;
+        case ChatState::Composing: tag = "composing"; break;
+        case ChatState::Paused: tag = "paused"; break;
+        case ChatState::Inactive: tag = "inactive"; break;
+        case ChatState::Gone: tag = "gone"; break;
     }
-    result += " xmlns=\"http://jabber.org/protocol/chatstates\"/>";
-    return result;
+    writer.startElement(tag, "http://jabber.org/protocol/chatstates");
+    writer.endElement();
 }
 
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -12,7 +12,7 @@
 
 #include <Swiften/Base/DateTime.h>
 #include <Swiften/Base/String.h>
-#include <Swiften/Serializer/XML/XMLElement.h>
+#include <Swiften/Serializer/XML/XMLWriter.h>
 
 namespace Swift {
 
@@ -20,12 +20,18 @@ DelaySerializer::DelaySerializer() : GenericPayloadSerializer<Delay>() {
 }
 
 std::string DelaySerializer::serializePayload(std::shared_ptr<Delay> delay)  const {
-    XMLElement delayElement("delay", "urn:xmpp:delay");
+    XMLWriter writer;
+    writePayload(delay, writer);
+    return writer.getBuffer();
+}
+
+void DelaySerializer::writePayload(std::shared_ptr<Delay> delay, XMLWriter& writer) const {
+    writer.startElement("delay", "urn:xmpp:delay");
     if (delay->getFrom() && delay->getFrom()->isValid()) {
-        delayElement.setAttribute("from", delay->getFrom()->toString());
+        writer.addAttribute("from", delay->getFrom()->toString());
     }
-    delayElement.setAttribute("stamp", dateTimeToString(delay->getStamp()));
-    return delayElement.serialize();
+    writer.addAttribute("stamp", dateTimeToString(delay->getStamp()));
+    writer.endElement();
 }
 
 }
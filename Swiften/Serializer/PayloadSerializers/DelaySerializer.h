@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -16,6 +16,7 @@ namespace Swift {
             DelaySerializer();
 
             virtual std::string serializePayload(std::shared_ptr<Delay>)  const;
+            virtual void writePayload(std::shared_ptr<Delay>, XMLWriter&) const;
     };
 }
 
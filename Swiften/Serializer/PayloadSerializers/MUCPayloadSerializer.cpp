@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -12,8 +12,7 @@
 #include <boost/lexical_cast.hpp>
 
 #include <Swiften/Base/String.h>
-#include <Swiften/Serializer/XML/XMLElement.h>
-#include <Swiften/Serializer/XML/XMLTextNode.h>
+#include <Swiften/Serializer/XML/XMLWriter.h>
 
 namespace Swift {
 
@@ -21,38 +20,37 @@ MUCPayloadSerializer::MUCPayloadSerializer() : GenericPayloadSerializer<MUCPaylo
 }
 
 std::string MUCPayloadSerializer::serializePayload(std::shared_ptr<MUCPayload> muc)  const {
-    XMLElement mucElement("x", "http://jabber.org/protocol/muc");
-    std::shared_ptr<XMLElement> historyElement(new XMLElement("history"));
-    bool history = false;
-    if (muc->getMaxChars() >= 0) {
-        historyElement->setAttribute("maxchars", boost::lexical_cast<std::string>(muc->getMaxChars()));
-        history = true;
-    }
-    if (muc->getMaxStanzas() >= 0) {
-        historyElement->setAttribute("maxstanzas", boost::lexical_cast<std::string>(muc->getMaxStanzas()));
-        history = true;
-    }
-    if (muc->getSeconds() >= 0) {
-        historyElement->setAttribute("seconds", boost::lexical_cast<std::string>(muc->getSeconds()));
-        history = true;
-    }
-    if (muc->getSince() != boost::posix_time::not_a_date_time) {
-        std::string sinceString = std::string(boost::posix_time::to_iso_extended_string(muc->getSince()));
-        String::replaceAll(sinceString, ',', ".");
-        sinceString += "Z";
-        historyElement->setAttribute("since", sinceString);
-        history = true;
-    }
+    XMLWriter writer;
+    writePayload(muc, writer);
+    return writer.getBuffer();
+}
+
+void MUCPayloadSerializer::writePayload(std::shared_ptr<MUCPayload> muc, XMLWriter& writer) const {
+    writer.startElement("x", "http://jabber.org/protocol/muc");
     if (muc->getPassword()) {
-        std::string password = *muc->getPassword();
-        std::shared_ptr<XMLElement> passwordElement(new XMLElement("password"));
-        passwordElement->addNode(std::make_shared<XMLTextNode>(password));
-        mucElement.addNode(passwordElement);
+        writer.writeTextElement("password", *muc->getPassword());
     }
+    bool history = muc->getMaxChars() >= 0 || muc->getMaxStanzas() >= 0 || muc->getSeconds() >= 0 || muc->getSince() != boost::posix_time::not_a_date_time;
     if (history) {
-        mucElement.addNode(historyElement);
+        writer.startElement("history");
+        if (muc->getMaxChars() >= 0) {
+            writer.addAttribute("maxchars", boost::lexical_cast<std::string>(muc->getMaxChars()));
+        }
+        if (muc->getMaxStanzas() >= 0) {
+            writer.addAttribute("maxstanzas", boost::lexical_cast<std::string>(muc->getMaxStanzas()));
+        }
+        if (muc->getSeconds() >= 0) {
+            writer.addAttribute("seconds", boost::lexical_cast<std::string>(muc->getSeconds()));
+        }
+        if (muc->getSince() != boost::posix_time::not_a_date_time) {
+            std::string sinceString = std::string(boost::posix_time::to_iso_extended_string(muc->getSince()));
+            String::replaceAll(sinceString, ',', ".");
+            sinceString += "Z";
+            writer.addAttribute("since", sinceString);
+        }
+        writer.endElement();
     }
-    return mucElement.serialize();
+    writer.endElement();
 }
 
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -15,6 +15,7 @@ namespace Swift {
         public:
             MUCPayloadSerializer();
             virtual std::string serializePayload(std::shared_ptr<MUCPayload> version)  const;
+            virtual void writePayload(std::shared_ptr<MUCPayload>, XMLWriter&) const;
     };
 }
 
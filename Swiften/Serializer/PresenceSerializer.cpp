@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -9,7 +9,7 @@
 #include <memory>
 
 #include <Swiften/Base/Log.h>
-#include <Swiften/Serializer/XML/XMLElement.h>
+#include <Swiften/Serializer/XML/XMLWriter.h>
 
 namespace Swift {
 
@@ -20,15 +20,15 @@ PresenceSerializer::PresenceSerializer(PayloadSerializerCollection* payloadSeria
 
 void PresenceSerializer::setStanzaSpecificAttributesGeneric(
         std::shared_ptr<Presence> presence,
-        XMLElement& element) const {
+        XMLWriter& writer) const {
     switch (presence->getType()) {
-        case Presence::Unavailable: element.setAttribute("type","unavailable"); break;
-        case Presence::Probe: element.setAttribute("type","probe"); break;
-        case Presence::Subscribe: element.setAttribute("type","subscribe"); break;
-        case Presence::Subscribed: element.setAttribute("type","subscribed"); break;
-        case Presence::Unsubscribe: element.setAttribute("type","unsubscribe"); break;
-        case Presence::Unsubscribed: element.setAttribute("type","unsubscribed"); break;
-        case Presence::Error: element.setAttribute("type","error"); break;
+        case Presence::Unavailable: writer.addAttribute("type","unavailable"); break;
+        case Presence::Probe: writer.addAttribute("type","probe"); break;
+        case Presence::Subscribe: writer.addAttribute("type","subscribe"); break;
+        case Presence::Subscribed: writer.addAttribute("type","subscribed"); break;
+        case Presence::Unsubscribe: writer.addAttribute("type","unsubscribe"); break;
+        case Presence::Unsubscribed: writer.addAttribute("type","unsubscribed"); break;
+        case Presence::Error: writer.addAttribute("type","error"); break;
         case Presence::Available: break;
     }
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -21,6 +21,6 @@ namespace Swift {
         private:
             virtual void setStanzaSpecificAttributesGeneric(
                     std::shared_ptr<Presence> presence,
-                    XMLElement& element) const;
+                    XMLWriter& writer) const;
     };
 }
@@ -1,12 +1,11 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <Swiften/Serializer/StanzaSerializer.h>
 
-#include <sstream>
 #include <typeinfo>
 
 #include <Swiften/Base/String.h>
@@ -14,8 +13,7 @@
 #include <Swiften/Elements/Stanza.h>
 #include <Swiften/Serializer/PayloadSerializer.h>
 #include <Swiften/Serializer/PayloadSerializerCollection.h>
-#include <Swiften/Serializer/XML/XMLElement.h>
-#include <Swiften/Serializer/XML/XMLRawTextNode.h>
+#include <Swiften/Serializer/XML/XMLWriter.h>
 
 namespace Swift {
 
@@ -23,45 +21,56 @@ StanzaSerializer::StanzaSerializer(const std::string& tag, PayloadSerializerColl
 }
 
 SafeByteArray StanzaSerializer::serialize(std::shared_ptr<ToplevelElement> element) const {
-    if (explicitDefaultNS_) {
-        return serialize(element, explicitDefaultNS_.get());
-    }
-    else {
-        return serialize(element, "");
-    }
+    XMLWriter writer;
+    write(element, writer);
+    return createSafeByteArray(writer.getBuffer());
 }
 
 SafeByteArray StanzaSerializer::serialize(std::shared_ptr<ToplevelElement> element, const std::string& xmlns) const {
+    XMLWriter writer;
+    write(element, xmlns, writer);
+    return createSafeByteArray(writer.getBuffer());
+}
+
+void StanzaSerializer::write(std::shared_ptr<ToplevelElement> element, XMLWriter& writer) const {
+    write(element, "", writer);
+}
+
+void StanzaSerializer::write(std::shared_ptr<ToplevelElement> element, const std::string& xmlns, XMLWriter& writer) const {
     std::shared_ptr<Stanza> stanza(std::dynamic_pointer_cast<Stanza>(element));
 
-    XMLElement stanzaElement(tag_, explicitDefaultNS_ ? explicitDefaultNS_.get() : xmlns);
+    writer.startElement(tag_, getNamespace(xmlns));
     if (stanza->getFrom().isValid()) {
-        stanzaElement.setAttribute("from", stanza->getFrom());
+        writer.addAttribute("from", stanza->getFrom());
     }
     if (stanza->getTo().isValid()) {
-        stanzaElement.setAttribute("to", stanza->getTo());
+        writer.addAttribute("to", stanza->getTo());
     }
     if (!stanza->getID().empty()) {
-        stanzaElement.setAttribute("id", stanza->getID());
+        writer.addAttribute("id", stanza->getID());
     }
-    setStanzaSpecificAttributes(stanza, stanzaElement);
+    setStanzaSpecificAttributes(stanza, writer);
 
-    std::string serializedPayloads;
+    // Only the payloads are sanitized, so everything written from here on
+    // is checked once the payloads are in.
+    writer.flushAttributes();
+    std::string& buffer = writer.getBuffer();
+    size_t payloadsStart = buffer.size();
     for (const auto& payload : stanza->getPayloads()) {
         PayloadSerializer* serializer = payloadSerializers_->getPayloadSerializer(payload);
         if (serializer) {
-            serializedPayloads += serializer->serialize(payload);
+            serializer->write(payload, writer);
         }
         else {
             SWIFT_LOG(warning) << "Could not find serializer for " << typeid(*(payload.get())).name() << std::endl;
         }
     }
-    serializedPayloads = String::sanitizeXMPPString(serializedPayloads);
-    if (!serializedPayloads.empty()) {
-        stanzaElement.addNode(std::make_shared<XMLRawTextNode>(serializedPayloads));
-    }
+    String::sanitizeXMPPStringInPlace(buffer, payloadsStart);
+    writer.endElement();
+}
 
-    return createSafeByteArray(stanzaElement.serialize());
+const std::string& StanzaSerializer::getNamespace(const std::string& xmlns) const {
+    return explicitDefaultNS_ ? explicitDefaultNS_.get() : xmlns;
 }
 
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -8,8 +8,10 @@
 #include <cppunit/extensions/TestFactoryRegistry.h>
 
 #include <Swiften/Elements/AuthChallenge.h>
+#include <Swiften/Elements/AuthRequest.h>
+#include <Swiften/Elements/Message.h>
 #include <Swiften/Elements/ProtocolHeader.h>
-#include <Swiften/Serializer/PayloadSerializerCollection.h>
+#include <Swiften/Serializer/PayloadSerializers/FullPayloadSerializerCollection.h>
 #include <Swiften/Serializer/XMPPSerializer.h>
 
 using namespace Swift;
@@ -19,11 +21,13 @@ class XMPPSerializerTest : public CppUnit::TestFixture {
         CPPUNIT_TEST(testSerializeHeader_Client);
         CPPUNIT_TEST(testSerializeHeader_Component);
         CPPUNIT_TEST(testSerializeHeader_Server);
+        CPPUNIT_TEST(testSerializeElement_AfterLargeElement);
+        CPPUNIT_TEST(testSerializeElement_AuthRequest);
         CPPUNIT_TEST_SUITE_END();
 
     public:
         void setUp() {
-            payloadSerializerCollection = new PayloadSerializerCollection();
+            payloadSerializerCollection = new FullPayloadSerializerCollection();
         }
 
         void tearDown() {
@@ -63,13 +67,33 @@ class XMPPSerializerTest : public CppUnit::TestFixture {
             CPPUNIT_ASSERT_EQUAL(std::string("<?xml version=\"1.0\"?><stream:stream xmlns=\"jabber:server\" xmlns:stream=\"http://etherx.jabber.org/streams\" from=\"bla@foo.com\" to=\"foo.com\" id=\"myid\" version=\"0.99\">"), testling->serializeHeader(protocolHeader));
         }
 
+        void testSerializeElement_AfterLargeElement() {
+            std::shared_ptr<XMPPSerializer> testling(createSerializer(ClientStreamType));
+            std::shared_ptr<Message> largeMessage = std::make_shared<Message>();
+            largeMessage->setBody(std::string(300000, 'a'));
+
+            SafeByteArray largeElement = testling->serializeElement(largeMessage);
+            SafeByteArray smallElement = testling->serializeElement(std::make_shared<Message>());
+
+            CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(300000 + 44), largeElement.size());
+            CPPUNIT_ASSERT_EQUAL(std::string("<message type=\"chat\"/>"), safeByteArrayToString(smallElement));
+        }
+
+        void testSerializeElement_AuthRequest() {
+            std::shared_ptr<XMPPSerializer> testling(createSerializer(ClientStreamType));
+
+            SafeByteArray result = testling->serializeElement(std::make_shared<AuthRequest>("PLAIN", createSafeByteArray("foo")));
+
+            CPPUNIT_ASSERT_EQUAL(std::string("<auth xmlns=\"urn:ietf:params:xml:ns:xmpp-sasl\" mechanism=\"PLAIN\">Zm9v</auth>"), safeByteArrayToString(result));
+        }
+
     private:
         XMPPSerializer* createSerializer(StreamType type) {
             return new XMPPSerializer(payloadSerializerCollection, type, false);
         }
 
     private:
-        PayloadSerializerCollection* payloadSerializerCollection;
+        FullPayloadSerializerCollection* payloadSerializerCollection;
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(XMPPSerializerTest);
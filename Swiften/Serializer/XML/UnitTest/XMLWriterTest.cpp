@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+
+#include <Swiften/Serializer/XML/XMLWriter.h>
+
+using namespace Swift;
+
+class XMLWriterTest : public CppUnit::TestFixture
+{
+        CPPUNIT_TEST_SUITE(XMLWriterTest);
+        CPPUNIT_TEST(testWrite);
+        CPPUNIT_TEST(testWrite_NoChildren);
+        CPPUNIT_TEST(testWrite_AttributesSortedByName);
+        CPPUNIT_TEST(testWrite_DuplicateAttribute);
+        CPPUNIT_TEST(testWrite_SpecialAttributeCharacters);
+        CPPUNIT_TEST(testWrite_EmptyTextElement);
+        CPPUNIT_TEST(testWrite_Raw);
+        CPPUNIT_TEST(testClear);
+        CPPUNIT_TEST(testSecureClear);
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+        void testWrite() {
+            XMLWriter testling;
+            testling.startElement("foo", "http://example.com");
+            testling.addAttribute("myatt", "myval");
+            testling.writeTextElement("bar", "Blo");
+            testling.startElement("baz");
+            testling.writeText("Bli&</stream>");
+            testling.endElement();
+            testling.endElement();
+
+            CPPUNIT_ASSERT_EQUAL(std::string(
+                "<foo myatt=\"myval\" xmlns=\"http://example.com\">"
+                    "<bar>Blo</bar>"
+                    "<baz>Bli&amp;&lt;/stream&gt;</baz>"
+                "</foo>"), testling.getBuffer());
+        }
+
+        void testWrite_NoChildren() {
+            XMLWriter testling;
+            testling.startElement("foo", "http://example.com");
+            testling.writeText("");
+            testling.endElement();
+
+            CPPUNIT_ASSERT_EQUAL(std::string("<foo xmlns=\"http://example.com\"/>"), testling.getBuffer());
+        }
+
+        void testWrite_AttributesSortedByName() {
+            XMLWriter testling;
+            testling.startElement("foo");
+            testling.addAttribute("to", "b");
+            testling.addAttribute("from", "a");
+            testling.addAttribute("id", "c");
+            testling.endElement();
+
+            CPPUNIT_ASSERT_EQUAL(std::string("<foo from=\"a\" id=\"c\" to=\"b\"/>"), testling.getBuffer());
+        }
+
+        void testWrite_DuplicateAttribute() {
+            XMLWriter testling;
+            testling.startElement("foo");
+            testling.addAttribute("type", "get");
+            testling.addAttribute("id", "1");
+            testling.addAttribute("type", "set");
+            testling.endElement();
+
+            CPPUNIT_ASSERT_EQUAL(std::string("<foo id=\"1\" type=\"set\"/>"), testling.getBuffer());
+        }
+
+        void testWrite_SpecialAttributeCharacters() {
+            XMLWriter testling;
+            testling.startElement("foo");
+            testling.addAttribute("myatt", "<\"'&>");
+            testling.endElement();
+
+            CPPUNIT_ASSERT_EQUAL(std::string("<foo myatt=\"&lt;&quot;&apos;&amp;&gt;\"/>"), testling.getBuffer());
+        }
+
+        void testWrite_EmptyTextElement() {
+            XMLWriter testling;
+            testling.startElement("foo");
+            testling.writeTextElement("bar", "");
+            testling.endElement();
+
+            CPPUNIT_ASSERT_EQUAL(std::string("<foo><bar></bar></foo>"), testling.getBuffer());
+        }
+
+        void testWrite_Raw() {
+            XMLWriter testling;
+            testling.startElement("foo");
+            testling.addAttribute("a", "b");
+            testling.writeRaw("<bar/>");
+            testling.endElement();
+
+            CPPUNIT_ASSERT_EQUAL(std::string("<foo a=\"b\"><bar/></foo>"), testling.getBuffer());
+        }
+
+        void testClear() {
+            XMLWriter testling;
+            testling.startElement("foo");
+            testling.addAttribute("a", "b");
+            testling.clear();
+            testling.startElement("bar");
+            testling.endElement();
+
+            CPPUNIT_ASSERT_EQUAL(std::string("<bar/>"), testling.getBuffer());
+        }
+
+        void testSecureClear() {
+            XMLWriter testling;
+            testling.startElement("foo");
+            testling.addAttribute("a", "b");
+            testling.writeTextElement("password", "secret");
+            testling.endElement();
+            testling.secureClear();
+
+            CPPUNIT_ASSERT(testling.getBuffer().empty());
+
+            testling.startElement("bar");
+            testling.addAttribute("c", "d");
+            testling.endElement();
+
+            CPPUNIT_ASSERT_EQUAL(std::string("<bar c=\"d\"/>"), testling.getBuffer());
+        }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(XMLWriterTest);
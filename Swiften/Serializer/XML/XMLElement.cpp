@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -7,6 +7,7 @@
 #include <Swiften/Serializer/XML/XMLElement.h>
 
 #include <Swiften/Serializer/XML/XMLTextNode.h>
+#include <Swiften/Serializer/XML/XMLWriter.h>
 
 namespace Swift {
 
@@ -40,12 +41,9 @@ std::string XMLElement::serialize() {
 }
 
 void XMLElement::setAttribute(const std::string& attribute, const std::string& value) {
-    std::string escapedValue(value);
-    String::replaceAll(escapedValue, '&', "&amp;");
-    String::replaceAll(escapedValue, '<', "&lt;");
-    String::replaceAll(escapedValue, '>', "&gt;");
-    String::replaceAll(escapedValue, '\'', "&apos;");
-    String::replaceAll(escapedValue, '"', "&quot;");
+    std::string escapedValue;
+    escapedValue.reserve(value.size());
+    XMLWriter::appendEscapedAttributeValue(escapedValue, value);
     attributes_[attribute] = escapedValue;
 }
 
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <Swiften/Serializer/XML/XMLWriter.h>
+
+#include <cassert>
+
+#include <Swiften/Base/SafeAllocator.h>
+
+namespace Swift {
+
+XMLWriter::XMLWriter() : startTagOpen_(false) {
+}
+
+void XMLWriter::clear() {
+    buffer_.clear();
+    openElements_.clear();
+    startTagOpen_ = false;
+    attributeData_.clear();
+    attributes_.clear();
+}
+
+void XMLWriter::secureClear() {
+    secureZeroMemory(&buffer_[0], buffer_.size());
+    secureZeroMemory(&attributeData_[0], attributeData_.size());
+    clear();
+}
+
+void XMLWriter::startElement(const std::string& tag, const std::string& xmlns) {
+    startContent();
+    buffer_ += '<';
+    openElements_.push_back(std::make_pair(buffer_.size(), tag.size()));
+    buffer_ += tag;
+    startTagOpen_ = true;
+    if (!xmlns.empty()) {
+        addAttribute("xmlns", xmlns);
+    }
+}
+
+void XMLWriter::addAttribute(const std::string& name, const std::string& value) {
+    assert(startTagOpen_);
+    Attribute attribute;
+    attribute.nameBegin = attributeData_.size();
+    attribute.nameSize = name.size();
+    attributeData_ += name;
+    attribute.valueBegin = attributeData_.size();
+    appendEscapedAttributeValue(attributeData_, value);
+    attribute.valueSize = attributeData_.size() - attribute.valueBegin;
+    attributes_.push_back(attribute);
+}
+
+void XMLWriter::closeStartTag() {
+    if (!startTagOpen_) {
+        return;
+    }
+    startTagOpen_ = false;
+    flushAttributes();
+}
+
+void XMLWriter::startContent() {
+    if (startTagOpen_) {
+        closeStartTag();
+        buffer_ += '>';
+    }
+}
+
+void XMLWriter::flushAttributes() {
+    // Insertion sort on the attribute names. Being stable, this keeps
+    // attributes that were set more than once in the order they were set.
+    const char* data = attributeData_.data();
+    for (size_t i = 1; i < attributes_.size(); ++i) {
+        Attribute attribute = attributes_[i];
+        size_t j = i;
+        while (j > 0 && attributeData_.compare(attributes_[j-1].nameBegin, attributes_[j-1].nameSize, data + attribute.nameBegin, attribute.nameSize) > 0) {
+            attributes_[j] = attributes_[j-1];
+            --j;
+        }
+        attributes_[j] = attribute;
+    }
+
+    for (size_t i = 0; i < attributes_.size(); ++i) {
+        const Attribute& attribute = attributes_[i];
+        // The last value set for an attribute wins
+        if (i + 1 < attributes_.size() && attributeData_.compare(attribute.nameBegin, attribute.nameSize, data + attributes_[i+1].nameBegin, attributes_[i+1].nameSize) == 0) {
+            continue;
+        }
+        buffer_ += ' ';
+        buffer_.append(attributeData_, attribute.nameBegin, attribute.nameSize);
+        buffer_ += "=\"";
+        buffer_.append(attributeData_, attribute.valueBegin, attribute.valueSize);
+        buffer_ += '"';
+    }
+    attributeData_.clear();
+    attributes_.clear();
+}
+
+void XMLWriter::endElement() {
+    assert(!openElements_.empty());
+    std::pair<size_t, size_t> tag = openElements_.back();
+    openElements_.pop_back();
+    if (startTagOpen_) {
+        closeStartTag();
+        // closeStartTag() has written the attributes; turn the start tag
+        // into an empty-element tag.
+        buffer_ += "/>";
+    }
+    else {
+        buffer_ += "</";
+        buffer_.append(buffer_, tag.first, tag.second);
+        buffer_ += '>';
+    }
+}
+
+void XMLWriter::writeText(const std::string& text) {
+    if (text.empty()) {
+        return;
+    }
+    startContent();
+    appendEscapedText(buffer_, text);
+}
+
+void XMLWriter::writeRaw(const std::string& data) {
+    if (data.empty()) {
+        return;
+    }
+    startContent();
+    buffer_ += data;
+}
+
+void XMLWriter::writeTextElement(const std::string& tag, const std::string& text) {
+    startContent();
+    buffer_ += '<';
+    buffer_ += tag;
+    buffer_ += '>';
+    appendEscapedText(buffer_, text);
+    buffer_ += "</";
+    buffer_ += tag;
+    buffer_ += '>';
+}
+
+void XMLWriter::appendEscapedText(std::string& buffer, const std::string& text) {
+    size_t start = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        const char* replacement;
+        switch (text[i]) {
+            case '&': replacement = "&amp;"; break;
+            case '<': replacement = "&lt;"; break;
+            case '>': replacement = "&gt;"; break;
+            default: continue;
+        }
+        buffer.append(text, start, i - start);
+        buffer += replacement;
+        start = i + 1;
+    }
+    buffer.append(text, start, std::string::npos);
+}
+
+void XMLWriter::appendEscapedAttributeValue(std::string& buffer, const std::string& value) {
+    size_t start = 0;
+    for (size_t i = 0; i < value.size(); ++i) {
+        const char* replacement;
+        switch (value[i]) {
+            case '&': replacement = "&amp;"; break;
+            case '<': replacement = "&lt;"; break;
+            case '>': replacement = "&gt;"; break;
+            case '\'': replacement = "&apos;"; break;
+            case '"': replacement = "&quot;"; break;
+            default: continue;
+        }
+        buffer.append(value, start, i - start);
+        buffer += replacement;
+        start = i + 1;
+    }
+    buffer.append(value, start, std::string::npos);
+}
+
+}
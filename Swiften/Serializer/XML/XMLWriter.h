@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include <Swiften/Base/API.h>
+
+namespace Swift {
+    /**
+     * Serializes XML by appending straight to a growable buffer.
+     *
+     * This is the streaming counterpart of XMLElement, producing the same
+     * output without building a tree. Attributes of an element are written
+     * in name order (like XMLElement does) when the start tag is closed,
+     * which happens when content is added or the element is ended. Elements
+     * without content are written as empty-element tags.
+     *
+     * The writer keeps its buffer and bookkeeping between uses, so reusing
+     * a writer after clear() does not allocate once it has grown to its
+     * working size.
+     */
+    class SWIFTEN_API XMLWriter : public boost::noncopyable {
+        public:
+            XMLWriter();
+
+            void startElement(const std::string& tag, const std::string& xmlns = "");
+            void addAttribute(const std::string& name, const std::string& value);
+            void endElement();
+
+            /**
+             * Writes out the attributes added to the current start tag so far.
+             *
+             * Everything appended to the buffer after this call is content of
+             * the element, apart from the '>' ending the start tag.
+             */
+            void flushAttributes();
+
+            /**
+             * Writes escaped character data.
+             */
+            void writeText(const std::string& text);
+
+            /**
+             * Writes already serialized XML.
+             */
+            void writeRaw(const std::string& data);
+
+            /**
+             * Writes an element that only contains the given text.
+             *
+             * As with an XMLElement holding a text node, the element gets
+             * an end tag even if the text is empty.
+             */
+            void writeTextElement(const std::string& tag, const std::string& text);
+
+            std::string& getBuffer() {
+                return buffer_;
+            }
+
+            const std::string& getBuffer() const {
+                return buffer_;
+            }
+
+            void clear();
+
+            /**
+             * Like clear(), but first overwrites the written data with zeros,
+             * so that it doesn't linger in the retained buffers.
+             */
+            void secureClear();
+
+            static void appendEscapedText(std::string& buffer, const std::string& text);
+            static void appendEscapedAttributeValue(std::string& buffer, const std::string& value);
+
+        private:
+            void closeStartTag();
+            void startContent();
+
+        private:
+            struct Attribute {
+                size_t nameBegin;
+                size_t nameSize;
+                size_t valueBegin;
+                size_t valueSize;
+            };
+
+            std::string buffer_;
+            // Position and size of the tag names of the open elements in buffer_
+            std::vector<std::pair<size_t, size_t> > openElements_;
+            bool startTagOpen_;
+            // Names and escaped values of the attributes of the open start tag
+            std::string attributeData_;
+            std::vector<Attribute> attributes_;
+    };
+}
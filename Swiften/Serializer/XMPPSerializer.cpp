@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -39,6 +39,8 @@
 
 namespace Swift {
 
+static const size_t maxRetainedBufferSize = 65536;
+
 XMPPSerializer::XMPPSerializer(PayloadSerializerCollection* payloadSerializers, StreamType type, bool setExplictNSonTopLevelElements) : type_(type) {
     serializers_.push_back(std::make_shared<PresenceSerializer>(payloadSerializers, setExplictNSonTopLevelElements ? getDefaultNamespace() : boost::optional<std::string>()));
     serializers_.push_back(std::make_shared<IQSerializer>(payloadSerializers, setExplictNSonTopLevelElements ? getDefaultNamespace() : boost::optional<std::string>()));
@@ -86,7 +88,17 @@ std::string XMPPSerializer::serializeHeader(const ProtocolHeader& header) const
 SafeByteArray XMPPSerializer::serializeElement(std::shared_ptr<ToplevelElement> element) const {
     std::vector< std::shared_ptr<ElementSerializer> >::const_iterator i = std::find_if(serializers_.begin(), serializers_.end(), boost::bind(&ElementSerializer::canSerialize, _1, element));
     if (i != serializers_.end()) {
-        return (*i)->serialize(element);
+        writer_.clear();
+        (*i)->write(element, writer_);
+        SafeByteArray result = createSafeByteArray(writer_.getBuffer());
+        // Elements may carry credentials (e.g. SASL auth, MUC or registration
+        // passwords), so don't leave them behind in the retained buffer.
+        writer_.secureClear();
+        if (writer_.getBuffer().capacity() > maxRetainedBufferSize) {
+            // Don't hold on to the memory of an unusually large element
+            writer_.getBuffer().shrink_to_fit();
+        }
+        return result;
     }
     else {
         SWIFT_LOG(warning) << "Could not find serializer for " << typeid(*(element.get())).name() << std::endl;
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2017 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -14,6 +14,7 @@
 #include <Swiften/Elements/StreamType.h>
 #include <Swiften/Elements/ToplevelElement.h>
 #include <Swiften/Serializer/ElementSerializer.h>
+#include <Swiften/Serializer/XML/XMLWriter.h>
 
 namespace Swift {
     class PayloadSerializerCollection;
@@ -33,5 +34,8 @@ namespace Swift {
         private:
             StreamType type_;
             std::vector< std::shared_ptr<ElementSerializer> > serializers_;
+            // Reused between elements to avoid reallocating the output buffer.
+            // It is wiped after each element.
+            mutable XMLWriter writer_;
     };
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2011-2017 Isode Limited.
+ * Copyright (c) 2011-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -49,6 +49,7 @@ namespace Swift {
             virtual ~BOSHSessionStream();
 
             void open();
+            void setPipeliningEnabled(bool enabled);
             virtual void close();
             virtual bool isOpen();
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -29,7 +29,8 @@ BasicSessionStream::BasicSessionStream(
         TLSContextFactory* tlsContextFactory,
         TimerFactory* timerFactory,
         XMLParserFactory* xmlParserFactory,
-        const TLSOptions& tlsOptions) :
+        const TLSOptions& tlsOptions,
+        const ZLibCompressionOptions& compressionOptions) :
             available(false),
             connection(connection),
             tlsContextFactory(tlsContextFactory),
@@ -37,7 +38,8 @@ BasicSessionStream::BasicSessionStream(
             compressionLayer(nullptr),
             tlsLayer(nullptr),
             whitespacePingLayer(nullptr),
-            tlsOptions_(tlsOptions) {
+            tlsOptions_(tlsOptions),
+            compressionOptions_(compressionOptions) {
     xmppLayer = new XMPPLayer(payloadParserFactories, payloadSerializers, xmlParserFactory, streamType);
     xmppLayer->onStreamStart.connect(boost::bind(&BasicSessionStream::handleStreamStartReceived, this, _1));
     xmppLayer->onStreamEnd.connect(boost::bind(&BasicSessionStream::handleStreamEndReceived, this));
@@ -148,7 +150,7 @@ bool BasicSessionStream::supportsZLibCompression() {
 }
 
 void BasicSessionStream::addZLibCompression() {
-    compressionLayer = new CompressionLayer();
+    compressionLayer = new CompressionLayer(compressionOptions_);
     streamStack->addLayer(compressionLayer);
 }
 
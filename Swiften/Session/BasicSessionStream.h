@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -10,6 +10,7 @@
 
 #include <Swiften/Base/API.h>
 #include <Swiften/Base/SafeByteArray.h>
+#include <Swiften/Compress/ZLibCompressionOptions.h>
 #include <Swiften/Elements/StreamType.h>
 #include <Swiften/Network/Connection.h>
 #include <Swiften/Session/SessionStream.h>
@@ -39,7 +40,8 @@ namespace Swift {
                 TLSContextFactory* tlsContextFactory,
                 TimerFactory* whitespacePingLayerFactory,
                 XMLParserFactory* xmlParserFactory,
-                const TLSOptions& tlsOptions
+                const TLSOptions& tlsOptions,
+                const ZLibCompressionOptions& compressionOptions = ZLibCompressionOptions()
             );
             virtual ~BasicSessionStream();
 
@@ -90,6 +92,7 @@ namespace Swift {
             WhitespacePingLayer* whitespacePingLayer;
             StreamStack* streamStack;
             TLSOptions tlsOptions_;
+            ZLibCompressionOptions compressionOptions_;
     };
 
 }
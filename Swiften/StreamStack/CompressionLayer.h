@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2016 Isode Limited.
+ * Copyright (c) 2010-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -11,6 +11,7 @@
 
 #include <Swiften/Base/API.h>
 #include <Swiften/Base/SafeByteArray.h>
+#include <Swiften/Compress/ZLibCompressionOptions.h>
 #include <Swiften/Compress/ZLibCompressor.h>
 #include <Swiften/Compress/ZLibDecompressor.h>
 #include <Swiften/Compress/ZLibException.h>
@@ -22,7 +23,7 @@ namespace Swift {
 
     class SWIFTEN_API CompressionLayer : public StreamLayer, boost::noncopyable {
         public:
-            CompressionLayer() {}
+            CompressionLayer(const ZLibCompressionOptions& options = ZLibCompressionOptions()) : compressor_(options), decompressor_(options) {}
 
             virtual void writeData(const SafeByteArray& data) {
                 try {
@@ -11,6 +11,7 @@
 #include <wincrypt.h>
 #endif
 
+#include <algorithm>
 #include <cassert>
 #include <memory>
 #include <vector>
@@ -18,6 +19,7 @@
 
 #include <openssl/bio.h>
 #include <openssl/err.h>
+#include <openssl/evp.h>
 #include <openssl/pkcs12.h>
 
 #if defined(SWIFTEN_PLATFORM_MACOSX)
@@ -26,6 +28,7 @@
 
 #include <Swiften/Base/Log.h>
 #include <Swiften/Base/Algorithm.h>
+#include <Swiften/StringCodecs/Hexify.h>
 #include <Swiften/TLS/OpenSSL/OpenSSLContext.h>
 #include <Swiften/TLS/OpenSSL/OpenSSLCertificate.h>
 #include <Swiften/TLS/CertificateWithKey.h>
@@ -41,6 +44,7 @@ namespace Swift {
 
 static const int MAX_FINISHED_SIZE = 4096;
 static const int SSL_READ_BUFFERSIZE = 8192;
+static const size_t MAX_RETAINED_APPLICATION_BUFFERSIZE = 4 * SSL_READ_BUFFERSIZE;
 
 static void freeX509Stack(STACK_OF(X509)* stack) {
     sk_X509_free(stack);
@@ -80,6 +84,20 @@ namespace {
         return sslCtx;
     }
 
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+    void* BIO_get_data(BIO* bio) {
+        return bio->ptr;
+    }
+
+    void BIO_set_data(BIO* bio, void* data) {
+        bio->ptr = data;
+    }
+
+    void BIO_set_init(BIO* bio, int init) {
+        bio->init = init;
+    }
+#endif
+
     std::string openSSLInternalErrorToString() {
         auto bio = std::shared_ptr<BIO>(BIO_new(BIO_s_mem()), BIO_free);
         ERR_print_errors(bio.get());
@@ -90,11 +108,23 @@ namespace {
     }
  }
 
-OpenSSLContext::OpenSSLContext(Mode mode) : mode_(mode), state_(State::Start) {
+OpenSSLContext::OpenSSLContext(Mode mode, std::shared_ptr<OpenSSLSessionCache> sessionCache, const std::string& sessionCacheKey) : mode_(mode), state_(State::Start), sessionCache_(sessionCache), sessionCacheKey_(sessionCacheKey) {
     ensureLibraryInitialized();
     context_ = createSSL_CTX(mode_);
     SSL_CTX_set_options(context_.get(), SSL_OP_NO_SSLv2 | SSL_OP_NO_SSLv3);
 
+    if (sessionCache_) {
+        if (mode_ == Mode::Client) {
+            // Sessions are handed to us as they are established (or, for TLS 1.3,
+            // as tickets arrive after the handshake), and kept in the shared cache.
+            SSL_CTX_set_session_cache_mode(context_.get(), SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+            SSL_CTX_sess_set_new_cb(context_.get(), OpenSSLContext::handleNewSessionCallback);
+        }
+        else {
+            sessionCache_->setUpServerContext(context_.get());
+        }
+    }
+
     if (mode_ == Mode::Server) {
 #if OPENSSL_VERSION_NUMBER < 0x1010
         // Automatically select highest preference curve used for ECDH temporary keys used during
@@ -162,17 +192,88 @@ OpenSSLContext::OpenSSLContext(Mode mode) : mode_(mode), state_(State::Start) {
 }
 
 OpenSSLContext::~OpenSSLContext() {
+    if (handle_ && state_ == State::Connected) {
+        // XMPP connections are usually closed without a TLS close_notify. Don't let
+        // OpenSSL treat that as an unclean shutdown and invalidate the session.
+        SSL_set_shutdown(handle_.get(), SSL_SENT_SHUTDOWN | SSL_RECEIVED_SHUTDOWN);
+    }
 }
 
 void OpenSSLContext::ensureLibraryInitialized() {
     static OpenSSLInitializerFinalizer openSSLInit;
 }
 
+const BIO_METHOD* OpenSSLContext::getBIOMethod() {
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+    static const auto method = std::unique_ptr<BIO_METHOD, decltype(&BIO_meth_free)>([]() {
+        auto method = BIO_meth_new(BIO_get_new_index() | BIO_TYPE_SOURCE_SINK, "Swiften TLS context");
+        BIO_meth_set_read(method, OpenSSLContext::handleBIORead);
+        BIO_meth_set_write(method, OpenSSLContext::handleBIOWrite);
+        BIO_meth_set_ctrl(method, OpenSSLContext::handleBIOControl);
+        return method;
+    }(), BIO_meth_free);
+    return method.get();
+#else
+    static BIO_METHOD method = {
+        BIO_TYPE_SOURCE_SINK, "Swiften TLS context",
+        OpenSSLContext::handleBIOWrite, OpenSSLContext::handleBIORead,
+        nullptr, nullptr, OpenSSLContext::handleBIOControl,
+        nullptr, nullptr, nullptr
+    };
+    return &method;
+#endif
+}
+
+int OpenSSLContext::handleBIORead(BIO* bio, char* data, int size) {
+    auto context = static_cast<OpenSSLContext*>(BIO_get_data(bio));
+    BIO_clear_retry_flags(bio);
+    if (context->networkInputSize_ == 0) {
+        BIO_set_retry_read(bio);
+        return -1;
+    }
+    auto readSize = std::min(static_cast<size_t>(size), context->networkInputSize_);
+    std::copy(context->networkInput_, context->networkInput_ + readSize, data);
+    context->networkInput_ += readSize;
+    context->networkInputSize_ -= readSize;
+    return static_cast<int>(readSize);
+}
+
+int OpenSSLContext::handleBIOWrite(BIO* bio, const char* data, int size) {
+    auto context = static_cast<OpenSSLContext*>(BIO_get_data(bio));
+    BIO_clear_retry_flags(bio);
+    context->networkOutput_.insert(context->networkOutput_.end(), data, data + size);
+    return size;
+}
+
+long OpenSSLContext::handleBIOControl(BIO* bio, int command, long, void*) {
+    auto context = static_cast<OpenSSLContext*>(BIO_get_data(bio));
+    switch (command) {
+        case BIO_CTRL_PENDING: return static_cast<long>(context->networkInputSize_);
+        case BIO_CTRL_WPENDING: return static_cast<long>(context->networkOutput_.size());
+        case BIO_CTRL_FLUSH: return 1;
+        default: return 0;
+    }
+}
+
 void OpenSSLContext::initAndSetBIOs() {
-    // Ownership of BIOs is transferred
-    readBIO_ = BIO_new(BIO_s_mem());
-    writeBIO_ = BIO_new(BIO_s_mem());
-    SSL_set_bio(handle_.get(), readBIO_, writeBIO_);
+    // A single BIO serves both directions. It reads the records straight from
+    // the buffers passed to handleDataFromNetwork(), and collects outgoing
+    // records in networkOutput_.
+    auto bio = BIO_new(const_cast<BIO_METHOD*>(getBIOMethod()));
+    BIO_set_data(bio, this);
+    BIO_set_init(bio, 1);
+    // Ownership of the BIO is transferred
+    SSL_set_bio(handle_.get(), bio, bio);
+}
+
+void OpenSSLContext::retainNetworkInput() {
+    // Keep the bytes OpenSSL hasn't consumed yet (usually the start of a
+    // record), as the buffer they point into belongs to our caller. This has
+    // to happen before emitting any signal, as a handler may destroy the
+    // caller's buffer, or this context.
+    SafeByteArray remaining(networkInput_, networkInput_ + networkInputSize_);
+    pendingNetworkInput_.swap(remaining);
+    networkInput_ = vecptr(pendingNetworkInput_);
 }
 
 void OpenSSLContext::accept() {
@@ -209,6 +310,28 @@ void OpenSSLContext::connect(const std::string& requestedServerName) {
         }
     }
 
+    if (sessionCacheKey_.empty()) {
+        sessionCacheKey_ = requestedServerName;
+    }
+    if (sessionCache_ && !sessionCacheKey_.empty()) {
+        // A resumed session keeps the identity it was authenticated with, so
+        // sessions made with one client certificate must not be offered with another.
+        if (X509* clientCertificate = SSL_CTX_get0_certificate(context_.get())) {
+            unsigned char digest[EVP_MAX_MD_SIZE];
+            unsigned int digestSize = 0;
+            if (X509_digest(clientCertificate, EVP_sha256(), digest, &digestSize) != 1) {
+                state_ = State::Error;
+                onError(std::make_shared<TLSError>());
+                return;
+            }
+            sessionCacheKey_ += "/" + Hexify::hexify(createByteArray(digest, digestSize));
+        }
+        SSL_set_app_data(handle_.get(), this);
+        if (auto session = sessionCache_->getSession(sessionCacheKey_)) {
+            SSL_set_session(handle_.get(), session.get());
+        }
+    }
+
     // Ownership of BIOs is transferred to the SSL_CTX instance in handle_.
     initAndSetBIOs();
 
@@ -219,15 +342,26 @@ void OpenSSLContext::connect(const std::string& requestedServerName) {
 void OpenSSLContext::doAccept() {
     auto acceptResult = SSL_accept(handle_.get());
     auto error = SSL_get_error(handle_.get(), acceptResult);
+    retainNetworkInput();
+    std::weak_ptr<bool> alive(alive_);
     switch (error) {
         case SSL_ERROR_NONE: {
             state_ = State::Connected;
+            handleHandshakeFinished();
             //std::cout << x->name << std::endl;
             //const char* comp = SSL_get_current_compression(handle_.get());
             //std::cout << "Compression: " << SSL_COMP_get_name(comp) << std::endl;
             onConnected();
+            if (alive.expired()) {
+                return;
+            }
             // The following call is important so the client knowns the handshake is finished.
             sendPendingDataToNetwork();
+            if (alive.expired()) {
+                return;
+            }
+            // The client may have sent application data right after its last handshake message.
+            sendPendingDataToApplication();
             break;
         }
         case SSL_ERROR_WANT_READ:
@@ -240,16 +374,20 @@ void OpenSSLContext::doAccept() {
             SWIFT_LOG(warning) << openSSLInternalErrorToString() << std::endl;
             state_ = State::Error;
             onError(std::make_shared<TLSError>());
-            sendPendingDataToNetwork();
+            if (!alive.expired()) {
+                sendPendingDataToNetwork();
+            }
     }
 }
 
 void OpenSSLContext::doConnect() {
     int connectResult = SSL_connect(handle_.get());
     int error = SSL_get_error(handle_.get(), connectResult);
+    retainNetworkInput();
     switch (error) {
         case SSL_ERROR_NONE: {
             state_ = State::Connected;
+            handleHandshakeFinished();
             //std::cout << x->name << std::endl;
             //const char* comp = SSL_get_current_compression(handle_.get());
             //std::cout << "Compression: " << SSL_COMP_get_name(comp) << std::endl;
@@ -261,6 +399,10 @@ void OpenSSLContext::doConnect() {
             break;
         default:
             SWIFT_LOG(warning) << openSSLInternalErrorToString() << std::endl;
+            if (sessionCache_ && !sessionCacheKey_.empty()) {
+                // Don't offer a session that might have caused the failure again
+                sessionCache_->removeSession(sessionCacheKey_);
+            }
             state_ = State::Error;
             onError(std::make_shared<TLSError>());
     }
@@ -284,18 +426,48 @@ int OpenSSLContext::handleServerNameCallback(SSL* ssl, int*, void* arg) {
     return SSL_TLSEXT_ERR_OK;
 }
 
+int OpenSSLContext::handleNewSessionCallback(SSL* ssl, SSL_SESSION* session) {
+    auto context = static_cast<OpenSSLContext*>(SSL_get_app_data(ssl));
+    if (!context || !context->sessionCache_ || context->sessionCacheKey_.empty()) {
+        return 0;
+    }
+    // Returning 1 tells OpenSSL that we keep the reference to the session.
+    context->sessionCache_->addSession(context->sessionCacheKey_, session);
+    return 1;
+}
+
+void OpenSSLContext::handleHandshakeFinished() {
+    if (sessionCache_) {
+        sessionCache_->recordHandshake(isSessionResumed());
+    }
+}
+
 void OpenSSLContext::sendPendingDataToNetwork() {
-    int size = BIO_pending(writeBIO_);
-    if (size > 0) {
+    if (!networkOutput_.empty()) {
+        // Hand out the buffer itself, and take it back afterwards to reuse its
+        // storage. Handlers may cause more output, so don't write to it meanwhile.
         SafeByteArray data;
-        data.resize(size);
-        BIO_read(writeBIO_, vecptr(data), size);
+        data.swap(networkOutput_);
+        std::weak_ptr<bool> alive(alive_);
         onDataForNetwork(data);
+        if (!alive.expired() && networkOutput_.empty()) {
+            data.clear();
+            networkOutput_.swap(data);
+        }
     }
 }
 
 void OpenSSLContext::handleDataFromNetwork(const SafeByteArray& data) {
-    BIO_write(readBIO_, vecptr(data), data.size());
+    if (networkInputSize_ == 0) {
+        networkInput_ = vecptr(data);
+        networkInputSize_ = data.size();
+    }
+    else {
+        retainNetworkInput();
+        append(pendingNetworkInput_, data);
+        networkInput_ = vecptr(pendingNetworkInput_);
+        networkInputSize_ = pendingNetworkInput_.size();
+    }
     switch (state_) {
         case State::Accepting:
             doAccept();
@@ -307,7 +479,7 @@ void OpenSSLContext::handleDataFromNetwork(const SafeByteArray& data) {
             sendPendingDataToApplication();
             break;
         case State::Start: assert(false); break;
-        case State::Error: /*assert(false);*/ break;
+        case State::Error: /*assert(false);*/ retainNetworkInput(); break;
     }
 }
 
@@ -322,16 +494,39 @@ void OpenSSLContext::handleDataFromApplication(const SafeByteArray& data) {
 }
 
 void OpenSSLContext::sendPendingDataToApplication() {
+    // Decrypt all complete records into one buffer, and hand them up at once.
     SafeByteArray data;
-    data.resize(SSL_READ_BUFFERSIZE);
-    int ret = SSL_read(handle_.get(), vecptr(data), data.size());
-    while (ret > 0) {
-        data.resize(ret);
+    data.swap(applicationOutput_);
+    size_t size = 0;
+    int ret;
+    do {
+        if (data.size() < size + SSL_READ_BUFFERSIZE) {
+            data.resize(size + SSL_READ_BUFFERSIZE);
+        }
+        ret = SSL_read(handle_.get(), vecptr(data) + size, SSL_READ_BUFFERSIZE);
+        if (ret > 0) {
+            size += static_cast<size_t>(ret);
+        }
+    } while (ret > 0);
+    auto error = ret < 0 ? SSL_get_error(handle_.get(), ret) : SSL_ERROR_NONE;
+    retainNetworkInput();
+
+    if (size > 0) {
+        data.resize(size);
+        std::weak_ptr<bool> alive(alive_);
         onDataForApplication(data);
-        data.resize(SSL_READ_BUFFERSIZE);
-        ret = SSL_read(handle_.get(), vecptr(data), data.size());
+        if (alive.expired()) {
+            return;
+        }
+    }
+    // Reuse the buffer for the next records, but don't keep the plaintext
+    // in it, nor hold on to the memory of an unusually large read.
+    if (applicationOutput_.empty() && data.capacity() <= MAX_RETAINED_APPLICATION_BUFFERSIZE) {
+        std::fill(data.begin(), data.end(), 0);
+        applicationOutput_.swap(data);
     }
-    if (ret < 0 && SSL_get_error(handle_.get(), ret) != SSL_ERROR_WANT_READ) {
+
+    if (ret < 0 && error != SSL_ERROR_WANT_READ) {
         state_ = State::Error;
         onError(std::make_shared<TLSError>());
     }
@@ -532,6 +727,10 @@ ByteArray OpenSSLContext::getPeerFinishMessage() const {
     return data;
  }
 
+bool OpenSSLContext::isSessionResumed() const {
+    return handle_ && SSL_session_reused(handle_.get()) == 1;
+}
+
 CertificateVerificationError::Type OpenSSLContext::getVerificationErrorTypeForResult(int result) {
     assert(result != 0);
     switch (result) {
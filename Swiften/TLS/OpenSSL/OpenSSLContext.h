@@ -14,7 +14,9 @@
 #include <openssl/ssl.h>
 
 #include <Swiften/Base/ByteArray.h>
+#include <Swiften/Base/SafeByteArray.h>
 #include <Swiften/TLS/CertificateWithKey.h>
+#include <Swiften/TLS/OpenSSL/OpenSSLSessionCache.h>
 #include <Swiften/TLS/TLSContext.h>
 
 namespace std {
@@ -38,7 +40,14 @@ namespace std {
 namespace Swift {
     class OpenSSLContext : public TLSContext, boost::noncopyable {
         public:
-            OpenSSLContext(Mode mode);
+            /**
+             * If a \p sessionCache is given, sessions are resumed from and
+             * stored in it. Client sessions are stored under \p sessionCacheKey,
+             * or under the requested server name if the key is empty. If the
+             * context has a client certificate, its fingerprint is added to
+             * the key.
+             */
+            OpenSSLContext(Mode mode, std::shared_ptr<OpenSSLSessionCache> sessionCache = std::shared_ptr<OpenSSLSessionCache>(), const std::string& sessionCacheKey = std::string());
             virtual ~OpenSSLContext() override final;
 
             void accept() override final;
@@ -59,17 +68,25 @@ namespace Swift {
 
             virtual ByteArray getFinishMessage() const override final;
             virtual ByteArray getPeerFinishMessage() const override final;
+            virtual bool isSessionResumed() const override final;
 
         private:
             static void ensureLibraryInitialized();
             static int handleServerNameCallback(SSL *ssl, int *ad, void *arg);
+            static int handleNewSessionCallback(SSL* ssl, SSL_SESSION* session);
+            static const BIO_METHOD* getBIOMethod();
+            static int handleBIORead(BIO* bio, char* data, int size);
+            static int handleBIOWrite(BIO* bio, const char* data, int size);
+            static long handleBIOControl(BIO* bio, int command, long, void*);
             static CertificateVerificationError::Type getVerificationErrorTypeForResult(int);
 
             void initAndSetBIOs();
+            void retainNetworkInput();
             void doAccept();
             void doConnect();
             void sendPendingDataToNetwork();
             void sendPendingDataToApplication();
+            void handleHandshakeFinished();
 
         private:
             enum class State { Start, Accepting, Connecting, Connected, Error };
@@ -78,8 +95,24 @@ namespace Swift {
             State state_;
             std::unique_ptr<SSL_CTX> context_;
             std::unique_ptr<SSL> handle_;
-            BIO* readBIO_ = nullptr;
-            BIO* writeBIO_ = nullptr;
+
+            // Ciphertext that OpenSSL has not read yet. This points into the
+            // buffer passed to handleDataFromNetwork() while it runs, and into
+            // pendingNetworkInput_ once that buffer is gone.
+            const unsigned char* networkInput_ = nullptr;
+            size_t networkInputSize_ = 0;
+            SafeByteArray pendingNetworkInput_;
+
+            // Reused across calls, so records are not copied through
+            // freshly allocated buffers.
+            SafeByteArray networkOutput_;
+            SafeByteArray applicationOutput_;
             bool abortTLSHandshake_ = false;
+            std::shared_ptr<OpenSSLSessionCache> sessionCache_;
+            std::string sessionCacheKey_;
+
+            // Expires when the context is destroyed, so code running after a
+            // signal can tell whether a handler has deleted the context.
+            std::shared_ptr<bool> alive_ = std::make_shared<bool>(true);
     };
 }
@@ -17,12 +17,15 @@
 
 namespace Swift {
 
+OpenSSLContextFactory::OpenSSLContextFactory() : sessionCache_(std::make_shared<OpenSSLSessionCache>()) {
+}
+
 bool OpenSSLContextFactory::canCreate() const {
     return true;
 }
 
-TLSContext* OpenSSLContextFactory::createTLSContext(const TLSOptions&, TLSContext::Mode mode) {
-    return new OpenSSLContext(mode);
+TLSContext* OpenSSLContextFactory::createTLSContext(const TLSOptions& tlsOptions, TLSContext::Mode mode) {
+    return new OpenSSLContext(mode, tlsOptions.sessionResumption ? sessionCache_ : std::shared_ptr<OpenSSLSessionCache>(), tlsOptions.sessionCacheKey);
 }
 
 ByteArray OpenSSLContextFactory::convertDHParametersFromPEMToDER(const std::string& dhParametersInPEM) {
@@ -6,11 +6,16 @@
 
 #pragma once
 
+#include <memory>
+
+#include <Swiften/TLS/OpenSSL/OpenSSLSessionCache.h>
 #include <Swiften/TLS/TLSContextFactory.h>
 
 namespace Swift {
     class OpenSSLContextFactory : public TLSContextFactory {
         public:
+            OpenSSLContextFactory();
+
             bool canCreate() const override final;
             virtual TLSContext* createTLSContext(const TLSOptions& tlsOptions, TLSContext::Mode mode) override final;
 
@@ -19,5 +24,15 @@ namespace Swift {
             // Not supported
             virtual void setCheckCertificateRevocation(bool b) override final;
             virtual void setDisconnectOnCardRemoval(bool b) override final;
+
+            /**
+             * The session cache shared by all contexts created by this factory.
+             */
+            std::shared_ptr<OpenSSLSessionCache> getSessionCache() const {
+                return sessionCache_;
+            }
+
+        private:
+            std::shared_ptr<OpenSSLSessionCache> sessionCache_;
     };
 }
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <Swiften/TLS/OpenSSL/OpenSSLSessionCache.h>
+
+#include <openssl/rand.h>
+
+#include <Swiften/Base/Log.h>
+
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+
+namespace Swift {
+
+static const unsigned char SESSION_ID_CONTEXT[] = "Swiften";
+
+OpenSSLSessionCache::OpenSSLSessionCache() {
+}
+
+std::shared_ptr<SSL_SESSION> OpenSSLSessionCache::getSession(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto session = sessions_.get(key);
+    if (!session) {
+        return std::shared_ptr<SSL_SESSION>();
+    }
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+    if (!SSL_SESSION_is_resumable(session->get())) {
+        sessions_.erase(key);
+        return std::shared_ptr<SSL_SESSION>();
+    }
+#endif
+    return *session;
+}
+
+void OpenSSLSessionCache::addSession(const std::string& key, SSL_SESSION* session) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sessions_.erase(key);
+    sessions_.insert(key, std::shared_ptr<SSL_SESSION>(session, SSL_SESSION_free));
+}
+
+void OpenSSLSessionCache::removeSession(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sessions_.erase(key);
+}
+
+void OpenSSLSessionCache::setUpServerContext(SSL_CTX* context) {
+    SSL_CTX_set_session_id_context(context, SESSION_ID_CONTEXT, sizeof(SESSION_ID_CONTEXT) - 1);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (ticketKeys_.empty()) {
+        // The key length depends on the OpenSSL version; asking without a buffer returns it.
+        long length = SSL_CTX_get_tlsext_ticket_keys(context, nullptr, 0);
+        if (length <= 0) {
+            SWIFT_LOG(warning) << "Unable to determine the TLS session ticket key length" << std::endl;
+            return;
+        }
+        ticketKeys_.resize(static_cast<size_t>(length));
+        if (RAND_bytes(vecptr(ticketKeys_), static_cast<int>(length)) != 1) {
+            SWIFT_LOG(warning) << "Unable to generate TLS session ticket keys" << std::endl;
+            ticketKeys_.clear();
+            return;
+        }
+    }
+    if (SSL_CTX_set_tlsext_ticket_keys(context, vecptr(ticketKeys_), static_cast<long>(ticketKeys_.size())) != 1) {
+        SWIFT_LOG(warning) << "Unable to set TLS session ticket keys" << std::endl;
+    }
+}
+
+void OpenSSLSessionCache::recordHandshake(bool resumed) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (resumed) {
+        statistics_.hits++;
+    }
+    else {
+        statistics_.misses++;
+    }
+}
+
+OpenSSLSessionCache::Statistics OpenSSLSessionCache::getStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return statistics_;
+}
+
+}
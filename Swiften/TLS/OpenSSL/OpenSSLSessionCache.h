@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2018 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <boost/noncopyable.hpp>
+
+#include <openssl/ssl.h>
+
+#include <Swiften/Base/LRUCache.h>
+#include <Swiften/Base/SafeByteArray.h>
+
+namespace Swift {
+    /**
+     * Keeps the TLS sessions established by the OpenSSLContexts of one
+     * OpenSSLContextFactory, so later connections can resume them instead of
+     * doing a full handshake.
+     *
+     * Client sessions (including TLS 1.3 tickets) are stored per server
+     * identity. Server contexts share a session ticket key, so any of them
+     * can resume a session started by another.
+     *
+     * This class is thread-safe.
+     */
+    class OpenSSLSessionCache : boost::noncopyable {
+        public:
+            struct Statistics {
+                /** Handshakes that resumed a session. */
+                size_t hits = 0;
+
+                /** Handshakes that had to do a full key exchange. */
+                size_t misses = 0;
+            };
+
+        public:
+            OpenSSLSessionCache();
+
+            /**
+             * Returns the most recent resumable session for the server
+             * identified by \p key, or a null pointer.
+             */
+            std::shared_ptr<SSL_SESSION> getSession(const std::string& key);
+
+            /**
+             * Takes over the reference to \p session.
+             */
+            void addSession(const std::string& key, SSL_SESSION* session);
+            void removeSession(const std::string& key);
+
+            /**
+             * Configures \p context to issue and accept session tickets with
+             * the key shared by all server contexts using this cache.
+             */
+            void setUpServerContext(SSL_CTX* context);
+
+            void recordHandshake(bool resumed);
+            Statistics getStatistics() const;
+
+        private:
+            mutable std::mutex mutex_;
+            LRUCache<std::string, std::shared_ptr<SSL_SESSION>, 256> sessions_;
+            SafeByteArray ticketKeys_;
+            Statistics statistics_;
+    };
+}
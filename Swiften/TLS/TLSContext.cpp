@@ -50,4 +50,8 @@ ByteArray TLSContext::getPeerFinishMessage() const {
     return ByteArray();
 }
 
+bool TLSContext::isSessionResumed() const {
+    return false;
+}
+
 }
@@ -50,6 +50,12 @@ namespace Swift {
             virtual ByteArray getFinishMessage() const = 0;
             virtual ByteArray getPeerFinishMessage() const;
 
+            /**
+             * Returns whether the handshake resumed an earlier session
+             * rather than doing a full key exchange.
+             */
+            virtual bool isSessionResumed() const;
+
 
         public:
             enum class Mode {
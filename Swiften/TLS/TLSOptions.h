@@ -1,11 +1,13 @@
 /*
- * Copyright (c) 2015 Isode Limited.
+ * Copyright (c) 2015-2018 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #pragma once
 
+#include <string>
+
 namespace Swift {
 
     struct TLSOptions {
@@ -21,5 +23,20 @@ namespace Swift {
          */
         bool schannelTLS1_0Workaround;
 
+        /**
+         * Whether to resume earlier TLS sessions (and to store new ones) to
+         * avoid a full handshake. Only supported with OpenSSL.
+         */
+        bool sessionResumption = true;
+
+        /**
+         * Identifies the server, e.g. by its domain, for looking up a client
+         * session to resume. If empty, the server name passed to
+         * TLSContext::connect() is used; without either, no client session is
+         * resumed. Clients with different credentials should use different
+         * keys; OpenSSL adds the client certificate's fingerprint itself.
+         */
+        std::string sessionCacheKey;
+
     };
 }
@@ -4,6 +4,7 @@
  * See the COPYING file for more information.
  */
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <utility>
@@ -13,8 +14,10 @@
 
 #include <gtest/gtest.h>
 
+#include <Swiften/Base/Algorithm.h>
 #include <Swiften/Base/Log.h>
 #include <Swiften/TLS/CertificateFactory.h>
+#include <Swiften/TLS/OpenSSL/OpenSSLContextFactory.h>
 #include <Swiften/TLS/PlatformTLSFactories.h>
 #include <Swiften/TLS/TLSContext.h>
 #include <Swiften/TLS/TLSContextFactory.h>
@@ -640,7 +643,9 @@ TEST(ClientServerTest, testClientServerSNIRequestedHostAvailable) {
         return event.first == "client" && (event.second.type() == typeid(TLSDataForApplication));
     })->second)));
 
-    ASSERT_EQ("/CN=montague.example", boost::get<TLSConnected>(events.events[5].second).chain[0]->getSubjectName());
+    ASSERT_EQ("/CN=montague.example", boost::get<TLSConnected>(std::find_if(events.events.begin(), events.events.end(), [](std::pair<std::string, TLSEvent>& event){
+        return event.first == "client" && (event.second.type() == typeid(TLSConnected));
+    })->second).chain[0]->getSubjectName());
 }
 
 TEST(ClientServerTest, testClientServerSNIRequestedHostUnavailable) {
@@ -758,3 +763,165 @@ TEST(ClientServerTest, testClientServerBasicCommunicationWith1024BitDHParams) {
         return event.first == "client" && (event.second.type() == typeid(TLSDataForApplication));
     })->second)));
 }
+
+namespace {
+
+// Runs a handshake between a new client and server context and returns whether the client resumed a session.
+bool connectAndExchangeData(OpenSSLContextFactory& factory, const TLSOptions& options, const std::string& clientCertificate = std::string()) {
+    auto clientContext = std::unique_ptr<TLSContext>(factory.createTLSContext(options, TLSContext::Mode::Client));
+    auto serverContext = std::unique_ptr<TLSContext>(factory.createTLSContext(options, TLSContext::Mode::Server));
+
+    TLSClientServerEventHistory events(clientContext.get(), serverContext.get());
+    ClientServerConnector connector(clientContext.get(), serverContext.get());
+
+    auto tlsFactories = std::make_shared<PlatformTLSFactories>();
+    if (!clientCertificate.empty()) {
+        EXPECT_EQ(true, clientContext->setCertificateChain(tlsFactories->getCertificateFactory()->createCertificateChain(createByteArray(certificatePEM[clientCertificate]))));
+        EXPECT_EQ(true, clientContext->setPrivateKey(tlsFactories->getCertificateFactory()->createPrivateKey(createSafeByteArray(privateKeyPEM[clientCertificate]))));
+    }
+    EXPECT_EQ(true, serverContext->setCertificateChain(tlsFactories->getCertificateFactory()->createCertificateChain(createByteArray(certificatePEM["capulet.example"]))));
+    EXPECT_EQ(true, serverContext->setPrivateKey(tlsFactories->getCertificateFactory()->createPrivateKey(createSafeByteArray(privateKeyPEM["capulet.example"]))));
+
+    serverContext->accept();
+    clientContext->connect();
+
+    // TLS 1.3 session tickets are only processed when the client reads data after the handshake.
+    clientContext->handleDataFromApplication(createSafeByteArray("This is a test message from the client."));
+    serverContext->handleDataFromApplication(createSafeByteArray("This is a test message from the server."));
+
+    EXPECT_EQ(2, std::count_if(events.events.begin(), events.events.end(), [](std::pair<std::string, TLSEvent>& event) {
+        return event.second.type() == typeid(TLSDataForApplication);
+    }));
+    EXPECT_EQ(clientContext->isSessionResumed(), serverContext->isSessionResumed());
+    return clientContext->isSessionResumed();
+}
+
+}
+
+TEST(ClientServerTest, testSessionResumption) {
+    OpenSSLContextFactory factory;
+    TLSOptions options;
+    options.sessionCacheKey = "capulet.example";
+
+    ASSERT_FALSE(connectAndExchangeData(factory, options));
+    ASSERT_TRUE(connectAndExchangeData(factory, options));
+    ASSERT_TRUE(connectAndExchangeData(factory, options));
+
+    ASSERT_EQ(4u, factory.getSessionCache()->getStatistics().hits);
+    ASSERT_EQ(2u, factory.getSessionCache()->getStatistics().misses);
+}
+
+TEST(ClientServerTest, testSessionResumptionWithOtherServerIdentity) {
+    OpenSSLContextFactory factory;
+    TLSOptions options;
+    options.sessionCacheKey = "capulet.example";
+    ASSERT_FALSE(connectAndExchangeData(factory, options));
+
+    options.sessionCacheKey = "montague.example";
+    ASSERT_FALSE(connectAndExchangeData(factory, options));
+    ASSERT_TRUE(connectAndExchangeData(factory, options));
+}
+
+TEST(ClientServerTest, testSessionResumptionWithOtherClientCertificate) {
+    OpenSSLContextFactory factory;
+    TLSOptions options;
+    options.sessionCacheKey = "capulet.example";
+    ASSERT_FALSE(connectAndExchangeData(factory, options, "montague.example"));
+
+    ASSERT_FALSE(connectAndExchangeData(factory, options, "capulet.example"));
+    ASSERT_FALSE(connectAndExchangeData(factory, options));
+    ASSERT_TRUE(connectAndExchangeData(factory, options, "montague.example"));
+    ASSERT_TRUE(connectAndExchangeData(factory, options, "capulet.example"));
+}
+
+TEST(ClientServerTest, testSessionResumptionDisabled) {
+    OpenSSLContextFactory factory;
+    TLSOptions options;
+    options.sessionCacheKey = "capulet.example";
+    options.sessionResumption = false;
+
+    ASSERT_FALSE(connectAndExchangeData(factory, options));
+    ASSERT_FALSE(connectAndExchangeData(factory, options));
+    ASSERT_EQ(0u, factory.getSessionCache()->getStatistics().misses);
+}
+
+TEST(ClientServerTest, testClientServerFragmentedRecords) {
+    auto clientContext = createTLSContext(TLSContext::Mode::Client);
+    auto serverContext = createTLSContext(TLSContext::Mode::Server);
+
+    // Deliver network data in small pieces, so records are split across calls.
+    auto forwardInFragments = [](TLSContext* context) {
+        return [context](const SafeByteArray& data) {
+            for (size_t i = 0; i < data.size(); i += 5) {
+                context->handleDataFromNetwork(SafeByteArray(data.begin() + i, data.begin() + std::min(data.size(), i + 5)));
+            }
+        };
+    };
+    clientContext->onDataForNetwork.connect(forwardInFragments(serverContext.get()));
+    serverContext->onDataForNetwork.connect(forwardInFragments(clientContext.get()));
+
+    SafeByteArray clientData;
+    SafeByteArray serverData;
+    clientContext->onDataForApplication.connect([&](const SafeByteArray& data) { append(clientData, data); });
+    serverContext->onDataForApplication.connect([&](const SafeByteArray& data) { append(serverData, data); });
+
+    auto tlsFactories = std::make_shared<PlatformTLSFactories>();
+    ASSERT_EQ(true, serverContext->setCertificateChain(tlsFactories->getCertificateFactory()->createCertificateChain(createByteArray(certificatePEM["capulet.example"]))));
+    ASSERT_EQ(true, serverContext->setPrivateKey(tlsFactories->getCertificateFactory()->createPrivateKey(createSafeByteArray(privateKeyPEM["capulet.example"]))));
+
+    serverContext->accept();
+    clientContext->connect();
+
+    SafeByteArray largeMessage(100000);
+    for (size_t i = 0; i < largeMessage.size(); ++i) {
+        largeMessage[i] = static_cast<unsigned char>(i % 251);
+    }
+    clientContext->handleDataFromApplication(largeMessage);
+    serverContext->handleDataFromApplication(createSafeByteArray("This is a test message from the server."));
+
+    ASSERT_EQ(largeMessage, serverData);
+    ASSERT_EQ("This is a test message from the server.", safeByteArrayToString(clientData));
+}
+
+TEST(ClientServerTest, testServerDestroyedByApplicationDataHandler) {
+    auto clientContext = createTLSContext(TLSContext::Mode::Client);
+    auto serverContext = createTLSContext(TLSContext::Mode::Server);
+
+    // Hold back the client's records after the handshake, so they reach the server in one buffer.
+    bool holdClientData = false;
+    SafeByteArray clientData;
+    clientContext->onDataForNetwork.connect([&](const SafeByteArray& data) {
+        append(clientData, data);
+        if (!holdClientData) {
+            SafeByteArray dataToSend;
+            dataToSend.swap(clientData);
+            serverContext->handleDataFromNetwork(dataToSend);
+        }
+    });
+    serverContext->onDataForNetwork.connect([&](const SafeByteArray& data) {
+        clientContext->handleDataFromNetwork(data);
+    });
+
+    // The handler destroys both the server context and the buffer it is reading from.
+    std::vector<std::string> serverData;
+    serverContext->onDataForApplication.connect([&](const SafeByteArray& data) {
+        serverData.push_back(safeByteArrayToString(data));
+        serverContext.reset();
+        SafeByteArray().swap(clientData);
+    });
+
+    auto tlsFactories = std::make_shared<PlatformTLSFactories>();
+    ASSERT_EQ(true, serverContext->setCertificateChain(tlsFactories->getCertificateFactory()->createCertificateChain(createByteArray(certificatePEM["capulet.example"]))));
+    ASSERT_EQ(true, serverContext->setPrivateKey(tlsFactories->getCertificateFactory()->createPrivateKey(createSafeByteArray(privateKeyPEM["capulet.example"]))));
+
+    serverContext->accept();
+    clientContext->connect();
+
+    holdClientData = true;
+    clientContext->handleDataFromApplication(createSafeByteArray("This is a test message "));
+    clientContext->handleDataFromApplication(createSafeByteArray("from the client."));
+    serverContext->handleDataFromNetwork(clientData);
+
+    ASSERT_EQ(nullptr, serverContext.get());
+    ASSERT_EQ(std::vector<std::string>({"This is a test message from the client."}), serverData);
+}